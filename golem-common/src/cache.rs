@@ -328,6 +328,24 @@ impl<
         })
     }
 
+    /// Returns the cached values with their last access time, ordered from the least recently
+    /// used to the most recently used one
+    pub fn iter_least_recently_used(&self) -> Vec<(K, V, Instant)> {
+        let mut items: Vec<(K, V, Instant)> = self
+            .state
+            .items
+            .iter()
+            .filter_map(|r| match r.deref() {
+                Item::Pending { .. } => None,
+                Item::Cached { value, last_access } => {
+                    Some((r.key().clone(), value.clone(), *last_access))
+                }
+            })
+            .collect();
+        items.sort_by_key(|(_, _, last_access)| *last_access);
+        items
+    }
+
     pub fn remove(&self, key: &K) {
         let removed = self.state.items.remove(key).is_some();
         if removed {
@@ -336,6 +354,42 @@ impl<
         }
     }
 
+    /// Removes the cached value of the given key if it satisfies the predicate, returning it.
+    ///
+    /// The predicate is evaluated while the entry is locked, so the value cannot be looked up
+    /// between checking and removing it. Pending values are never removed.
+    pub fn remove_if(&self, key: &K, predicate: impl FnOnce(&V) -> bool) -> Option<V> {
+        let removed = self.state.items.remove_if(key, |_, item| match item {
+            Item::Cached { value, .. } => predicate(value),
+            Item::Pending { .. } => false,
+        });
+        match removed {
+            Some((_, Item::Cached { value, .. })) => {
+                let count = self.state.count.fetch_sub(1, Ordering::SeqCst);
+                record_cache_size(self.name, count.saturating_sub(1));
+                Some(value)
+            }
+            _ => None,
+        }
+    }
+
+    /// Replaces the cached value of the given key, returning whether it was replaced.
+    ///
+    /// The value is swapped while the entry is locked, so a lookup either gets the old or the new
+    /// value, never a miss. Missing and pending values are not replaced.
+    pub fn replace(&self, key: &K, new_value: V) -> bool {
+        match self.state.items.get_mut(key) {
+            Some(mut item) => match item.value_mut() {
+                Item::Cached { value, .. } => {
+                    *value = new_value;
+                    true
+                }
+                Item::Pending { .. } => false,
+            },
+            None => false,
+        }
+    }
+
     pub fn create_weak_remover(&self, key: K) -> impl FnOnce() {
         let weak_state = Arc::downgrade(&self.state);
         let name = self.name;
@@ -38,7 +38,9 @@ use serde_json::Value;
 use uuid::Uuid;
 
 use crate::config::RetryConfig;
-use crate::model::oplog::{OplogIndex, TimestampedUpdateDescription};
+use crate::model::oplog::{
+    KeyValueWriteBehindRecord, OplogIndex, TimestampedUpdateDescription, WorkerSnapshot,
+};
 use crate::model::regions::DeletedRegions;
 use crate::newtype_uuid;
 
@@ -388,7 +390,7 @@ impl Display for PromiseId {
 }
 
 /// Actions that can be scheduled to be executed at a given point in time
-#[derive(Debug, Clone, Hash, Serialize, Deserialize, Encode, Decode)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash, Serialize, Deserialize, Encode, Decode)]
 pub enum ScheduledAction {
     /// Completes a given promise
     CompletePromise {
@@ -837,6 +839,17 @@ pub struct WorkerStatusRecord {
     pub component_size: u64,
     pub total_linear_memory_size: u64,
     pub oplog_idx: OplogIndex,
+    /// The worker's last snapshot. The oplog before it is skipped during recovery, and the
+    /// worker's state is restored by loading the snapshot instead. Added after the other
+    /// fields, so a record stored without it fails to decode and is calculated again.
+    pub last_snapshot: Option<WorkerSnapshot>,
+    /// The worker's last recorded key-value write-behind settings. Needed when they were
+    /// recorded before the last snapshot, as those entries are not replayed. Added after
+    /// `last_snapshot` for the same reason.
+    pub key_value_write_behind: Option<KeyValueWriteBehindRecord>,
+    /// The oplog index where the worker recorded that it derives its clock readings from
+    /// snapshots, kept for the same reasons as `key_value_write_behind`
+    pub clock_snapshot_mode: Option<OplogIndex>,
 }
 
 impl Default for WorkerStatusRecord {
@@ -855,6 +868,9 @@ impl Default for WorkerStatusRecord {
             component_size: 0,
             total_linear_memory_size: 0,
             oplog_idx: OplogIndex::default(),
+            last_snapshot: None,
+            key_value_write_behind: None,
+            clock_snapshot_mode: None,
         }
     }
 }
@@ -1373,6 +1389,48 @@ impl WorkerFilter {
         }
     }
 
+    /// Evaluates the filter for a worker of which only the status is known. Returns `None` if
+    /// the result also depends on other properties of the worker.
+    pub fn matches_status(&self, status: &WorkerStatus) -> Option<bool> {
+        match self {
+            WorkerFilter::Status(WorkerStatusFilter { comparator, value }) => {
+                Some(comparator.matches(status, value))
+            }
+            WorkerFilter::Name(_)
+            | WorkerFilter::Version(_)
+            | WorkerFilter::Env(_)
+            | WorkerFilter::CreatedAt(_) => None,
+            WorkerFilter::Not(WorkerNotFilter { filter }) => {
+                filter.matches_status(status).map(|result| !result)
+            }
+            WorkerFilter::And(WorkerAndFilter { filters }) => {
+                let mut result = Some(true);
+                for filter in filters {
+                    match filter.matches_status(status) {
+                        Some(false) => return Some(false),
+                        Some(true) => {}
+                        None => result = None,
+                    }
+                }
+                result
+            }
+            WorkerFilter::Or(WorkerOrFilter { filters }) => {
+                if filters.is_empty() {
+                    return Some(true);
+                }
+                let mut result = Some(false);
+                for filter in filters {
+                    match filter.matches_status(status) {
+                        Some(true) => return Some(true),
+                        Some(false) => {}
+                        None => result = None,
+                    }
+                }
+                result
+            }
+        }
+    }
+
     pub fn new_and(filters: Vec<WorkerFilter>) -> Self {
         WorkerFilter::And(WorkerAndFilter::new(filters))
     }
@@ -2132,4 +2190,37 @@ mod tests {
             ))
             .matches(&worker_metadata));
     }
+
+    #[test]
+    fn worker_filter_matches_status() {
+        let filter =
+            WorkerFilter::new_status(FilterComparator::GreaterEqual, WorkerStatus::Retrying);
+        assert_eq!(filter.matches_status(&WorkerStatus::Failed), Some(true));
+        assert_eq!(filter.matches_status(&WorkerStatus::Idle), Some(false));
+        assert_eq!(filter.not().matches_status(&WorkerStatus::Idle), Some(true));
+
+        let name = WorkerFilter::new_name(StringFilterComparator::Equal, "worker-1".to_string());
+        assert_eq!(name.matches_status(&WorkerStatus::Idle), None);
+        assert_eq!(
+            name.and(filter.clone()).matches_status(&WorkerStatus::Idle),
+            Some(false)
+        );
+        assert_eq!(
+            name.and(filter.clone())
+                .matches_status(&WorkerStatus::Exited),
+            None
+        );
+        assert_eq!(
+            name.or(filter.clone()).matches_status(&WorkerStatus::Idle),
+            None
+        );
+        assert_eq!(
+            name.or(filter).matches_status(&WorkerStatus::Exited),
+            Some(true)
+        );
+        assert_eq!(
+            WorkerFilter::new_or(vec![]).matches_status(&WorkerStatus::Idle),
+            Some(true)
+        );
+    }
 }
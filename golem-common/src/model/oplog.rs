@@ -216,6 +216,22 @@ pub enum OplogEntry {
         target_version: ComponentVersion,
         details: Option<String>,
     },
+    /// Increased the total linear memory size of the worker by `delta` bytes
+    GrowMemory { timestamp: Timestamp, delta: u64 },
+    /// A snapshot of the worker's state, returned by its save-snapshot export. Recovery loads it
+    /// instead of replaying the oplog entries before it.
+    Snapshot {
+        timestamp: Timestamp,
+        payload: OplogPayload,
+    },
+    /// The worker buffers its key-value mutations from this point, flushing them once
+    /// `max_buffered_writes` mutations are pending
+    KeyValueWriteBehind {
+        timestamp: Timestamp,
+        max_buffered_writes: u64,
+    },
+    /// The worker derives its clock readings from per-invocation snapshots from this point
+    ClockSnapshotMode { timestamp: Timestamp },
 }
 
 impl OplogEntry {
@@ -346,6 +362,33 @@ impl OplogEntry {
         }
     }
 
+    pub fn grow_memory(delta: u64) -> OplogEntry {
+        OplogEntry::GrowMemory {
+            timestamp: Timestamp::now_utc(),
+            delta,
+        }
+    }
+
+    pub fn snapshot(payload: OplogPayload) -> OplogEntry {
+        OplogEntry::Snapshot {
+            timestamp: Timestamp::now_utc(),
+            payload,
+        }
+    }
+
+    pub fn key_value_write_behind(max_buffered_writes: u64) -> OplogEntry {
+        OplogEntry::KeyValueWriteBehind {
+            timestamp: Timestamp::now_utc(),
+            max_buffered_writes,
+        }
+    }
+
+    pub fn clock_snapshot_mode() -> OplogEntry {
+        OplogEntry::ClockSnapshotMode {
+            timestamp: Timestamp::now_utc(),
+        }
+    }
+
     pub fn is_end_atomic_region(&self, idx: OplogIndex) -> bool {
         matches!(self, OplogEntry::EndAtomicRegion { begin_index, .. } if *begin_index == idx)
     }
@@ -366,6 +409,10 @@ impl OplogEntry {
                 | OplogEntry::PendingUpdate { .. }
                 | OplogEntry::SuccessfulUpdate { .. }
                 | OplogEntry::FailedUpdate { .. }
+                | OplogEntry::GrowMemory { .. }
+                | OplogEntry::Snapshot { .. }
+                | OplogEntry::KeyValueWriteBehind { .. }
+                | OplogEntry::ClockSnapshotMode { .. }
         )
     }
 
@@ -389,7 +436,11 @@ impl OplogEntry {
             | OplogEntry::PendingWorkerInvocation { timestamp, .. }
             | OplogEntry::PendingUpdate { timestamp, .. }
             | OplogEntry::SuccessfulUpdate { timestamp, .. }
-            | OplogEntry::FailedUpdate { timestamp, .. } => *timestamp,
+            | OplogEntry::FailedUpdate { timestamp, .. }
+            | OplogEntry::GrowMemory { timestamp, .. }
+            | OplogEntry::Snapshot { timestamp, .. }
+            | OplogEntry::KeyValueWriteBehind { timestamp, .. }
+            | OplogEntry::ClockSnapshotMode { timestamp } => *timestamp,
         }
     }
 }
@@ -423,6 +474,22 @@ pub struct TimestampedUpdateDescription {
     pub description: UpdateDescription,
 }
 
+/// The last snapshot of a worker, recorded by an `OplogEntry::Snapshot` at `oplog_index`
+#[derive(Clone, Debug, PartialEq, Eq, Encode, Decode)]
+pub struct WorkerSnapshot {
+    pub timestamp: Timestamp,
+    pub oplog_index: OplogIndex,
+    pub payload: OplogPayload,
+}
+
+/// The key-value write-behind settings of a worker, recorded by an
+/// `OplogEntry::KeyValueWriteBehind` at `oplog_index`
+#[derive(Clone, Debug, PartialEq, Eq, Encode, Decode)]
+pub struct KeyValueWriteBehindRecord {
+    pub oplog_index: OplogIndex,
+    pub max_buffered_writes: u64,
+}
+
 #[derive(Clone, Debug, PartialEq, Eq, Encode, Decode)]
 pub enum OplogPayload {
     /// Load the payload from the given byte array
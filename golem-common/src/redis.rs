@@ -19,7 +19,7 @@ use std::time::Instant;
 
 use bincode::{Decode, Encode};
 use bytes::Bytes;
-use fred::clients::Transaction;
+use fred::clients::{Pipeline, RedisClient, Transaction};
 use fred::cmd;
 use fred::prelude::{RedisPool as FredRedisPool, *};
 use fred::types::{
@@ -664,6 +664,31 @@ impl<'a> RedisLabelledApi<'a> {
         )
     }
 
+    /// Runs a Lua script atomically on the given keys
+    pub async fn eval<R, K, V>(&self, script: &'static str, keys: Vec<K>, args: V) -> RedisResult<R>
+    where
+        R: FromRedis,
+        K: AsRef<str>,
+        V: TryInto<MultipleValues> + Send,
+        V::Error: Into<RedisError> + Send,
+    {
+        self.ensure_connected().await?;
+        let start = Instant::now();
+        self.record(
+            start,
+            "EVAL",
+            self.pool
+                .eval(
+                    script,
+                    keys.iter()
+                        .map(|k| self.prefixed_key(k))
+                        .collect::<Vec<_>>(),
+                    args,
+                )
+                .await,
+        )
+    }
+
     pub async fn transaction<R, F, Fu>(&self, func: F) -> RedisResult<R>
     where
         R: FromRedis,
@@ -681,6 +706,54 @@ impl<'a> RedisLabelledApi<'a> {
         self.record(start, "MULTI", trx.trx.exec(true).await)
     }
 
+    /// Sends all the commands queued by `func` in a single round trip, without the atomicity
+    /// guarantees of a transaction.
+    pub async fn pipeline<R, F, Fu>(&self, func: F) -> RedisResult<R>
+    where
+        R: FromRedis,
+        F: FnOnce(RedisPipeline) -> Fu,
+        Fu: std::future::Future<Output = RedisResult<RedisPipeline>>,
+    {
+        self.ensure_connected().await?;
+        let start = Instant::now();
+
+        let client = self.pool.next_connected();
+        let pipeline = client.pipeline();
+        let pipeline = RedisPipeline::new(pipeline, self.key_prefix.clone());
+        let pipeline = func(pipeline).await?;
+
+        self.record(start, "PIPELINE", pipeline.pipeline.all().await)
+    }
+
+    /// Sends all the commands queued by `func` in a single round trip like `pipeline`, but
+    /// returns the result of each command separately, so a failing command does not hide the
+    /// results of the others.
+    pub async fn pipeline_each<R, F, Fu>(&self, func: F) -> RedisResult<Vec<RedisResult<R>>>
+    where
+        R: FromRedis,
+        F: FnOnce(RedisPipeline) -> Fu,
+        Fu: std::future::Future<Output = RedisResult<RedisPipeline>>,
+    {
+        self.ensure_connected().await?;
+        let start = Instant::now();
+
+        let client = self.pool.next_connected();
+        let pipeline = client.pipeline();
+        let pipeline = RedisPipeline::new(pipeline, self.key_prefix.clone());
+        let pipeline = func(pipeline).await?;
+
+        let results = pipeline.pipeline.try_all::<R>().await;
+        match results.iter().find_map(|result| result.as_ref().err()) {
+            Some(err) => {
+                let _ = self.record::<()>(start, "PIPELINE", Err(err.clone()));
+            }
+            None => {
+                let _ = self.record(start, "PIPELINE", Ok(()));
+            }
+        }
+        Ok(results)
+    }
+
     pub async fn wait(&self, replicas: i64, timeout: i64) -> RedisResult<i64> {
         self.ensure_connected().await?;
         let start = Instant::now();
@@ -739,6 +812,71 @@ impl<'a> RedisLabelledApi<'a> {
         )
     }
 
+    pub async fn sscan<K>(&self, key: K, cursor: u64, count: u64) -> RedisResult<(u64, Vec<Bytes>)>
+    where
+        K: AsRef<str>,
+    {
+        self.ensure_connected().await?;
+        let start = Instant::now();
+
+        //https://redis.io/commands/sscan/
+        let args: Vec<String> = vec![
+            self.prefixed_key(key),
+            cursor.to_string(),
+            "COUNT".to_string(),
+            count.to_string(),
+        ];
+
+        self.record(
+            start,
+            "SSCAN",
+            self.pool
+                .next()
+                .custom_raw(cmd!("SSCAN"), args)
+                .await
+                .and_then(|f| self.parse_member_scan_frame(f)),
+        )
+    }
+
+    fn parse_member_scan_frame(&self, frame: Resp3Frame) -> RedisResult<(u64, Vec<Bytes>)> {
+        use fred::prelude::*;
+        if let Resp3Frame::Array { mut data, .. } = frame {
+            if data.len() == 2 {
+                let cursor: u64 = data[0]
+                    .clone()
+                    .try_into()
+                    .and_then(|value: RedisValue| value.convert())?;
+
+                if let Some(Resp3Frame::Array { data, .. }) = data.pop() {
+                    let mut members = Vec::with_capacity(data.len());
+                    for frame in data.into_iter() {
+                        let member: Bytes = frame
+                            .try_into()
+                            .and_then(|value: RedisValue| value.convert())?;
+                        members.push(member);
+                    }
+
+                    Ok((cursor, members))
+                } else {
+                    Err(RedisError::new(
+                        RedisErrorKind::Protocol,
+                        "Expected second SSCAN result element to be an array.",
+                    ))
+                }
+            } else {
+                Err(RedisError::new(
+                    RedisErrorKind::Protocol,
+                    "Expected two-element bulk string array from SSCAN.",
+                ))
+            }
+        } else {
+            Err(RedisError::new(
+                RedisErrorKind::Protocol,
+                "Expected bulk string array from SSCAN.",
+            ))
+        }
+    }
+
     fn parse_key_scan_frame(&self, frame: Resp3Frame) -> RedisResult<(u64, Vec<String>)> {
         use fred::prelude::*;
         if let Resp3Frame::Array { mut data, .. } = frame {
@@ -854,3 +992,57 @@ impl RedisTransaction {
         self.trx.scard(self.prefixed_key(key)).await
     }
 }
+
+pub struct RedisPipeline {
+    pipeline: Pipeline<RedisClient>,
+    key_prefix: String,
+}
+
+impl RedisPipeline {
+    fn new(pipeline: Pipeline<RedisClient>, key_prefix: String) -> Self {
+        Self {
+            pipeline,
+            key_prefix,
+        }
+    }
+
+    fn prefixed_key<K>(&self, key: K) -> String
+    where
+        K: AsRef<str>,
+    {
+        format!("{}{}", &self.key_prefix, key.as_ref())
+    }
+
+    pub async fn xadd<K, C, I, F>(
+        &self,
+        key: K,
+        nomkstream: bool,
+        cap: C,
+        id: I,
+        fields: F,
+    ) -> RedisResult<()>
+    where
+        K: AsRef<str>,
+        I: Into<XID> + Send,
+        F: TryInto<MultipleOrderedPairs> + Send,
+        F::Error: Into<RedisError> + Send,
+        C: TryInto<XCap> + Send,
+        C::Error: Into<RedisError> + Send,
+    {
+        self.pipeline
+            .xadd(self.prefixed_key(key), nomkstream, cap, id, fields)
+            .await
+    }
+
+    /// Queues running a Lua script on a single key
+    pub async fn eval<K, V>(&self, script: &'static str, key: K, args: V) -> RedisResult<()>
+    where
+        K: AsRef<str>,
+        V: TryInto<MultipleValues> + Send,
+        V::Error: Into<RedisError> + Send,
+    {
+        self.pipeline
+            .eval(script, self.prefixed_key(key), args)
+            .await
+    }
+}
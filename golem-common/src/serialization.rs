@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::io::Read;
+use std::marker::PhantomData;
+
 use bincode::{Decode, Encode};
 use bytes::{BufMut, Bytes, BytesMut};
 use tracing::error;
@@ -79,6 +82,56 @@ pub fn try_deserialize_with_version<T: Decode>(
     }
 }
 
+/// Deserializes the elements of a `Vec<T>` serialized by `serialize` from `reader` one by one,
+/// without reading the whole serialized vector into memory
+pub fn deserialize_vec_from_reader<T: Decode, R: Read>(
+    mut reader: R,
+) -> Result<VecDeserializer<T, R>, String> {
+    let mut version = [0u8; 1];
+    reader
+        .read_exact(&mut version)
+        .map_err(|e| format!("Failed to read serialization version: {e}"))?;
+    match version[0] {
+        SERIALIZATION_VERSION_V1 => {
+            panic!("Support for v1 serialization format has been dropped");
+        }
+        SERIALIZATION_VERSION_V2 => {
+            let remaining: u64 =
+                bincode::decode_from_std_read(&mut reader, bincode::config::standard())
+                    .map_err(|e| format!("Failed to deserialize value: {e}"))?;
+            Ok(VecDeserializer {
+                reader,
+                remaining,
+                element: PhantomData,
+            })
+        }
+        version => Err(format!("invalid serialization version: {version}")),
+    }
+}
+
+/// Iterator over the elements deserialized by `deserialize_vec_from_reader`
+pub struct VecDeserializer<T, R> {
+    reader: R,
+    remaining: u64,
+    element: PhantomData<T>,
+}
+
+impl<T: Decode, R: Read> Iterator for VecDeserializer<T, R> {
+    type Item = Result<T, String>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.remaining == 0 {
+            None
+        } else {
+            self.remaining -= 1;
+            Some(
+                bincode::decode_from_std_read(&mut self.reader, bincode::config::standard())
+                    .map_err(|e| format!("Failed to deserialize value: {e}")),
+            )
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use bincode::{Decode, Encode};
@@ -132,4 +185,16 @@ mod tests {
             assert_eq!(result, None);
         }
     }
+
+    #[test]
+    pub fn deserialize_vec_from_reader_roundtrip() {
+        let mut rng = rand::thread_rng();
+        let examples: Vec<Example> = (0..100).map(|_| Example::random(&mut rng)).collect();
+        let serialized = super::serialize(&examples).unwrap();
+        let deserialized: Vec<Example> = super::deserialize_vec_from_reader(&*serialized)
+            .unwrap()
+            .collect::<Result<_, _>>()
+            .unwrap();
+        assert_eq!(examples, deserialized);
+    }
 }
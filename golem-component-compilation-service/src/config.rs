@@ -21,6 +21,7 @@ use serde::Deserialize;
 use uuid::Uuid;
 
 use golem_common::config::RetryConfig;
+use golem_worker_executor_base::services::compiled_component::CpuFeatureLevel;
 use golem_worker_executor_base::services::golem_config::{
     BlobStorageConfig, CompiledComponentServiceConfig,
 };
@@ -68,6 +69,9 @@ impl ComponentServiceConfig {
 pub struct CompileWorkerConfig {
     pub retries: RetryConfig,
     pub max_component_size: usize,
+    /// The CPU feature levels to compile each component for. Levels of other architectures
+    /// than the one of the service are ignored.
+    pub feature_levels: Vec<CpuFeatureLevel>,
 }
 
 impl ServerConfig {
@@ -24,6 +24,7 @@ use tracing::info;
 use crate::service::compile_service::ComponentCompilationServiceImpl;
 use config::ServerConfig;
 use golem_api_grpc::proto::golem::componentcompilation::component_compilation_service_server::ComponentCompilationServiceServer;
+use golem_worker_executor_base::services::compiled_component::CpuFeatureLevel;
 use golem_worker_executor_base::services::golem_config::BlobStorageConfig;
 use golem_worker_executor_base::storage::blob::s3::S3BlobStorage;
 use golem_worker_executor_base::storage::blob::BlobStorage;
@@ -90,7 +91,21 @@ async fn run(config: ServerConfig, prometheus: Registry) -> Result<(), Box<dyn s
     };
     let compiled_component =
         compiled_component::configured(&config.compiled_component_service, blob_storage.clone());
-    let engine = wasmtime::Engine::new(&create_wasmtime_config()).expect("Failed to create engine");
+    let engines = config
+        .compile_worker
+        .feature_levels
+        .iter()
+        .filter(|level| CpuFeatureLevel::all().contains(level))
+        .map(|level| {
+            let engine = wasmtime::Engine::new(&create_wasmtime_config(*level))
+                .expect("Failed to create engine");
+            (*level, engine)
+        })
+        .collect::<Vec<_>>();
+    info!(
+        "Compiling components for CPU feature levels {:?}",
+        engines.iter().map(|(level, _)| level).collect::<Vec<_>>()
+    );
 
     // Start metrics and healthcheck server.
     let address = config.http_addr().expect("Invalid HTTP address");
@@ -103,7 +118,7 @@ async fn run(config: ServerConfig, prometheus: Registry) -> Result<(), Box<dyn s
     let compilation_service = ComponentCompilationServiceImpl::new(
         config.compile_worker,
         config.component_service,
-        engine,
+        engines,
         compiled_component,
     );
 
@@ -140,7 +155,7 @@ async fn start_grpc_server(
         .await
 }
 
-fn create_wasmtime_config() -> wasmtime::Config {
+fn create_wasmtime_config(feature_level: CpuFeatureLevel) -> wasmtime::Config {
     let mut config = wasmtime::Config::default();
 
     config.wasm_multi_value(true);
@@ -148,6 +163,7 @@ fn create_wasmtime_config() -> wasmtime::Config {
     config.wasm_component_model(true);
     config.epoch_interruption(true);
     config.consume_fuel(true);
+    feature_level.configure(&mut config);
 
     config
 }
@@ -15,6 +15,7 @@
 use std::fmt::Display;
 
 use golem_common::model::ComponentId;
+use golem_worker_executor_base::services::compiled_component::CpuFeatureLevel;
 use tokio::sync::mpsc;
 use wasmtime::component::Component;
 
@@ -37,6 +38,7 @@ pub struct CompilationRequest {
 
 pub struct CompiledComponent {
     pub component_and_version: ComponentWithVersion,
+    pub feature_level: CpuFeatureLevel,
     pub component: Component,
 }
 
@@ -17,7 +17,9 @@ use crate::config::{CompileWorkerConfig, ComponentServiceConfig};
 use crate::model::*;
 use async_trait::async_trait;
 use golem_common::model::ComponentId;
-use golem_worker_executor_base::services::compiled_component::CompiledComponentService;
+use golem_worker_executor_base::services::compiled_component::{
+    CompiledComponentService, CpuFeatureLevel,
+};
 use std::sync::Arc;
 use tokio::sync::mpsc;
 use wasmtime::Engine;
@@ -41,7 +43,7 @@ impl ComponentCompilationServiceImpl {
         compile_worker: CompileWorkerConfig,
         component_service: ComponentServiceConfig,
 
-        engine: Engine,
+        engines: Vec<(CpuFeatureLevel, Engine)>,
 
         compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
     ) -> Self {
@@ -52,7 +54,7 @@ impl ComponentCompilationServiceImpl {
             component_service.uri(),
             component_service.access_token,
             compile_worker,
-            engine.clone(),
+            engines,
             compiled_component_service.clone(),
             upload_tx,
             compile_rx,
@@ -28,7 +28,9 @@ use golem_worker_executor_base::grpc::authorised_grpc_request;
 use golem_worker_executor_base::grpc::is_grpc_retriable;
 use golem_worker_executor_base::grpc::GrpcError;
 use golem_worker_executor_base::metrics::component::record_compilation_time;
-use golem_worker_executor_base::services::compiled_component::CompiledComponentService;
+use golem_worker_executor_base::services::compiled_component::{
+    CompiledComponentService, CpuFeatureLevel,
+};
 use http::Uri;
 use std::sync::Arc;
 use std::time::Instant;
@@ -46,7 +48,7 @@ pub struct CompileWorker {
     config: CompileWorkerConfig,
 
     // Resources
-    engine: Engine,
+    engines: Vec<(CpuFeatureLevel, Engine)>,
     compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
 }
 
@@ -56,7 +58,7 @@ impl CompileWorker {
         access_token: Uuid,
         config: CompileWorkerConfig,
 
-        engine: Engine,
+        engines: Vec<(CpuFeatureLevel, Engine)>,
         compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
 
         sender: mpsc::Sender<CompiledComponent>,
@@ -64,7 +66,7 @@ impl CompileWorker {
     ) {
         let worker = Self {
             uri,
-            engine,
+            engines,
             compiled_component_service,
             config,
             access_token,
@@ -76,18 +78,21 @@ impl CompileWorker {
                 let result = worker.compile_component(&request.component).await;
                 match result {
                     Err(_) => {}
-                    Ok(component) => {
+                    Ok(components) => {
                         tracing::info!("Compiled component {}", request.component);
-                        let send_result = sender
-                            .send(CompiledComponent {
-                                component_and_version: request.component,
-                                component,
-                            })
-                            .await;
-
-                        if send_result.is_err() {
-                            tracing::error!("Failed to send compiled component");
-                            break;
+                        for (feature_level, component) in components {
+                            let send_result = sender
+                                .send(CompiledComponent {
+                                    component_and_version: request.component.clone(),
+                                    feature_level,
+                                    component,
+                                })
+                                .await;
+
+                            if send_result.is_err() {
+                                tracing::error!("Failed to send compiled component");
+                                return;
+                            }
                         }
                     }
                 };
@@ -95,33 +100,42 @@ impl CompileWorker {
         });
     }
 
+    /// Compiles the component for each configured CPU feature level it has not been compiled
+    /// for yet
     async fn compile_component(
         &self,
         component_with_version: &ComponentWithVersion,
-    ) -> Result<Component, CompilationError> {
-        let engine = self.engine.clone();
-
-        // Ensure that the component hasn't already been compiled.
-        let result = self
-            .compiled_component_service
-            .get(
-                &component_with_version.id,
-                component_with_version.version,
-                &engine,
-            )
-            .await;
-
-        match result {
-            Ok(Some(component)) => return Ok(component),
-            Ok(_) => (),
-            Err(err) => {
-                tracing::warn!(
-                    "Failed to download compiled component {:?}: {}",
-                    component_with_version,
-                    err
-                );
-            }
-        };
+    ) -> Result<Vec<(CpuFeatureLevel, Component)>, CompilationError> {
+        let mut missing_levels = Vec::new();
+        for (feature_level, engine) in &self.engines {
+            // Ensure that the component hasn't already been compiled.
+            let result = self
+                .compiled_component_service
+                .exists(
+                    &component_with_version.id,
+                    component_with_version.version,
+                    *feature_level,
+                )
+                .await;
+
+            match result {
+                Ok(true) => (),
+                Ok(false) => missing_levels.push((*feature_level, engine.clone())),
+                Err(err) => {
+                    tracing::warn!(
+                        "Failed to check compiled component {:?} ({:?}): {}",
+                        component_with_version,
+                        feature_level,
+                        err
+                    );
+                    missing_levels.push((*feature_level, engine.clone()));
+                }
+            };
+        }
+
+        if missing_levels.is_empty() {
+            return Ok(Vec::new());
+        }
 
         let bytes = download_via_grpc(
             &self.uri,
@@ -133,25 +147,30 @@ impl CompileWorker {
         )
         .await?;
 
-        let start = Instant::now();
-        let component = Component::from_binary(&engine, &bytes).map_err(|e| {
-            CompilationError::CompileFailure(format!(
-                "Failed to compile component {:?}: {}",
-                component_with_version, e
-            ))
-        })?;
-        let end = Instant::now();
+        let mut components = Vec::new();
+        for (feature_level, engine) in missing_levels {
+            let start = Instant::now();
+            let component = Component::from_binary(&engine, &bytes).map_err(|e| {
+                CompilationError::CompileFailure(format!(
+                    "Failed to compile component {:?} ({:?}): {}",
+                    component_with_version, feature_level, e
+                ))
+            })?;
+            let end = Instant::now();
+
+            let compilation_time = end.duration_since(start);
 
-        let compilation_time = end.duration_since(start);
+            record_compilation_time(compilation_time);
 
-        record_compilation_time(compilation_time);
+            tracing::debug!(
+                "Compiled {component_with_version:?} ({feature_level:?}) in {}ms",
+                compilation_time.as_millis(),
+            );
 
-        tracing::debug!(
-            "Compiled {component_with_version:?} in {}ms",
-            compilation_time.as_millis(),
-        );
+            components.push((feature_level, component));
+        }
 
-        Ok(component)
+        Ok(components)
     }
 }
 
@@ -47,6 +47,7 @@ impl UploadWorker {
     async fn upload_component(&self, compiled_component: CompiledComponent) {
         let CompiledComponent {
             component_and_version,
+            feature_level,
             component,
         } = compiled_component;
 
@@ -55,15 +56,16 @@ impl UploadWorker {
             .put(
                 &component_and_version.id,
                 component_and_version.version,
+                feature_level,
                 &component,
             )
             .await
             .map_err(|err| CompilationError::ComponentUploadFailed(err.to_string()));
 
         if let Err(ref err) = upload_result {
-            tracing::warn!("Failed to upload compiled component {component_and_version}: {err:?}");
+            tracing::warn!("Failed to upload compiled component {component_and_version} ({feature_level:?}): {err:?}");
         } else {
-            tracing::info!("Successfully uploaded compiled component {component_and_version}");
+            tracing::info!("Successfully uploaded compiled component {component_and_version} ({feature_level:?})");
         }
     }
 }
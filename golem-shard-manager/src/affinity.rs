@@ -0,0 +1,129 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::collections::HashMap;
+
+use golem_common::model::ShardId;
+
+/// Weighted, undirected graph of the worker to worker RPC traffic between shards, built from
+/// the call counts reported by the worker executors.
+///
+/// Weights are decayed periodically so the graph follows changes of the traffic pattern, and
+/// edges whose weight drops below [`AffinityGraph::MIN_WEIGHT`] are forgotten.
+#[derive(Clone, Debug, Default)]
+pub struct AffinityGraph {
+    edges: HashMap<ShardId, HashMap<ShardId, f64>>,
+}
+
+impl AffinityGraph {
+    const MIN_WEIGHT: f64 = 1.0;
+
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.edges.is_empty()
+    }
+
+    /// Adds `calls` observed calls between the workers of two shards. Calls within a single
+    /// shard are ignored as they never cross nodes.
+    pub fn record(&mut self, caller: ShardId, callee: ShardId, calls: u64) {
+        if caller == callee || calls == 0 {
+            return;
+        }
+        *self
+            .edges
+            .entry(caller)
+            .or_default()
+            .entry(callee)
+            .or_default() += calls as f64;
+        *self
+            .edges
+            .entry(callee)
+            .or_default()
+            .entry(caller)
+            .or_default() += calls as f64;
+    }
+
+    /// Multiplies all weights by `factor`, dropping the edges becoming negligible
+    pub fn decay(&mut self, factor: f64) {
+        for neighbours in self.edges.values_mut() {
+            for weight in neighbours.values_mut() {
+                *weight *= factor;
+            }
+            neighbours.retain(|_, weight| *weight >= Self::MIN_WEIGHT);
+        }
+        self.edges.retain(|_, neighbours| !neighbours.is_empty());
+    }
+
+    pub fn neighbours(&self, shard_id: &ShardId) -> impl Iterator<Item = (&ShardId, f64)> {
+        self.edges
+            .get(shard_id)
+            .into_iter()
+            .flat_map(|neighbours| neighbours.iter().map(|(id, weight)| (id, *weight)))
+    }
+
+    /// All edges, each listed once, in decreasing order of weight
+    pub fn edges_by_weight(&self) -> Vec<(ShardId, ShardId, f64)> {
+        let mut edges = self
+            .edges
+            .iter()
+            .flat_map(|(a, neighbours)| {
+                neighbours
+                    .iter()
+                    .filter(move |(b, _)| a < *b)
+                    .map(move |(b, weight)| (*a, *b, *weight))
+            })
+            .collect::<Vec<_>>();
+        edges.sort_by(|(a1, b1, w1), (a2, b2, w2)| {
+            w2.total_cmp(w1).then(a1.cmp(a2)).then(b1.cmp(b2))
+        });
+        edges
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use golem_common::model::ShardId;
+
+    use crate::affinity::AffinityGraph;
+
+    #[test]
+    fn edges_are_undirected_and_decay() {
+        let mut graph = AffinityGraph::new();
+        graph.record(ShardId::new(1), ShardId::new(2), 10);
+        graph.record(ShardId::new(2), ShardId::new(1), 30);
+        graph.record(ShardId::new(3), ShardId::new(1), 1);
+        graph.record(ShardId::new(3), ShardId::new(3), 100);
+
+        assert_eq!(
+            graph.edges_by_weight(),
+            vec![
+                (ShardId::new(1), ShardId::new(2), 40.0),
+                (ShardId::new(1), ShardId::new(3), 1.0)
+            ]
+        );
+
+        graph.decay(0.5);
+        assert_eq!(
+            graph.edges_by_weight(),
+            vec![(ShardId::new(1), ShardId::new(2), 20.0)]
+        );
+        assert_eq!(graph.neighbours(&ShardId::new(3)).count(), 0);
+
+        graph.decay(0.01);
+        assert!(graph.is_empty());
+    }
+}
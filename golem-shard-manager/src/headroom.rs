@@ -0,0 +1,85 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::collections::{HashMap, HashSet};
+
+use crate::model::Pod;
+
+/// The worker memory of the pods and the memory requirement of their active workers, as last
+/// reported by the worker executors.
+///
+/// A pod whose free worker memory drops below [`MemoryHeadroom::MIN_HEADROOM_RATIO`] of its
+/// worker memory is considered exhausted, and is not assigned more shards while others can take
+/// them.
+#[derive(Clone, Debug, Default)]
+pub struct MemoryHeadroom {
+    pods: HashMap<Pod, (u64, u64)>,
+}
+
+impl MemoryHeadroom {
+    const MIN_HEADROOM_RATIO: f64 = 0.1;
+
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Records the latest report of a pod, replacing the previous one
+    pub fn record(&mut self, pod: Pod, worker_memory: u64, used_memory: u64) {
+        self.pods.insert(pod, (worker_memory, used_memory));
+    }
+
+    pub fn remove(&mut self, pod: &Pod) {
+        self.pods.remove(pod);
+    }
+
+    /// The pods without enough free worker memory to take more shards
+    pub fn exhausted_pods(&self) -> HashSet<Pod> {
+        self.pods
+            .iter()
+            .filter(|(_, (worker_memory, used_memory))| {
+                let headroom = worker_memory.saturating_sub(*used_memory);
+                (headroom as f64) < (*worker_memory as f64) * Self::MIN_HEADROOM_RATIO
+            })
+            .map(|(pod, _)| pod.clone())
+            .collect()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::HashSet;
+
+    use crate::headroom::MemoryHeadroom;
+    use crate::model::Pod;
+
+    #[test]
+    fn pods_without_headroom_are_exhausted() {
+        let pod1 = Pod::new("pod1".to_string(), 9000);
+        let pod2 = Pod::new("pod2".to_string(), 9000);
+        let pod3 = Pod::new("pod3".to_string(), 9000);
+
+        let mut headroom = MemoryHeadroom::new();
+        headroom.record(pod1.clone(), 1000, 950);
+        headroom.record(pod2.clone(), 1000, 500);
+        headroom.record(pod3.clone(), 1000, 1200);
+        assert_eq!(
+            headroom.exhausted_pods(),
+            HashSet::from([pod1.clone(), pod3.clone()])
+        );
+
+        headroom.record(pod1.clone(), 1000, 100);
+        headroom.remove(&pod3);
+        assert!(headroom.exhausted_pods().is_empty());
+    }
+}
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+mod affinity;
 mod error;
+mod headroom;
 mod healthcheck;
 mod http_server;
 mod model;
@@ -65,6 +67,7 @@ impl ShardManagerServiceImpl {
             worker_executor_service,
             health_check.clone(),
             shard_manager_config.rebalance_threshold,
+            shard_manager_config.rebalance_strategy.clone(),
         )
         .await?;
 
@@ -97,6 +100,41 @@ impl ShardManagerServiceImpl {
         Ok(())
     }
 
+    async fn report_rpc_affinity_internal(
+        &self,
+        request: golem::shardmanager::ReportRpcAffinityRequest,
+    ) -> Result<(), ShardManagerError> {
+        let edges = request
+            .edges
+            .into_iter()
+            .map(|edge| match (edge.caller, edge.callee) {
+                (Some(caller), Some(callee)) => Ok((caller.into(), callee.into(), edge.calls)),
+                _ => Err(ShardManagerError::invalid_request(
+                    "missing shard id in RPC affinity edge",
+                )),
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+        debug!("Shard Manager received {} RPC affinity edges", edges.len());
+        self.shard_management.record_rpc_affinity(edges).await;
+        Ok(())
+    }
+
+    async fn report_memory_headroom_internal(
+        &self,
+        request: tonic::Request<golem::shardmanager::ReportMemoryHeadroomRequest>,
+    ) -> Result<(), ShardManagerError> {
+        let pod = Pod::from_memory_headroom_request(&request)?;
+        let request = request.into_inner();
+        debug!(
+            "Shard Manager received memory headroom of pod {}: {} of {} bytes used",
+            pod, request.used_memory, request.worker_memory
+        );
+        self.shard_management
+            .record_memory_headroom(pod, request.worker_memory, request.used_memory)
+            .await;
+        Ok(())
+    }
+
     fn start_health_check(&self) {
         let delay = self.shard_manager_config.health_check.delay;
         let shard_management = self.shard_management.clone();
@@ -170,6 +208,63 @@ impl ShardManagerService for ShardManagerServiceImpl {
             })),
         }
     }
+
+    async fn report_rpc_affinity(
+        &self,
+        request: tonic::Request<golem::shardmanager::ReportRpcAffinityRequest>,
+    ) -> Result<tonic::Response<golem::shardmanager::ReportRpcAffinityResponse>, tonic::Status>
+    {
+        match self
+            .report_rpc_affinity_internal(request.into_inner())
+            .await
+        {
+            Ok(_) => Ok(Response::new(
+                golem::shardmanager::ReportRpcAffinityResponse {
+                    result: Some(
+                        golem::shardmanager::report_rpc_affinity_response::Result::Success(
+                            golem::common::Empty {},
+                        ),
+                    ),
+                },
+            )),
+            Err(error) => Ok(Response::new(
+                golem::shardmanager::ReportRpcAffinityResponse {
+                    result: Some(
+                        golem::shardmanager::report_rpc_affinity_response::Result::Failure(
+                            error.into(),
+                        ),
+                    ),
+                },
+            )),
+        }
+    }
+
+    async fn report_memory_headroom(
+        &self,
+        request: tonic::Request<golem::shardmanager::ReportMemoryHeadroomRequest>,
+    ) -> Result<tonic::Response<golem::shardmanager::ReportMemoryHeadroomResponse>, tonic::Status>
+    {
+        match self.report_memory_headroom_internal(request).await {
+            Ok(_) => Ok(Response::new(
+                golem::shardmanager::ReportMemoryHeadroomResponse {
+                    result: Some(
+                        golem::shardmanager::report_memory_headroom_response::Result::Success(
+                            golem::common::Empty {},
+                        ),
+                    ),
+                },
+            )),
+            Err(error) => Ok(Response::new(
+                golem::shardmanager::ReportMemoryHeadroomResponse {
+                    result: Some(
+                        golem::shardmanager::report_memory_headroom_response::Result::Failure(
+                            error.into(),
+                        ),
+                    ),
+                },
+            )),
+        }
+    }
 }
 
 pub fn server_main() -> Result<(), Box<dyn std::error::Error>> {
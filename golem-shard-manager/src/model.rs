@@ -64,17 +64,44 @@ impl Pod {
     pub fn from_register_request(
         request: tonic::Request<golem::shardmanager::RegisterRequest>,
     ) -> Result<Self, ShardManagerError> {
-        let source_ip = request
+        let source_ip = Self::source_ip(&request)?;
+        let request = request.into_inner();
+        Self::from_source(source_ip, request.host, request.port, request.pod_name)
+    }
+
+    /// Identifies the reporting pod the same way as it was identified at registration
+    pub fn from_memory_headroom_request(
+        request: &tonic::Request<golem::shardmanager::ReportMemoryHeadroomRequest>,
+    ) -> Result<Self, ShardManagerError> {
+        let source_ip = Self::source_ip(request)?;
+        let request = request.get_ref();
+        Self::from_source(
+            source_ip,
+            request.host.clone(),
+            request.port,
+            request.pod_name.clone(),
+        )
+    }
+
+    fn source_ip<T>(request: &tonic::Request<T>) -> Result<IpAddr, ShardManagerError> {
+        Ok(request
             .remote_addr()
             .ok_or(ShardManagerError::invalid_request(
                 "could not get source IP",
             ))?
-            .ip();
-        let request = request.into_inner();
+            .ip())
+    }
+
+    fn from_source(
+        source_ip: IpAddr,
+        host: String,
+        port: i32,
+        pod_name: Option<String>,
+    ) -> Result<Self, ShardManagerError> {
         let pod = Pod {
-            host: request.host,
-            port: request.port as u16,
-            pod_name: request.pod_name,
+            host,
+            port: port as u16,
+            pod_name,
             ip: source_ip,
         };
 
@@ -1,7 +1,8 @@
-use crate::model::{Assignments, Pod, RoutingTable, Unassignments};
+use crate::affinity::AffinityGraph;
+use crate::model::{Assignments, Pod, RoutingTable, RoutingTableEntry, Unassignments};
 use golem_common::model::ShardId;
 use serde::{Deserialize, Serialize};
-use std::collections::{BTreeSet, HashSet};
+use std::collections::{BTreeSet, HashMap, HashSet};
 use std::fmt;
 use std::fmt::{Display, Formatter};
 use tracing::trace;
@@ -30,28 +31,91 @@ impl Rebalance {
     /// and a threshold of 10%, pods with shard count between 90 and 110 will be considered
     /// balanced.
     pub fn from_routing_table(routing_table: &RoutingTable, threshold: f64) -> Self {
+        Self::balance(routing_table, threshold, &HashSet::new()).0
+    }
+
+    /// Constructs a rebalance plan like [`Rebalance::from_routing_table`], but does not assign
+    /// more shards to the `exhausted_pods` running out of worker memory. Unassigned shards still
+    /// go to them if all the pods are exhausted.
+    pub fn from_routing_table_avoiding(
+        routing_table: &RoutingTable,
+        threshold: f64,
+        exhausted_pods: &HashSet<Pod>,
+    ) -> Self {
+        Self::balance(routing_table, threshold, exhausted_pods).0
+    }
+
+    /// Constructs a rebalance plan like [`Rebalance::from_routing_table_avoiding`], then moves at
+    /// most `max_moves` additional shards to the pods hosting the shards they exchange the most
+    /// RPC calls with, according to `affinity`.
+    ///
+    /// Affinity moves are only made within the slack allowed by `threshold`, so they never make
+    /// a pod unbalanced, and shards already moved by the balancing step are left alone.
+    pub fn from_routing_table_with_affinity(
+        routing_table: &RoutingTable,
+        threshold: f64,
+        affinity: &AffinityGraph,
+        max_moves: usize,
+        exhausted_pods: &HashSet<Pod>,
+    ) -> Self {
+        let (mut rebalance, mut routing_table_entries) =
+            Self::balance(routing_table, threshold, exhausted_pods);
+        if routing_table_entries.len() > 1 && !affinity.is_empty() {
+            let (lower_threshold, upper_threshold) = Self::thresholds(routing_table, threshold);
+            rebalance.improve_affinity(
+                &mut routing_table_entries,
+                affinity,
+                lower_threshold,
+                upper_threshold,
+                max_moves,
+                exhausted_pods,
+            );
+        }
+        rebalance
+    }
+
+    /// Lower and upper bounds of the number of shards of a balanced pod
+    fn thresholds(routing_table: &RoutingTable, threshold: f64) -> (usize, usize) {
+        let optimal_count = routing_table.number_of_shards / routing_table.get_pod_count();
+        let upper_threshold = (optimal_count as f64 * (1.0 + threshold)).ceil() as usize;
+        let lower_threshold = (optimal_count as f64 * (1.0 - threshold)).floor() as usize;
+        (lower_threshold, upper_threshold)
+    }
+
+    /// Computes the balancing plan, also returning the routing table entries as they will be
+    /// after applying it
+    fn balance(
+        routing_table: &RoutingTable,
+        threshold: f64,
+        exhausted_pods: &HashSet<Pod>,
+    ) -> (Self, Vec<RoutingTableEntry>) {
         let mut assignments = Assignments::new();
         let mut unassignments = Unassignments::new();
         let pod_count = routing_table.get_pod_count();
         if pod_count == 0 {
-            return Rebalance {
-                assignments,
-                unassignments,
-            };
+            return (
+                Rebalance {
+                    assignments,
+                    unassignments,
+                },
+                Vec::new(),
+            );
         }
 
         let mut routing_table_entries = routing_table.get_entries_vec();
 
         let mut empty_pods = BTreeSet::new();
         for (idx, entry) in routing_table_entries.iter().enumerate() {
-            if entry.shard_ids.is_empty() {
+            if entry.shard_ids.is_empty() && !exhausted_pods.contains(&entry.pod) {
                 empty_pods.insert(idx);
             }
         }
+        let all_exhausted = routing_table_entries
+            .iter()
+            .all(|entry| exhausted_pods.contains(&entry.pod));
         let mut initial_target_pods = empty_pods.iter().copied().collect::<Vec<_>>(); // this will be updated during the unassignment step, while empty_pods is used later in the assignment step
         let optimal_count = routing_table.number_of_shards / pod_count;
-        let upper_threshold = (optimal_count as f64 * (1.0 + threshold)).ceil() as usize;
-        let lower_threshold = (optimal_count as f64 * (1.0 - threshold)).floor() as usize;
+        let (lower_threshold, upper_threshold) = Self::thresholds(routing_table, threshold);
 
         // Distributing unassigned shards evenly first among the new pods, once they reached
         // the optimal per-pod shard count, distribute the rest among all pods
@@ -59,7 +123,11 @@ impl Rebalance {
         let mut idx = 0;
         for unassigned_shard in unassigned_shards {
             if initial_target_pods.is_empty() {
-                // No more initial empty pods, distribute shards among all pods
+                // No more initial empty pods, distribute shards among all pods which are not
+                // exhausted
+                while !all_exhausted && exhausted_pods.contains(&routing_table_entries[idx].pod) {
+                    idx = (idx + 1) % pod_count;
+                }
                 trace!("Assigning shard: {} to {}", unassigned_shard, idx);
                 let routing_table_entry = &mut routing_table_entries[idx];
                 assignments.assign(routing_table_entry.pod.clone(), unassigned_shard);
@@ -91,10 +159,13 @@ impl Rebalance {
         }
 
         if pod_count == 1 {
-            return Rebalance {
-                assignments,
-                unassignments,
-            };
+            return (
+                Rebalance {
+                    assignments,
+                    unassignments,
+                },
+                routing_table_entries,
+            );
         };
 
         // We redistribute shards from each entry having more than the optimal count
@@ -110,7 +181,9 @@ impl Rebalance {
                 );
             }
 
-            if routing_table_entries[target_idx].shard_ids.len() < lower_threshold {
+            if routing_table_entries[target_idx].shard_ids.len() < lower_threshold
+                && !exhausted_pods.contains(&routing_table_entries[target_idx].pod)
+            {
                 trace!("Found a pod with too few shards: {}", target_idx);
 
                 loop {
@@ -163,9 +236,105 @@ impl Rebalance {
             }
         }
 
-        Rebalance {
-            assignments,
-            unassignments,
+        (
+            Rebalance {
+                assignments,
+                unassignments,
+            },
+            routing_table_entries,
+        )
+    }
+
+    /// Greedily goes through the affinity edges in decreasing order of weight, and for each edge
+    /// crossing two pods moves one of its shards to the other's pod if that increases the
+    /// weight of the edges kept within a single pod.
+    fn improve_affinity(
+        &mut self,
+        routing_table_entries: &mut [RoutingTableEntry],
+        affinity: &AffinityGraph,
+        lower_threshold: usize,
+        upper_threshold: usize,
+        max_moves: usize,
+        exhausted_pods: &HashSet<Pod>,
+    ) {
+        let mut pod_indices: HashMap<ShardId, usize> = HashMap::new();
+        for (idx, entry) in routing_table_entries.iter().enumerate() {
+            for shard_id in &entry.shard_ids {
+                pod_indices.insert(*shard_id, idx);
+            }
+        }
+        // Every shard is moved at most once per plan
+        let mut moved: HashSet<ShardId> = self
+            .assignments
+            .assignments
+            .values()
+            .flatten()
+            .copied()
+            .collect();
+
+        let gain = |pod_indices: &HashMap<ShardId, usize>,
+                    shard_id: &ShardId,
+                    source_idx: usize,
+                    target_idx: usize| {
+            affinity
+                .neighbours(shard_id)
+                .map(|(neighbour, weight)| match pod_indices.get(neighbour) {
+                    Some(idx) if *idx == target_idx => weight,
+                    Some(idx) if *idx == source_idx => -weight,
+                    _ => 0.0,
+                })
+                .sum::<f64>()
+        };
+
+        let mut moves = 0;
+        for (a, b, _) in affinity.edges_by_weight() {
+            if moves >= max_moves {
+                break;
+            }
+            let (Some(a_idx), Some(b_idx)) =
+                (pod_indices.get(&a).copied(), pod_indices.get(&b).copied())
+            else {
+                continue;
+            };
+            if a_idx == b_idx {
+                continue;
+            }
+
+            let best = [(a, a_idx, b_idx), (b, b_idx, a_idx)]
+                .into_iter()
+                .filter(|(shard_id, source_idx, target_idx)| {
+                    !moved.contains(shard_id)
+                        && routing_table_entries[*source_idx].shard_ids.len() > lower_threshold
+                        && routing_table_entries[*target_idx].shard_ids.len() < upper_threshold
+                        && !exhausted_pods.contains(&routing_table_entries[*target_idx].pod)
+                })
+                .map(|(shard_id, source_idx, target_idx)| {
+                    let gain = gain(&pod_indices, &shard_id, source_idx, target_idx);
+                    (shard_id, source_idx, target_idx, gain)
+                })
+                .filter(|(_, _, _, gain)| *gain > 0.0)
+                .max_by(|(_, _, _, gain1), (_, _, _, gain2)| gain1.total_cmp(gain2));
+
+            if let Some((shard_id, source_idx, target_idx, gain)) = best {
+                trace!(
+                    "Moving shard {} from {} to {} for RPC affinity (gain: {})",
+                    shard_id,
+                    source_idx,
+                    target_idx,
+                    gain
+                );
+                routing_table_entries[source_idx]
+                    .shard_ids
+                    .remove(&shard_id);
+                routing_table_entries[target_idx].shard_ids.insert(shard_id);
+                self.assignments
+                    .assign(routing_table_entries[target_idx].pod.clone(), shard_id);
+                self.unassignments
+                    .unassign(routing_table_entries[source_idx].pod.clone(), shard_id);
+                pod_indices.insert(shard_id, target_idx);
+                moved.insert(shard_id);
+                moves += 1;
+            }
         }
     }
 
@@ -241,9 +410,11 @@ impl Display for Rebalance {
 
 #[cfg(test)]
 mod tests {
+    use crate::affinity::AffinityGraph;
     use crate::model::{Pod, RoutingTable};
     use crate::rebalancing::Rebalance;
     use golem_common::model::ShardId;
+    use std::collections::HashSet;
     use tracing_test::traced_test;
 
     fn assign_shard(routing_table: &mut RoutingTable, pod: &Pod, shard_id: i64) {
@@ -669,4 +840,97 @@ mod tests {
             vec![ShardId::new(0), ShardId::new(1), ShardId::new(6)]
         );
     }
+
+    #[test]
+    #[traced_test]
+    fn affinity_moves_shards_within_threshold() {
+        let pod1 = Pod::new("pod1".to_string(), 9000);
+        let pod2 = Pod::new("pod2".to_string(), 9001);
+
+        let mut routing_table = RoutingTable::new(8);
+        routing_table.add_pod(&pod1);
+        routing_table.add_pod(&pod2);
+        for shard_id in 0..4 {
+            assign_shard(&mut routing_table, &pod1, shard_id);
+            assign_shard(&mut routing_table, &pod2, shard_id + 4);
+        }
+
+        let mut affinity = AffinityGraph::new();
+        affinity.record(ShardId::new(1), ShardId::new(5), 100);
+        affinity.record(ShardId::new(5), ShardId::new(6), 10);
+        affinity.record(ShardId::new(2), ShardId::new(6), 5);
+
+        // No slack for affinity moves
+        let rebalance = Rebalance::from_routing_table_with_affinity(
+            &routing_table,
+            0.0,
+            &affinity,
+            16,
+            &HashSet::new(),
+        );
+        assert!(rebalance.is_empty());
+
+        // Shard 1 follows shard 5, then pod1 has no shard to spare and moving 6 away from 5 does
+        // not pay off
+        let rebalance = Rebalance::from_routing_table_with_affinity(
+            &routing_table,
+            0.25,
+            &affinity,
+            16,
+            &HashSet::new(),
+        );
+        assert_eq!(get_assigned_ids(&rebalance, &pod1), vec![]);
+        assert_eq!(get_assigned_ids(&rebalance, &pod2), vec![ShardId::new(1)]);
+        assert_eq!(get_unassigned_ids(&rebalance, &pod1), vec![ShardId::new(1)]);
+        assert_eq!(get_unassigned_ids(&rebalance, &pod2), vec![]);
+
+        let rebalance = Rebalance::from_routing_table_with_affinity(
+            &routing_table,
+            0.25,
+            &affinity,
+            0,
+            &HashSet::new(),
+        );
+        assert!(rebalance.is_empty());
+    }
+
+    #[test]
+    #[traced_test]
+    fn exhausted_pods_get_no_more_shards() {
+        let pod1 = Pod::new("pod1".to_string(), 9000);
+        let pod2 = Pod::new("pod2".to_string(), 9001);
+
+        let mut routing_table = RoutingTable::new(4);
+        routing_table.add_pod(&pod1);
+        routing_table.add_pod(&pod2);
+        assign_shard(&mut routing_table, &pod1, 0);
+        assign_shard(&mut routing_table, &pod2, 1);
+
+        let rebalance = Rebalance::from_routing_table(&routing_table, 0.0);
+        assert_eq!(get_assigned_ids(&rebalance, &pod1).len(), 1);
+        assert_eq!(get_assigned_ids(&rebalance, &pod2).len(), 1);
+
+        let rebalance = Rebalance::from_routing_table_avoiding(
+            &routing_table,
+            0.0,
+            &HashSet::from([pod2.clone()]),
+        );
+        assert_eq!(
+            get_assigned_ids(&rebalance, &pod1),
+            vec![ShardId::new(2), ShardId::new(3)]
+        );
+        assert_eq!(get_assigned_ids(&rebalance, &pod2), vec![]);
+        assert_eq!(get_unassigned_ids(&rebalance, &pod1), vec![]);
+
+        // The unassigned shards must go somewhere even if every pod is exhausted
+        let rebalance = Rebalance::from_routing_table_avoiding(
+            &routing_table,
+            0.0,
+            &HashSet::from([pod1.clone(), pod2.clone()]),
+        );
+        assert_eq!(
+            get_assigned_ids(&rebalance, &pod1).len() + get_assigned_ids(&rebalance, &pod2).len(),
+            2
+        );
+    }
 }
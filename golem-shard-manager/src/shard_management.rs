@@ -1,10 +1,14 @@
+use crate::affinity::AffinityGraph;
 use crate::error::ShardManagerError;
+use crate::headroom::MemoryHeadroom;
 use crate::healthcheck::{get_unhealthy_pods, HealthCheck};
 use crate::model::{Pod, RoutingTable};
 use crate::persistence::PersistenceService;
 use crate::rebalancing::Rebalance;
+use crate::shard_manager_config::{AffinityAwareRebalanceConfig, RebalanceStrategy};
 use crate::worker_executor::{assign_shards, revoke_shards, WorkerExecutorService};
 use async_rwlock::RwLock;
+use golem_common::model::ShardId;
 use std::collections::HashSet;
 use std::ops::Deref;
 use std::sync::Arc;
@@ -18,7 +22,13 @@ pub struct ShardManagement {
     change: Arc<Notify>,
     #[allow(dead_code)]
     worker_handle: Arc<WorkerHandle>, // Just kept here for abort on dropping
+    #[allow(dead_code)]
+    affinity_handle: Option<Arc<WorkerHandle>>, // Just kept here for abort on dropping
     updates: Arc<Mutex<ShardManagementChanges>>,
+    /// Observed RPC traffic between shards, only collected by the affinity-aware strategy
+    affinity: Option<Arc<Mutex<AffinityGraph>>>,
+    /// Memory headroom of the pods, used to avoid assigning shards to pods running out of memory
+    headroom: Arc<Mutex<MemoryHeadroom>>,
 }
 
 impl ShardManagement {
@@ -29,6 +39,7 @@ impl ShardManagement {
         worker_executors: Arc<dyn WorkerExecutorService + Send + Sync>,
         health_check: Arc<dyn HealthCheck + Send + Sync>,
         threshold: f64,
+        rebalance_strategy: RebalanceStrategy,
     ) -> Result<Self, ShardManagerError> {
         let (routing_table, mut pending_rebalance) = persistence_service.read().await.unwrap();
         let routing_table = Arc::new(RwLock::new(routing_table));
@@ -60,10 +71,23 @@ impl ShardManagement {
 
         let change = Arc::new(Notify::new());
         let updates = Arc::new(Mutex::new(ShardManagementChanges::new()));
+        let headroom = Arc::new(Mutex::new(MemoryHeadroom::new()));
+
+        let (affinity_config, affinity) = match rebalance_strategy {
+            RebalanceStrategy::Balanced(_) => (None, None),
+            RebalanceStrategy::AffinityAware(config) => (
+                Some(config),
+                Some(Arc::new(Mutex::new(AffinityGraph::new()))),
+            ),
+        };
 
         let routing_table_clone = routing_table.clone();
         let notify_clone = change.clone();
         let updates_clone = updates.clone();
+        let headroom_clone = headroom.clone();
+        let affinity_clone = affinity
+            .clone()
+            .zip(affinity_config.as_ref().map(|config| config.max_moves));
 
         let worker_handle = Arc::new(WorkerHandle::new(tokio::spawn(async move {
             Self::worker(
@@ -73,18 +97,51 @@ impl ShardManagement {
                 persistence_service,
                 worker_executors,
                 threshold,
+                affinity_clone,
+                headroom_clone,
             )
             .await
         })));
 
+        let affinity_handle = affinity_config
+            .zip(affinity.clone())
+            .map(|(config, affinity)| {
+                let change = change.clone();
+                Arc::new(WorkerHandle::new(tokio::spawn(async move {
+                    Self::affinity_ticker(config, affinity, change).await
+                })))
+            });
+
         Ok(ShardManagement {
             routing_table,
             change,
             worker_handle,
+            affinity_handle,
             updates,
+            affinity,
+            headroom,
         })
     }
 
+    /// Records the RPC calls between shards observed by a worker executor. Ignored unless the
+    /// affinity-aware rebalance strategy is used.
+    pub async fn record_rpc_affinity(&self, edges: Vec<(ShardId, ShardId, u64)>) {
+        if let Some(affinity) = &self.affinity {
+            let mut affinity = affinity.lock().await;
+            for (caller, callee, calls) in edges {
+                affinity.record(caller, callee, calls);
+            }
+        }
+    }
+
+    /// Records the worker memory and its estimated use reported by a worker executor
+    pub async fn record_memory_headroom(&self, pod: Pod, worker_memory: u64, used_memory: u64) {
+        self.headroom
+            .lock()
+            .await
+            .record(pod, worker_memory, used_memory);
+    }
+
     /// Registers a new pod to be added
     pub async fn register_pod(&self, pod: Pod) {
         debug!("Registering pod: {pod}");
@@ -95,6 +152,7 @@ impl ShardManagement {
     /// Marks a pod to be removed
     pub async fn unregister_pod(&self, pod: Pod) {
         debug!("Unregistering pod: {pod}");
+        self.headroom.lock().await.remove(&pod);
         self.updates.lock().await.remove_pod(pod);
         self.change.notify_one();
     }
@@ -111,6 +169,8 @@ impl ShardManagement {
         persistence_service: Arc<dyn PersistenceService + Send + Sync>,
         worker_executors: Arc<dyn WorkerExecutorService + Send + Sync>,
         threshold: f64,
+        affinity: Option<(Arc<Mutex<AffinityGraph>>, usize)>,
+        headroom: Arc<Mutex<MemoryHeadroom>>,
     ) {
         loop {
             debug!("Shard management loop awaiting changes");
@@ -118,6 +178,7 @@ impl ShardManagement {
 
             let (new_pods, removed_pods) = updates.lock().await.reset();
             debug!("Shard management loop woken up by change; new pods: {new_pods:?}, removed pods: {removed_pods:?}");
+            let pods_changed = !new_pods.is_empty() || !removed_pods.is_empty();
 
             // Getting a write lock while the rebalance plan is calculated and got persisted (but NOT applied)
             let mut current_routing_table = routing_table.write().await;
@@ -140,7 +201,26 @@ impl ShardManagement {
                     info!("Registered new worker executor: {pod}")
                 }
             }
-            let mut rebalance = Rebalance::from_routing_table(&current_routing_table, threshold);
+            let exhausted_pods = headroom.lock().await.exhausted_pods();
+            let mut rebalance = match &affinity {
+                Some((affinity, max_moves)) => Rebalance::from_routing_table_with_affinity(
+                    &current_routing_table,
+                    threshold,
+                    affinity.lock().await.deref(),
+                    *max_moves,
+                    &exhausted_pods,
+                ),
+                None => Rebalance::from_routing_table_avoiding(
+                    &current_routing_table,
+                    threshold,
+                    &exhausted_pods,
+                ),
+            };
+
+            if !pods_changed && rebalance.is_empty() {
+                debug!("Nothing to rebalance");
+                continue;
+            }
 
             for pod in send_full_assignment {
                 let assignments = current_routing_table.get_shards(&pod).unwrap_or_default();
@@ -170,6 +250,23 @@ impl ShardManagement {
         }
     }
 
+    /// Periodically wakes up the shard management loop to make affinity driven moves, and
+    /// decays the observed traffic so it follows changes of the call patterns
+    async fn affinity_ticker(
+        config: AffinityAwareRebalanceConfig,
+        affinity: Arc<Mutex<AffinityGraph>>,
+        change: Arc<Notify>,
+    ) {
+        let mut interval = tokio::time::interval(config.interval);
+        interval.tick().await;
+        loop {
+            interval.tick().await;
+            affinity.lock().await.decay(config.decay);
+            debug!("Shard management scheduled affinity driven rebalance");
+            change.notify_one();
+        }
+    }
+
     async fn execute_rebalance(
         worker_executors: Arc<dyn WorkerExecutorService + Send + Sync>,
         rebalance: &mut Rebalance,
@@ -29,6 +29,7 @@ pub struct ShardManagerConfig {
     pub http_port: u16,
     pub number_of_shards: usize,
     pub rebalance_threshold: f64,
+    pub rebalance_strategy: RebalanceStrategy,
 }
 
 impl ShardManagerConfig {
@@ -72,6 +73,28 @@ pub struct HealthCheckK8sConfig {
     pub namespace: String,
 }
 
+#[derive(Clone, Debug, Deserialize)]
+#[serde(tag = "type", content = "config")]
+pub enum RebalanceStrategy {
+    /// Shards are only moved to keep the number of shards per pod balanced
+    Balanced(Empty),
+    /// Additionally moves shards to the pods hosting the shards they exchange the most RPC
+    /// calls with, as reported by the worker executors
+    AffinityAware(AffinityAwareRebalanceConfig),
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct AffinityAwareRebalanceConfig {
+    /// Time between two affinity driven rebalances
+    #[serde(with = "humantime_serde")]
+    pub interval: Duration,
+    /// Maximum number of shards moved by a single affinity driven rebalance
+    pub max_moves: usize,
+    /// Factor the observed call counts are multiplied by at each interval, so older traffic
+    /// counts less
+    pub decay: f64,
+}
+
 #[cfg(test)]
 mod tests {
     #[test]
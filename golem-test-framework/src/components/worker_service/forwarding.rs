@@ -22,6 +22,7 @@ use golem_api_grpc::proto::golem::common::{Empty, ResourceLimits};
 use golem_api_grpc::proto::golem::worker::{
     ConnectWorkerRequest, DeleteWorkerRequest, DeleteWorkerResponse, GetWorkerMetadataRequest,
     GetWorkerMetadataResponse, InterruptWorkerRequest, InterruptWorkerResponse,
+    InvokeAndAwaitBatchRequest, InvokeAndAwaitBatchResponse, InvokeAndAwaitBatchSuccessResponse,
     InvokeAndAwaitRequest, InvokeAndAwaitResponse, InvokeRequest, InvokeResponse, InvokeResult,
     LaunchNewWorkerRequest, LaunchNewWorkerResponse, LaunchNewWorkerSuccessResponse, LogEvent,
     ResumeWorkerRequest, ResumeWorkerResponse, UpdateWorkerRequest, UpdateWorkerResponse,
@@ -297,6 +298,74 @@ impl WorkerService for ForwardingWorkerService {
         }
     }
 
+    async fn invoke_and_await_batch(
+        &self,
+        request: InvokeAndAwaitBatchRequest,
+    ) -> InvokeAndAwaitBatchResponse {
+        let result = self
+            .worker_executor
+            .client()
+            .await
+            .invoke_and_await_worker_batch(workerexecutor::InvokeAndAwaitWorkerBatchRequest {
+                worker_id: request.worker_id,
+                invocations: request
+                    .invocations
+                    .into_iter()
+                    .map(|invocation| workerexecutor::BatchedInvocation {
+                        name: invocation.function,
+                        input: invocation
+                            .invoke_parameters
+                            .map(|p| p.params)
+                            .unwrap_or_default(),
+                        idempotency_key: invocation.idempotency_key,
+                        calling_convention: invocation.calling_convention,
+                    })
+                    .collect(),
+                account_id: Some(
+                    AccountId {
+                        value: "test-account".to_string(),
+                    }
+                    .into(),
+                ),
+                account_limits: Some(ResourceLimits {
+                    available_fuel: i64::MAX,
+                    max_memory_per_worker: i64::MAX,
+                }),
+                context: request.context,
+            })
+            .await
+            .expect("Failed to call golem-worker-executor")
+            .into_inner();
+
+        match result.result {
+            None => panic!("No response from golem-worker-executor invoke batch call"),
+            Some(workerexecutor::invoke_and_await_worker_batch_response::Result::Success(
+                result,
+            )) => InvokeAndAwaitBatchResponse {
+                result: Some(worker::invoke_and_await_batch_response::Result::Success(
+                    InvokeAndAwaitBatchSuccessResponse {
+                        results: result
+                            .results
+                            .into_iter()
+                            .map(|result| InvokeResult {
+                                result: result.output,
+                            })
+                            .collect(),
+                    },
+                )),
+            },
+            Some(workerexecutor::invoke_and_await_worker_batch_response::Result::Failure(
+                error,
+            )) => InvokeAndAwaitBatchResponse {
+                result: Some(worker::invoke_and_await_batch_response::Result::Error(
+                    WorkerError {
+                        error: Some(worker::worker_error::Error::InternalError(error)),
+                    },
+                )),
+            },
+        }
+    }
+
     async fn connect_worker(&self, request: ConnectWorkerRequest) -> Streaming<LogEvent> {
         self.worker_executor
             .client()
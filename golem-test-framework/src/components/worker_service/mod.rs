@@ -25,9 +25,10 @@ use golem_api_grpc::proto::golem::worker::worker_service_client::WorkerServiceCl
 use golem_api_grpc::proto::golem::worker::{
     ConnectWorkerRequest, DeleteWorkerRequest, DeleteWorkerResponse, GetWorkerMetadataRequest,
     GetWorkerMetadataResponse, GetWorkersMetadataRequest, GetWorkersMetadataResponse,
-    InterruptWorkerRequest, InterruptWorkerResponse, InvokeAndAwaitRequest, InvokeAndAwaitResponse,
-    InvokeRequest, InvokeResponse, LaunchNewWorkerRequest, LaunchNewWorkerResponse, LogEvent,
-    ResumeWorkerRequest, ResumeWorkerResponse, UpdateWorkerRequest, UpdateWorkerResponse,
+    InterruptWorkerRequest, InterruptWorkerResponse, InvokeAndAwaitBatchRequest,
+    InvokeAndAwaitBatchResponse, InvokeAndAwaitRequest, InvokeAndAwaitResponse, InvokeRequest,
+    InvokeResponse, LaunchNewWorkerRequest, LaunchNewWorkerResponse, LogEvent, ResumeWorkerRequest,
+    ResumeWorkerResponse, UpdateWorkerRequest, UpdateWorkerResponse,
 };
 
 use crate::components::component_service::ComponentService;
@@ -110,6 +111,18 @@ pub trait WorkerService {
             .into_inner()
     }
 
+    async fn invoke_and_await_batch(
+        &self,
+        request: InvokeAndAwaitBatchRequest,
+    ) -> InvokeAndAwaitBatchResponse {
+        self.client()
+            .await
+            .invoke_and_await_batch(request)
+            .await
+            .expect("Failed to call golem-worker-service")
+            .into_inner()
+    }
+
     async fn connect_worker(&self, request: ConnectWorkerRequest) -> Streaming<LogEvent> {
         self.client()
             .await
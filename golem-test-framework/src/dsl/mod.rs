@@ -21,13 +21,14 @@ use golem_api_grpc::proto::golem::worker::update_record::Update;
 use golem_api_grpc::proto::golem::worker::worker_error::Error;
 use golem_api_grpc::proto::golem::worker::{
     get_worker_metadata_response, get_workers_metadata_response, interrupt_worker_response,
-    invoke_and_await_response, invoke_response, launch_new_worker_response, log_event,
-    resume_worker_response, update_worker_response, worker_execution_error, CallingConvention,
-    ConnectWorkerRequest, DeleteWorkerRequest, GetWorkerMetadataRequest, GetWorkersMetadataRequest,
+    invoke_and_await_batch_response, invoke_and_await_response, invoke_response,
+    launch_new_worker_response, log_event, resume_worker_response, update_worker_response,
+    worker_execution_error, BatchedInvokeParameters, CallingConvention, ConnectWorkerRequest,
+    DeleteWorkerRequest, GetWorkerMetadataRequest, GetWorkersMetadataRequest,
     GetWorkersMetadataSuccessResponse, InterruptWorkerRequest, InterruptWorkerResponse,
-    InvokeAndAwaitRequest, InvokeParameters, InvokeRequest, LaunchNewWorkerRequest, LogEvent,
-    ResumeWorkerRequest, StdErrLog, StdOutLog, UpdateMode, UpdateWorkerRequest,
-    UpdateWorkerResponse, WorkerError, WorkerExecutionError,
+    InvokeAndAwaitBatchRequest, InvokeAndAwaitRequest, InvokeParameters, InvokeRequest,
+    LaunchNewWorkerRequest, LogEvent, ResumeWorkerRequest, StdErrLog, StdOutLog, UpdateMode,
+    UpdateWorkerRequest, UpdateWorkerResponse, WorkerError, WorkerExecutionError,
 };
 use golem_common::model::oplog::{OplogIndex, TimestampedUpdateDescription, UpdateDescription};
 use golem_common::model::regions::DeletedRegions;
@@ -131,6 +132,16 @@ pub trait TestDsl {
         params: Vec<Value>,
         cc: CallingConvention,
     ) -> Result<Vec<Value>, Error>;
+    async fn invoke_and_await_batch(
+        &self,
+        worker_id: &WorkerId,
+        invocations: Vec<(&str, Vec<Value>)>,
+    ) -> Result<Vec<Vec<Value>>, Error>;
+    async fn invoke_and_await_batch_with_keys(
+        &self,
+        worker_id: &WorkerId,
+        invocations: Vec<(IdempotencyKey, &str, Vec<Value>)>,
+    ) -> Result<Vec<Vec<Value>>, Error>;
     async fn capture_output(&self, worker_id: &WorkerId) -> UnboundedReceiver<LogEvent>;
     async fn capture_output_forever(
         &self,
@@ -503,6 +514,71 @@ impl<T: TestDependencies + Send + Sync> TestDsl for T {
         }
     }
 
+    async fn invoke_and_await_batch(
+        &self,
+        worker_id: &WorkerId,
+        invocations: Vec<(&str, Vec<Value>)>,
+    ) -> Result<Vec<Vec<Value>>, Error> {
+        self.invoke_and_await_batch_with_keys(
+            worker_id,
+            invocations
+                .into_iter()
+                .map(|(function_name, params)| (IdempotencyKey::fresh(), function_name, params))
+                .collect(),
+        )
+        .await
+    }
+
+    async fn invoke_and_await_batch_with_keys(
+        &self,
+        worker_id: &WorkerId,
+        invocations: Vec<(IdempotencyKey, &str, Vec<Value>)>,
+    ) -> Result<Vec<Vec<Value>>, Error> {
+        let invocations = invocations
+            .into_iter()
+            .map(
+                |(idempotency_key, function_name, params)| BatchedInvokeParameters {
+                    idempotency_key: Some(idempotency_key.into()),
+                    function: function_name.to_string(),
+                    invoke_parameters: Some(InvokeParameters {
+                        params: params.into_iter().map(|v| v.into()).collect(),
+                    }),
+                    calling_convention: CallingConvention::Component.into(),
+                },
+            )
+            .collect();
+        let invoke_response = self
+            .worker_service()
+            .invoke_and_await_batch(InvokeAndAwaitBatchRequest {
+                worker_id: Some(worker_id.clone().into()),
+                invocations,
+                context: None,
+            })
+            .await;
+
+        match invoke_response.result {
+            None => panic!("No response from invoke_and_await_batch"),
+            Some(invoke_and_await_batch_response::Result::Success(response)) => Ok(response
+                .results
+                .into_iter()
+                .map(|result| {
+                    result
+                        .result
+                        .into_iter()
+                        .map(|v| v.try_into())
+                        .collect::<Result<Vec<Value>, String>>()
+                        .expect("Invocation result had unexpected format")
+                })
+                .collect()),
+            Some(invoke_and_await_batch_response::Result::Error(WorkerError {
+                error: Some(error),
+            })) => Err(error),
+            Some(invoke_and_await_batch_response::Result::Error(_)) => {
+                panic!("Empty error response from invoke_and_await_batch")
+            }
+        }
+    }
+
     async fn capture_output(&self, worker_id: &WorkerId) -> UnboundedReceiver<LogEvent> {
         let (tx, rx) = tokio::sync::mpsc::unbounded_channel();
         let cloned_service = self.worker_service().clone();
@@ -966,6 +1042,9 @@ pub fn to_worker_metadata(
                     _ => None,
                 })
                 .collect(),
+            last_snapshot: None,          // not passed through gRPC
+            key_value_write_behind: None, // not passed through gRPC
+            clock_snapshot_mode: None,    // not passed through gRPC
             invocation_results: HashMap::new(),
             current_idempotency_key: None,
             component_version: metadata.component_version,
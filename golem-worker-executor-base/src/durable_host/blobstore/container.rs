@@ -13,6 +13,7 @@
 // limitations under the License.
 
 use async_trait::async_trait;
+use bytes::Bytes;
 use golem_common::model::oplog::WrappedFunctionType;
 use wasmtime::component::Resource;
 use wasmtime_wasi::WasiView;
@@ -35,7 +36,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         &mut self,
         container: Resource<Container>,
     ) -> anyhow::Result<Result<String, Error>> {
-        record_host_function_call("blobstore::container::container", "name");
+        let _timer = record_host_function_call("blobstore::container::container", "name");
         let name = self
             .as_wasi_view()
             .table()
@@ -48,7 +49,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         &mut self,
         container: Resource<Container>,
     ) -> anyhow::Result<Result<ContainerMetadata, Error>> {
-        record_host_function_call("blobstore::container::container", "info");
+        let _timer = record_host_function_call("blobstore::container::container", "info");
         let info = self
             .as_wasi_view()
             .table()
@@ -67,7 +68,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         start: u64,
         end: u64,
     ) -> anyhow::Result<Result<Resource<IncomingValue>, Error>> {
-        record_host_function_call("blobstore::container::container", "get_data");
+        let _timer = record_host_function_call("blobstore::container::container", "get_data");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -108,7 +109,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         name: ObjectName,
         data: Resource<OutgoingValue>,
     ) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::container::container", "write_data");
+        let _timer = record_host_function_call("blobstore::container::container", "write_data");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -120,7 +121,9 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
             .as_wasi_view()
             .table()
             .get::<OutgoingValueEntry>(&data)
-            .map(|outgoing_value_entry| outgoing_value_entry.body.read().unwrap().clone())?;
+            .map(|outgoing_value_entry| {
+                Bytes::from(outgoing_value_entry.body.read().unwrap().clone())
+            })?;
         let result = Durability::<Ctx, (), SerializableError>::wrap(
             self,
             WrappedFunctionType::WriteRemote,
@@ -145,7 +148,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         &mut self,
         container: Resource<Container>,
     ) -> anyhow::Result<Result<Resource<StreamObjectNames>, Error>> {
-        record_host_function_call("blobstore::container::container", "list_objects");
+        let _timer = record_host_function_call("blobstore::container::container", "list_objects");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -181,7 +184,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         container: Resource<Container>,
         name: ObjectName,
     ) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::container::container", "delete_object");
+        let _timer = record_host_function_call("blobstore::container::container", "delete_object");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -213,7 +216,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         container: Resource<Container>,
         names: Vec<ObjectName>,
     ) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::container::container", "delete_objects");
+        let _timer = record_host_function_call("blobstore::container::container", "delete_objects");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -245,7 +248,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         container: Resource<Container>,
         name: ObjectName,
     ) -> anyhow::Result<Result<bool, Error>> {
-        record_host_function_call("blobstore::container::container", "has_object");
+        let _timer = record_host_function_call("blobstore::container::container", "has_object");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -277,7 +280,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
         container: Resource<Container>,
         name: ObjectName,
     ) -> anyhow::Result<Result<ObjectMetadata, Error>> {
-        record_host_function_call("blobstore::container::container", "object_info");
+        let _timer = record_host_function_call("blobstore::container::container", "object_info");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -317,7 +320,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
     }
 
     async fn clear(&mut self, container: Resource<Container>) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::container::container", "clear");
+        let _timer = record_host_function_call("blobstore::container::container", "clear");
         let account_id = self.state.owned_worker_id.account_id();
 
         let container_name = self
@@ -340,7 +343,7 @@ impl<Ctx: WorkerCtx> HostContainer for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, container: Resource<Container>) -> anyhow::Result<()> {
-        record_host_function_call("blobstore::container::container", "drop");
+        let _timer = record_host_function_call("blobstore::container::container", "drop");
         self.as_wasi_view()
             .table()
             .delete::<ContainerEntry>(container)?;
@@ -355,7 +358,7 @@ impl<Ctx: WorkerCtx> HostStreamObjectNames for DurableWorkerCtx<Ctx> {
         self_: Resource<StreamObjectNames>,
         len: u64,
     ) -> anyhow::Result<Result<(Vec<ObjectName>, bool), Error>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "blobstore::container::stream_object_names",
             "read_stream_object_names",
         );
@@ -381,7 +384,7 @@ impl<Ctx: WorkerCtx> HostStreamObjectNames for DurableWorkerCtx<Ctx> {
         self_: Resource<StreamObjectNames>,
         num: u64,
     ) -> anyhow::Result<Result<(u64, bool), Error>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "blobstore::container::stream_object_names",
             "skip_stream_object_names",
         );
@@ -403,7 +406,7 @@ impl<Ctx: WorkerCtx> HostStreamObjectNames for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<StreamObjectNames>) -> anyhow::Result<()> {
-        record_host_function_call("blobstore::container::stream_object_names", "drop");
+        let _timer = record_host_function_call("blobstore::container::stream_object_names", "drop");
         self.as_wasi_view().table().delete(rep)?;
         Ok(())
     }
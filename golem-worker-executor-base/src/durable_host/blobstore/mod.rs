@@ -35,7 +35,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         &mut self,
         name: ContainerName,
     ) -> anyhow::Result<Result<Resource<Container>, Error>> {
-        record_host_function_call("blobstore::blobstore", "create_container");
+        let _timer = record_host_function_call("blobstore::blobstore", "create_container");
         let account_id = self.state.owned_worker_id.account_id();
         let name_clone = name.clone();
         let result: Result<u64, anyhow::Error> = Durability::<Ctx, u64, SerializableError>::wrap(
@@ -75,7 +75,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         &mut self,
         name: ContainerName,
     ) -> anyhow::Result<Result<Resource<Container>, Error>> {
-        record_host_function_call("blobstore::blobstore", "get_container");
+        let _timer = record_host_function_call("blobstore::blobstore", "get_container");
         let account_id = self.state.owned_worker_id.account_id();
         let result = Durability::<Ctx, Option<u64>, SerializableError>::wrap(
             self,
@@ -102,7 +102,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn delete_container(&mut self, name: ContainerName) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::blobstore", "delete_container");
+        let _timer = record_host_function_call("blobstore::blobstore", "delete_container");
         let account_id = self.state.owned_worker_id.account_id();
         let result = Durability::<Ctx, (), SerializableError>::wrap(
             self,
@@ -125,7 +125,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         &mut self,
         name: ContainerName,
     ) -> anyhow::Result<Result<bool, Error>> {
-        record_host_function_call("blobstore::blobstore", "container_exists");
+        let _timer = record_host_function_call("blobstore::blobstore", "container_exists");
         let account_id = self.state.owned_worker_id.account_id();
         let result = Durability::<Ctx, bool, SerializableError>::wrap(
             self,
@@ -149,7 +149,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         src: ObjectId,
         dest: ObjectId,
     ) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::blobstore", "copy_object");
+        let _timer = record_host_function_call("blobstore::blobstore", "copy_object");
         let account_id = self.state.owned_worker_id.account_id();
         let result = Durability::<Ctx, (), SerializableError>::wrap(
             self,
@@ -177,7 +177,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         src: ObjectId,
         dest: ObjectId,
     ) -> anyhow::Result<Result<(), Error>> {
-        record_host_function_call("blobstore::blobstore", "move_object");
+        let _timer = record_host_function_call("blobstore::blobstore", "move_object");
         let account_id = self.state.owned_worker_id.account_id();
         let result = Durability::<Ctx, (), SerializableError>::wrap(
             self,
@@ -24,7 +24,7 @@ use wasmtime_wasi::bindings::cli::environment::Host;
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn get_environment(&mut self) -> anyhow::Result<Vec<(String, String)>> {
-        record_host_function_call("cli::environment", "get_environment");
+        let _timer = record_host_function_call("cli::environment", "get_environment");
         Durability::<Ctx, Vec<(String, String)>, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -35,7 +35,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn get_arguments(&mut self) -> anyhow::Result<Vec<String>> {
-        record_host_function_call("cli::environment", "get_arguments");
+        let _timer = record_host_function_call("cli::environment", "get_arguments");
         Durability::<Ctx, Vec<String>, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -46,7 +46,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn initial_cwd(&mut self) -> anyhow::Result<Option<String>> {
-        record_host_function_call("cli::environment", "initial_cwd");
+        let _timer = record_host_function_call("cli::environment", "initial_cwd");
         Durability::<Ctx, Option<String>, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -22,7 +22,7 @@ use wasmtime_wasi::bindings::cli::exit::Host;
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn exit(&mut self, status: Result<(), ()>) -> anyhow::Result<()> {
-        record_host_function_call("cli::exit", "exit");
+        let _timer = record_host_function_call("cli::exit", "exit");
         Host::exit(&mut self.as_wasi_view(), status)
     }
 }
@@ -21,7 +21,7 @@ use wasmtime_wasi::bindings::cli::stderr::{Host, OutputStream};
 
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn get_stderr(&mut self) -> anyhow::Result<Resource<OutputStream>> {
-        record_host_function_call("cli::stderr", "get_stderr");
+        let _timer = record_host_function_call("cli::stderr", "get_stderr");
         self.as_wasi_view().get_stderr()
     }
 }
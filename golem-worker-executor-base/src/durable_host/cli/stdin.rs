@@ -21,7 +21,7 @@ use wasmtime_wasi::bindings::cli::stdin::{Host, InputStream};
 
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn get_stdin(&mut self) -> anyhow::Result<Resource<InputStream>> {
-        record_host_function_call("cli::stdin", "get_stdin");
+        let _timer = record_host_function_call("cli::stdin", "get_stdin");
         self.as_wasi_view().get_stdin()
     }
 }
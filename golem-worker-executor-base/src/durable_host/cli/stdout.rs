@@ -21,7 +21,7 @@ use wasmtime_wasi::bindings::cli::stdout::{Host, OutputStream};
 
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn get_stdout(&mut self) -> anyhow::Result<Resource<OutputStream>> {
-        record_host_function_call("cli::stdout", "get_stdout");
+        let _timer = record_host_function_call("cli::stdout", "get_stdout");
         self.as_wasi_view().get_stdout()
     }
 }
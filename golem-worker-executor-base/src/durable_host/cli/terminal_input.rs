@@ -23,7 +23,7 @@ use wasmtime_wasi::bindings::cli::terminal_input::{Host, HostTerminalInput, Term
 #[async_trait]
 impl<Ctx: WorkerCtx> HostTerminalInput for DurableWorkerCtx<Ctx> {
     fn drop(&mut self, rep: Resource<TerminalInput>) -> anyhow::Result<()> {
-        record_host_function_call("cli::terminal_input::terminal_input", "drop");
+        let _timer = record_host_function_call("cli::terminal_input::terminal_input", "drop");
         self.as_wasi_view().drop(rep)
     }
 }
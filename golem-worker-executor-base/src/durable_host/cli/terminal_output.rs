@@ -23,7 +23,7 @@ use wasmtime_wasi::bindings::cli::terminal_output::{Host, HostTerminalOutput, Te
 #[async_trait]
 impl<Ctx: WorkerCtx> HostTerminalOutput for DurableWorkerCtx<Ctx> {
     fn drop(&mut self, rep: Resource<TerminalOutput>) -> anyhow::Result<()> {
-        record_host_function_call("cli::terminal_output::terminal_output", "drop");
+        let _timer = record_host_function_call("cli::terminal_output::terminal_output", "drop");
         HostTerminalOutput::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -23,7 +23,7 @@ use wasmtime_wasi::bindings::cli::terminal_stderr::{Host, TerminalOutput};
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn get_terminal_stderr(&mut self) -> anyhow::Result<Option<Resource<TerminalOutput>>> {
-        record_host_function_call("cli::terminal_stderr", "get_terminal_stderr");
+        let _timer = record_host_function_call("cli::terminal_stderr", "get_terminal_stderr");
         self.as_wasi_view().get_terminal_stderr()
     }
 }
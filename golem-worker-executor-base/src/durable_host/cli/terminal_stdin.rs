@@ -23,7 +23,7 @@ use wasmtime_wasi::bindings::cli::terminal_stdin::{Host, TerminalInput};
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn get_terminal_stdin(&mut self) -> anyhow::Result<Option<Resource<TerminalInput>>> {
-        record_host_function_call("cli::terminal_stdin", "get_terminal_stdin");
+        let _timer = record_host_function_call("cli::terminal_stdin", "get_terminal_stdin");
         self.as_wasi_view().get_terminal_stdin()
     }
 }
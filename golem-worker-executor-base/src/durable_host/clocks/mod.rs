@@ -13,4 +13,5 @@
 // limitations under the License.
 
 pub mod monotonic_clock;
+pub mod snapshot;
 pub mod wall_clock;
@@ -25,7 +25,10 @@ use wasmtime_wasi::bindings::clocks::monotonic_clock::{Duration, Host, Instant,
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn now(&mut self) -> anyhow::Result<Instant> {
-        record_host_function_call("clocks::monotonic_clock", "now");
+        let _timer = record_host_function_call("clocks::monotonic_clock", "now");
+        if self.is_clock_snapshot_enabled().await? {
+            return self.snapshot_monotonic_clock_now().await;
+        }
         Durability::<Ctx, Instant, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -36,7 +39,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn resolution(&mut self) -> anyhow::Result<Instant> {
-        record_host_function_call("clocks::monotonic_clock", "resolution");
+        let _timer = record_host_function_call("clocks::monotonic_clock", "resolution");
         Durability::<Ctx, Instant, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -47,15 +50,28 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn subscribe_instant(&mut self, when: Instant) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("clocks::monotonic_clock", "subscribe_instant");
+        let _timer = record_host_function_call("clocks::monotonic_clock", "subscribe_instant");
+        if self.is_clock_snapshot_enabled().await? {
+            // The instant was computed from the derived readings, which are not comparable to
+            // the real clock, so the remaining duration from the next reading is waited for
+            let now = self.snapshot_monotonic_clock_now().await?;
+            let when = self.snapshot_deadline(when.saturating_sub(now)).await?;
+            self.state.oplog.commit().await;
+            return Host::subscribe_instant(&mut self.as_wasi_view(), when).await;
+        }
         Host::subscribe_instant(&mut self.as_wasi_view(), when).await
     }
 
     async fn subscribe_duration(&mut self, when: Duration) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("clocks::monotonic_clock", "subscribe_duration");
-        let now = self.now().await?;
+        let _timer = record_host_function_call("clocks::monotonic_clock", "subscribe_duration");
+        let when = if self.is_clock_snapshot_enabled().await? {
+            // The deadline is based on the current time, and the readings after the wait have
+            // to include the time spent waiting
+            self.snapshot_deadline(when).await?
+        } else {
+            self.now().await?.saturating_add(when)
+        };
         self.state.oplog.commit().await;
-        let when = now.saturating_add(when);
         Host::subscribe_instant(&mut self.as_wasi_view(), when).await
     }
 }
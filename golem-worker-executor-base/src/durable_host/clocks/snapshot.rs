@@ -0,0 +1,231 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Per-invocation clock snapshots.
+//!
+//! When enabled, the first clock reading of an invocation reads both the wall and the monotonic
+//! clock and records them in the oplog as a single entry. Every further reading of the
+//! invocation is derived from this snapshot by advancing it a nanosecond per reading, so the
+//! readings are deterministic during replay without persisting them one by one, and the
+//! monotonic clock keeps increasing.
+//!
+//! Waiting for a duration or until an instant takes a new snapshot to compute the deadline from,
+//! and discards it after, so the readings following the wait reflect the time spent waiting.
+//! Instants are given in the time of the derived readings, so waiting for one waits for the
+//! duration remaining from the next derived reading.
+//!
+//! When snapshots are used, it is recorded in the oplog by a dedicated entry at the first clock
+//! reading of each worker, and a worker keeps using the recorded mode even if the configuration
+//! changes. Workers without such an entry keep recording every reading.
+
+use bincode::{Decode, Encode};
+use golem_common::model::oplog::{OplogEntry, WrappedFunctionType};
+use wasmtime_wasi::bindings::clocks::{monotonic_clock, wall_clock};
+
+use crate::durable_host::serialized::SerializableError;
+use crate::durable_host::{Durability, DurableWorkerCtx};
+use crate::model::PersistenceLevel;
+use crate::workerctx::WorkerCtx;
+
+/// A durable reading of both clocks
+#[derive(Debug, Clone, PartialEq, Eq, Encode, Decode)]
+pub struct ClockSnapshot {
+    pub wall_seconds: u64,
+    pub wall_nanoseconds: u32,
+    pub monotonic: u64,
+}
+
+/// Clock readings derived from the current snapshot of the invocation
+#[derive(Debug, Default)]
+pub struct SnapshotClock {
+    current: Option<ClockSnapshot>,
+    /// Number of readings derived from the current snapshot
+    readings: u64,
+    /// The last derived monotonic reading, never decreasing across snapshots
+    last_monotonic: Option<u64>,
+}
+
+impl SnapshotClock {
+    /// Starts deriving readings from a new snapshot
+    pub fn set(&mut self, snapshot: ClockSnapshot) {
+        self.current = Some(snapshot);
+        self.readings = 0;
+    }
+
+    /// Discards the current snapshot, so the next reading takes a new one
+    pub fn invalidate(&mut self) {
+        self.current = None;
+    }
+
+    pub fn is_set(&self) -> bool {
+        self.current.is_some()
+    }
+
+    /// The next wall clock (seconds, nanoseconds) and monotonic reading, if there is a snapshot
+    pub fn next(&mut self) -> Option<((u64, u32), u64)> {
+        let snapshot = self.current.as_ref()?;
+        let elapsed = self.readings;
+        self.readings += 1;
+
+        let total_nanos = snapshot.wall_nanoseconds as u64 + elapsed;
+        let wall = (
+            snapshot.wall_seconds + total_nanos / 1_000_000_000,
+            (total_nanos % 1_000_000_000) as u32,
+        );
+        let monotonic = match self.last_monotonic {
+            Some(last) => (snapshot.monotonic + elapsed).max(last + 1),
+            None => snapshot.monotonic + elapsed,
+        };
+        self.last_monotonic = Some(monotonic);
+        Some((wall, monotonic))
+    }
+}
+
+impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
+    /// Whether the clock readings of the worker are derived from snapshots. Using snapshots is
+    /// recorded by an `OplogEntry::ClockSnapshotMode` the first time it is needed. The entry is
+    /// a hint that enables snapshots when it is replayed, so a replaying worker that has not
+    /// read one reads the clocks one by one, like it did before the entry was written. This
+    /// includes every worker created before clock snapshots existed.
+    pub(crate) async fn is_clock_snapshot_enabled(&mut self) -> anyhow::Result<bool> {
+        if let Some(enabled) = self.state.clock_snapshot_enabled {
+            return Ok(enabled);
+        }
+
+        let persist_nothing = self.state.persistence_level == PersistenceLevel::PersistNothing;
+        if self.state.is_replay() && !persist_nothing {
+            // The entry may be among the hints not yet read, if it was recorded before anything
+            // else was replayed
+            self.state.skip_hints().await;
+            if let Some(enabled) = self.state.clock_snapshot_enabled {
+                return Ok(enabled);
+            }
+        }
+
+        let enabled =
+            (self.state.is_live() || persist_nothing) && self.state.config.clock_snapshot.enabled;
+        if enabled && !persist_nothing {
+            self.state
+                .oplog
+                .add(OplogEntry::clock_snapshot_mode())
+                .await;
+        }
+        self.state.clock_snapshot_enabled = Some(enabled);
+        Ok(enabled)
+    }
+
+    /// The next wall clock reading of the invocation, derived from its clock snapshot
+    pub(crate) async fn snapshot_wall_clock_now(&mut self) -> anyhow::Result<wall_clock::Datetime> {
+        let ((seconds, nanoseconds), _) = self.next_snapshot_reading().await?;
+        Ok(wall_clock::Datetime {
+            seconds,
+            nanoseconds,
+        })
+    }
+
+    /// The next monotonic clock reading of the invocation, derived from its clock snapshot
+    pub(crate) async fn snapshot_monotonic_clock_now(
+        &mut self,
+    ) -> anyhow::Result<monotonic_clock::Instant> {
+        let (_, monotonic) = self.next_snapshot_reading().await?;
+        Ok(monotonic)
+    }
+
+    /// Durably reads both clocks and starts deriving the readings from them
+    pub(crate) async fn take_clock_snapshot(&mut self) -> anyhow::Result<()> {
+        let snapshot = Durability::<Ctx, ClockSnapshot, SerializableError>::wrap(
+            self,
+            WrappedFunctionType::ReadLocal,
+            "golem clocks::snapshot",
+            |ctx| {
+                Box::pin(async {
+                    let wall = wall_clock::Host::now(&mut ctx.as_wasi_view()).await?;
+                    let monotonic = monotonic_clock::Host::now(&mut ctx.as_wasi_view()).await?;
+                    Ok::<ClockSnapshot, anyhow::Error>(ClockSnapshot {
+                        wall_seconds: wall.seconds,
+                        wall_nanoseconds: wall.nanoseconds,
+                        monotonic,
+                    })
+                })
+            },
+        )
+        .await?;
+        self.state.clock_snapshot.set(snapshot);
+        Ok(())
+    }
+
+    /// The monotonic deadline of waiting `duration` nanoseconds, computed from a new snapshot,
+    /// which is discarded after, so the readings following the wait include the time waited
+    pub(crate) async fn snapshot_deadline(
+        &mut self,
+        duration: u64,
+    ) -> anyhow::Result<monotonic_clock::Instant> {
+        self.take_clock_snapshot().await?;
+        let now = self.snapshot_monotonic_clock_now().await?;
+        self.state.clock_snapshot.invalidate();
+        Ok(now.saturating_add(duration))
+    }
+
+    async fn next_snapshot_reading(&mut self) -> anyhow::Result<((u64, u32), u64)> {
+        if !self.state.clock_snapshot.is_set() {
+            self.take_clock_snapshot().await?;
+        }
+        Ok(self
+            .state
+            .clock_snapshot
+            .next()
+            .expect("clock snapshot has just been taken"))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::durable_host::clocks::snapshot::{ClockSnapshot, SnapshotClock};
+
+    #[test]
+    fn readings_advance_from_the_snapshot() {
+        let mut clock = SnapshotClock::default();
+        assert_eq!(clock.next(), None);
+
+        clock.set(ClockSnapshot {
+            wall_seconds: 100,
+            wall_nanoseconds: 999_999_999,
+            monotonic: 5000,
+        });
+        assert_eq!(clock.next(), Some(((100, 999_999_999), 5000)));
+        assert_eq!(clock.next(), Some(((101, 0), 5001)));
+
+        clock.invalidate();
+        assert_eq!(clock.next(), None);
+    }
+
+    #[test]
+    fn monotonic_readings_never_decrease_across_snapshots() {
+        let mut clock = SnapshotClock::default();
+        clock.set(ClockSnapshot {
+            wall_seconds: 100,
+            wall_nanoseconds: 0,
+            monotonic: 5000,
+        });
+        clock.next();
+        clock.next();
+
+        clock.set(ClockSnapshot {
+            wall_seconds: 99,
+            wall_nanoseconds: 0,
+            monotonic: 5000,
+        });
+        assert_eq!(clock.next(), Some(((99, 0), 5002)));
+    }
+}
@@ -24,7 +24,10 @@ use wasmtime_wasi::bindings::clocks::wall_clock::{Datetime, Host};
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn now(&mut self) -> anyhow::Result<Datetime> {
-        record_host_function_call("clocks::wall_clock", "now");
+        let _timer = record_host_function_call("clocks::wall_clock", "now");
+        if self.is_clock_snapshot_enabled().await? {
+            return self.snapshot_wall_clock_now().await;
+        }
         Durability::<Ctx, SerializableDateTime, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -35,7 +38,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn resolution(&mut self) -> anyhow::Result<Datetime> {
-        record_host_function_call("clocks::wall_clock", "resolution");
+        let _timer = record_host_function_call("clocks::wall_clock", "resolution");
         Durability::<Ctx, SerializableDateTime, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -1,5 +1,6 @@
 use crate::durable_host::DurableWorkerCtx;
 use crate::error::GolemError;
+use crate::metrics::wasm::{record_durable_function_io, record_durable_function_persist};
 use crate::model::PersistenceLevel;
 use crate::services::oplog::OplogOps;
 use crate::workerctx::WorkerCtx;
@@ -9,6 +10,7 @@ use golem_common::model::oplog::{OplogEntry, OplogIndex, WrappedFunctionType};
 use std::fmt::Debug;
 use std::future::Future;
 use std::pin::Pin;
+use std::time::Instant;
 use tracing::error;
 
 #[async_trait]
@@ -154,7 +156,9 @@ impl<Ctx: WorkerCtx, SerializedSuccess: Sync, SerializedErr: Sync>
             .await?;
         if self.state.is_live() || self.state.persistence_level == PersistenceLevel::PersistNothing
         {
+            let start = Instant::now();
             let result = function(self).await;
+            record_durable_function_io(function_name, start.elapsed());
             let serializable_result: Result<SerializedSuccess, SerializedErr> = result
                 .as_ref()
                 .map_err(|err| err.into())
@@ -245,7 +249,9 @@ impl<Ctx: WorkerCtx, SerializedSuccess: Sync, SerializedErr: Sync>
             .await?;
         if self.state.is_live() || self.state.persistence_level == PersistenceLevel::PersistNothing
         {
+            let start = Instant::now();
             let result = function(self).await;
+            record_durable_function_io(function_name, start.elapsed());
             if persist(&result) {
                 let serializable_result: Result<SerializedSuccess, SerializedErr> = result
                     .as_ref()
@@ -300,6 +306,7 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
         SerializedErr: Encode + Debug + From<GolemError> + Into<Err> + Send + Sync,
     {
         if self.state.persistence_level != PersistenceLevel::PersistNothing {
+            let start = Instant::now();
             self.state
                 .oplog
                 .add_imported_function_invoked(
@@ -321,6 +328,7 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
             if *wrapped_function_type == WrappedFunctionType::WriteRemote {
                 self.state.oplog.commit().await;
             }
+            record_durable_function_persist(function_name, start.elapsed());
         }
         Ok(())
     }
@@ -0,0 +1,428 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Read-only initial file systems of components, shared by all of their workers on a node.
+//!
+//! The image of a component version is the directory `{root}/{component_id}/{version}`,
+//! provisioned on the node. It is copied once per node into a temporary snapshot, whose files
+//! are made read-only, leaving the provisioned image untouched. Every worker of that version
+//! gets the directory tree recreated in its own root with the files of the snapshot
+//! hard-linked, so mounting it reads no file contents and all workers share the same pages of
+//! the page cache. A worker opening one of the shared files for writing (or changing its
+//! times) first gets a private copy of it, so its writes never reach the snapshot or the other
+//! workers.
+//!
+//! The snapshots are kept by the executor's `InitialFileSystemService`, which drops the ones of
+//! the component versions not used for a while. A dropped snapshot is deleted once the last
+//! worker linked to it is dropped.
+
+use std::collections::HashSet;
+use std::fs;
+use std::io;
+use std::os::unix::fs::{MetadataExt, PermissionsExt};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+use std::time::Duration;
+
+use fs_set_times::{set_times, SystemTimeSpec};
+use golem_common::cache::{BackgroundEvictionMode, Cache, FullCacheEvictionMode, SimpleCache};
+use golem_common::model::{ComponentId, ComponentVersion};
+use tempfile::TempDir;
+use tokio::task::spawn_blocking;
+use tracing::{debug, warn};
+
+use crate::error::GolemError;
+use crate::services::golem_config::InitialFileSystemConfig;
+
+/// The initial file systems of the component versions, shared by all workers of the executor
+pub struct InitialFileSystemService {
+    config: InitialFileSystemConfig,
+    images: Cache<(ComponentId, ComponentVersion), (), Arc<InitialFileSystem>, GolemError>,
+}
+
+impl InitialFileSystemService {
+    pub fn new(config: &InitialFileSystemConfig) -> Self {
+        Self {
+            config: config.clone(),
+            images: Cache::new(
+                Some(config.max_capacity),
+                FullCacheEvictionMode::LeastRecentlyUsed(1),
+                BackgroundEvictionMode::OlderThan {
+                    ttl: config.time_to_idle,
+                    period: Duration::from_secs(60),
+                },
+                "initial_file_system",
+            ),
+        }
+    }
+
+    /// The initial file system of a component version, if it has one
+    pub async fn get(
+        &self,
+        component_id: &ComponentId,
+        component_version: ComponentVersion,
+    ) -> Result<Option<Arc<InitialFileSystem>>, GolemError> {
+        if !self.config.enabled {
+            return Ok(None);
+        }
+
+        let key = (component_id.clone(), component_version);
+        if let Some(image) = self.images.try_get(&key) {
+            return Ok(Some(image));
+        }
+
+        let root = self
+            .config
+            .root
+            .join(component_id.to_string())
+            .join(component_version.to_string());
+        let image = spawn_blocking(move || {
+            if root.is_dir() {
+                InitialFileSystem::scan(root).map(Some)
+            } else {
+                Ok(None)
+            }
+        })
+        .await
+        .map_err(|err| GolemError::unknown(err.to_string()))?
+        .map_err(|err| {
+            GolemError::runtime(format!("Failed to scan the initial file system: {err}"))
+        })?;
+
+        // Missing images are not cached, so they can be provisioned while the executor runs
+        match image {
+            Some(image) => {
+                debug!(
+                    "Scanned the initial file system of {component_id}#{component_version}: {} entries",
+                    image.entries.len()
+                );
+                let image = Arc::new(image);
+                let image = self
+                    .images
+                    .get_or_insert_simple(&key, || Box::pin(async move { Ok(image) }))
+                    .await?;
+                Ok(Some(image))
+            }
+            None => Ok(None),
+        }
+    }
+}
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+enum Entry {
+    Directory(PathBuf),
+    File(PathBuf),
+    Symlink(PathBuf, PathBuf),
+}
+
+#[derive(Debug)]
+pub struct InitialFileSystem {
+    /// The read-only copy of the image the workers' files are linked to
+    snapshot: TempDir,
+    /// Relative paths of the entries, every directory preceding its contents
+    entries: Vec<Entry>,
+    /// Device and inode numbers of the files, identifying the links to them
+    inodes: HashSet<(u64, u64)>,
+}
+
+impl InitialFileSystem {
+    /// Copies the image into a new snapshot, keeping the times of its files
+    fn scan(root: PathBuf) -> io::Result<Self> {
+        let snapshot = tempfile::Builder::new()
+            .prefix("golem-initial-fs")
+            .tempdir()?;
+        let mut entries = Vec::new();
+        let mut inodes = HashSet::new();
+        let mut pending = vec![PathBuf::new()];
+
+        while let Some(dir) = pending.pop() {
+            let mut children = fs::read_dir(root.join(&dir))?.collect::<Result<Vec<_>, _>>()?;
+            children.sort_by_key(|child| child.file_name());
+            for child in children {
+                let path = dir.join(child.file_name());
+                let copy = snapshot.path().join(&path);
+                let metadata = child.path().symlink_metadata()?;
+                if metadata.is_dir() {
+                    fs::create_dir(&copy)?;
+                    entries.push(Entry::Directory(path.clone()));
+                    pending.push(path);
+                } else if metadata.is_symlink() {
+                    entries.push(Entry::Symlink(path, fs::read_link(child.path())?));
+                } else {
+                    fs::copy(child.path(), &copy)?;
+                    set_times(
+                        &copy,
+                        Some(SystemTimeSpec::from(metadata.accessed()?)),
+                        Some(SystemTimeSpec::from(metadata.modified()?)),
+                    )?;
+                    let mut permissions = metadata.permissions();
+                    permissions.set_readonly(true);
+                    fs::set_permissions(&copy, permissions)?;
+
+                    let metadata = copy.metadata()?;
+                    inodes.insert((metadata.dev(), metadata.ino()));
+                    entries.push(Entry::File(path));
+                }
+            }
+        }
+
+        Ok(Self {
+            snapshot,
+            entries,
+            inodes,
+        })
+    }
+
+    /// Recreates the file system in the root directory of a worker, linking the files
+    pub fn mount(&self, target: &Path) -> io::Result<()> {
+        let mut copied = 0;
+        for entry in &self.entries {
+            match entry {
+                Entry::Directory(path) => fs::create_dir_all(target.join(path))?,
+                Entry::Symlink(path, link) => std::os::unix::fs::symlink(link, target.join(path))?,
+                Entry::File(path) => {
+                    // Hard links cannot cross file systems
+                    let source = self.snapshot.path().join(path);
+                    if fs::hard_link(&source, target.join(path)).is_err() {
+                        fs::copy(&source, target.join(path))?;
+                        copied += 1;
+                    }
+                }
+            }
+        }
+
+        if copied > 0 {
+            warn!(
+                "Copied {copied} files of the initial file system {:?} instead of linking them, it should be on the same file system as {target:?}",
+                self.snapshot.path()
+            );
+        }
+        Ok(())
+    }
+
+    /// Resolves the host path of a file of a worker, following its symlinks. `None` if the file
+    /// does not exist. The host path is built from a guest path, so paths resolving outside of
+    /// the worker's root directory through `..` or a symlink are refused.
+    fn resolve(root: &Path, path: &Path) -> io::Result<Option<PathBuf>> {
+        let root = root.canonicalize()?;
+        match path.canonicalize() {
+            Ok(resolved) if resolved.starts_with(&root) => Ok(Some(resolved)),
+            Ok(_) => Err(io::Error::new(
+                io::ErrorKind::PermissionDenied,
+                format!("{path:?} is outside of the worker's root directory"),
+            )),
+            Err(err) if err.kind() == io::ErrorKind::NotFound => Ok(None),
+            Err(err) => Err(err),
+        }
+    }
+
+    /// Whether the file at the given host path in the root directory of a worker is shared with
+    /// the image
+    pub fn is_shared(&self, root: &Path, path: &Path) -> io::Result<bool> {
+        Ok(self.resolve_shared(root, path)?.is_some())
+    }
+
+    /// The resolved host path of the file if it is shared with the image
+    fn resolve_shared(&self, root: &Path, path: &Path) -> io::Result<Option<PathBuf>> {
+        match Self::resolve(root, path)? {
+            Some(path) => {
+                let metadata = path.metadata()?;
+                let shared =
+                    metadata.is_file() && self.inodes.contains(&(metadata.dev(), metadata.ino()));
+                Ok(shared.then_some(path))
+            }
+            None => Ok(None),
+        }
+    }
+
+    /// Replaces the file at the given host path in the root directory of a worker by a private
+    /// copy if it is shared with the image
+    pub fn unshare(&self, root: &Path, path: &Path) -> io::Result<()> {
+        // The path can be a symlink to the shared file, the copy replaces the file itself
+        let Some(path) = self.resolve_shared(root, path)? else {
+            return Ok(());
+        };
+
+        let metadata = path.metadata()?;
+        let file_name = path.file_name().unwrap_or_default().to_string_lossy();
+        let copy = path.with_file_name(format!(".{file_name}.golem-copy"));
+        fs::copy(&path, &copy)?;
+
+        let mut permissions = metadata.permissions();
+        permissions.set_mode(permissions.mode() | 0o200);
+        fs::set_permissions(&copy, permissions)?;
+        set_times(
+            &copy,
+            Some(SystemTimeSpec::from(metadata.accessed()?)),
+            Some(SystemTimeSpec::from(metadata.modified()?)),
+        )?;
+        fs::rename(&copy, &path)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::fs;
+    use std::io;
+
+    use std::sync::Arc;
+    use std::time::Duration;
+
+    use golem_common::model::ComponentId;
+    use tempfile::TempDir;
+    use uuid::Uuid;
+
+    use crate::durable_host::filesystem::initial::{InitialFileSystem, InitialFileSystemService};
+    use crate::services::golem_config::InitialFileSystemConfig;
+
+    #[test]
+    fn mounted_files_are_shared_until_written() {
+        let image = TempDir::new().unwrap();
+        fs::create_dir_all(image.path().join("assets/images")).unwrap();
+        fs::write(image.path().join("config.json"), "{}").unwrap();
+        fs::write(image.path().join("assets/images/logo.svg"), "<svg/>").unwrap();
+        std::os::unix::fs::symlink("config.json", image.path().join("current.json")).unwrap();
+
+        let initial = InitialFileSystem::scan(image.path().to_path_buf()).unwrap();
+        assert_eq!(initial.inodes.len(), 2);
+        // The provisioned image is left as it is
+        assert!(!fs::metadata(image.path().join("config.json"))
+            .unwrap()
+            .permissions()
+            .readonly());
+
+        let worker1 = TempDir::new().unwrap();
+        let worker2 = TempDir::new().unwrap();
+        initial.mount(worker1.path()).unwrap();
+        initial.mount(worker2.path()).unwrap();
+        let root1 = worker1.path();
+
+        assert_eq!(
+            fs::read_to_string(root1.join("assets/images/logo.svg")).unwrap(),
+            "<svg/>"
+        );
+        assert_eq!(
+            fs::read_to_string(worker2.path().join("current.json")).unwrap(),
+            "{}"
+        );
+
+        assert!(initial
+            .is_shared(root1, &root1.join("current.json"))
+            .unwrap());
+        let modified = fs::metadata(image.path().join("config.json"))
+            .unwrap()
+            .modified()
+            .unwrap();
+        initial.unshare(root1, &root1.join("current.json")).unwrap();
+        assert!(!initial
+            .is_shared(root1, &root1.join("config.json"))
+            .unwrap());
+        assert_eq!(
+            fs::metadata(root1.join("config.json"))
+                .unwrap()
+                .modified()
+                .unwrap(),
+            modified
+        );
+        fs::write(root1.join("config.json"), "{\"changed\":true}").unwrap();
+
+        assert_eq!(
+            fs::read_to_string(root1.join("current.json")).unwrap(),
+            "{\"changed\":true}"
+        );
+        assert_eq!(
+            fs::read_to_string(worker2.path().join("config.json")).unwrap(),
+            "{}"
+        );
+        assert_eq!(
+            fs::read_to_string(image.path().join("config.json")).unwrap(),
+            "{}"
+        );
+
+        // Files which are not shared are left as they are
+        initial.unshare(root1, &root1.join("config.json")).unwrap();
+        initial.unshare(root1, &root1.join("missing")).unwrap();
+        assert!(root1.join("current.json").is_symlink());
+    }
+
+    #[test]
+    fn paths_outside_of_the_worker_root_are_refused() {
+        let image = TempDir::new().unwrap();
+        fs::write(image.path().join("config.json"), "{}").unwrap();
+        let initial = InitialFileSystem::scan(image.path().to_path_buf()).unwrap();
+
+        let worker = TempDir::new().unwrap();
+        initial.mount(worker.path()).unwrap();
+        let root = worker.path();
+        std::os::unix::fs::symlink(image.path(), root.join("escape")).unwrap();
+
+        let outside = [
+            root.join("../")
+                .join(image.path().file_name().unwrap())
+                .join("config.json"),
+            root.join("escape/config.json"),
+        ];
+        for path in outside {
+            assert_eq!(
+                initial.unshare(root, &path).unwrap_err().kind(),
+                io::ErrorKind::PermissionDenied
+            );
+            assert_eq!(
+                initial.is_shared(root, &path).unwrap_err().kind(),
+                io::ErrorKind::PermissionDenied
+            );
+        }
+        assert_eq!(
+            fs::read_to_string(image.path().join("config.json")).unwrap(),
+            "{}"
+        );
+    }
+
+    #[tokio::test]
+    async fn least_recently_used_snapshots_are_evicted() {
+        let root = TempDir::new().unwrap();
+        let component_id = ComponentId(Uuid::new_v4());
+        for version in 0..2 {
+            let image = root
+                .path()
+                .join(component_id.to_string())
+                .join(version.to_string());
+            fs::create_dir_all(&image).unwrap();
+            fs::write(image.join("config.json"), "{}").unwrap();
+        }
+        let service = InitialFileSystemService::new(&InitialFileSystemConfig {
+            enabled: true,
+            root: root.path().to_path_buf(),
+            max_capacity: 1,
+            time_to_idle: Duration::from_secs(60),
+        });
+
+        let first = service.get(&component_id, 0).await.unwrap().unwrap();
+        let cached = service.get(&component_id, 0).await.unwrap().unwrap();
+        assert!(Arc::ptr_eq(&first, &cached));
+        let snapshot = first.snapshot.path().to_path_buf();
+        drop(cached);
+
+        tokio::time::sleep(Duration::from_millis(10)).await;
+        let second = service.get(&component_id, 1).await.unwrap().unwrap();
+
+        // The evicted snapshot is kept while a worker still uses it
+        assert!(snapshot.exists());
+        drop(first);
+        assert!(!snapshot.exists());
+        assert!(second.snapshot.path().exists());
+
+        assert!(service.get(&component_id, 2).await.unwrap().is_none());
+    }
+}
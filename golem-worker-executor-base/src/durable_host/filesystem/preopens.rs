@@ -26,7 +26,7 @@ use wasmtime_wasi::bindings::filesystem::preopens::{Descriptor, Host};
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn get_directories(&mut self) -> anyhow::Result<Vec<(Resource<Descriptor>, String)>> {
-        record_host_function_call("cli_base::preopens", "get_directories");
+        let _timer = record_host_function_call("cli_base::preopens", "get_directories");
 
         let current_dirs1 = Host::get_directories(&mut self.as_wasi_view()).await?;
         let current_dirs2 = Host::get_directories(&mut self.as_wasi_view()).await?;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 use std::hash::Hasher;
+use std::path::PathBuf;
 use std::time::SystemTime;
 
 use async_trait::async_trait;
@@ -39,6 +40,19 @@ use crate::durable_host::{Durability, DurableWorkerCtx};
 use crate::metrics::wasm::record_host_function_call;
 use crate::workerctx::WorkerCtx;
 
+impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
+    /// Gives the worker a private copy of a file of its initial file system before modifying it
+    async fn unshare_initial_file(&self, path: PathBuf) -> Result<(), FsError> {
+        if let Some(initial_file_system) = self.initial_file_system.clone() {
+            let root = self.temp_dir.path().to_path_buf();
+            spawn_blocking(move || initial_file_system.unshare(&root, &path))
+                .await
+                .map_err(ErrorCode::from)?;
+        }
+        Ok(())
+    }
+}
+
 #[async_trait]
 impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
     fn read_via_stream(
@@ -46,7 +60,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         offset: Filesize,
     ) -> Result<Resource<InputStream>, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "read_via_stream");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "read_via_stream");
         HostDescriptor::read_via_stream(&mut self.as_wasi_view(), self_, offset)
     }
 
@@ -55,7 +69,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         offset: Filesize,
     ) -> Result<Resource<OutputStream>, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "write_via_stream");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "write_via_stream");
         HostDescriptor::write_via_stream(&mut self.as_wasi_view(), self_, offset)
     }
 
@@ -63,7 +77,8 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<Descriptor>,
     ) -> Result<Resource<OutputStream>, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "append_via_stream");
+        let _timer =
+            record_host_function_call("filesystem::types::descriptor", "append_via_stream");
         HostDescriptor::append_via_stream(&mut self.as_wasi_view(), self_)
     }
 
@@ -74,22 +89,22 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         length: Filesize,
         advice: Advice,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "advise");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "advise");
         HostDescriptor::advise(&mut self.as_wasi_view(), self_, offset, length, advice).await
     }
 
     async fn sync_data(&mut self, self_: Resource<Descriptor>) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "sync_data");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "sync_data");
         HostDescriptor::sync_data(&mut self.as_wasi_view(), self_).await
     }
 
     async fn get_flags(&mut self, self_: Resource<Descriptor>) -> Result<DescriptorFlags, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "get_flags");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "get_flags");
         HostDescriptor::get_flags(&mut self.as_wasi_view(), self_).await
     }
 
     async fn get_type(&mut self, self_: Resource<Descriptor>) -> Result<DescriptorType, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "get_type");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "get_type");
         HostDescriptor::get_type(&mut self.as_wasi_view(), self_).await
     }
 
@@ -98,7 +113,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         size: Filesize,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "set_size");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "set_size");
         HostDescriptor::set_size(&mut self.as_wasi_view(), self_, size).await
     }
 
@@ -108,7 +123,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         data_access_timestamp: NewTimestamp,
         data_modification_timestamp: NewTimestamp,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "set_times");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "set_times");
         HostDescriptor::set_times(
             &mut self.as_wasi_view(),
             self_,
@@ -124,7 +139,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         length: Filesize,
         offset: Filesize,
     ) -> Result<(Vec<u8>, bool), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "read");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "read");
         HostDescriptor::read(&mut self.as_wasi_view(), self_, length, offset).await
     }
 
@@ -134,7 +149,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         buffer: Vec<u8>,
         offset: Filesize,
     ) -> Result<Filesize, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "write");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "write");
         HostDescriptor::write(&mut self.as_wasi_view(), self_, buffer, offset).await
     }
 
@@ -142,7 +157,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<Descriptor>,
     ) -> Result<Resource<DirectoryEntryStream>, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "read_directory");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "read_directory");
         let stream = HostDescriptor::read_directory(&mut self.as_wasi_view(), self_).await?;
         // Iterating through the whole stream to make sure we have a stable order
         let mut entries = Vec::new();
@@ -158,7 +173,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
     }
 
     async fn sync(&mut self, self_: Resource<Descriptor>) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "sync");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "sync");
         HostDescriptor::sync(&mut self.as_wasi_view(), self_).await
     }
 
@@ -167,18 +182,21 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         path: String,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "create_directory_at");
+        let _timer =
+            record_host_function_call("filesystem::types::descriptor", "create_directory_at");
         HostDescriptor::create_directory_at(&mut self.as_wasi_view(), self_, path).await
     }
 
     async fn stat(&mut self, self_: Resource<Descriptor>) -> Result<DescriptorStat, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "stat");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "stat");
 
         let path = match self.table().get(&self_)? {
             Descriptor::File(f) => f.path.clone(),
             Descriptor::Dir(d) => d.path.clone(),
         };
 
+        let initial_file_system = self.initial_file_system.clone();
+        let root = self.temp_dir.path().to_path_buf();
         let mut stat = HostDescriptor::stat(&mut self.as_wasi_view(), self_).await?;
         stat.status_change_timestamp = None; // We cannot guarantee this to be the same during replays, so we rather not support it
 
@@ -208,7 +226,18 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
                             t.clone(),
                         ))
                     });
-                    spawn_blocking(|| set_symlink_times(path, accessed, modified)).await?;
+                    spawn_blocking(move || {
+                        // The times of the shared files are the image's, which never change
+                        match initial_file_system {
+                            Some(initial_file_system)
+                                if initial_file_system.is_shared(&root, &path)? =>
+                            {
+                                Ok(())
+                            }
+                            _ => set_symlink_times(path, accessed, modified),
+                        }
+                    })
+                    .await?;
                     stat.data_access_timestamp = times.data_access_timestamp.map(|t| t.into());
                     stat.data_modification_timestamp =
                         times.data_modification_timestamp.map(|t| t.into());
@@ -226,12 +255,14 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         path_flags: PathFlags,
         path: String,
     ) -> Result<DescriptorStat, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "stat_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "stat_at");
         let full_path = match self.table().get(&self_)? {
             Descriptor::File(f) => f.path.join(path.clone()),
             Descriptor::Dir(d) => d.path.join(path.clone()),
         };
 
+        let initial_file_system = self.initial_file_system.clone();
+        let root = self.temp_dir.path().to_path_buf();
         let mut stat =
             HostDescriptor::stat_at(&mut self.as_wasi_view(), self_, path_flags, path).await?;
         stat.status_change_timestamp = None; // We cannot guarantee this to be the same during replays, so we rather not support it
@@ -262,7 +293,18 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
                             t.clone(),
                         ))
                     });
-                    spawn_blocking(|| set_symlink_times(full_path, accessed, modified)).await?;
+                    spawn_blocking(move || {
+                        // The times of the shared files are the image's, which never change
+                        match initial_file_system {
+                            Some(initial_file_system)
+                                if initial_file_system.is_shared(&root, &full_path)? =>
+                            {
+                                Ok(())
+                            }
+                            _ => set_symlink_times(full_path, accessed, modified),
+                        }
+                    })
+                    .await?;
                     stat.data_access_timestamp = times.data_access_timestamp.map(|t| t.into());
                     stat.data_modification_timestamp =
                         times.data_modification_timestamp.map(|t| t.into());
@@ -282,7 +324,12 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         data_access_timestamp: NewTimestamp,
         data_modification_timestamp: NewTimestamp,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "set_times_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "set_times_at");
+        let full_path = match self.table().get(&self_)? {
+            Descriptor::File(f) => f.path.join(&path),
+            Descriptor::Dir(d) => d.path.join(&path),
+        };
+        self.unshare_initial_file(full_path).await?;
         HostDescriptor::set_times_at(
             &mut self.as_wasi_view(),
             self_,
@@ -302,7 +349,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         new_descriptor: Resource<Descriptor>,
         new_path: String,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "link_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "link_at");
         HostDescriptor::link_at(
             &mut self.as_wasi_view(),
             self_,
@@ -322,7 +369,14 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         open_flags: OpenFlags,
         flags: DescriptorFlags,
     ) -> Result<Resource<Descriptor>, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "open_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "open_at");
+        if flags.contains(DescriptorFlags::WRITE) || open_flags.contains(OpenFlags::TRUNCATE) {
+            let full_path = match self.table().get(&self_)? {
+                Descriptor::File(f) => f.path.join(&path),
+                Descriptor::Dir(d) => d.path.join(&path),
+            };
+            self.unshare_initial_file(full_path).await?;
+        }
         HostDescriptor::open_at(
             &mut self.as_wasi_view(),
             self_,
@@ -339,7 +393,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         path: String,
     ) -> Result<String, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "readlink_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "readlink_at");
         HostDescriptor::readlink_at(&mut self.as_wasi_view(), self_, path).await
     }
 
@@ -348,7 +402,8 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         path: String,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "remove_directory_at");
+        let _timer =
+            record_host_function_call("filesystem::types::descriptor", "remove_directory_at");
         HostDescriptor::remove_directory_at(&mut self.as_wasi_view(), self_, path.clone()).await
     }
 
@@ -359,7 +414,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         new_descriptor: Resource<Descriptor>,
         new_path: String,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "rename_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "rename_at");
         HostDescriptor::rename_at(
             &mut self.as_wasi_view(),
             self_,
@@ -376,7 +431,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         old_path: String,
         new_path: String,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "symlink_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "symlink_at");
         HostDescriptor::symlink_at(&mut self.as_wasi_view(), self_, old_path, new_path.clone())
             .await
     }
@@ -386,7 +441,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         path: String,
     ) -> Result<(), FsError> {
-        record_host_function_call("filesystem::types::descriptor", "unlink_file_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "unlink_file_at");
         HostDescriptor::unlink_file_at(&mut self.as_wasi_view(), self_, path.clone()).await
     }
 
@@ -395,7 +450,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         self_: Resource<Descriptor>,
         other: Resource<Descriptor>,
     ) -> anyhow::Result<bool> {
-        record_host_function_call("filesystem::types::descriptor", "is_same_object");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "is_same_object");
         HostDescriptor::is_same_object(&mut self.as_wasi_view(), self_, other).await
     }
 
@@ -403,7 +458,7 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<Descriptor>,
     ) -> Result<MetadataHashValue, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "metadata_hash");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "metadata_hash");
 
         // Using the WASI stat function as it guarantees the file times are preserved
         let metadata = self.stat(self_).await?;
@@ -416,14 +471,14 @@ impl<Ctx: WorkerCtx> HostDescriptor for DurableWorkerCtx<Ctx> {
         path_flags: PathFlags,
         path: String,
     ) -> Result<MetadataHashValue, FsError> {
-        record_host_function_call("filesystem::types::descriptor", "metadata_hash_at");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "metadata_hash_at");
         // Using the WASI stat_at function as it guarantees the file times are preserved
         let metadata = self.stat_at(self_, path_flags, path).await?;
         Ok(calculate_metadata_hash(&metadata))
     }
 
     fn drop(&mut self, rep: Resource<Descriptor>) -> anyhow::Result<()> {
-        record_host_function_call("filesystem::types::descriptor", "drop");
+        let _timer = record_host_function_call("filesystem::types::descriptor", "drop");
         HostDescriptor::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -434,7 +489,7 @@ impl<Ctx: WorkerCtx> HostDirectoryEntryStream for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<DirectoryEntryStream>,
     ) -> Result<Option<DirectoryEntry>, FsError> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "filesystem::types::directory_entry_stream",
             "read_directory_entry",
         );
@@ -442,7 +497,7 @@ impl<Ctx: WorkerCtx> HostDirectoryEntryStream for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<DirectoryEntryStream>) -> anyhow::Result<()> {
-        record_host_function_call("filesystem::types::directory_entry_stream", "drop");
+        let _timer = record_host_function_call("filesystem::types::directory_entry_stream", "drop");
         HostDirectoryEntryStream::drop(&mut self.as_wasi_view(), rep)
     }
 }
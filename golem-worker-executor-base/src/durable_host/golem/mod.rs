@@ -45,7 +45,7 @@ impl<Ctx: WorkerCtx> HostGetWorkers for DurableWorkerCtx<Ctx> {
         filter: Option<golem::api::host::WorkerAnyFilter>,
         precise: bool,
     ) -> anyhow::Result<Resource<GetWorkersEntry>> {
-        record_host_function_call("golem::api::get-workers", "new");
+        let _timer = record_host_function_call("golem::api::get-workers", "new");
         let entry = GetWorkersEntry::new(component_id.into(), filter.map(|f| f.into()), precise);
         let resource = self.as_wasi_view().table().push(entry)?;
         Ok(resource)
@@ -55,7 +55,7 @@ impl<Ctx: WorkerCtx> HostGetWorkers for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<GetWorkersEntry>,
     ) -> anyhow::Result<Option<Vec<golem::api::host::WorkerMetadata>>> {
-        record_host_function_call("golem::api::get-workers", "get_next");
+        let _timer = record_host_function_call("golem::api::get-workers", "get_next");
         let (component_id, filter, count, precise, cursor) = self
             .as_wasi_view()
             .table()
@@ -89,7 +89,7 @@ impl<Ctx: WorkerCtx> HostGetWorkers for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<GetWorkersEntry>) -> anyhow::Result<()> {
-        record_host_function_call("golem::api::get-workers", "drop");
+        let _timer = record_host_function_call("golem::api::get-workers", "drop");
         self.as_wasi_view().table().delete::<GetWorkersEntry>(rep)?;
         Ok(())
     }
@@ -126,7 +126,7 @@ impl GetWorkersEntry {
 #[async_trait]
 impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     async fn golem_create_promise(&mut self) -> Result<golem::api::host::PromiseId, anyhow::Error> {
-        record_host_function_call("golem::api", "golem_create_promise");
+        let _timer = record_host_function_call("golem::api", "golem_create_promise");
         let oplog_idx = self.get_oplog_index().await?;
         Ok(self
             .public_state
@@ -143,7 +143,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         &mut self,
         promise_id: golem::api::host::PromiseId,
     ) -> Result<Vec<u8>, anyhow::Error> {
-        record_host_function_call("golem::api", "golem_await_promise");
+        let _timer = record_host_function_call("golem::api", "golem_await_promise");
         let promise_id: PromiseId = promise_id.into();
         match self
             .public_state
@@ -164,7 +164,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         promise_id: golem::api::host::PromiseId,
         data: Vec<u8>,
     ) -> Result<bool, anyhow::Error> {
-        record_host_function_call("golem::api", "golem_complete_promise");
+        let _timer = record_host_function_call("golem::api", "golem_complete_promise");
         Durability::<Ctx, bool, SerializableError>::wrap(
             self,
             WrappedFunctionType::WriteLocal,
@@ -186,7 +186,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         &mut self,
         promise_id: golem::api::host::PromiseId,
     ) -> Result<(), anyhow::Error> {
-        record_host_function_call("golem::api", "golem_delete_promise");
+        let _timer = record_host_function_call("golem::api", "golem_delete_promise");
         Durability::<Ctx, (), SerializableError>::wrap(
             self,
             WrappedFunctionType::WriteLocal,
@@ -208,7 +208,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         &mut self,
         function_name: String,
     ) -> Result<golem::rpc::types::Uri, anyhow::Error> {
-        record_host_function_call("golem::api", "get_self_uri");
+        let _timer = record_host_function_call("golem::api", "get_self_uri");
         let uri = golem_wasm_rpc::golem::rpc::types::Uri::golem_uri(
             &self.owned_worker_id.worker_id,
             Some(&function_name),
@@ -217,7 +217,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn get_oplog_index(&mut self) -> anyhow::Result<golem::api::host::OplogIndex> {
-        record_host_function_call("golem::api", "get_oplog_index");
+        let _timer = record_host_function_call("golem::api", "get_oplog_index");
         if self.state.is_live() {
             self.state.oplog.add(OplogEntry::nop()).await;
             Ok(self.state.current_oplog_index().await.into())
@@ -231,7 +231,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         &mut self,
         oplog_idx: golem::api::host::OplogIndex,
     ) -> anyhow::Result<()> {
-        record_host_function_call("golem::api", "set_oplog_index");
+        let _timer = record_host_function_call("golem::api", "set_oplog_index");
         let jump_source = self.state.current_oplog_index().await.next(); // index of the Jump instruction that we will add
         let jump_target = OplogIndex::from_u64(oplog_idx).next(); // we want to jump _after_ reaching the target index
         if jump_target > jump_source {
@@ -287,7 +287,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn mark_begin_operation(&mut self) -> anyhow::Result<golem::api::host::OplogIndex> {
-        record_host_function_call("golem::api", "mark_begin_operation");
+        let _timer = record_host_function_call("golem::api", "mark_begin_operation");
 
         if self.state.is_live() {
             self.state
@@ -339,7 +339,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         &mut self,
         begin: golem::api::host::OplogIndex,
     ) -> anyhow::Result<()> {
-        record_host_function_call("golem::api", "mark_end_operation");
+        let _timer = record_host_function_call("golem::api", "mark_end_operation");
         if self.state.is_live() {
             self.state
                 .oplog
@@ -353,7 +353,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn get_retry_policy(&mut self) -> anyhow::Result<RetryPolicy> {
-        record_host_function_call("golem::api", "get_retry_policy");
+        let _timer = record_host_function_call("golem::api", "get_retry_policy");
         match &self.state.overridden_retry_policy {
             Some(policy) => Ok(policy.into()),
             None => Ok((&self.state.config.retry).into()),
@@ -361,7 +361,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn set_retry_policy(&mut self, new_retry_policy: RetryPolicy) -> anyhow::Result<()> {
-        record_host_function_call("golem::api", "set_retry_policy");
+        let _timer = record_host_function_call("golem::api", "set_retry_policy");
         let new_retry_policy: RetryConfig = new_retry_policy.into();
         self.state.overridden_retry_policy = Some(new_retry_policy.clone());
 
@@ -377,7 +377,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn get_oplog_persistence_level(&mut self) -> anyhow::Result<PersistenceLevel> {
-        record_host_function_call("golem::api", "get_oplog_persistence_level");
+        let _timer = record_host_function_call("golem::api", "get_oplog_persistence_level");
         Ok(self.state.persistence_level.clone().into())
     }
 
@@ -385,7 +385,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         &mut self,
         new_persistence_level: PersistenceLevel,
     ) -> anyhow::Result<()> {
-        record_host_function_call("golem::api", "set_oplog_persistence_level");
+        let _timer = record_host_function_call("golem::api", "set_oplog_persistence_level");
         // commit all pending entries and change persistence level
         if self.state.is_live() {
             self.state.oplog.commit().await;
@@ -399,18 +399,18 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn get_idempotence_mode(&mut self) -> anyhow::Result<bool> {
-        record_host_function_call("golem::api", "get_idempotence_mode");
+        let _timer = record_host_function_call("golem::api", "get_idempotence_mode");
         Ok(self.state.assume_idempotence)
     }
 
     async fn set_idempotence_mode(&mut self, idempotent: bool) -> anyhow::Result<()> {
-        record_host_function_call("golem::api", "set_idempotence_mode");
+        let _timer = record_host_function_call("golem::api", "set_idempotence_mode");
         self.state.assume_idempotence = idempotent;
         Ok(())
     }
 
     async fn generate_idempotency_key(&mut self) -> anyhow::Result<golem::api::host::Uuid> {
-        record_host_function_call("golem::api", "generate_idempotency_key");
+        let _timer = record_host_function_call("golem::api", "generate_idempotency_key");
         let uuid = Durability::<Ctx, (u64, u64), SerializableError>::custom_wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -436,7 +436,7 @@ impl<Ctx: WorkerCtx> golem::api::host::Host for DurableWorkerCtx<Ctx> {
         target_version: ComponentVersion,
         mode: UpdateMode,
     ) -> anyhow::Result<()> {
-        record_host_function_call("golem::api", "update_worker");
+        let _timer = record_host_function_call("golem::api", "update_worker");
 
         let worker_id: WorkerId = worker_id.into();
         let owned_worker_id = OwnedWorkerId::new(&self.owned_worker_id.account_id, &worker_id);
@@ -0,0 +1,537 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Executor-wide connection pool for the outgoing HTTP requests of the workers.
+//!
+//! Idle connections are kept per scheme and authority and reused by any worker calling the same
+//! host. Connections to TLS servers negotiate HTTP/2 through ALPN when the server supports it,
+//! multiplexing the concurrent requests on a single connection, and all connections share one
+//! TLS client configuration, so its session cache resumes TLS sessions on reconnects.
+//!
+//! The pool only replaces how a request is sent in live mode; requests are never sent during
+//! replay, and the responses are persisted in the oplog exactly as before.
+
+use std::error::Error;
+use std::fmt::{Display, Formatter};
+use std::future::Future;
+use std::pin::Pin;
+use std::sync::Arc;
+use std::task::{Context, Poll};
+use std::time::Duration;
+
+use dashmap::DashMap;
+use http::uri::{PathAndQuery, Scheme};
+use http::Uri;
+use http_body_util::BodyExt;
+use hyper_rustls::{HttpsConnector, HttpsConnectorBuilder};
+use hyper_util::client::legacy::connect::HttpConnector;
+use hyper_util::client::legacy::Client;
+use hyper_util::rt::TokioExecutor;
+use tokio::sync::{OwnedSemaphorePermit, Semaphore};
+use tower_service::Service;
+use tracing::warn;
+use wasmtime_wasi::runtime::spawn;
+use wasmtime_wasi_http::bindings::http::types::{DnsErrorPayload, ErrorCode};
+use wasmtime_wasi_http::body::HyperOutgoingBody;
+use wasmtime_wasi_http::hyper_response_error;
+use wasmtime_wasi_http::types::{
+    HostFutureIncomingResponse, IncomingResponse, OutgoingRequestConfig,
+};
+
+use crate::services::golem_config::OutgoingHttpConfig;
+
+type PooledClient = Client<TimeoutConnector<HttpsConnector<HttpConnector>>, HyperOutgoingBody>;
+
+pub struct HttpConnectionPool {
+    client: PooledClient,
+    max_concurrent_requests_per_host: usize,
+    /// The concurrency limits of the hosts with requests in flight, by scheme and authority
+    permits: Arc<DashMap<String, Arc<Semaphore>>>,
+}
+
+impl HttpConnectionPool {
+    pub fn new(config: &OutgoingHttpConfig) -> Self {
+        let mut root_store = rustls::RootCertStore::empty();
+        root_store.extend(webpki_roots::TLS_SERVER_ROOTS.iter().cloned());
+        // Several crypto providers are enabled in the dependency tree, so there is no
+        // process-wide default to pick
+        let tls_config = rustls::ClientConfig::builder_with_provider(Arc::new(
+            rustls::crypto::aws_lc_rs::default_provider(),
+        ))
+        .with_safe_default_protocol_versions()
+        .expect("The default TLS protocol versions are supported")
+        .with_root_certificates(root_store)
+        .with_no_client_auth();
+
+        let mut http_connector = HttpConnector::new();
+        http_connector.enforce_http(false);
+        http_connector.set_nodelay(true);
+        let connector = HttpsConnectorBuilder::new()
+            .with_tls_config(tls_config)
+            .https_or_http()
+            .enable_http1()
+            .enable_http2()
+            .wrap_connector(http_connector);
+
+        let client = Client::builder(TokioExecutor::new())
+            .pool_idle_timeout(config.idle_timeout)
+            .pool_max_idle_per_host(config.max_idle_connections_per_host)
+            .build(TimeoutConnector { inner: connector });
+
+        Self {
+            client,
+            max_concurrent_requests_per_host: config.max_concurrent_requests_per_host,
+            permits: Arc::new(DashMap::new()),
+        }
+    }
+
+    /// Sends the request on a pooled connection, a drop-in replacement of
+    /// `wasmtime_wasi_http::types::default_send_request`
+    pub fn send_request(
+        &self,
+        request: hyper::Request<HyperOutgoingBody>,
+        config: OutgoingRequestConfig,
+    ) -> HostFutureIncomingResponse {
+        let handle = match absolute_uri(request, config.use_tls) {
+            Ok(request) => {
+                let client = self.client.clone();
+                let limit = self.limit_of(&request);
+                spawn(async move { Ok(Self::send(client, limit, request, config).await) })
+            }
+            Err(error_code) => spawn(async move { Ok(Err(error_code)) }),
+        };
+        HostFutureIncomingResponse::pending(handle)
+    }
+
+    /// The concurrency limit of the host of a request with an absolute URI
+    fn limit_of(&self, request: &hyper::Request<HyperOutgoingBody>) -> HostLimit {
+        let uri = request.uri();
+        let scheme = uri.scheme_str().unwrap_or_default();
+        let host = uri.host().unwrap_or_default();
+        let port = uri
+            .port_u16()
+            .unwrap_or(if scheme == "https" { 443 } else { 80 });
+        let key = format!("{scheme}://{host}:{port}");
+        let semaphore = self
+            .permits
+            .entry(key.clone())
+            .or_insert_with(|| Arc::new(Semaphore::new(self.max_concurrent_requests_per_host)))
+            .clone();
+        HostLimit {
+            key,
+            permits: self.permits.clone(),
+            semaphore: Some(semaphore),
+            permit: None,
+        }
+    }
+
+    async fn send(
+        client: PooledClient,
+        mut limit: HostLimit,
+        request: hyper::Request<HyperOutgoingBody>,
+        config: OutgoingRequestConfig,
+    ) -> Result<IncomingResponse, ErrorCode> {
+        let OutgoingRequestConfig {
+            connect_timeout,
+            first_byte_timeout,
+            between_bytes_timeout,
+            ..
+        } = config;
+
+        limit.acquire().await?;
+
+        // A pooled connection may already be established, so receiving the response headers is
+        // given the first byte timeout on top of the time left from the connect timeout. A new
+        // connection still fails with a connection timeout once the connect timeout is over.
+        let response = CONNECT_TIMEOUT
+            .scope(
+                connect_timeout,
+                tokio::time::timeout(
+                    connect_timeout + first_byte_timeout,
+                    client.request(request),
+                ),
+            )
+            .await
+            .map_err(|_| ErrorCode::ConnectionReadTimeout)?
+            .map_err(client_error)?;
+
+        // The request stops counting towards the limit of its host once its response headers
+        // arrived, so a guest holding on to the body does not keep the other requests waiting
+        drop(limit);
+
+        let resp = response.map(|body| body.map_err(hyper_response_error).boxed());
+
+        Ok(IncomingResponse {
+            resp,
+            worker: None,
+            between_bytes_timeout,
+        })
+    }
+}
+
+/// A request's share of the concurrency limit of its host. The limit of a host is removed from
+/// the pool together with its last request, so the pool only keeps the hosts in use.
+struct HostLimit {
+    key: String,
+    permits: Arc<DashMap<String, Arc<Semaphore>>>,
+    semaphore: Option<Arc<Semaphore>>,
+    permit: Option<OwnedSemaphorePermit>,
+}
+
+impl HostLimit {
+    async fn acquire(&mut self) -> Result<(), ErrorCode> {
+        if let Some(semaphore) = self.semaphore.clone() {
+            let permit = semaphore
+                .acquire_owned()
+                .await
+                .map_err(|err| ErrorCode::InternalError(Some(err.to_string())))?;
+            self.permit = Some(permit);
+        }
+        Ok(())
+    }
+}
+
+impl Drop for HostLimit {
+    fn drop(&mut self) {
+        drop(self.permit.take());
+        drop(self.semaphore.take());
+        // Requests holding or waiting for a permit keep a reference to the semaphore, and they
+        // can only get one while the entry is locked, so this is not racing with them
+        self.permits
+            .remove_if(&self.key, |_, semaphore| Arc::strong_count(semaphore) == 1);
+    }
+}
+
+tokio::task_local! {
+    /// The connect timeout of the request the client is opening a new connection for
+    static CONNECT_TIMEOUT: Duration;
+}
+
+/// Applies the connect timeout of the request to opening a new connection, including the TLS
+/// handshake. The client creates the connection within the request's task, where the timeout is
+/// set.
+#[derive(Clone)]
+struct TimeoutConnector<C> {
+    inner: C,
+}
+
+impl<C> Service<Uri> for TimeoutConnector<C>
+where
+    C: Service<Uri>,
+    C::Response: Send + 'static,
+    C::Future: Send + 'static,
+    C::Error: Into<Box<dyn Error + Send + Sync>>,
+{
+    type Response = C::Response;
+    type Error = Box<dyn Error + Send + Sync>;
+    type Future = Pin<Box<dyn Future<Output = Result<Self::Response, Self::Error>> + Send>>;
+
+    fn poll_ready(&mut self, cx: &mut Context<'_>) -> Poll<Result<(), Self::Error>> {
+        self.inner.poll_ready(cx).map_err(Into::into)
+    }
+
+    fn call(&mut self, uri: Uri) -> Self::Future {
+        let connect_timeout = CONNECT_TIMEOUT.try_with(|connect_timeout| *connect_timeout);
+        let connecting = self.inner.call(uri);
+        Box::pin(async move {
+            match connect_timeout {
+                Ok(connect_timeout) => tokio::time::timeout(connect_timeout, connecting)
+                    .await
+                    .map_err(|_| Box::new(ConnectTimeout) as Box<dyn Error + Send + Sync>)?
+                    .map_err(Into::into),
+                Err(_) => connecting.await.map_err(Into::into),
+            }
+        })
+    }
+}
+
+#[derive(Debug)]
+struct ConnectTimeout;
+
+impl Display for ConnectTimeout {
+    fn fmt(&self, f: &mut Formatter<'_>) -> std::fmt::Result {
+        write!(f, "connect timeout")
+    }
+}
+
+impl Error for ConnectTimeout {}
+
+/// Makes the URI of the request absolute, the pool selects the connection by its scheme and
+/// authority
+fn absolute_uri(
+    mut request: hyper::Request<HyperOutgoingBody>,
+    use_tls: bool,
+) -> Result<hyper::Request<HyperOutgoingBody>, ErrorCode> {
+    let mut uri = request.uri().clone().into_parts();
+    uri.scheme = Some(if use_tls { Scheme::HTTPS } else { Scheme::HTTP });
+    if uri.path_and_query.is_none() {
+        uri.path_and_query = Some(PathAndQuery::from_static("/"));
+    }
+    *request.uri_mut() = Uri::from_parts(uri).map_err(|_| ErrorCode::HttpRequestUriInvalid)?;
+    Ok(request)
+}
+
+/// Maps the errors of the client to the error codes `default_send_request` returns for them
+fn client_error(err: hyper_util::client::legacy::Error) -> ErrorCode {
+    let mut source = err.source();
+    while let Some(cause) = source {
+        // Errors of the outgoing body stream are the guest's own error codes
+        if let Some(error_code) = cause.downcast_ref::<ErrorCode>() {
+            return error_code.clone();
+        }
+        if err.is_connect() {
+            if cause.is::<ConnectTimeout>() {
+                return ErrorCode::ConnectionTimeout;
+            }
+            // The resolver's errors are wrapped in a connect error with this message
+            if cause.to_string() == "dns error" {
+                return ErrorCode::DnsError(DnsErrorPayload {
+                    rcode: Some("address not available".to_string()),
+                    info_code: Some(0),
+                });
+            }
+            if let Some(io_error) = cause.downcast_ref::<std::io::Error>() {
+                if io_error
+                    .get_ref()
+                    .is_some_and(|inner| inner.is::<rustls::Error>())
+                {
+                    warn!("tls protocol error: {err:?}");
+                    return ErrorCode::TlsProtocolError;
+                }
+            }
+        }
+        source = cause.source();
+    }
+
+    if err.is_connect() {
+        ErrorCode::ConnectionRefused
+    } else {
+        warn!("hyper request error: {err:?}");
+        ErrorCode::HttpProtocolError
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::sync::Arc;
+    use std::time::{Duration, Instant};
+
+    use bytes::Bytes;
+    use http_body_util::{BodyExt, Empty};
+    use tokio::io::{AsyncReadExt, AsyncWriteExt};
+    use tokio::net::TcpListener;
+    use wasmtime_wasi_http::bindings::http::types::ErrorCode;
+    use wasmtime_wasi_http::body::HyperOutgoingBody;
+    use wasmtime_wasi_http::types::OutgoingRequestConfig;
+
+    use crate::durable_host::http::connection_pool::{absolute_uri, HttpConnectionPool};
+    use crate::services::golem_config::OutgoingHttpConfig;
+
+    /// HTTP/1.1 server answering every request with `ok` after `delay`, on keep-alive connections
+    struct TestServer {
+        port: u16,
+        connections: Arc<AtomicUsize>,
+        max_in_flight: Arc<AtomicUsize>,
+    }
+
+    async fn start_server(delay: Duration) -> TestServer {
+        let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+        let port = listener.local_addr().unwrap().port();
+        let connections = Arc::new(AtomicUsize::new(0));
+        let in_flight = Arc::new(AtomicUsize::new(0));
+        let max_in_flight = Arc::new(AtomicUsize::new(0));
+
+        let connections_clone = connections.clone();
+        let max_in_flight_clone = max_in_flight.clone();
+        tokio::spawn(async move {
+            loop {
+                let (mut stream, _) = listener.accept().await.unwrap();
+                connections_clone.fetch_add(1, Ordering::SeqCst);
+                let in_flight = in_flight.clone();
+                let max_in_flight = max_in_flight_clone.clone();
+                tokio::spawn(async move {
+                    let mut received = Vec::new();
+                    let mut buffer = [0u8; 1024];
+                    loop {
+                        let Some(end) =
+                            received.windows(4).position(|window| window == b"\r\n\r\n")
+                        else {
+                            match stream.read(&mut buffer).await {
+                                Ok(0) | Err(_) => break,
+                                Ok(n) => received.extend_from_slice(&buffer[..n]),
+                            }
+                            continue;
+                        };
+                        received.drain(..end + 4);
+
+                        let current = in_flight.fetch_add(1, Ordering::SeqCst) + 1;
+                        max_in_flight.fetch_max(current, Ordering::SeqCst);
+                        tokio::time::sleep(delay).await;
+                        in_flight.fetch_sub(1, Ordering::SeqCst);
+                        if stream
+                            .write_all(b"HTTP/1.1 200 OK\r\ncontent-length: 2\r\n\r\nok")
+                            .await
+                            .is_err()
+                        {
+                            break;
+                        }
+                    }
+                });
+            }
+        });
+
+        TestServer {
+            port,
+            connections,
+            max_in_flight,
+        }
+    }
+
+    fn pool(max_concurrent_requests_per_host: usize) -> HttpConnectionPool {
+        HttpConnectionPool::new(&OutgoingHttpConfig {
+            connection_pool: true,
+            max_idle_connections_per_host: 32,
+            idle_timeout: Duration::from_secs(90),
+            max_concurrent_requests_per_host,
+        })
+    }
+
+    async fn get(
+        pool: &HttpConnectionPool,
+        port: u16,
+        connect_timeout: Duration,
+        first_byte_timeout: Duration,
+    ) -> Result<Bytes, ErrorCode> {
+        let config = OutgoingRequestConfig {
+            use_tls: false,
+            connect_timeout,
+            first_byte_timeout,
+            between_bytes_timeout: Duration::from_secs(10),
+        };
+        let request = hyper::Request::builder()
+            .uri(format!("127.0.0.1:{port}"))
+            .body::<HyperOutgoingBody>(Empty::new().map_err(|never| match never {}).boxed())
+            .unwrap();
+        let request = absolute_uri(request, config.use_tls)?;
+        let limit = pool.limit_of(&request);
+        let response =
+            HttpConnectionPool::send(pool.client.clone(), limit, request, config).await?;
+        Ok(response.resp.into_body().collect().await?.to_bytes())
+    }
+
+    #[tokio::test]
+    async fn connections_are_reused() {
+        let server = start_server(Duration::ZERO).await;
+        let pool = pool(16);
+        let timeout = Duration::from_secs(5);
+
+        for _ in 0..3 {
+            let body = get(&pool, server.port, timeout, timeout).await.unwrap();
+            assert_eq!(body, Bytes::from_static(b"ok"));
+        }
+
+        assert_eq!(server.connections.load(Ordering::SeqCst), 1);
+        assert!(pool.permits.is_empty());
+    }
+
+    #[tokio::test]
+    async fn concurrent_requests_are_limited_per_host() {
+        let server = start_server(Duration::from_millis(100)).await;
+        let pool = pool(2);
+        let timeout = Duration::from_secs(5);
+
+        let results =
+            futures::future::join_all((0..6).map(|_| get(&pool, server.port, timeout, timeout)))
+                .await;
+
+        assert!(results.iter().all(|result| result.is_ok()));
+        assert!(server.max_in_flight.load(Ordering::SeqCst) <= 2);
+        assert!(server.connections.load(Ordering::SeqCst) <= 2);
+        assert!(pool.permits.is_empty());
+    }
+
+    #[tokio::test]
+    async fn connect_and_first_byte_timeouts_are_combined() {
+        let pool = pool(16);
+        let timeout = Duration::from_millis(200);
+
+        // Slower than the first byte timeout alone, but within the combined deadline
+        let server = start_server(Duration::from_millis(300)).await;
+        assert!(get(&pool, server.port, timeout, timeout).await.is_ok());
+
+        let server = start_server(Duration::from_secs(10)).await;
+        let start = Instant::now();
+        let result = get(&pool, server.port, timeout, timeout).await;
+        assert!(matches!(result, Err(ErrorCode::ConnectionReadTimeout)));
+        assert!(start.elapsed() < Duration::from_secs(5));
+        assert!(pool.permits.is_empty());
+    }
+
+    #[tokio::test]
+    async fn permits_are_released_with_the_response_headers() {
+        let server = start_server(Duration::ZERO).await;
+        let pool = pool(1);
+        let config = OutgoingRequestConfig {
+            use_tls: false,
+            connect_timeout: Duration::from_secs(5),
+            first_byte_timeout: Duration::from_secs(5),
+            between_bytes_timeout: Duration::from_secs(5),
+        };
+        let request = hyper::Request::builder()
+            .uri(format!("127.0.0.1:{}", server.port))
+            .body::<HyperOutgoingBody>(Empty::new().map_err(|never| match never {}).boxed())
+            .unwrap();
+        let request = absolute_uri(request, config.use_tls).unwrap();
+        let limit = pool.limit_of(&request);
+
+        let response = HttpConnectionPool::send(pool.client.clone(), limit, request, config)
+            .await
+            .unwrap();
+
+        // The body is not read yet, but the next request to the host can already be sent
+        assert!(pool.permits.is_empty());
+        let timeout = Duration::from_secs(5);
+        assert!(get(&pool, server.port, timeout, timeout).await.is_ok());
+        drop(response);
+    }
+
+    #[tokio::test]
+    async fn connect_errors_are_mapped() {
+        let pool = pool(16);
+        let timeout = Duration::from_secs(5);
+
+        let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+        let port = listener.local_addr().unwrap().port();
+        drop(listener);
+        let result = get(&pool, port, timeout, timeout).await;
+        assert!(matches!(result, Err(ErrorCode::ConnectionRefused)));
+
+        let config = OutgoingRequestConfig {
+            use_tls: false,
+            connect_timeout: timeout,
+            first_byte_timeout: timeout,
+            between_bytes_timeout: timeout,
+        };
+        let request = hyper::Request::builder()
+            .uri("unknown-host.invalid")
+            .body::<HyperOutgoingBody>(Empty::new().map_err(|never| match never {}).boxed())
+            .unwrap();
+        let request = absolute_uri(request, config.use_tls).unwrap();
+        let limit = pool.limit_of(&request);
+        let result = HttpConnectionPool::send(pool.client.clone(), limit, request, config).await;
+        assert!(matches!(result, Err(ErrorCode::DnsError(_))));
+        assert!(pool.permits.is_empty());
+    }
+}
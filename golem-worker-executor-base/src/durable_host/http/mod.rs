@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+/// Executor-wide connection pool for the outgoing HTTP requests
+pub mod connection_pool;
+
 pub mod outgoing_http;
 
 /// Serializable response data structures to be stored in the oplog
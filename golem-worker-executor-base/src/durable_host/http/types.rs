@@ -50,7 +50,7 @@ use wasmtime_wasi_http::{HttpError, HttpResult};
 
 impl<Ctx: WorkerCtx> HostFields for DurableWorkerCtx<Ctx> {
     fn new(&mut self) -> anyhow::Result<Resource<Fields>> {
-        record_host_function_call("http::types::fields", "new");
+        let _timer = record_host_function_call("http::types::fields", "new");
         HostFields::new(&mut self.as_wasi_http_view())
     }
 
@@ -58,17 +58,17 @@ impl<Ctx: WorkerCtx> HostFields for DurableWorkerCtx<Ctx> {
         &mut self,
         entries: Vec<(FieldKey, FieldValue)>,
     ) -> anyhow::Result<Result<Resource<Fields>, HeaderError>> {
-        record_host_function_call("http::types::fields", "from_list");
+        let _timer = record_host_function_call("http::types::fields", "from_list");
         HostFields::from_list(&mut self.as_wasi_http_view(), entries)
     }
 
     fn get(&mut self, self_: Resource<Fields>, name: FieldKey) -> anyhow::Result<Vec<FieldValue>> {
-        record_host_function_call("http::types::fields", "get");
+        let _timer = record_host_function_call("http::types::fields", "get");
         HostFields::get(&mut self.as_wasi_http_view(), self_, name)
     }
 
     fn has(&mut self, self_: Resource<Fields>, name: FieldKey) -> anyhow::Result<bool> {
-        record_host_function_call("http::types::fields", "has");
+        let _timer = record_host_function_call("http::types::fields", "has");
         HostFields::has(&mut self.as_wasi_http_view(), self_, name)
     }
 
@@ -78,7 +78,7 @@ impl<Ctx: WorkerCtx> HostFields for DurableWorkerCtx<Ctx> {
         name: FieldKey,
         value: Vec<FieldValue>,
     ) -> anyhow::Result<Result<(), HeaderError>> {
-        record_host_function_call("http::types::fields", "set");
+        let _timer = record_host_function_call("http::types::fields", "set");
         HostFields::set(&mut self.as_wasi_http_view(), self_, name, value)
     }
 
@@ -87,7 +87,7 @@ impl<Ctx: WorkerCtx> HostFields for DurableWorkerCtx<Ctx> {
         self_: Resource<Fields>,
         name: FieldKey,
     ) -> anyhow::Result<Result<(), HeaderError>> {
-        record_host_function_call("http::types::fields", "delete");
+        let _timer = record_host_function_call("http::types::fields", "delete");
         HostFields::delete(&mut self.as_wasi_http_view(), self_, name)
     }
 
@@ -97,29 +97,29 @@ impl<Ctx: WorkerCtx> HostFields for DurableWorkerCtx<Ctx> {
         name: FieldKey,
         value: FieldValue,
     ) -> anyhow::Result<Result<(), HeaderError>> {
-        record_host_function_call("http::types::fields", "append");
+        let _timer = record_host_function_call("http::types::fields", "append");
         HostFields::append(&mut self.as_wasi_http_view(), self_, name, value)
     }
 
     fn entries(&mut self, self_: Resource<Fields>) -> anyhow::Result<Vec<(FieldKey, FieldValue)>> {
-        record_host_function_call("http::types::fields", "entries");
+        let _timer = record_host_function_call("http::types::fields", "entries");
         HostFields::entries(&mut self.as_wasi_http_view(), self_)
     }
 
     fn clone(&mut self, self_: Resource<Fields>) -> anyhow::Result<Resource<Fields>> {
-        record_host_function_call("http::types::fields", "clone");
+        let _timer = record_host_function_call("http::types::fields", "clone");
         HostFields::clone(&mut self.as_wasi_http_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<Fields>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::fields", "drop");
+        let _timer = record_host_function_call("http::types::fields", "drop");
         HostFields::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
 
 impl<Ctx: WorkerCtx> HostIncomingRequest for DurableWorkerCtx<Ctx> {
     fn method(&mut self, self_: Resource<IncomingRequest>) -> anyhow::Result<Method> {
-        record_host_function_call("http::types::incoming_request", "method");
+        let _timer = record_host_function_call("http::types::incoming_request", "method");
         HostIncomingRequest::method(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -127,22 +127,22 @@ impl<Ctx: WorkerCtx> HostIncomingRequest for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<IncomingRequest>,
     ) -> anyhow::Result<Option<String>> {
-        record_host_function_call("http::types::incoming_request", "path_with_query");
+        let _timer = record_host_function_call("http::types::incoming_request", "path_with_query");
         HostIncomingRequest::path_with_query(&mut self.as_wasi_http_view(), self_)
     }
 
     fn scheme(&mut self, self_: Resource<IncomingRequest>) -> anyhow::Result<Option<Scheme>> {
-        record_host_function_call("http::types::incoming_request", "scheme");
+        let _timer = record_host_function_call("http::types::incoming_request", "scheme");
         HostIncomingRequest::scheme(&mut self.as_wasi_http_view(), self_)
     }
 
     fn authority(&mut self, self_: Resource<IncomingRequest>) -> anyhow::Result<Option<String>> {
-        record_host_function_call("http::types::incoming_request", "authority");
+        let _timer = record_host_function_call("http::types::incoming_request", "authority");
         HostIncomingRequest::authority(&mut self.as_wasi_http_view(), self_)
     }
 
     fn headers(&mut self, self_: Resource<IncomingRequest>) -> anyhow::Result<Resource<Headers>> {
-        record_host_function_call("http::types::incoming_request", "headers");
+        let _timer = record_host_function_call("http::types::incoming_request", "headers");
         HostIncomingRequest::headers(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -150,19 +150,19 @@ impl<Ctx: WorkerCtx> HostIncomingRequest for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<IncomingRequest>,
     ) -> anyhow::Result<Result<Resource<IncomingBody>, ()>> {
-        record_host_function_call("http::types::incoming_request", "consume");
+        let _timer = record_host_function_call("http::types::incoming_request", "consume");
         HostIncomingRequest::consume(&mut self.as_wasi_http_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<IncomingRequest>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::incoming_request", "drop");
+        let _timer = record_host_function_call("http::types::incoming_request", "drop");
         HostIncomingRequest::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
 
 impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
     fn new(&mut self, headers: Resource<Headers>) -> anyhow::Result<Resource<OutgoingRequest>> {
-        record_host_function_call("http::types::outgoing_request", "new");
+        let _timer = record_host_function_call("http::types::outgoing_request", "new");
         HostOutgoingRequest::new(&mut self.as_wasi_http_view(), headers)
     }
 
@@ -170,12 +170,12 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<OutgoingRequest>,
     ) -> anyhow::Result<Result<Resource<OutgoingBody>, ()>> {
-        record_host_function_call("http::types::outgoing_request", "body");
+        let _timer = record_host_function_call("http::types::outgoing_request", "body");
         HostOutgoingRequest::body(&mut self.as_wasi_http_view(), self_)
     }
 
     fn method(&mut self, self_: Resource<OutgoingRequest>) -> anyhow::Result<Method> {
-        record_host_function_call("http::types::outgoing_request", "method");
+        let _timer = record_host_function_call("http::types::outgoing_request", "method");
         HostOutgoingRequest::method(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -184,7 +184,7 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
         self_: Resource<OutgoingRequest>,
         method: Method,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::outgoing_request", "set_method");
+        let _timer = record_host_function_call("http::types::outgoing_request", "set_method");
         HostOutgoingRequest::set_method(&mut self.as_wasi_http_view(), self_, method)
     }
 
@@ -192,7 +192,7 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<OutgoingRequest>,
     ) -> anyhow::Result<Option<String>> {
-        record_host_function_call("http::types::outgoing_request", "path_with_query");
+        let _timer = record_host_function_call("http::types::outgoing_request", "path_with_query");
         HostOutgoingRequest::path_with_query(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -201,7 +201,8 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
         self_: Resource<OutgoingRequest>,
         path_with_query: Option<String>,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::outgoing_request", "set_path_with_query");
+        let _timer =
+            record_host_function_call("http::types::outgoing_request", "set_path_with_query");
         HostOutgoingRequest::set_path_with_query(
             &mut self.as_wasi_http_view(),
             self_,
@@ -210,7 +211,7 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
     }
 
     fn scheme(&mut self, self_: Resource<OutgoingRequest>) -> anyhow::Result<Option<Scheme>> {
-        record_host_function_call("http::types::outgoing_request", "scheme");
+        let _timer = record_host_function_call("http::types::outgoing_request", "scheme");
         HostOutgoingRequest::scheme(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -219,12 +220,12 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
         self_: Resource<OutgoingRequest>,
         scheme: Option<Scheme>,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::outgoing_request", "set_scheme");
+        let _timer = record_host_function_call("http::types::outgoing_request", "set_scheme");
         HostOutgoingRequest::set_scheme(&mut self.as_wasi_http_view(), self_, scheme)
     }
 
     fn authority(&mut self, self_: Resource<OutgoingRequest>) -> anyhow::Result<Option<String>> {
-        record_host_function_call("http::types::outgoing_request", "authority");
+        let _timer = record_host_function_call("http::types::outgoing_request", "authority");
         HostOutgoingRequest::authority(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -233,17 +234,17 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
         self_: Resource<OutgoingRequest>,
         authority: Option<String>,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::outgoing_request", "set_authority");
+        let _timer = record_host_function_call("http::types::outgoing_request", "set_authority");
         HostOutgoingRequest::set_authority(&mut self.as_wasi_http_view(), self_, authority)
     }
 
     fn headers(&mut self, self_: Resource<OutgoingRequest>) -> anyhow::Result<Resource<Headers>> {
-        record_host_function_call("http::types::outgoing_request", "headers");
+        let _timer = record_host_function_call("http::types::outgoing_request", "headers");
         HostOutgoingRequest::headers(&mut self.as_wasi_http_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<OutgoingRequest>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::outgoing_request", "drop");
+        let _timer = record_host_function_call("http::types::outgoing_request", "drop");
         HostOutgoingRequest::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -251,7 +252,7 @@ impl<Ctx: WorkerCtx> HostOutgoingRequest for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
     fn new(&mut self) -> anyhow::Result<Resource<RequestOptions>> {
-        record_host_function_call("http::types::request_options", "new");
+        let _timer = record_host_function_call("http::types::request_options", "new");
         HostRequestOptions::new(&mut self.as_wasi_http_view())
     }
 
@@ -259,7 +260,8 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<RequestOptions>,
     ) -> anyhow::Result<Option<Duration>> {
-        record_host_function_call("http::types::request_options", "connect_timeout_ms");
+        let _timer =
+            record_host_function_call("http::types::request_options", "connect_timeout_ms");
         HostRequestOptions::connect_timeout(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -268,7 +270,8 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
         self_: Resource<RequestOptions>,
         ms: Option<Duration>,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::request_options", "set_connect_timeout_ms");
+        let _timer =
+            record_host_function_call("http::types::request_options", "set_connect_timeout_ms");
         HostRequestOptions::set_connect_timeout(&mut self.as_wasi_http_view(), self_, ms)
     }
 
@@ -276,7 +279,8 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<RequestOptions>,
     ) -> anyhow::Result<Option<Duration>> {
-        record_host_function_call("http::types::request_options", "first_byte_timeout_ms");
+        let _timer =
+            record_host_function_call("http::types::request_options", "first_byte_timeout_ms");
         HostRequestOptions::first_byte_timeout(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -285,7 +289,8 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
         self_: Resource<RequestOptions>,
         ms: Option<Duration>,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::request_options", "set_first_byte_timeout_ms");
+        let _timer =
+            record_host_function_call("http::types::request_options", "set_first_byte_timeout_ms");
         HostRequestOptions::set_first_byte_timeout(&mut self.as_wasi_http_view(), self_, ms)
     }
 
@@ -293,7 +298,8 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<RequestOptions>,
     ) -> anyhow::Result<Option<Duration>> {
-        record_host_function_call("http::types::request_options", "between_bytes_timeout_ms");
+        let _timer =
+            record_host_function_call("http::types::request_options", "between_bytes_timeout_ms");
         HostRequestOptions::between_bytes_timeout(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -302,7 +308,7 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
         self_: Resource<RequestOptions>,
         ms: Option<Duration>,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "http::types::request_options",
             "set_between_bytes_timeout_ms",
         );
@@ -310,7 +316,7 @@ impl<Ctx: WorkerCtx> HostRequestOptions for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<RequestOptions>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::request_options", "drop");
+        let _timer = record_host_function_call("http::types::request_options", "drop");
         HostRequestOptions::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -322,12 +328,12 @@ impl<Ctx: WorkerCtx> HostResponseOutparam for DurableWorkerCtx<Ctx> {
         param: Resource<ResponseOutparam>,
         response: Result<Resource<OutgoingResponse>, ErrorCode>,
     ) -> anyhow::Result<()> {
-        record_host_function_call("http::types::response_outparam", "set");
+        let _timer = record_host_function_call("http::types::response_outparam", "set");
         HostResponseOutparam::set(&mut self.as_wasi_http_view(), param, response)
     }
 
     fn drop(&mut self, rep: Resource<ResponseOutparam>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::response_outparam", "drop");
+        let _timer = record_host_function_call("http::types::response_outparam", "drop");
         HostResponseOutparam::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -335,12 +341,12 @@ impl<Ctx: WorkerCtx> HostResponseOutparam for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> HostIncomingResponse for DurableWorkerCtx<Ctx> {
     fn status(&mut self, self_: Resource<IncomingResponse>) -> anyhow::Result<StatusCode> {
-        record_host_function_call("http::types::incoming_response", "status");
+        let _timer = record_host_function_call("http::types::incoming_response", "status");
         HostIncomingResponse::status(&mut self.as_wasi_http_view(), self_)
     }
 
     fn headers(&mut self, self_: Resource<IncomingResponse>) -> anyhow::Result<Resource<Headers>> {
-        record_host_function_call("http::types::incoming_response", "headers");
+        let _timer = record_host_function_call("http::types::incoming_response", "headers");
         HostIncomingResponse::headers(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -348,12 +354,12 @@ impl<Ctx: WorkerCtx> HostIncomingResponse for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<IncomingResponse>,
     ) -> anyhow::Result<Result<Resource<IncomingBody>, ()>> {
-        record_host_function_call("http::types::incoming_response", "consume");
+        let _timer = record_host_function_call("http::types::incoming_response", "consume");
         HostIncomingResponse::consume(&mut self.as_wasi_http_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<IncomingResponse>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::incoming_response", "drop");
+        let _timer = record_host_function_call("http::types::incoming_response", "drop");
         HostIncomingResponse::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -364,17 +370,17 @@ impl<Ctx: WorkerCtx> HostIncomingBody for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<IncomingBody>,
     ) -> anyhow::Result<Result<Resource<InputStream>, ()>> {
-        record_host_function_call("http::types::incoming_body", "stream");
+        let _timer = record_host_function_call("http::types::incoming_body", "stream");
         HostIncomingBody::stream(&mut self.as_wasi_http_view(), self_)
     }
 
     fn finish(&mut self, this: Resource<IncomingBody>) -> anyhow::Result<Resource<FutureTrailers>> {
-        record_host_function_call("http::types::incoming_body", "finish");
+        let _timer = record_host_function_call("http::types::incoming_body", "finish");
         HostIncomingBody::finish(&mut self.as_wasi_http_view(), this)
     }
 
     fn drop(&mut self, rep: Resource<IncomingBody>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::incoming_body", "drop");
+        let _timer = record_host_function_call("http::types::incoming_body", "drop");
         HostIncomingBody::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -382,7 +388,7 @@ impl<Ctx: WorkerCtx> HostIncomingBody for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> HostFutureTrailers for DurableWorkerCtx<Ctx> {
     fn subscribe(&mut self, self_: Resource<FutureTrailers>) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("http::types::future_trailers", "subscribe");
+        let _timer = record_host_function_call("http::types::future_trailers", "subscribe");
         HostFutureTrailers::subscribe(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -390,7 +396,7 @@ impl<Ctx: WorkerCtx> HostFutureTrailers for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<FutureTrailers>,
     ) -> anyhow::Result<Option<Result<Result<Option<Resource<Trailers>>, ErrorCode>, ()>>> {
-        record_host_function_call("http::types::future_trailers", "get");
+        let _timer = record_host_function_call("http::types::future_trailers", "get");
         Durability::<
             Ctx,
             Option<Result<Result<Option<HashMap<String, Vec<u8>>>, SerializableErrorCode>, ()>>,
@@ -449,7 +455,7 @@ impl<Ctx: WorkerCtx> HostFutureTrailers for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<FutureTrailers>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::future_trailers", "drop");
+        let _timer = record_host_function_call("http::types::future_trailers", "drop");
         HostFutureTrailers::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -457,12 +463,12 @@ impl<Ctx: WorkerCtx> HostFutureTrailers for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> HostOutgoingResponse for DurableWorkerCtx<Ctx> {
     fn new(&mut self, headers: Resource<Headers>) -> anyhow::Result<Resource<OutgoingResponse>> {
-        record_host_function_call("http::types::outgoing_response", "new");
+        let _timer = record_host_function_call("http::types::outgoing_response", "new");
         HostOutgoingResponse::new(&mut self.as_wasi_http_view(), headers)
     }
 
     fn status_code(&mut self, self_: Resource<OutgoingResponse>) -> anyhow::Result<StatusCode> {
-        record_host_function_call("http::types::outgoing_response", "status_code");
+        let _timer = record_host_function_call("http::types::outgoing_response", "status_code");
         HostOutgoingResponse::status_code(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -471,12 +477,12 @@ impl<Ctx: WorkerCtx> HostOutgoingResponse for DurableWorkerCtx<Ctx> {
         self_: Resource<OutgoingResponse>,
         status_code: StatusCode,
     ) -> anyhow::Result<Result<(), ()>> {
-        record_host_function_call("http::types::outgoing_response", "set_status_code");
+        let _timer = record_host_function_call("http::types::outgoing_response", "set_status_code");
         HostOutgoingResponse::set_status_code(&mut self.as_wasi_http_view(), self_, status_code)
     }
 
     fn headers(&mut self, self_: Resource<OutgoingResponse>) -> anyhow::Result<Resource<Headers>> {
-        record_host_function_call("http::types::outgoing_response", "headers");
+        let _timer = record_host_function_call("http::types::outgoing_response", "headers");
         HostOutgoingResponse::headers(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -484,12 +490,12 @@ impl<Ctx: WorkerCtx> HostOutgoingResponse for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<OutgoingResponse>,
     ) -> anyhow::Result<Result<Resource<OutgoingBody>, ()>> {
-        record_host_function_call("http::types::outgoing_response", "body");
+        let _timer = record_host_function_call("http::types::outgoing_response", "body");
         HostOutgoingResponse::body(&mut self.as_wasi_http_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<OutgoingResponse>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::outgoing_response", "drop");
+        let _timer = record_host_function_call("http::types::outgoing_response", "drop");
         HostOutgoingResponse::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -500,7 +506,7 @@ impl<Ctx: WorkerCtx> HostOutgoingBody for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<OutgoingBody>,
     ) -> anyhow::Result<Result<Resource<OutputStream>, ()>> {
-        record_host_function_call("http::types::outgoing_body", "write");
+        let _timer = record_host_function_call("http::types::outgoing_body", "write");
         HostOutgoingBody::write(&mut self.as_wasi_http_view(), self_)
     }
 
@@ -509,12 +515,12 @@ impl<Ctx: WorkerCtx> HostOutgoingBody for DurableWorkerCtx<Ctx> {
         this: Resource<OutgoingBody>,
         trailers: Option<Resource<Trailers>>,
     ) -> HttpResult<()> {
-        record_host_function_call("http::types::outgoing_body", "finish");
+        let _timer = record_host_function_call("http::types::outgoing_body", "finish");
         HostOutgoingBody::finish(&mut self.as_wasi_http_view(), this, trailers)
     }
 
     fn drop(&mut self, rep: Resource<OutgoingBody>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::outgoing_body", "drop");
+        let _timer = record_host_function_call("http::types::outgoing_body", "drop");
         HostOutgoingBody::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
@@ -525,7 +531,8 @@ impl<Ctx: WorkerCtx> HostFutureIncomingResponse for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<FutureIncomingResponse>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("http::types::future_incoming_response", "subscribe");
+        let _timer =
+            record_host_function_call("http::types::future_incoming_response", "subscribe");
         // In replay mode the future is in Deferred state for which the built-in Subscribe implementation immediately returns.
         // This is exactly what we want for replay mode. In live mode the future is in Pending state until the response is
         // available, and the returned Pollable will wait for the request task to finish.
@@ -536,7 +543,7 @@ impl<Ctx: WorkerCtx> HostFutureIncomingResponse for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<FutureIncomingResponse>,
     ) -> anyhow::Result<Option<Result<Result<Resource<IncomingResponse>, ErrorCode>, ()>>> {
-        record_host_function_call("http::types::future_incoming_response", "get");
+        let _timer = record_host_function_call("http::types::future_incoming_response", "get");
         // Each get call is stored in the oplog. If the result was Error or None (future is pending), we just
         // continue the replay. If the result was Ok, we return register the stored response to the table as a new
         // HostIncomingResponse and return its reference.
@@ -644,19 +651,19 @@ impl<Ctx: WorkerCtx> HostFutureIncomingResponse for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<FutureIncomingResponse>) -> anyhow::Result<()> {
-        record_host_function_call("http::types::future_incoming_response", "drop");
+        let _timer = record_host_function_call("http::types::future_incoming_response", "drop");
         HostFutureIncomingResponse::drop(&mut self.as_wasi_http_view(), rep)
     }
 }
 
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn http_error_code(&mut self, err: Resource<IoError>) -> anyhow::Result<Option<ErrorCode>> {
-        record_host_function_call("http::types", "http_error_code");
+        let _timer = record_host_function_call("http::types", "http_error_code");
         Host::http_error_code(&mut self.as_wasi_http_view(), err)
     }
 
     fn convert_error_code(&mut self, err: HttpError) -> wasmtime::Result<ErrorCode> {
-        record_host_function_call("http::types", "convert_error_code");
+        let _timer = record_host_function_call("http::types", "convert_error_code");
         Host::convert_error_code(&mut self.as_wasi_http_view(), err)
     }
 }
@@ -22,12 +22,12 @@ use wasmtime_wasi::bindings::io::error::{Error, Host, HostError};
 #[async_trait]
 impl<Ctx: WorkerCtx> HostError for DurableWorkerCtx<Ctx> {
     fn to_debug_string(&mut self, self_: Resource<Error>) -> anyhow::Result<String> {
-        record_host_function_call("io::error", "to_debug_string");
+        let _timer = record_host_function_call("io::error", "to_debug_string");
         HostError::to_debug_string(&mut self.as_wasi_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<Error>) -> anyhow::Result<()> {
-        record_host_function_call("io::error", "drop");
+        let _timer = record_host_function_call("io::error", "drop");
         HostError::drop(&mut self.as_wasi_view(), rep)
     }
 }
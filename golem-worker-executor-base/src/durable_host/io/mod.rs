@@ -17,6 +17,7 @@ use anyhow::anyhow;
 use async_trait::async_trait;
 use bytes::Bytes;
 use std::any::Any;
+use std::io::IoSlice;
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
 use std::time::Duration;
@@ -203,7 +204,11 @@ impl ManagedStdOut {
         let handle = tokio::spawn(async move {
             loop {
                 let bytes: Bytes = outgoing_rx.recv_async().await.unwrap();
-                let _ = io_clone.write(&bytes).await;
+                // Writing everything queued up so far in one go
+                let mut chunks = vec![bytes];
+                chunks.extend(outgoing_rx.try_iter());
+                let slices: Vec<IoSlice> = chunks.iter().map(|chunk| IoSlice::new(chunk)).collect();
+                let _ = io_clone.write_vectored(&slices).await;
 
                 if outgoing_rx.is_empty() {
                     dirty_clone.store(false, Ordering::Relaxed);
@@ -27,19 +27,19 @@ use crate::workerctx::WorkerCtx;
 #[async_trait]
 impl<Ctx: WorkerCtx> HostPollable for DurableWorkerCtx<Ctx> {
     async fn ready(&mut self, self_: Resource<Pollable>) -> anyhow::Result<bool> {
-        record_host_function_call("io::poll:pollable", "ready");
+        let _timer = record_host_function_call("io::poll:pollable", "ready");
         HostPollable::ready(&mut self.as_wasi_view(), self_).await
     }
 
     async fn block(&mut self, self_: Resource<Pollable>) -> anyhow::Result<()> {
-        record_host_function_call("io::poll:pollable", "block");
+        let _timer = record_host_function_call("io::poll:pollable", "block");
         let in_ = vec![self_];
         let _ = self.poll(in_).await?;
         Ok(())
     }
 
     fn drop(&mut self, rep: Resource<Pollable>) -> anyhow::Result<()> {
-        record_host_function_call("io::poll:pollable", "drop");
+        let _timer = record_host_function_call("io::poll:pollable", "drop");
         HostPollable::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -47,7 +47,10 @@ impl<Ctx: WorkerCtx> HostPollable for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn poll(&mut self, in_: Vec<Resource<Pollable>>) -> anyhow::Result<Vec<u32>> {
-        record_host_function_call("io::poll", "poll");
+        let _timer = record_host_function_call("io::poll", "poll");
+
+        // Not holding back buffered output while the worker is waiting
+        self.flush_output();
 
         let result = Durability::<Ctx, Vec<u32>, SerializableError>::wrap_conditionally(
             self,
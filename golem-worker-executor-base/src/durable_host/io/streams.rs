@@ -23,6 +23,7 @@ use crate::durable_host::{Durability, DurableWorkerCtx};
 use crate::error::GolemError;
 use crate::metrics::wasm::record_host_function_call;
 use crate::model::PersistenceLevel;
+use crate::services::worker_event::OutputStreamKind;
 use crate::workerctx::WorkerCtx;
 use golem_common::model::oplog::WrappedFunctionType;
 use wasmtime_wasi::bindings::io::streams::{
@@ -37,7 +38,7 @@ impl<Ctx: WorkerCtx> HostInputStream for DurableWorkerCtx<Ctx> {
         self_: Resource<InputStream>,
         len: u64,
     ) -> Result<Vec<u8>, StreamError> {
-        record_host_function_call("io::streams::input_stream", "read");
+        let _timer = record_host_function_call("io::streams::input_stream", "read");
         if is_incoming_http_body_stream(self.table(), &self_) {
             Durability::<Ctx, Vec<u8>, SerializableStreamError>::wrap(
                 self,
@@ -60,7 +61,7 @@ impl<Ctx: WorkerCtx> HostInputStream for DurableWorkerCtx<Ctx> {
         self_: Resource<InputStream>,
         len: u64,
     ) -> Result<Vec<u8>, StreamError> {
-        record_host_function_call("io::streams::input_stream", "blocking_read");
+        let _timer = record_host_function_call("io::streams::input_stream", "blocking_read");
         if is_incoming_http_body_stream(self.table(), &self_) {
             Durability::<Ctx, Vec<u8>, SerializableStreamError>::wrap(
                 self,
@@ -79,7 +80,7 @@ impl<Ctx: WorkerCtx> HostInputStream for DurableWorkerCtx<Ctx> {
     }
 
     async fn skip(&mut self, self_: Resource<InputStream>, len: u64) -> Result<u64, StreamError> {
-        record_host_function_call("io::streams::input_stream", "skip");
+        let _timer = record_host_function_call("io::streams::input_stream", "skip");
         if is_incoming_http_body_stream(self.table(), &self_) {
             Durability::<Ctx, u64, SerializableStreamError>::wrap(
                 self,
@@ -102,7 +103,7 @@ impl<Ctx: WorkerCtx> HostInputStream for DurableWorkerCtx<Ctx> {
         self_: Resource<InputStream>,
         len: u64,
     ) -> Result<u64, StreamError> {
-        record_host_function_call("io::streams::input_stream", "blocking_skip");
+        let _timer = record_host_function_call("io::streams::input_stream", "blocking_skip");
         if is_incoming_http_body_stream(self.table(), &self_) {
             Durability::<Ctx, u64, SerializableStreamError>::wrap(
                 self,
@@ -121,12 +122,12 @@ impl<Ctx: WorkerCtx> HostInputStream for DurableWorkerCtx<Ctx> {
     }
 
     fn subscribe(&mut self, self_: Resource<InputStream>) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("io::streams::input_stream", "subscribe");
+        let _timer = record_host_function_call("io::streams::input_stream", "subscribe");
         HostInputStream::subscribe(&mut self.as_wasi_view(), self_)
     }
 
     fn drop(&mut self, rep: Resource<InputStream>) -> anyhow::Result<()> {
-        record_host_function_call("io::streams::input_stream", "drop");
+        let _timer = record_host_function_call("io::streams::input_stream", "drop");
         HostInputStream::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -134,7 +135,7 @@ impl<Ctx: WorkerCtx> HostInputStream for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
     fn check_write(&mut self, self_: Resource<OutputStream>) -> Result<u64, StreamError> {
-        record_host_function_call("io::streams::output_stream", "check_write");
+        let _timer = record_host_function_call("io::streams::output_stream", "check_write");
         HostOutputStream::check_write(&mut self.as_wasi_view(), self_)
     }
 
@@ -143,24 +144,23 @@ impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
         self_: Resource<OutputStream>,
         contents: Vec<u8>,
     ) -> Result<(), StreamError> {
-        record_host_function_call("io::streams::output_stream", "write");
+        let _timer = record_host_function_call("io::streams::output_stream", "write");
 
-        let event_service = self.public_state.event_service.clone();
-
-        let mut is_std = false;
         let is_live = self.state.is_live()
             || self.state.persistence_level == PersistenceLevel::PersistNothing;
         let output = self.table().get(&self_)?;
-        if output.as_any().downcast_ref::<ManagedStdOut>().is_some() {
-            if is_live {
-                event_service.emit_stdout(contents.clone());
-            }
-            is_std = true;
+        let std_kind = if output.as_any().downcast_ref::<ManagedStdOut>().is_some() {
+            Some(OutputStreamKind::StdOut)
         } else if output.as_any().downcast_ref::<ManagedStdErr>().is_some() {
-            if is_live {
-                event_service.emit_stderr(contents.clone());
+            Some(OutputStreamKind::StdErr)
+        } else {
+            None
+        };
+        let is_std = std_kind.is_some();
+        if is_live {
+            if let Some(kind) = std_kind {
+                self.emit_output(kind, &contents);
             }
-            is_std = true;
         }
 
         if !is_std || is_live {
@@ -175,24 +175,24 @@ impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
         self_: Resource<OutputStream>,
         contents: Vec<u8>,
     ) -> Result<(), StreamError> {
-        record_host_function_call("io::streams::output_stream", "blocking_write_and_flush");
+        let _timer =
+            record_host_function_call("io::streams::output_stream", "blocking_write_and_flush");
 
-        let event_service = self.public_state.event_service.clone();
-
-        let mut is_std = false;
         let is_live = self.state.is_live()
             || self.state.persistence_level == PersistenceLevel::PersistNothing;
         let output = self.table().get(&self_)?;
-        if output.as_any().downcast_ref::<ManagedStdOut>().is_some() {
-            if is_live {
-                event_service.emit_stdout(contents.clone());
-            }
-            is_std = true;
+        let std_kind = if output.as_any().downcast_ref::<ManagedStdOut>().is_some() {
+            Some(OutputStreamKind::StdOut)
         } else if output.as_any().downcast_ref::<ManagedStdErr>().is_some() {
-            if is_live {
-                event_service.emit_stderr(contents.clone());
+            Some(OutputStreamKind::StdErr)
+        } else {
+            None
+        };
+        let is_std = std_kind.is_some();
+        if is_live {
+            if let Some(kind) = std_kind {
+                self.emit_output(kind, &contents);
             }
-            is_std = true;
         }
 
         if !is_std || is_live {
@@ -204,22 +204,22 @@ impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
     }
 
     fn flush(&mut self, self_: Resource<OutputStream>) -> Result<(), StreamError> {
-        record_host_function_call("io::streams::output_stream", "flush");
+        let _timer = record_host_function_call("io::streams::output_stream", "flush");
         HostOutputStream::flush(&mut self.as_wasi_view(), self_)
     }
 
     async fn blocking_flush(&mut self, self_: Resource<OutputStream>) -> Result<(), StreamError> {
-        record_host_function_call("io::streams::output_stream", "blocking_flush");
+        let _timer = record_host_function_call("io::streams::output_stream", "blocking_flush");
         HostOutputStream::blocking_flush(&mut self.as_wasi_view(), self_).await
     }
 
     fn subscribe(&mut self, self_: Resource<OutputStream>) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("io::streams::output_stream", "subscribe");
+        let _timer = record_host_function_call("io::streams::output_stream", "subscribe");
         HostOutputStream::subscribe(&mut self.as_wasi_view(), self_)
     }
 
     fn write_zeroes(&mut self, self_: Resource<OutputStream>, len: u64) -> Result<(), StreamError> {
-        record_host_function_call("io::streams::output_stream", "write_zeroeas");
+        let _timer = record_host_function_call("io::streams::output_stream", "write_zeroeas");
         HostOutputStream::write_zeroes(&mut self.as_wasi_view(), self_, len)
     }
 
@@ -228,7 +228,7 @@ impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
         self_: Resource<OutputStream>,
         len: u64,
     ) -> Result<(), StreamError> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "io::streams::output_stream",
             "blocking_write_zeroes_and_flush",
         );
@@ -242,7 +242,7 @@ impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
         src: Resource<InputStream>,
         len: u64,
     ) -> Result<u64, StreamError> {
-        record_host_function_call("io::streams::output_stream", "splice");
+        let _timer = record_host_function_call("io::streams::output_stream", "splice");
         HostOutputStream::splice(&mut self.as_wasi_view(), self_, src, len).await
     }
 
@@ -252,12 +252,12 @@ impl<Ctx: WorkerCtx> HostOutputStream for DurableWorkerCtx<Ctx> {
         src: Resource<InputStream>,
         len: u64,
     ) -> Result<u64, StreamError> {
-        record_host_function_call("io::streams::output_stream", "blocking_splice");
+        let _timer = record_host_function_call("io::streams::output_stream", "blocking_splice");
         HostOutputStream::blocking_splice(&mut self.as_wasi_view(), self_, src, len).await
     }
 
     fn drop(&mut self, rep: Resource<OutputStream>) -> anyhow::Result<()> {
-        record_host_function_call("io::streams::output_stream", "drop");
+        let _timer = record_host_function_call("io::streams::output_stream", "drop");
         HostOutputStream::drop(&mut self.as_wasi_view(), rep)
     }
 }
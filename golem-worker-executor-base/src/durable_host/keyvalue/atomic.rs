@@ -28,7 +28,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         _key: Key,
         _delta: u64,
     ) -> anyhow::Result<Result<u64, Resource<Error>>> {
-        record_host_function_call("keyvalue::atomic", "increment");
+        let _timer = record_host_function_call("keyvalue::atomic", "increment");
         unimplemented!("increment")
     }
 
@@ -39,7 +39,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         _old: u64,
         _new: u64,
     ) -> anyhow::Result<Result<bool, Resource<Error>>> {
-        record_host_function_call("keyvalue::atomic", "compare_and_swap");
+        let _timer = record_host_function_call("keyvalue::atomic", "compare_and_swap");
         unimplemented!("compare_and_swap")
     }
 }
@@ -30,7 +30,8 @@ impl<Ctx: WorkerCtx> HostFutureGetResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureGetResult>,
     ) -> anyhow::Result<Option<Result<Option<Resource<IncomingValue>>, Resource<Error>>>> {
-        record_host_function_call("keyvalue::cache::future_get", "future_get_result_get");
+        let _timer =
+            record_host_function_call("keyvalue::cache::future_get", "future_get_result_get");
         unimplemented!("future_get_result_get")
     }
 
@@ -38,12 +39,13 @@ impl<Ctx: WorkerCtx> HostFutureGetResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureGetResult>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("keyvalue::cache::future_get", "listen_to_future_get_result");
+        let _timer =
+            record_host_function_call("keyvalue::cache::future_get", "listen_to_future_get_result");
         unimplemented!("listen_to_future_get_result")
     }
 
     fn drop(&mut self, _rep: Resource<FutureGetResult>) -> anyhow::Result<()> {
-        record_host_function_call("keyvalue::cache::future_get", "drop");
+        let _timer = record_host_function_call("keyvalue::cache::future_get", "drop");
         unimplemented!("drop")
     }
 }
@@ -54,7 +56,8 @@ impl<Ctx: WorkerCtx> HostFutureExistsResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureExistsResult>,
     ) -> anyhow::Result<Option<Result<bool, Resource<Error>>>> {
-        record_host_function_call("keyvalue::cache::future_exists", "future_exists_result_get");
+        let _timer =
+            record_host_function_call("keyvalue::cache::future_exists", "future_exists_result_get");
         unimplemented!("future_exists_result_get")
     }
 
@@ -62,7 +65,7 @@ impl<Ctx: WorkerCtx> HostFutureExistsResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureExistsResult>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "keyvalue::cache::future_exists",
             "listen_to_future_exists_result",
         );
@@ -70,7 +73,7 @@ impl<Ctx: WorkerCtx> HostFutureExistsResult for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, _rep: Resource<FutureExistsResult>) -> anyhow::Result<()> {
-        record_host_function_call("keyvalue::cache::future_exists", "drop");
+        let _timer = record_host_function_call("keyvalue::cache::future_exists", "drop");
         unimplemented!("drop")
     }
 }
@@ -81,7 +84,8 @@ impl<Ctx: WorkerCtx> HostFutureResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureResult>,
     ) -> anyhow::Result<Option<Result<(), Resource<Error>>>> {
-        record_host_function_call("keyvalue::cache::future_result", "future_result_get");
+        let _timer =
+            record_host_function_call("keyvalue::cache::future_result", "future_result_get");
         unimplemented!("future_result_get")
     }
 
@@ -89,12 +93,13 @@ impl<Ctx: WorkerCtx> HostFutureResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureResult>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("keyvalue::cache::future_result", "listen_to_future_result");
+        let _timer =
+            record_host_function_call("keyvalue::cache::future_result", "listen_to_future_result");
         unimplemented!("listen_to_future_result")
     }
 
     fn drop(&mut self, _rep: Resource<FutureResult>) -> anyhow::Result<()> {
-        record_host_function_call("keyvalue::cache::future_result", "drop");
+        let _timer = record_host_function_call("keyvalue::cache::future_result", "drop");
         unimplemented!("drop")
     }
 }
@@ -105,7 +110,7 @@ impl<Ctx: WorkerCtx> HostFutureGetOrSetResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureGetOrSetResult>,
     ) -> anyhow::Result<Option<Result<GetOrSetEntry, Resource<Error>>>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "keyvalue::cache::future_get_or_set",
             "future_get_or_set_result_get",
         );
@@ -116,7 +121,7 @@ impl<Ctx: WorkerCtx> HostFutureGetOrSetResult for DurableWorkerCtx<Ctx> {
         &mut self,
         _self_: Resource<FutureGetOrSetResult>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "keyvalue::cache::future_get_or_set",
             "listen_to_future_get_or_set_result",
         );
@@ -124,7 +129,7 @@ impl<Ctx: WorkerCtx> HostFutureGetOrSetResult for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, _rep: Resource<FutureGetOrSetResult>) -> anyhow::Result<()> {
-        record_host_function_call("keyvalue::cache::future_get_or_set", "drop");
+        let _timer = record_host_function_call("keyvalue::cache::future_get_or_set", "drop");
         unimplemented!("drop")
     }
 }
@@ -136,12 +141,12 @@ impl<Ctx: WorkerCtx> HostVacancy for DurableWorkerCtx<Ctx> {
         _self_: Resource<Vacancy>,
         _ttl_ms: Option<u32>,
     ) -> anyhow::Result<Resource<OutgoingValue>> {
-        record_host_function_call("keyvalue::cache::vacancy", "vacancy_fill");
+        let _timer = record_host_function_call("keyvalue::cache::vacancy", "vacancy_fill");
         unimplemented!("vacancy_fill")
     }
 
     fn drop(&mut self, _rep: Resource<Vacancy>) -> anyhow::Result<()> {
-        record_host_function_call("keyvalue::cache::vacancy", "drop");
+        let _timer = record_host_function_call("keyvalue::cache::vacancy", "drop");
         unimplemented!("drop")
     }
 }
@@ -149,12 +154,12 @@ impl<Ctx: WorkerCtx> HostVacancy for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn get(&mut self, _k: Key) -> anyhow::Result<Resource<FutureGetResult>> {
-        record_host_function_call("keyvalue::cache", "get");
+        let _timer = record_host_function_call("keyvalue::cache", "get");
         unimplemented!("get")
     }
 
     async fn exists(&mut self, _k: Key) -> anyhow::Result<Resource<FutureExistsResult>> {
-        record_host_function_call("keyvalue::cache", "exists");
+        let _timer = record_host_function_call("keyvalue::cache", "exists");
         unimplemented!("exists")
     }
 
@@ -164,17 +169,17 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         _v: Resource<OutgoingValue>,
         _ttl_ms: Option<u32>,
     ) -> anyhow::Result<Resource<FutureResult>> {
-        record_host_function_call("keyvalue::cache", "set");
+        let _timer = record_host_function_call("keyvalue::cache", "set");
         unimplemented!("set")
     }
 
     async fn get_or_set(&mut self, _k: Key) -> anyhow::Result<Resource<FutureGetOrSetResult>> {
-        record_host_function_call("keyvalue::cache", "get_or_set");
+        let _timer = record_host_function_call("keyvalue::cache", "get_or_set");
         unimplemented!("get_or_set")
     }
 
     async fn delete(&mut self, _k: Key) -> anyhow::Result<Resource<FutureResult>> {
-        record_host_function_call("keyvalue::cache", "delete");
+        let _timer = record_host_function_call("keyvalue::cache", "delete");
         unimplemented!("delete")
     }
 }
@@ -24,7 +24,7 @@ use crate::workerctx::WorkerCtx;
 #[async_trait]
 impl<Ctx: WorkerCtx> HostError for DurableWorkerCtx<Ctx> {
     async fn trace(&mut self, self_: Resource<Error>) -> anyhow::Result<String> {
-        record_host_function_call("keyvalue::wasi_cloud_error", "trace");
+        let _timer = record_host_function_call("keyvalue::wasi_cloud_error", "trace");
         let trace = self
             .as_wasi_view()
             .table()
@@ -35,7 +35,7 @@ impl<Ctx: WorkerCtx> HostError for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<Error>) -> anyhow::Result<()> {
-        record_host_function_call("keyvalue::wasi_cloud_error", "drop_error");
+        let _timer = record_host_function_call("keyvalue::wasi_cloud_error", "drop_error");
         self.as_wasi_view().table().delete::<ErrorEntry>(rep)?;
         Ok(())
     }
@@ -34,7 +34,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         bucket: Resource<Bucket>,
         key: Key,
     ) -> anyhow::Result<Result<Option<Resource<IncomingValue>>, Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual", "get");
+        let _timer = record_host_function_call("keyvalue::eventual", "get");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -42,14 +42,23 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .get::<BucketEntry>(&bucket)?
             .name
             .clone();
+        let buffered = self.buffered_key_value(&bucket, &key);
         let result = Durability::<Ctx, Option<Vec<u8>>, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadRemote,
             "golem keyvalue::eventual::get",
             |ctx| {
-                ctx.state
-                    .key_value_service
-                    .get(account_id.clone(), bucket.clone(), key.clone())
+                Box::pin(async move {
+                    match buffered {
+                        Some(value) => Ok(value),
+                        None => {
+                            ctx.state
+                                .key_value_service
+                                .get(account_id, bucket, key)
+                                .await
+                        }
+                    }
+                })
             },
         )
         .await;
@@ -78,7 +87,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         key: Key,
         outgoing_value: Resource<OutgoingValue>,
     ) -> anyhow::Result<Result<(), Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual", "set");
+        let _timer = record_host_function_call("keyvalue::eventual", "set");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -94,20 +103,29 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .read()
             .unwrap()
             .clone();
-        let result = Durability::<Ctx, (), SerializableError>::wrap(
-            self,
-            WrappedFunctionType::WriteRemote,
-            "golem keyvalue::eventual::set",
-            |ctx| {
-                ctx.state.key_value_service.set(
-                    account_id.clone(),
-                    bucket.clone(),
-                    key.clone(),
-                    outgoing_value.clone(),
-                )
-            },
-        )
-        .await;
+        let result = if self.is_key_value_write_behind_enabled().await? {
+            self.buffer_key_value_writes(
+                "golem keyvalue::eventual::set",
+                bucket,
+                vec![(key, Some(outgoing_value))],
+            )
+            .await?
+        } else {
+            Durability::<Ctx, (), SerializableError>::wrap(
+                self,
+                WrappedFunctionType::WriteRemote,
+                "golem keyvalue::eventual::set",
+                |ctx| {
+                    ctx.state.key_value_service.set(
+                        account_id.clone(),
+                        bucket.clone(),
+                        key.clone(),
+                        outgoing_value.clone(),
+                    )
+                },
+            )
+            .await
+        };
         match result {
             Ok(()) => Ok(Ok(())),
             Err(e) => {
@@ -125,7 +143,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         bucket: Resource<Bucket>,
         key: Key,
     ) -> anyhow::Result<Result<(), Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual", "delete");
+        let _timer = record_host_function_call("keyvalue::eventual", "delete");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -133,17 +151,28 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .get::<BucketEntry>(&bucket)?
             .name
             .clone();
-        let result = Durability::<Ctx, (), SerializableError>::wrap(
-            self,
-            WrappedFunctionType::WriteRemote,
-            "golem keyvalue::eventual::delete",
-            |ctx| {
-                ctx.state
-                    .key_value_service
-                    .delete(account_id.clone(), bucket.clone(), key.clone())
-            },
-        )
-        .await;
+        let result = if self.is_key_value_write_behind_enabled().await? {
+            self.buffer_key_value_writes(
+                "golem keyvalue::eventual::delete",
+                bucket,
+                vec![(key, None)],
+            )
+            .await?
+        } else {
+            Durability::<Ctx, (), SerializableError>::wrap(
+                self,
+                WrappedFunctionType::WriteRemote,
+                "golem keyvalue::eventual::delete",
+                |ctx| {
+                    ctx.state.key_value_service.delete(
+                        account_id.clone(),
+                        bucket.clone(),
+                        key.clone(),
+                    )
+                },
+            )
+            .await
+        };
         match result {
             Ok(()) => Ok(Ok(())),
             Err(e) => {
@@ -161,7 +190,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         bucket: Resource<Bucket>,
         key: Key,
     ) -> anyhow::Result<Result<bool, Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual", "exists");
+        let _timer = record_host_function_call("keyvalue::eventual", "exists");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -169,14 +198,23 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .get::<BucketEntry>(&bucket)?
             .name
             .clone();
+        let buffered = self.buffered_key_value(&bucket, &key);
         let result = Durability::<Ctx, bool, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadRemote,
             "golem keyvalue::eventual::exists",
             |ctx| {
-                ctx.state
-                    .key_value_service
-                    .exists(account_id.clone(), bucket.clone(), key.clone())
+                Box::pin(async move {
+                    match buffered {
+                        Some(value) => Ok(value.is_some()),
+                        None => {
+                            ctx.state
+                                .key_value_service
+                                .exists(account_id, bucket, key)
+                                .await
+                        }
+                    }
+                })
             },
         )
         .await;
@@ -34,7 +34,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         bucket: Resource<Bucket>,
         keys: Vec<Key>,
     ) -> anyhow::Result<Result<Vec<Option<Resource<IncomingValue>>>, Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual_batch", "get_many");
+        let _timer = record_host_function_call("keyvalue::eventual_batch", "get_many");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -42,17 +42,43 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .get::<BucketEntry>(&bucket)?
             .name
             .clone();
+        let buffered = keys
+            .iter()
+            .map(|key| self.buffered_key_value(&bucket, key))
+            .collect::<Vec<_>>();
         let result: anyhow::Result<Vec<Option<Vec<u8>>>> =
             Durability::<Ctx, Vec<Option<Vec<u8>>>, SerializableError>::wrap(
                 self,
                 WrappedFunctionType::ReadRemote,
                 "golem keyvalue::eventual_batch::get_many",
                 |ctx| {
-                    ctx.state.key_value_service.get_many(
-                        account_id.clone(),
-                        bucket.clone(),
-                        keys.clone(),
-                    )
+                    Box::pin(async move {
+                        // Only the keys without buffered mutations are read from the service
+                        let missing_keys = keys
+                            .iter()
+                            .zip(&buffered)
+                            .filter(|(_, buffered)| buffered.is_none())
+                            .map(|(key, _)| key.clone())
+                            .collect::<Vec<_>>();
+                        let mut fetched = if missing_keys.is_empty() {
+                            Vec::new()
+                        } else {
+                            ctx.state
+                                .key_value_service
+                                .get_many(account_id, bucket, missing_keys)
+                                .await?
+                        }
+                        .into_iter();
+                        Ok::<_, anyhow::Error>(
+                            buffered
+                                .into_iter()
+                                .map(|buffered| match buffered {
+                                    Some(value) => value,
+                                    None => fetched.next().flatten(),
+                                })
+                                .collect(),
+                        )
+                    })
                 },
             )
             .await;
@@ -89,7 +115,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         &mut self,
         bucket: Resource<Bucket>,
     ) -> anyhow::Result<Result<Vec<Key>, Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual_batch", "get_keys");
+        let _timer = record_host_function_call("keyvalue::eventual_batch", "get_keys");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -97,6 +123,8 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .get::<BucketEntry>(&bucket)?
             .name
             .clone();
+        // Listing the keys needs all the buffered mutations to be written first
+        self.flush_key_value_writes().await?;
         let keys = Durability::<Ctx, Vec<String>, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadRemote,
@@ -116,7 +144,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         bucket: Resource<Bucket>,
         key_values: Vec<(Key, Resource<OutgoingValue>)>,
     ) -> anyhow::Result<Result<(), Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual_batch", "set_many");
+        let _timer = record_host_function_call("keyvalue::eventual_batch", "set_many");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -138,19 +166,31 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
                 Ok((key, outgoing_value))
             })
             .collect::<Result<Vec<(String, Vec<u8>)>, ResourceTableError>>()?;
-        let result = Durability::<Ctx, (), SerializableError>::wrap(
-            self,
-            WrappedFunctionType::WriteRemote,
-            "golem keyvalue::eventual_batch::set_many",
-            |ctx| {
-                ctx.state.key_value_service.set_many(
-                    account_id.clone(),
-                    bucket.clone(),
-                    key_values.clone(),
-                )
-            },
-        )
-        .await;
+        let result = if self.is_key_value_write_behind_enabled().await? {
+            self.buffer_key_value_writes(
+                "golem keyvalue::eventual_batch::set_many",
+                bucket,
+                key_values
+                    .into_iter()
+                    .map(|(key, value)| (key, Some(value)))
+                    .collect(),
+            )
+            .await?
+        } else {
+            Durability::<Ctx, (), SerializableError>::wrap(
+                self,
+                WrappedFunctionType::WriteRemote,
+                "golem keyvalue::eventual_batch::set_many",
+                |ctx| {
+                    ctx.state.key_value_service.set_many(
+                        account_id.clone(),
+                        bucket.clone(),
+                        key_values.clone(),
+                    )
+                },
+            )
+            .await
+        };
         match result {
             Ok(()) => Ok(Ok(())),
             Err(e) => {
@@ -168,7 +208,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         bucket: Resource<Bucket>,
         keys: Vec<Key>,
     ) -> anyhow::Result<Result<(), Resource<Error>>> {
-        record_host_function_call("keyvalue::eventual_batch", "delete_many");
+        let _timer = record_host_function_call("keyvalue::eventual_batch", "delete_many");
         let account_id = self.owned_worker_id.account_id();
         let bucket = self
             .as_wasi_view()
@@ -176,19 +216,28 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
             .get::<BucketEntry>(&bucket)?
             .name
             .clone();
-        let result = Durability::<Ctx, (), SerializableError>::wrap(
-            self,
-            WrappedFunctionType::WriteRemote,
-            "golem keyvalue::eventual_batch::delete_many",
-            |ctx| {
-                ctx.state.key_value_service.delete_many(
-                    account_id.clone(),
-                    bucket.clone(),
-                    keys.clone(),
-                )
-            },
-        )
-        .await;
+        let result = if self.is_key_value_write_behind_enabled().await? {
+            self.buffer_key_value_writes(
+                "golem keyvalue::eventual_batch::delete_many",
+                bucket,
+                keys.into_iter().map(|key| (key, None)).collect(),
+            )
+            .await?
+        } else {
+            Durability::<Ctx, (), SerializableError>::wrap(
+                self,
+                WrappedFunctionType::WriteRemote,
+                "golem keyvalue::eventual_batch::delete_many",
+                |ctx| {
+                    ctx.state.key_value_service.delete_many(
+                        account_id.clone(),
+                        bucket.clone(),
+                        keys.clone(),
+                    )
+                },
+            )
+            .await
+        };
         match result {
             Ok(()) => Ok(Ok(())),
             Err(e) => {
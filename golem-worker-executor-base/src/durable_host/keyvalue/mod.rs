@@ -18,3 +18,4 @@ pub mod error;
 pub mod eventual;
 pub mod eventual_batch;
 pub mod types;
+pub mod write_behind;
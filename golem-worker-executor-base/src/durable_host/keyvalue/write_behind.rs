@@ -0,0 +1,305 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Write-behind buffering of the key-value mutations of a worker.
+//!
+//! When enabled, `set` and `delete` calls only record their result in the oplog as local writes
+//! and put the mutation into the worker's [`KeyValueWriteBuffer`], where later writes to the same
+//! key replace earlier ones. Reads are served from the buffer when possible. The buffer is
+//! written to the key-value service in one batch per bucket at the end of each invocation, or
+//! earlier when it grows over the configured limit, and each flush is recorded in the oplog as
+//! a remote write.
+//!
+//! During replay the mutations are buffered again from the oplog, and a replayed flush drops
+//! them just like the original flush did, so the mutations that were not yet flushed when the
+//! worker stopped are written by the next flush after recovery. A failed flush is not recorded
+//! and fails the invocation, which is then retried according to the worker's retry policy.
+//!
+//! When write-behind is used, it is recorded in the oplog together with the flush limit at the
+//! first key-value mutation of each worker, in a dedicated oplog entry, and a worker keeps using
+//! the recorded settings even if the configuration changes. Workers without such an entry keep
+//! writing directly.
+
+use std::collections::BTreeMap;
+use std::sync::Arc;
+
+use crate::durable_host::serialized::SerializableError;
+use crate::durable_host::{Durability, DurableWorkerCtx};
+use crate::error::GolemError;
+use crate::model::PersistenceLevel;
+use crate::services::key_value::KeyValueService;
+use crate::workerctx::WorkerCtx;
+use golem_common::model::oplog::{OplogEntry, WrappedFunctionType};
+use golem_common::model::AccountId;
+
+/// Key-value mutations of a worker not yet written to the key-value service, indexed by bucket
+/// and key. `None` values are deletions.
+#[derive(Debug, Default)]
+pub struct KeyValueWriteBuffer {
+    buckets: BTreeMap<String, BTreeMap<String, Option<Vec<u8>>>>,
+    len: usize,
+}
+
+impl KeyValueWriteBuffer {
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Buffers setting (`Some`) or deleting (`None`) a key, replacing any earlier mutation of it
+    pub fn put(&mut self, bucket: String, key: String, value: Option<Vec<u8>>) {
+        if self
+            .buckets
+            .entry(bucket)
+            .or_default()
+            .insert(key, value)
+            .is_none()
+        {
+            self.len += 1;
+        }
+    }
+
+    /// Gets the buffered value of a key. Returns `None` if there is no buffered mutation for
+    /// it, and `Some(None)` if it has been deleted.
+    pub fn get(&self, bucket: &str, key: &str) -> Option<Option<Vec<u8>>> {
+        self.buckets
+            .get(bucket)
+            .and_then(|keys| keys.get(key))
+            .cloned()
+    }
+
+    pub fn take(&mut self) -> Self {
+        std::mem::take(self)
+    }
+
+    /// Puts back mutations taken by a failed flush, keeping the ones buffered since then
+    pub fn restore(&mut self, older: Self) {
+        for (bucket, keys) in older.buckets {
+            for (key, value) in keys {
+                let newer = self.buckets.entry(bucket.clone()).or_default();
+                if !newer.contains_key(&key) {
+                    newer.insert(key, value);
+                    self.len += 1;
+                }
+            }
+        }
+    }
+
+    /// Writes all the mutations with one `set_many` and one `delete_many` call per bucket
+    pub async fn write(
+        &self,
+        key_value_service: &Arc<dyn KeyValueService + Send + Sync>,
+        account_id: &AccountId,
+    ) -> anyhow::Result<()> {
+        for (bucket, keys) in &self.buckets {
+            let mut key_values = Vec::new();
+            let mut deleted_keys = Vec::new();
+            for (key, value) in keys {
+                match value {
+                    Some(value) => key_values.push((key.clone(), value.clone())),
+                    None => deleted_keys.push(key.clone()),
+                }
+            }
+            if !key_values.is_empty() {
+                key_value_service
+                    .set_many(account_id.clone(), bucket.clone(), key_values)
+                    .await?;
+            }
+            if !deleted_keys.is_empty() {
+                key_value_service
+                    .delete_many(account_id.clone(), bucket.clone(), deleted_keys)
+                    .await?;
+            }
+        }
+        Ok(())
+    }
+}
+
+/// How the key-value mutations of a worker are written
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum KeyValueWriteMode {
+    /// Every mutation is written to the key-value service when it is made
+    Direct,
+    /// Mutations are buffered and flushed when the invocation ends, or earlier once
+    /// `max_buffered_writes` mutations are buffered
+    WriteBehind { max_buffered_writes: usize },
+}
+
+impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
+    /// Gets how the key-value mutations of the worker are written.
+    ///
+    /// Write-behind is recorded by an `OplogEntry::KeyValueWriteBehind`, together with its
+    /// flush limit, the first time it is needed. The entry is a hint that sets the mode when it
+    /// is replayed, so a replaying worker that has not read one writes directly, like it did
+    /// before the entry was written. This includes every worker created before write-behind
+    /// existed.
+    pub(crate) async fn key_value_write_mode(&mut self) -> Result<KeyValueWriteMode, GolemError> {
+        if let Some(mode) = self.state.key_value_write_mode {
+            return Ok(mode);
+        }
+
+        let persist_nothing = self.state.persistence_level == PersistenceLevel::PersistNothing;
+        if self.state.is_replay() && !persist_nothing {
+            // The entry may be among the hints not yet read, if it was recorded before anything
+            // else was replayed
+            self.state.skip_hints().await;
+            if let Some(mode) = self.state.key_value_write_mode {
+                return Ok(mode);
+            }
+        }
+
+        let config = &self.state.config.key_value_write_behind;
+        let mode = if (self.state.is_live() || persist_nothing) && config.enabled {
+            let max_buffered_writes = config.max_buffered_writes;
+            if !persist_nothing {
+                self.state
+                    .oplog
+                    .add(OplogEntry::key_value_write_behind(
+                        max_buffered_writes as u64,
+                    ))
+                    .await;
+            }
+            KeyValueWriteMode::WriteBehind {
+                max_buffered_writes,
+            }
+        } else {
+            KeyValueWriteMode::Direct
+        };
+        self.state.key_value_write_mode = Some(mode);
+        Ok(mode)
+    }
+
+    /// Whether the key-value mutations of the worker are buffered, see
+    /// [`DurableWorkerCtx::key_value_write_mode`]
+    pub(crate) async fn is_key_value_write_behind_enabled(&mut self) -> Result<bool, GolemError> {
+        Ok(self.key_value_write_mode().await? != KeyValueWriteMode::Direct)
+    }
+
+    /// Gets the buffered value of a key, see [`KeyValueWriteBuffer::get`]
+    pub(crate) fn buffered_key_value(&self, bucket: &str, key: &str) -> Option<Option<Vec<u8>>> {
+        self.state.key_value_write_buffer.get(bucket, key)
+    }
+
+    /// Records a key-value mutation as a local write and buffers it, flushing the buffer if it
+    /// is full. The inner result is the one returned to the guest, while a failed flush is
+    /// returned as the outer error, failing the invocation.
+    pub(crate) async fn buffer_key_value_writes(
+        &mut self,
+        function_name: &str,
+        bucket: String,
+        mutations: Vec<(String, Option<Vec<u8>>)>,
+    ) -> Result<anyhow::Result<()>, GolemError> {
+        let result = Durability::<Ctx, (), SerializableError>::wrap(
+            self,
+            WrappedFunctionType::WriteLocal,
+            function_name,
+            |_ctx| Box::pin(async { Ok::<(), anyhow::Error>(()) }),
+        )
+        .await;
+        if result.is_err() {
+            return Ok(result);
+        }
+
+        for (key, value) in mutations {
+            self.state
+                .key_value_write_buffer
+                .put(bucket.clone(), key, value);
+        }
+        if let KeyValueWriteMode::WriteBehind {
+            max_buffered_writes,
+        } = self.key_value_write_mode().await?
+        {
+            if self.state.key_value_write_buffer.len() >= max_buffered_writes {
+                self.flush_key_value_writes().await?;
+            }
+        }
+        Ok(Ok(()))
+    }
+
+    /// Writes the buffered key-value mutations to the key-value service. If the write fails, the
+    /// mutations are kept in the buffer and the error is returned without recording it in the
+    /// oplog, so the invocation fails and the flush is performed again when it is retried.
+    pub(crate) async fn flush_key_value_writes(&mut self) -> Result<(), GolemError> {
+        if self.state.key_value_write_buffer.is_empty() {
+            return Ok(());
+        }
+
+        let writes = self.state.key_value_write_buffer.take();
+        let writes = Arc::new(writes);
+        let writes_clone = writes.clone();
+        let account_id = self.owned_worker_id.account_id();
+        let result = Durability::<Ctx, (), SerializableError>::wrap_conditionally(
+            self,
+            WrappedFunctionType::WriteRemote,
+            "golem keyvalue::flush",
+            |ctx| {
+                Box::pin(async move {
+                    writes_clone
+                        .write(&ctx.state.key_value_service, &account_id)
+                        .await
+                        .map_err(|err| {
+                            GolemError::runtime(format!(
+                                "failed to flush buffered key-value writes: {err}"
+                            ))
+                        })
+                })
+            },
+            |result: &Result<(), GolemError>| result.is_ok(),
+        )
+        .await;
+
+        if result.is_err() {
+            let writes = Arc::into_inner(writes).unwrap_or_default();
+            self.state.key_value_write_buffer.restore(writes);
+        }
+        result
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::durable_host::keyvalue::write_behind::KeyValueWriteBuffer;
+
+    #[test]
+    fn write_buffer_coalesces_writes_to_the_same_key() {
+        let mut buffer = KeyValueWriteBuffer::default();
+        buffer.put("b1".to_string(), "k1".to_string(), Some(vec![1]));
+        buffer.put("b1".to_string(), "k1".to_string(), Some(vec![2]));
+        buffer.put("b1".to_string(), "k2".to_string(), Some(vec![3]));
+        buffer.put("b2".to_string(), "k1".to_string(), None);
+
+        assert_eq!(buffer.len(), 3);
+        assert_eq!(buffer.get("b1", "k1"), Some(Some(vec![2])));
+        assert_eq!(buffer.get("b2", "k1"), Some(None));
+        assert_eq!(buffer.get("b2", "k2"), None);
+    }
+
+    #[test]
+    fn restored_writes_do_not_override_newer_ones() {
+        let mut older = KeyValueWriteBuffer::default();
+        older.put("b1".to_string(), "k1".to_string(), Some(vec![1]));
+        older.put("b1".to_string(), "k2".to_string(), Some(vec![2]));
+
+        let mut buffer = KeyValueWriteBuffer::default();
+        buffer.put("b1".to_string(), "k1".to_string(), None);
+        buffer.restore(older);
+
+        assert_eq!(buffer.len(), 2);
+        assert_eq!(buffer.get("b1", "k1"), Some(None));
+        assert_eq!(buffer.get("b1", "k2"), Some(Some(vec![2])));
+    }
+}
@@ -24,9 +24,12 @@ use crate::workerctx::WorkerCtx;
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn log(&mut self, level: Level, context: String, message: String) -> anyhow::Result<()> {
-        record_host_function_call("logging::handler", "log");
+        let _timer = record_host_function_call("logging::handler", "log");
         if self.state.is_live() || self.state.persistence_level == PersistenceLevel::PersistNothing
         {
+            // Buffered output written before the log message must be emitted first
+            self.flush_output();
+
             let event_service = &self.public_state.event_service;
             let log_level = match level {
                 Level::Critical => LogLevel::Critical,
@@ -15,7 +15,7 @@
 // WASI Host implementation for Golem, delegating to the core WASI implementation (wasmtime_wasi)
 // implementing the Golem specific instrumentation on top of it.
 
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::error::Error;
 use std::fmt::{Debug, Display, Formatter};
 use std::ops::Add;
@@ -34,7 +34,7 @@ use crate::services::golem_config::GolemConfig;
 use crate::services::key_value::KeyValueService;
 use crate::services::promise::PromiseService;
 use crate::services::worker::WorkerService;
-use crate::services::worker_event::WorkerEventService;
+use crate::services::worker_event::{OutputStreamKind, WorkerEventService, WorkerOutputBuffer};
 use crate::services::{worker_enumeration, HasAll, HasOplog, HasWorker};
 use crate::wasi_host::managed_stdio::ManagedStandardIo;
 use crate::workerctx::{
@@ -44,8 +44,12 @@ use crate::workerctx::{
 use anyhow::anyhow;
 use async_trait::async_trait;
 use chrono::{DateTime, Utc};
+use futures::stream::{self, StreamExt, TryStreamExt};
 use golem_common::config::RetryConfig;
-use golem_common::model::oplog::{OplogEntry, OplogIndex, UpdateDescription, WrappedFunctionType};
+use golem_common::model::oplog::{
+    OplogEntry, OplogIndex, OplogPayload, TimestampedUpdateDescription, UpdateDescription,
+    WorkerSnapshot, WrappedFunctionType,
+};
 use golem_common::model::regions::{DeletedRegions, OplogRegion};
 use golem_common::model::{
     AccountId, CallingConvention, ComponentId, ComponentVersion, FailedUpdateRecord,
@@ -65,10 +69,16 @@ use wasmtime_wasi_http::types::{
 };
 use wasmtime_wasi_http::{HttpResult, WasiHttpCtx, WasiHttpView};
 
+use crate::durable_host::clocks::snapshot::SnapshotClock;
+use crate::durable_host::filesystem::initial::{InitialFileSystem, InitialFileSystemService};
+use crate::durable_host::http::connection_pool::HttpConnectionPool;
 use crate::durable_host::io::{ManagedStdErr, ManagedStdIn, ManagedStdOut};
+use crate::durable_host::keyvalue::write_behind::{KeyValueWriteBuffer, KeyValueWriteMode};
 use crate::durable_host::wasm_rpc::UriExtensions;
-use crate::metrics::wasm::{record_number_of_replayed_functions, record_resume_worker};
-use crate::services::oplog::{Oplog, OplogOps, OplogService};
+use crate::metrics::wasm::{
+    record_allocated_memory, record_number_of_replayed_functions, record_resume_worker,
+};
+use crate::services::oplog::{MultiLayerOplog, Oplog, OplogOps, OplogService};
 use crate::services::rpc::Rpc;
 use crate::services::scheduler::SchedulerService;
 use crate::services::HasOplogService;
@@ -78,9 +88,9 @@ use crate::worker::{calculate_last_known_status, is_worker_error_retriable};
 pub mod blobstore;
 mod cli;
 mod clocks;
-mod filesystem;
+pub mod filesystem;
 pub mod golem;
-mod http;
+pub mod http;
 pub mod io;
 pub mod keyvalue;
 mod logging;
@@ -90,6 +100,8 @@ mod sockets;
 pub mod wasm_rpc;
 
 mod durability;
+mod replay;
+use crate::durable_host::replay::ReplayBuffer;
 use crate::services::component::ComponentMetadata;
 use crate::services::worker_proxy::WorkerProxy;
 use crate::worker::{RecoveryDecision, Worker};
@@ -106,6 +118,7 @@ pub struct DurableWorkerCtx<Ctx: WorkerCtx> {
     state: PrivateDurableWorkerState,
     #[allow(unused)] // note: need to keep reference to it to keep the temp dir alive
     temp_dir: Arc<TempDir>,
+    initial_file_system: Option<Arc<InitialFileSystem>>,
     execution_status: Arc<RwLock<ExecutionStatus>>,
 }
 
@@ -127,6 +140,8 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         rpc: Arc<dyn Rpc + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
         config: Arc<GolemConfig>,
         worker_config: WorkerConfig,
         execution_status: Arc<RwLock<ExecutionStatus>>,
@@ -139,6 +154,24 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
             temp_dir.path()
         );
 
+        let initial_file_system = initial_file_system_service
+            .get(
+                &owned_worker_id.worker_id.component_id,
+                component_metadata.version,
+            )
+            .await?;
+        if let Some(initial_file_system) = &initial_file_system {
+            let initial_file_system = initial_file_system.clone();
+            let root = temp_dir.path().to_path_buf();
+            tokio::task::spawn_blocking(move || initial_file_system.mount(&root))
+                .await
+                .map_err(|err| GolemError::unknown(err.to_string()))?
+                .map_err(|err| {
+                    GolemError::runtime(format!("Failed to mount the initial file system: {err}"))
+                })?;
+            debug!("Mounted the initial file system of the component");
+        }
+
         debug!(
             "Worker {} initialized with deleted regions {}",
             owned_worker_id.worker_id, worker_config.deleted_regions
@@ -187,11 +220,14 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
                         owned_worker_id.clone(),
                         rpc,
                         worker_proxy,
+                        http_connection_pool,
                         worker_config.deleted_regions.clone(),
                         last_oplog_index,
                         component_metadata,
+                        worker_config.total_linear_memory_size,
                     ),
                     temp_dir,
+                    initial_file_system,
                     execution_status,
                 }
             },
@@ -221,6 +257,83 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
         &self.state.component_metadata
     }
 
+    /// The total linear memory size of the worker known so far, in bytes. It is the highest
+    /// value ever recorded so it can be used to estimate the memory needs of the worker before
+    /// replaying its oplog.
+    pub fn total_linear_memory_size(&self) -> u64 {
+        self.state.total_linear_memory_size
+    }
+
+    /// Records that one of the worker's linear memories grew by `delta` bytes, including the
+    /// initial allocation of the memories when the worker is instantiated.
+    ///
+    /// Only the growth beyond the size recorded in the oplog is written to it, by
+    /// `flush_memory_growth`, so a guest growing its memory many times within an invocation gets
+    /// a single entry. Growing happens again during replay and when the worker is restarted, and
+    /// it can go beyond the recorded size there too if the last growth was not written before the
+    /// executor stopped, so the difference is written once the worker is live again.
+    pub async fn increase_memory(&mut self, delta: u64) -> anyhow::Result<bool> {
+        self.state.current_linear_memory_size += delta;
+        if self.state.current_linear_memory_size > self.state.total_linear_memory_size {
+            self.state.total_linear_memory_size = self.state.current_linear_memory_size;
+        }
+        Ok(true)
+    }
+
+    /// Writes the growth of the total linear memory size beyond the size recorded in the oplog
+    /// as a single `GrowMemory` entry. Nothing is written during replay, the growth is kept until
+    /// the worker is live.
+    async fn flush_memory_growth(&mut self) {
+        if !self.state.is_live() {
+            return;
+        }
+        let growth = self
+            .state
+            .total_linear_memory_size
+            .saturating_sub(self.state.recorded_linear_memory_size);
+        if growth > 0 {
+            debug!("Increasing total linear memory size by {growth}");
+            self.state.oplog.add(OplogEntry::grow_memory(growth)).await;
+            self.state.recorded_linear_memory_size = self.state.total_linear_memory_size;
+            record_allocated_memory(growth as usize);
+        }
+    }
+
+    /// Emits a chunk of the worker's stdout or stderr as worker events, coalescing it with the
+    /// previous writes if enabled in the configuration
+    pub fn emit_output(&mut self, kind: OutputStreamKind, data: &[u8]) {
+        let mut buffer = self.state.output_buffer.lock().unwrap();
+        let pending_before = buffer.pending_since();
+        for event in buffer.push(kind, data) {
+            self.public_state.event_service.emit_event(event);
+        }
+        let pending_after = buffer.pending_since();
+        let max_delay = buffer.max_delay();
+        drop(buffer);
+
+        if pending_after.is_some() && pending_after != pending_before {
+            // A new chunk has been started, which has to be emitted after `max_delay` even if
+            // the worker keeps running without writing to its output or waiting
+            let output_buffer = self.state.output_buffer.clone();
+            let event_service = self.public_state.event_service.clone();
+            tokio::spawn(async move {
+                tokio::time::sleep(max_delay).await;
+                let mut buffer = output_buffer.lock().unwrap();
+                if let Some(event) = buffer.flush_expired() {
+                    event_service.emit_event(event);
+                }
+            });
+        }
+    }
+
+    /// Emits the buffered stdout or stderr chunk, if any
+    pub fn flush_output(&mut self) {
+        let mut buffer = self.state.output_buffer.lock().unwrap();
+        if let Some(event) = buffer.flush() {
+            self.public_state.event_service.emit_event(event);
+        }
+    }
+
     pub fn is_exit(error: &anyhow::Error) -> Option<i32> {
         error
             .root_cause()
@@ -317,6 +430,38 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
         self.public_state.worker().update_status(status).await;
     }
 
+    /// Records a snapshot of the worker's current state. Recovery loads it instead of replaying
+    /// the oplog before it.
+    async fn record_snapshot(&mut self, payload: OplogPayload) {
+        self.flush_memory_growth().await;
+        let entry = OplogEntry::snapshot(payload.clone());
+        let timestamp = entry.timestamp();
+        let oplog_index = self.public_state.oplog.add_and_commit(entry).await;
+
+        // The temporary override of a pending snapshot based update is replaced by the
+        // permanent region
+        if self.state.deleted_regions.is_overridden() {
+            self.state.deleted_regions.drop_override();
+        }
+        self.state.deleted_regions.add(OplogRegion {
+            start: OplogIndex::INITIAL.next(),
+            end: oplog_index,
+        });
+        self.update_worker_status(|status| {
+            status.last_snapshot = Some(WorkerSnapshot {
+                timestamp,
+                oplog_index,
+                payload,
+            })
+        })
+        .await;
+
+        // The entries replaced by the snapshot are no longer replayed, so they are moved out of
+        // the primary oplog. They are kept in the archive layers as the worker's history.
+        let _ =
+            MultiLayerOplog::try_archive_prefix(&self.public_state.oplog, oplog_index.previous());
+    }
+
     pub async fn store_worker_status(&self, status: WorkerStatus) {
         self.update_worker_status(|s| s.status = status.clone())
             .await;
@@ -431,6 +576,135 @@ impl<Ctx: WorkerCtx> DurableWorkerCtx<Ctx> {
 }
 
 impl<Ctx: WorkerCtx + DurableWorkerCtxView<Ctx>> DurableWorkerCtx<Ctx> {
+    /// Restores the worker's state by passing the given snapshot to its load snapshot export.
+    async fn load_snapshot(
+        data: &[u8],
+        instance: &Instance,
+        store: &mut (impl AsContextMut<Data = Ctx> + Send),
+    ) -> Result<(), String> {
+        let idempotency_key = IdempotencyKey::fresh();
+        store
+            .as_context_mut()
+            .data_mut()
+            .durable_ctx_mut()
+            .set_current_idempotency_key(idempotency_key.clone())
+            .await;
+
+        store
+            .as_context_mut()
+            .data_mut()
+            .begin_call_snapshotting_function();
+        let load_result = invoke_worker(
+            "golem:api/load-snapshot@0.2.0.{load}".to_string(),
+            vec![Value::List(data.iter().map(|b| Value::U8(*b)).collect())],
+            store,
+            instance,
+            CallingConvention::Component,
+            true,
+        )
+        .await;
+        store
+            .as_context_mut()
+            .data_mut()
+            .end_call_snapshotting_function();
+
+        match load_result {
+            Err(error) => Err(error.to_string()),
+            Ok(InvokeResult::Failed { error, .. }) => Err(error.to_string()),
+            Ok(InvokeResult::Succeeded { output, .. }) => {
+                if output.len() == 1 {
+                    match &output[0] {
+                        Value::Result(Err(Some(boxed_error_value))) => match &**boxed_error_value {
+                            Value::String(error) => Err(error.clone()),
+                            _ => Err("Unexpected result value from the snapshot load function"
+                                .to_string()),
+                        },
+                        _ => Ok(()),
+                    }
+                } else {
+                    Err("Unexpected result value from the snapshot load function".to_string())
+                }
+            }
+            _ => Ok(()),
+        }
+    }
+
+    /// If the oplog before the worker's last snapshot is skipped, and there is no newer snapshot
+    /// based update pending, restores the worker's state from the last snapshot before replaying
+    /// the rest of the oplog.
+    async fn restore_last_snapshot(
+        instance: &Instance,
+        store: &mut (impl AsContextMut<Data = Ctx> + Send),
+    ) -> Result<(), GolemError> {
+        let durable_ctx = store.as_context().data().durable_ctx();
+        let (pending_updates, _) = durable_ctx.public_state.worker().pending_updates();
+        let has_pending_snapshot = matches!(
+            pending_updates.front(),
+            Some(TimestampedUpdateDescription {
+                description: UpdateDescription::SnapshotBased { .. },
+                ..
+            })
+        );
+        let (last_snapshot, key_value_write_behind, clock_snapshot_mode) = {
+            let execution_status = durable_ctx.execution_status.read().unwrap();
+            let status = execution_status.last_known_status();
+            (
+                status.last_snapshot.clone(),
+                status.key_value_write_behind.clone(),
+                status.clock_snapshot_mode,
+            )
+        };
+
+        match last_snapshot {
+            Some(snapshot) if !has_pending_snapshot => {
+                let skipped = durable_ctx
+                    .state
+                    .deleted_regions
+                    .find_next_deleted_region(OplogIndex::INITIAL.next())
+                    .is_some_and(|region| {
+                        region.start == OplogIndex::INITIAL.next()
+                            && region.end >= snapshot.oplog_index
+                    });
+                if skipped {
+                    debug!(
+                        "Restoring the worker from its snapshot at {}",
+                        snapshot.oplog_index
+                    );
+                    let data = store
+                        .as_context()
+                        .data()
+                        .durable_ctx()
+                        .public_state
+                        .oplog
+                        .download_payload(&snapshot.payload)
+                        .await
+                        .map_err(GolemError::runtime)?;
+                    Self::load_snapshot(&data, instance, store)
+                        .await
+                        .map_err(|error| {
+                            GolemError::runtime(format!("Failed to load snapshot: {error}"))
+                        })?;
+
+                    // Settings recorded before the snapshot are not replayed
+                    let mut context = store.as_context_mut();
+                    let state = &mut context.data_mut().durable_ctx_mut().state;
+                    if let Some(record) = key_value_write_behind {
+                        if record.oplog_index < snapshot.oplog_index {
+                            state.key_value_write_mode = Some(KeyValueWriteMode::WriteBehind {
+                                max_buffered_writes: record.max_buffered_writes as usize,
+                            });
+                        }
+                    }
+                    if clock_snapshot_mode.is_some_and(|idx| idx < snapshot.oplog_index) {
+                        state.clock_snapshot_enabled = Some(true);
+                    }
+                }
+                Ok(())
+            }
+            _ => Ok(()),
+        }
+    }
+
     /// Records the result of an automatic update, if any was active, and returns whether the worker
     /// should be restarted to retry recovering without the pending update.
     pub async fn finalize_pending_update(
@@ -461,58 +735,12 @@ impl<Ctx: WorkerCtx + DurableWorkerCtxView<Ctx>> DurableWorkerCtx<Ctx> {
                             .await
                         {
                             Ok(Some(data)) => {
-                                let idempotency_key = IdempotencyKey::fresh();
-                                store
-                                    .as_context_mut()
-                                    .data_mut()
-                                    .durable_ctx_mut()
-                                    .set_current_idempotency_key(idempotency_key.clone())
-                                    .await;
-
-                                store
-                                    .as_context_mut()
-                                    .data_mut()
-                                    .begin_call_snapshotting_function();
-                                let load_result = invoke_worker(
-                                    "golem:api/load-snapshot@0.2.0.{load}".to_string(),
-                                    vec![Value::List(data.iter().map(|b| Value::U8(*b)).collect())],
-                                    store,
-                                    instance,
-                                    CallingConvention::Component,
-                                    true,
-                                )
-                                .await;
-                                store
-                                    .as_context_mut()
-                                    .data_mut()
-                                    .end_call_snapshotting_function();
-
-                                let failed = match load_result {
-                                    Err(error) => Some(format!(
-                                        "Manual update failed to load snapshot: {error}"
-                                    )),
-                                    Ok(InvokeResult::Failed { error, .. }) => Some(format!(
-                                        "Manual update failed to load snapshot: {error}"
-                                    )),
-                                    Ok(InvokeResult::Succeeded { output, .. }) => {
-                                        if output.len() == 1 {
-                                            match &output[0] {
-                                                    Value::Result(Err(Some(boxed_error_value))) => {
-                                                        match &**boxed_error_value {
-                                                            Value::String(error) =>
-                                                                Some(format!("Manual update failed to load snapshot: {error}")),
-                                                            _ =>
-                                                                Some("Unexpected result value from the snapshot load function".to_string())
-                                                        }
-                                                    }
-                                                    _ => None
-                                                }
-                                        } else {
-                                            Some("Unexpected result value from the snapshot load function".to_string())
-                                        }
-                                    }
-                                    _ => None,
-                                };
+                                let failed = Self::load_snapshot(&data, instance, store)
+                                    .await
+                                    .err()
+                                    .map(|error| {
+                                        format!("Manual update failed to load snapshot: {error}")
+                                    });
 
                                 if let Some(error) = failed {
                                     store
@@ -532,6 +760,18 @@ impl<Ctx: WorkerCtx + DurableWorkerCtxView<Ctx>> DurableWorkerCtx<Ctx> {
                                             component_metadata.size,
                                         )
                                         .await;
+
+                                    // The oplog before the snapshot never has to be replayed again
+                                    if let UpdateDescription::SnapshotBased { payload, .. } =
+                                        &pending_update.description
+                                    {
+                                        store
+                                            .as_context_mut()
+                                            .data_mut()
+                                            .durable_ctx_mut()
+                                            .record_snapshot(payload.clone())
+                                            .await;
+                                    }
                                     RecoveryDecision::None
                                 }
                             }
@@ -672,6 +912,8 @@ impl<Ctx: WorkerCtx> InvocationHooks for DurableWorkerCtx<Ctx> {
         function_input: &Vec<Value>,
         calling_convention: Option<CallingConvention>,
     ) -> Result<(), GolemError> {
+        self.state.clock_snapshot.invalidate();
+
         if self.state.snapshotting_mode.is_none() {
             let proto_function_input: Vec<golem_wasm_rpc::protobuf::Val> = function_input
                 .iter()
@@ -695,12 +937,17 @@ impl<Ctx: WorkerCtx> InvocationHooks for DurableWorkerCtx<Ctx> {
                         self.worker_id()
                     )
                 });
-            self.state.oplog.commit().await;
+            if self.state.batched_invocation_results.is_none() {
+                self.state.oplog.commit().await;
+            }
         }
         Ok(())
     }
 
     async fn on_invocation_failure(&mut self, trap_type: &TrapType) -> RecoveryDecision {
+        self.flush_output();
+        self.flush_memory_growth().await;
+
         let needs_commit = match trap_type {
             TrapType::Error(error) => Some((OplogEntry::error(error.clone()), true)),
             TrapType::Interrupt(InterruptKind::Interrupt) => {
@@ -769,6 +1016,10 @@ impl<Ctx: WorkerCtx> InvocationHooks for DurableWorkerCtx<Ctx> {
         consumed_fuel: i64,
         output: Vec<Value>,
     ) -> Result<(), GolemError> {
+        self.flush_output();
+        self.flush_key_value_writes().await?;
+        self.flush_memory_growth().await;
+
         let is_live_after = self.state.is_live();
 
         if is_live_after {
@@ -783,14 +1034,25 @@ impl<Ctx: WorkerCtx> InvocationHooks for DurableWorkerCtx<Ctx> {
                     .unwrap_or_else(|err| {
                         panic!("could not encode function result for {full_function_name}: {err}")
                     });
-                self.state.oplog.commit().await;
-                let oplog_idx = self.state.oplog.current_oplog_index().await;
 
-                if let Some(idempotency_key) = self.state.get_current_idempotency_key() {
-                    self.public_state
-                        .worker()
-                        .store_invocation_success(&idempotency_key, output.clone(), oplog_idx)
-                        .await;
+                if self.state.batched_invocation_results.is_some() {
+                    let oplog_idx = self.state.oplog.current_oplog_index().await;
+                    let idempotency_key = self.state.get_current_idempotency_key();
+                    if let (Some(batched_results), Some(idempotency_key)) =
+                        (&mut self.state.batched_invocation_results, idempotency_key)
+                    {
+                        batched_results.push((idempotency_key, output.clone(), oplog_idx));
+                    }
+                } else {
+                    self.state.oplog.commit().await;
+                    let oplog_idx = self.state.oplog.current_oplog_index().await;
+
+                    if let Some(idempotency_key) = self.state.get_current_idempotency_key() {
+                        self.public_state
+                            .worker()
+                            .store_invocation_success(&idempotency_key, output.clone(), oplog_idx)
+                            .await;
+                    }
                 }
             }
         } else {
@@ -817,6 +1079,22 @@ impl<Ctx: WorkerCtx> InvocationHooks for DurableWorkerCtx<Ctx> {
         // Return indicating that it is done
         Ok(())
     }
+
+    fn on_invocation_batch_started(&mut self) {
+        self.state.batched_invocation_results = Some(Vec::new());
+    }
+
+    async fn on_invocation_batch_finished(&mut self) {
+        if let Some(batched_results) = self.state.batched_invocation_results.take() {
+            self.state.oplog.commit().await;
+            for (idempotency_key, output, oplog_idx) in batched_results {
+                self.public_state
+                    .worker()
+                    .store_invocation_success(&idempotency_key, output, oplog_idx)
+                    .await;
+            }
+        }
+    }
 }
 
 #[async_trait]
@@ -882,6 +1160,13 @@ impl<Ctx: WorkerCtx> UpdateManagement for DurableWorkerCtx<Ctx> {
         );
     }
 
+    async fn on_snapshot_saved(&mut self, snapshot: &[u8]) -> Result<(), String> {
+        let payload = self.public_state.oplog.upload_payload(snapshot).await?;
+        self.record_snapshot(payload).await;
+        debug!("Saved a snapshot of {} bytes", snapshot.len());
+        Ok(())
+    }
+
     async fn on_worker_update_succeeded(
         &self,
         target_version: ComponentVersion,
@@ -976,6 +1261,13 @@ impl<Ctx: WorkerCtx + DurableWorkerCtxView<Ctx>> ExternalOperations<Ctx> for Dur
             .state
             .get_out_of_deleted_region();
 
+        if let Err(error) = Self::restore_last_snapshot(instance, store).await {
+            return Err(GolemError::failed_to_resume_worker(
+                worker_id.clone(),
+                error,
+            ));
+        }
+
         let result = loop {
             let cont = store.as_context().data().durable_ctx().state.is_replay();
 
@@ -1094,6 +1386,15 @@ impl<Ctx: WorkerCtx + DurableWorkerCtxView<Ctx>> ExternalOperations<Ctx> for Dur
         record_resume_worker(start.elapsed());
         record_number_of_replayed_functions(count);
 
+        // The initial allocation of the memories of a new or updated instance, and the growth
+        // during replay beyond the recorded size
+        store
+            .as_context_mut()
+            .data_mut()
+            .durable_ctx_mut()
+            .flush_memory_growth()
+            .await;
+
         let final_decision = Self::finalize_pending_update(&result, instance, store).await;
 
         // The update finalization has the right to override the Err result with an explicit retry request
@@ -1130,41 +1431,80 @@ impl<Ctx: WorkerCtx + DurableWorkerCtxView<Ctx>> ExternalOperations<Ctx> for Dur
 
         debug!("Recovering running workers: {:?}", workers);
 
-        let default_retry_config = &this.config().retry;
-        for worker in workers {
-            let owned_worker_id = worker.owned_worker_id();
-            let actualized_metadata =
-                calculate_last_known_status(this, &owned_worker_id, &Some(worker)).await?;
-            let last_error = Self::get_last_error_and_retry_count(this, &owned_worker_id).await;
-            let decision = Self::get_recovery_decision_on_startup(
-                actualized_metadata
-                    .overridden_retry_config
-                    .as_ref()
-                    .unwrap_or(default_retry_config),
-                &last_error,
-            );
-            if let Some(last_error) = last_error {
-                debug!("Recovery decision after {last_error}: {decision:?}");
-            }
-
-            match decision {
-                RecoveryDecision::Immediate => {
-                    let _ = Worker::get_or_create_running(
-                        this,
-                        &owned_worker_id,
-                        None,
-                        None,
-                        None,
-                        None,
-                    )
-                    .await?;
-                }
-                RecoveryDecision::Delayed(_) => {
-                    panic!("Delayed recovery on startup is not supported currently")
+        // Loading the distinct components of the recovered workers concurrently up front,
+        // instead of one by one as the workers get recovered. Like the recoveries, the number of
+        // components compiled or deserialized at once is bounded.
+        let components: HashSet<(ComponentId, ComponentVersion)> = workers
+            .iter()
+            .map(|worker| {
+                (
+                    worker.worker_id.component_id.clone(),
+                    worker.last_known_status.component_version,
+                )
+            })
+            .collect();
+        let engine = this.engine();
+        let component_service = this.component_service();
+        stream::iter(components.iter().map(|(component_id, component_version)| {
+            let engine = engine.clone();
+            let component_service = component_service.clone();
+            async move {
+                if let Err(err) = component_service
+                    .get(&engine, component_id, *component_version)
+                    .await
+                {
+                    warn!("Failed to preload component {component_id}#{component_version}: {err}");
                 }
-                RecoveryDecision::None => {}
             }
-        }
+        }))
+        .buffer_unordered(this.config().limits.max_concurrent_recoveries)
+        .collect::<Vec<_>>()
+        .await;
+
+        // Starting the recovered workers concurrently; loading their metadata and instantiating
+        // them would otherwise serialize the recovery of a whole shard
+        let default_retry_config = &this.config().retry;
+        stream::iter(workers.into_iter().map(Ok::<_, anyhow::Error>))
+            .try_for_each_concurrent(
+                this.config().limits.max_concurrent_recoveries,
+                |worker: WorkerMetadata| async move {
+                    let owned_worker_id = worker.owned_worker_id();
+                    let actualized_metadata =
+                        calculate_last_known_status(this, &owned_worker_id, &Some(worker)).await?;
+                    let last_error =
+                        Self::get_last_error_and_retry_count(this, &owned_worker_id).await;
+                    let decision = Self::get_recovery_decision_on_startup(
+                        actualized_metadata
+                            .overridden_retry_config
+                            .as_ref()
+                            .unwrap_or(default_retry_config),
+                        &last_error,
+                    );
+                    if let Some(last_error) = last_error {
+                        debug!("Recovery decision after {last_error}: {decision:?}");
+                    }
+
+                    match decision {
+                        RecoveryDecision::Immediate => {
+                            let _ = Worker::get_or_create_running(
+                                this,
+                                &owned_worker_id,
+                                None,
+                                None,
+                                None,
+                                None,
+                            )
+                            .await?;
+                        }
+                        RecoveryDecision::Delayed(_) => {
+                            panic!("Delayed recovery on startup is not supported currently")
+                        }
+                        RecoveryDecision::None => {}
+                    }
+                    Ok(())
+                },
+            )
+            .await?;
 
         info!("Finished recovering workers");
         Ok(())
@@ -1222,12 +1562,17 @@ pub struct PrivateDurableWorkerState {
     worker_service: Arc<dyn WorkerService + Send + Sync>,
     worker_enumeration_service: Arc<dyn worker_enumeration::WorkerEnumerationService + Send + Sync>,
     key_value_service: Arc<dyn KeyValueService + Send + Sync>,
+    /// Key-value mutations not yet written to the key-value service
+    key_value_write_buffer: KeyValueWriteBuffer,
+    /// How the key-value mutations are written, once it has been decided for this worker
+    key_value_write_mode: Option<KeyValueWriteMode>,
     blob_store_service: Arc<dyn BlobStoreService + Send + Sync>,
     config: Arc<GolemConfig>,
     owned_worker_id: OwnedWorkerId,
     current_idempotency_key: Option<IdempotencyKey>,
     rpc: Arc<dyn Rpc + Send + Sync>,
     worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
+    http_connection_pool: Arc<HttpConnectionPool>,
     resources: HashMap<u64, ResourceAny>,
     last_resource_id: u64,
     deleted_regions: DeletedRegions,
@@ -1240,10 +1585,26 @@ pub struct PrivateDurableWorkerState {
 
     /// The oplog index of the last replayed entry
     last_replayed_index: OplogIndex,
+    replay_buffer: ReplayBuffer,
     snapshotting_mode: Option<PersistenceLevel>,
+    /// Results of the invocations of the currently running batch, published once it is committed
+    batched_invocation_results: Option<Vec<(IdempotencyKey, Vec<Value>, OplogIndex)>>,
+    /// Guest output not yet emitted as a worker event, shared with the timers flushing it
+    output_buffer: Arc<Mutex<WorkerOutputBuffer>>,
+    /// Clock readings of the current invocation, if clock snapshots are enabled
+    clock_snapshot: SnapshotClock,
+    /// Whether the clock readings are derived from snapshots, once it has been decided for this
+    /// worker
+    clock_snapshot_enabled: Option<bool>,
 
     indexed_resources: HashMap<IndexedResourceKey, u64>,
     component_metadata: ComponentMetadata,
+    /// The highest total linear memory size of the worker
+    total_linear_memory_size: u64,
+    /// The sum of the sizes of the linear memories of the current instance
+    current_linear_memory_size: u64,
+    /// The total linear memory size written to the oplog so far
+    recorded_linear_memory_size: u64,
 }
 
 impl PrivateDurableWorkerState {
@@ -1262,10 +1623,18 @@ impl PrivateDurableWorkerState {
         owned_worker_id: OwnedWorkerId,
         rpc: Arc<dyn Rpc + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
+        http_connection_pool: Arc<HttpConnectionPool>,
         deleted_regions: DeletedRegions,
         last_oplog_index: OplogIndex,
         component_metadata: ComponentMetadata,
+        total_linear_memory_size: u64,
     ) -> Self {
+        let output_buffer = Arc::new(Mutex::new(WorkerOutputBuffer::new(&config.worker_output)));
+        let replay_buffer = ReplayBuffer::new(
+            oplog_service.clone(),
+            owned_worker_id.clone(),
+            config.oplog.replay_prefetch_size,
+        );
         let mut result = Self {
             oplog_service,
             oplog,
@@ -1274,12 +1643,15 @@ impl PrivateDurableWorkerState {
             worker_service,
             worker_enumeration_service,
             key_value_service,
+            key_value_write_buffer: KeyValueWriteBuffer::default(),
+            key_value_write_mode: None,
             blob_store_service,
             config,
             owned_worker_id,
             current_idempotency_key: None,
             rpc,
             worker_proxy,
+            http_connection_pool,
             resources: HashMap::new(),
             last_resource_id: 0,
             deleted_regions: deleted_regions.clone(),
@@ -1289,10 +1661,18 @@ impl PrivateDurableWorkerState {
             assume_idempotence: true,
             open_function_table: HashMap::new(),
             last_replayed_index: OplogIndex::NONE,
+            replay_buffer,
             replay_target: last_oplog_index,
             snapshotting_mode: None,
+            batched_invocation_results: None,
+            output_buffer,
+            clock_snapshot: SnapshotClock::default(),
+            clock_snapshot_enabled: None,
             indexed_resources: HashMap::new(),
             component_metadata,
+            total_linear_memory_size,
+            current_linear_memory_size: 0,
+            recorded_linear_memory_size: total_linear_memory_size,
         };
         result.move_replay_idx(OplogIndex::INITIAL); // By this we handle initial deleted regions applied by manual updates correctly
         result
@@ -1367,14 +1747,6 @@ impl PrivateDurableWorkerState {
         }
     }
 
-    async fn read_oplog(&self, idx: OplogIndex, n: u64) -> Vec<OplogEntry> {
-        self.oplog_service
-            .read(&self.owned_worker_id, idx, n)
-            .await
-            .into_values()
-            .collect()
-    }
-
     /// Returns whether we are in live mode where we are executing new calls.
     pub fn is_live(&self) -> bool {
         self.last_replayed_index == self.replay_target
@@ -1415,21 +1787,24 @@ impl PrivateDurableWorkerState {
     async fn get_oplog_entry(&mut self) -> (OplogIndex, OplogEntry) {
         let read_idx = self.last_replayed_index.next();
         let entry = self.internal_get_next_oplog_entry().await;
+        self.skip_hints().await;
+        (read_idx, entry)
+    }
 
-        // Skipping hint entries
+    /// Reads the hint entries following the last replayed entry, stopping before the next
+    /// non-hint entry
+    async fn skip_hints(&mut self) {
         while self.is_replay() {
             let saved_replay_idx = self.last_replayed_index;
             let saved_next_deleted_region = self.next_deleted_region.clone();
             let entry = self.internal_get_next_oplog_entry().await;
             if !entry.is_hint() {
-                // TODO: cache the last hint entry to avoid reading it again
+                // The entry stays in the replay buffer, so reading it again is cheap
                 self.last_replayed_index = saved_replay_idx;
                 self.next_deleted_region = saved_next_deleted_region;
                 break;
             }
         }
-
-        (read_idx, entry)
     }
 
     /// Gets the next oplog entry, no matter if it is hint or not, following jumps
@@ -1438,9 +1813,24 @@ impl PrivateDurableWorkerState {
 
         let read_idx = self.last_replayed_index.next();
 
-        let oplog_entries = self.read_oplog(read_idx, 1).await;
-        let oplog_entry = oplog_entries.into_iter().next().unwrap();
+        let oplog_entry = self.replay_buffer.get(read_idx, self.replay_target).await;
         self.move_replay_idx(read_idx);
+        if self.is_live() {
+            self.replay_buffer.clear();
+        }
+
+        if let OplogEntry::KeyValueWriteBehind {
+            max_buffered_writes,
+            ..
+        } = &oplog_entry
+        {
+            self.key_value_write_mode = Some(KeyValueWriteMode::WriteBehind {
+                max_buffered_writes: *max_buffered_writes as usize,
+            });
+        }
+        if let OplogEntry::ClockSnapshotMode { .. } = &oplog_entry {
+            self.clock_snapshot_enabled = Some(true);
+        }
 
         oplog_entry
     }
@@ -1762,6 +2152,12 @@ impl<'a, Ctx: WorkerCtx> WasiHttpView for DurableWorkerCtxWasiHttpView<'a, Ctx>
             // If that is the case, the request has to be sent as soon as we get into live mode and trying to await
             // or poll the response future.
             Ok(HostFutureIncomingResponse::deferred(request, config))
+        } else if self.0.state.config.outgoing_http.connection_pool {
+            Ok(self
+                .0
+                .state
+                .http_connection_pool
+                .send_request(request, config))
         } else {
             Ok(default_send_request(request, config))
         }
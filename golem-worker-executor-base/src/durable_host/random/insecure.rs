@@ -24,7 +24,7 @@ use wasmtime_wasi::bindings::random::insecure::Host;
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn get_insecure_random_bytes(&mut self, len: u64) -> anyhow::Result<Vec<u8>> {
-        record_host_function_call("random::insecure", "get_insecure_random_bytes");
+        let _timer = record_host_function_call("random::insecure", "get_insecure_random_bytes");
         Durability::<Ctx, Vec<u8>, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -39,7 +39,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     }
 
     async fn get_insecure_random_u64(&mut self) -> anyhow::Result<u64> {
-        record_host_function_call("random::insecure", "get_insecure_random_u64");
+        let _timer = record_host_function_call("random::insecure", "get_insecure_random_u64");
         Durability::<Ctx, u64, SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
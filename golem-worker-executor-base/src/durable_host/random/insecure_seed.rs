@@ -24,7 +24,7 @@ use wasmtime_wasi::bindings::random::insecure_seed::Host;
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     async fn insecure_seed(&mut self) -> anyhow::Result<(u64, u64)> {
-        record_host_function_call("random::insecure_seed", "insecure_seed");
+        let _timer = record_host_function_call("random::insecure_seed", "insecure_seed");
         Durability::<Ctx, (u64, u64), SerializableError>::wrap(
             self,
             WrappedFunctionType::ReadLocal,
@@ -0,0 +1,217 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::collections::{BTreeMap, VecDeque};
+use std::sync::Arc;
+
+use golem_common::model::oplog::{OplogEntry, OplogIndex};
+use golem_common::model::OwnedWorkerId;
+use tokio::task::JoinHandle;
+use tracing::warn;
+
+use crate::services::oplog::OplogService;
+
+/// Read-ahead buffer of the oplog entries to be replayed.
+///
+/// Instead of reading the oplog one entry at a time as the guest reaches each replayed host
+/// function, entries are read and decoded in chunks. As soon as a chunk is taken into use, the
+/// next one is fetched by a background task, so replay only waits for the storage when it
+/// consumes entries faster than they can be read, or when it jumps over a deleted region.
+pub struct ReplayBuffer {
+    oplog_service: Arc<dyn OplogService + Send + Sync>,
+    owned_worker_id: OwnedWorkerId,
+    chunk_size: u64,
+    /// Entries read ahead, in increasing oplog index order
+    entries: VecDeque<(OplogIndex, OplogEntry)>,
+    /// The chunk being fetched in the background, with the index of its first entry
+    next_chunk: Option<(OplogIndex, JoinHandle<BTreeMap<OplogIndex, OplogEntry>>)>,
+}
+
+impl ReplayBuffer {
+    pub fn new(
+        oplog_service: Arc<dyn OplogService + Send + Sync>,
+        owned_worker_id: OwnedWorkerId,
+        chunk_size: u64,
+    ) -> Self {
+        Self {
+            oplog_service,
+            owned_worker_id,
+            chunk_size: chunk_size.max(1),
+            entries: VecDeque::new(),
+            next_chunk: None,
+        }
+    }
+
+    /// Gets the entry at `idx`, which must not be after `replay_target`.
+    ///
+    /// Entries before `idx` are dropped from the buffer, but the entry itself is kept, so
+    /// reading the same index again (as done when looking ahead for hint entries) does not
+    /// access the storage.
+    pub async fn get(&mut self, idx: OplogIndex, replay_target: OplogIndex) -> OplogEntry {
+        while matches!(self.entries.front(), Some((front, _)) if *front < idx) {
+            self.entries.pop_front();
+        }
+
+        if !matches!(self.entries.front(), Some((front, _)) if *front == idx) {
+            self.entries.clear();
+            let chunk = match self.next_chunk.take() {
+                Some((start, handle))
+                    if start <= idx && idx <= start.range_end(self.chunk_size) =>
+                {
+                    match handle.await {
+                        Ok(chunk) => chunk,
+                        Err(err) => {
+                            warn!("Prefetching oplog entries failed: {err}");
+                            self.read_chunk(idx, replay_target).await
+                        }
+                    }
+                }
+                Some((_, handle)) => {
+                    // Jumped over the prefetched chunk
+                    handle.abort();
+                    self.read_chunk(idx, replay_target).await
+                }
+                None => self.read_chunk(idx, replay_target).await,
+            };
+            self.entries.extend(
+                chunk
+                    .into_iter()
+                    .skip_while(|(entry_idx, _)| *entry_idx < idx),
+            );
+        }
+
+        let entry = match self.entries.front() {
+            Some((front, entry)) if *front == idx => entry.clone(),
+            _ => panic!(
+                "Missing oplog entry {idx} of {} during replay",
+                self.owned_worker_id
+            ),
+        };
+        self.prefetch_next_chunk(replay_target);
+        entry
+    }
+
+    /// Drops all the buffered entries, for example when the worker switches to live mode
+    pub fn clear(&mut self) {
+        self.entries.clear();
+        if let Some((_, handle)) = self.next_chunk.take() {
+            handle.abort();
+        }
+    }
+
+    async fn read_chunk(
+        &self,
+        idx: OplogIndex,
+        replay_target: OplogIndex,
+    ) -> BTreeMap<OplogIndex, OplogEntry> {
+        self.oplog_service
+            .read(
+                &self.owned_worker_id,
+                idx,
+                Self::chunk_length(idx, replay_target, self.chunk_size),
+            )
+            .await
+    }
+
+    fn prefetch_next_chunk(&mut self, replay_target: OplogIndex) {
+        if self.next_chunk.is_some() {
+            return;
+        }
+        if let Some((last, _)) = self.entries.back() {
+            let start = last.next();
+            if start <= replay_target {
+                let n = Self::chunk_length(start, replay_target, self.chunk_size);
+                let oplog_service = self.oplog_service.clone();
+                let owned_worker_id = self.owned_worker_id.clone();
+                let handle =
+                    tokio::spawn(
+                        async move { oplog_service.read(&owned_worker_id, start, n).await },
+                    );
+                self.next_chunk = Some((start, handle));
+            }
+        }
+    }
+
+    fn chunk_length(start: OplogIndex, replay_target: OplogIndex, chunk_size: u64) -> u64 {
+        let remaining = Into::<u64>::into(replay_target) - Into::<u64>::into(start) + 1;
+        remaining.min(chunk_size)
+    }
+}
+
+impl Drop for ReplayBuffer {
+    fn drop(&mut self) {
+        self.clear();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::Arc;
+    use std::time::Duration;
+
+    use golem_common::model::oplog::{OplogEntry, OplogIndex};
+    use golem_common::model::regions::OplogRegion;
+    use golem_common::model::{AccountId, ComponentId, OwnedWorkerId, WorkerId};
+    use uuid::Uuid;
+
+    use crate::durable_host::replay::ReplayBuffer;
+    use crate::services::oplog::{OplogService, PrimaryOplogService};
+    use crate::storage::blob::memory::InMemoryBlobStorage;
+    use crate::storage::indexed::memory::InMemoryIndexedStorage;
+
+    #[tokio::test]
+    async fn replay_buffer_reads_ahead_and_follows_jumps() {
+        let oplog_service = Arc::new(
+            PrimaryOplogService::new(
+                Arc::new(InMemoryIndexedStorage::new()),
+                Arc::new(InMemoryBlobStorage::new()),
+                1,
+                100,
+                Duration::ZERO,
+                1024,
+            )
+            .await,
+        );
+        let owned_worker_id = OwnedWorkerId::new(
+            &AccountId {
+                value: "user1".to_string(),
+            },
+            &WorkerId {
+                component_id: ComponentId(Uuid::new_v4()),
+                worker_name: "replay-buffer".to_string(),
+            },
+        );
+
+        let oplog = oplog_service.open(&owned_worker_id).await;
+        for i in 1..=20 {
+            oplog
+                .add_and_commit(OplogEntry::jump(OplogRegion {
+                    start: OplogIndex::from_u64(i),
+                    end: OplogIndex::from_u64(i),
+                }))
+                .await;
+        }
+        let replay_target = oplog.current_oplog_index().await;
+        let expected = oplog_service
+            .read(&owned_worker_id, OplogIndex::INITIAL, 20)
+            .await;
+
+        let mut buffer = ReplayBuffer::new(oplog_service.clone(), owned_worker_id.clone(), 3);
+        for idx in [1, 2, 2, 3, 4, 5, 6, 6, 7, 12, 13, 19, 20] {
+            let idx = OplogIndex::from_u64(idx);
+            let entry = buffer.get(idx, replay_target).await;
+            assert_eq!(Some(&entry), expected.get(&idx));
+        }
+    }
+}
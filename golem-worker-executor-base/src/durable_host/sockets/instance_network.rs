@@ -23,7 +23,7 @@ use wasmtime_wasi::bindings::sockets::instance_network::{Host, Network};
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn instance_network(&mut self) -> anyhow::Result<Resource<Network>> {
-        record_host_function_call("sockets::instance_network", "instance_network");
+        let _timer = record_host_function_call("sockets::instance_network", "instance_network");
         Host::instance_network(&mut self.as_wasi_view())
     }
 }
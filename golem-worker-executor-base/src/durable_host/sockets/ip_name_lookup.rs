@@ -33,7 +33,7 @@ impl<Ctx: WorkerCtx> HostResolveAddressStream for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<ResolveAddressStream>,
     ) -> Result<Option<IpAddress>, SocketError> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "sockets::ip_name_lookup::resolve_address_stream",
             "resolve_next_address",
         );
@@ -44,7 +44,7 @@ impl<Ctx: WorkerCtx> HostResolveAddressStream for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<ResolveAddressStream>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call(
+        let _timer = record_host_function_call(
             "sockets::ip_name_lookup::resolve_address_stream",
             "subscribe",
         );
@@ -52,7 +52,8 @@ impl<Ctx: WorkerCtx> HostResolveAddressStream for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<ResolveAddressStream>) -> anyhow::Result<()> {
-        record_host_function_call("sockets::ip_name_lookup::resolve_address_stream", "drop");
+        let _timer =
+            record_host_function_call("sockets::ip_name_lookup::resolve_address_stream", "drop");
         HostResolveAddressStream::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -64,7 +65,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         network: Resource<Network>,
         name: String,
     ) -> Result<Resource<ResolveAddressStream>, SocketError> {
-        record_host_function_call("sockets::ip_name_lookup", "resolve_addresses");
+        let _timer = record_host_function_call("sockets::ip_name_lookup", "resolve_addresses");
 
         let addresses: Result<Vec<IpAddress>, SocketError> =
             Durability::<Ctx, SerializableIpAddresses, SerializableError>::wrap(
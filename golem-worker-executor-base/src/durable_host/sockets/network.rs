@@ -23,7 +23,7 @@ use wasmtime_wasi::SocketError;
 
 impl<Ctx: WorkerCtx> HostNetwork for DurableWorkerCtx<Ctx> {
     fn drop(&mut self, rep: Resource<Network>) -> anyhow::Result<()> {
-        record_host_function_call("sockets::network", "drop_network");
+        let _timer = record_host_function_call("sockets::network", "drop_network");
         HostNetwork::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -31,7 +31,7 @@ impl<Ctx: WorkerCtx> HostNetwork for DurableWorkerCtx<Ctx> {
 #[async_trait]
 impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
     fn convert_error_code(&mut self, err: SocketError) -> anyhow::Result<ErrorCode> {
-        record_host_function_call("sockets::network", "convert_error_code");
+        let _timer = record_host_function_call("sockets::network", "convert_error_code");
         Host::convert_error_code(&mut self.as_wasi_view(), err)
     }
 }
@@ -32,12 +32,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         network: Resource<Network>,
         local_address: IpSocketAddress,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "start_bind");
+        let _timer = record_host_function_call("sockets::tcp", "start_bind");
         HostTcpSocket::start_bind(&mut self.as_wasi_view(), self_, network, local_address)
     }
 
     fn finish_bind(&mut self, self_: Resource<TcpSocket>) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "finish_bind");
+        let _timer = record_host_function_call("sockets::tcp", "finish_bind");
         HostTcpSocket::finish_bind(&mut self.as_wasi_view(), self_)
     }
 
@@ -47,7 +47,7 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         network: Resource<Network>,
         remote_address: IpSocketAddress,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "start_connect");
+        let _timer = record_host_function_call("sockets::tcp", "start_connect");
         HostTcpSocket::start_connect(&mut self.as_wasi_view(), self_, network, remote_address)
     }
 
@@ -55,17 +55,17 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<TcpSocket>,
     ) -> Result<(Resource<InputStream>, Resource<OutputStream>), SocketError> {
-        record_host_function_call("sockets::tcp", "finish_connect");
+        let _timer = record_host_function_call("sockets::tcp", "finish_connect");
         HostTcpSocket::finish_connect(&mut self.as_wasi_view(), self_)
     }
 
     fn start_listen(&mut self, self_: Resource<TcpSocket>) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "start_listen");
+        let _timer = record_host_function_call("sockets::tcp", "start_listen");
         HostTcpSocket::start_listen(&mut self.as_wasi_view(), self_)
     }
 
     fn finish_listen(&mut self, self_: Resource<TcpSocket>) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "finish_listen");
+        let _timer = record_host_function_call("sockets::tcp", "finish_listen");
         HostTcpSocket::finish_listen(&mut self.as_wasi_view(), self_)
     }
 
@@ -80,7 +80,7 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         ),
         SocketError,
     > {
-        record_host_function_call("sockets::tcp", "accept");
+        let _timer = record_host_function_call("sockets::tcp", "accept");
         HostTcpSocket::accept(&mut self.as_wasi_view(), self_)
     }
 
@@ -88,7 +88,7 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<TcpSocket>,
     ) -> Result<IpSocketAddress, SocketError> {
-        record_host_function_call("sockets::tcp", "local_address");
+        let _timer = record_host_function_call("sockets::tcp", "local_address");
         HostTcpSocket::local_address(&mut self.as_wasi_view(), self_)
     }
 
@@ -96,17 +96,17 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<TcpSocket>,
     ) -> Result<IpSocketAddress, SocketError> {
-        record_host_function_call("sockets::tcp", "remote_address");
+        let _timer = record_host_function_call("sockets::tcp", "remote_address");
         HostTcpSocket::remote_address(&mut self.as_wasi_view(), self_)
     }
 
     fn is_listening(&mut self, self_: Resource<TcpSocket>) -> anyhow::Result<bool> {
-        record_host_function_call("sockets::tcp", "is_listening");
+        let _timer = record_host_function_call("sockets::tcp", "is_listening");
         HostTcpSocket::is_listening(&mut self.as_wasi_view(), self_)
     }
 
     fn address_family(&mut self, self_: Resource<TcpSocket>) -> anyhow::Result<IpAddressFamily> {
-        record_host_function_call("sockets::tcp", "address_family");
+        let _timer = record_host_function_call("sockets::tcp", "address_family");
         HostTcpSocket::address_family(&mut self.as_wasi_view(), self_)
     }
 
@@ -115,12 +115,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: u64,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_listen_backlog_size");
+        let _timer = record_host_function_call("sockets::tcp", "set_listen_backlog_size");
         HostTcpSocket::set_listen_backlog_size(&mut self.as_wasi_view(), self_, value)
     }
 
     fn keep_alive_enabled(&mut self, self_: Resource<TcpSocket>) -> Result<bool, SocketError> {
-        record_host_function_call("sockets::tcp", "keep_alive_enabled");
+        let _timer = record_host_function_call("sockets::tcp", "keep_alive_enabled");
         HostTcpSocket::keep_alive_enabled(&mut self.as_wasi_view(), self_)
     }
 
@@ -129,7 +129,7 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: bool,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_keep_alive_enabled");
+        let _timer = record_host_function_call("sockets::tcp", "set_keep_alive_enabled");
         HostTcpSocket::set_keep_alive_enabled(&mut self.as_wasi_view(), self_, value)
     }
 
@@ -137,7 +137,7 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         &mut self,
         self_: Resource<TcpSocket>,
     ) -> Result<Duration, SocketError> {
-        record_host_function_call("sockets::tcp", "keep_alive_idle_time");
+        let _timer = record_host_function_call("sockets::tcp", "keep_alive_idle_time");
         HostTcpSocket::keep_alive_idle_time(&mut self.as_wasi_view(), self_)
     }
 
@@ -146,12 +146,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: Duration,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_keep_alive_idle_time");
+        let _timer = record_host_function_call("sockets::tcp", "set_keep_alive_idle_time");
         HostTcpSocket::set_keep_alive_idle_time(&mut self.as_wasi_view(), self_, value)
     }
 
     fn keep_alive_interval(&mut self, self_: Resource<TcpSocket>) -> Result<Duration, SocketError> {
-        record_host_function_call("sockets::tcp", "keep_alive_interval");
+        let _timer = record_host_function_call("sockets::tcp", "keep_alive_interval");
         HostTcpSocket::keep_alive_interval(&mut self.as_wasi_view(), self_)
     }
 
@@ -160,12 +160,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: Duration,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_keep_alive_interval");
+        let _timer = record_host_function_call("sockets::tcp", "set_keep_alive_interval");
         HostTcpSocket::set_keep_alive_interval(&mut self.as_wasi_view(), self_, value)
     }
 
     fn keep_alive_count(&mut self, self_: Resource<TcpSocket>) -> Result<u32, SocketError> {
-        record_host_function_call("sockets::tcp", "keep_alive_count");
+        let _timer = record_host_function_call("sockets::tcp", "keep_alive_count");
         HostTcpSocket::keep_alive_count(&mut self.as_wasi_view(), self_)
     }
 
@@ -174,22 +174,22 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: u32,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_keep_alive_count");
+        let _timer = record_host_function_call("sockets::tcp", "set_keep_alive_count");
         HostTcpSocket::set_keep_alive_count(&mut self.as_wasi_view(), self_, value)
     }
 
     fn hop_limit(&mut self, self_: Resource<TcpSocket>) -> Result<u8, SocketError> {
-        record_host_function_call("sockets::tcp", "hop_limit");
+        let _timer = record_host_function_call("sockets::tcp", "hop_limit");
         HostTcpSocket::hop_limit(&mut self.as_wasi_view(), self_)
     }
 
     fn set_hop_limit(&mut self, self_: Resource<TcpSocket>, value: u8) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_hop_limit");
+        let _timer = record_host_function_call("sockets::tcp", "set_hop_limit");
         HostTcpSocket::set_hop_limit(&mut self.as_wasi_view(), self_, value)
     }
 
     fn receive_buffer_size(&mut self, self_: Resource<TcpSocket>) -> Result<u64, SocketError> {
-        record_host_function_call("sockets::tcp", "receive_buffer_size");
+        let _timer = record_host_function_call("sockets::tcp", "receive_buffer_size");
         HostTcpSocket::receive_buffer_size(&mut self.as_wasi_view(), self_)
     }
 
@@ -198,12 +198,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: u64,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_receive_buffer_size");
+        let _timer = record_host_function_call("sockets::tcp", "set_receive_buffer_size");
         HostTcpSocket::set_receive_buffer_size(&mut self.as_wasi_view(), self_, value)
     }
 
     fn send_buffer_size(&mut self, self_: Resource<TcpSocket>) -> Result<u64, SocketError> {
-        record_host_function_call("sockets::tcp", "send_buffer_size");
+        let _timer = record_host_function_call("sockets::tcp", "send_buffer_size");
         HostTcpSocket::send_buffer_size(&mut self.as_wasi_view(), self_)
     }
 
@@ -212,12 +212,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         value: u64,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "set_send_buffer_size");
+        let _timer = record_host_function_call("sockets::tcp", "set_send_buffer_size");
         HostTcpSocket::set_send_buffer_size(&mut self.as_wasi_view(), self_, value)
     }
 
     fn subscribe(&mut self, self_: Resource<TcpSocket>) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("sockets::tcp", "subscribe");
+        let _timer = record_host_function_call("sockets::tcp", "subscribe");
         HostTcpSocket::subscribe(&mut self.as_wasi_view(), self_)
     }
 
@@ -226,12 +226,12 @@ impl<Ctx: WorkerCtx> HostTcpSocket for DurableWorkerCtx<Ctx> {
         self_: Resource<TcpSocket>,
         shutdown_type: ShutdownType,
     ) -> Result<(), SocketError> {
-        record_host_function_call("sockets::tcp", "shutdown");
+        let _timer = record_host_function_call("sockets::tcp", "shutdown");
         HostTcpSocket::shutdown(&mut self.as_wasi_view(), self_, shutdown_type)
     }
 
     fn drop(&mut self, rep: Resource<TcpSocket>) -> anyhow::Result<()> {
-        record_host_function_call("sockets::tcp", "drop");
+        let _timer = record_host_function_call("sockets::tcp", "drop");
         HostTcpSocket::drop(&mut self.as_wasi_view(), rep)
     }
 }
@@ -27,7 +27,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         &mut self,
         address_family: IpAddressFamily,
     ) -> Result<Resource<TcpSocket>, SocketError> {
-        record_host_function_call("sockets::tcp_create_socket", "create_tcp_socket");
+        let _timer = record_host_function_call("sockets::tcp_create_socket", "create_tcp_socket");
         Host::create_tcp_socket(&mut self.as_wasi_view(), address_family)
     }
 }
@@ -27,7 +27,7 @@ impl<Ctx: WorkerCtx> Host for DurableWorkerCtx<Ctx> {
         &mut self,
         address_family: IpAddressFamily,
     ) -> Result<Resource<UdpSocket>, SocketError> {
-        record_host_function_call("sockets::udp_create_socket", "create_udp_socket");
+        let _timer = record_host_function_call("sockets::udp_create_socket", "create_udp_socket");
         Host::create_udp_socket(&mut self.as_wasi_view(), address_family)
     }
 }
@@ -44,7 +44,7 @@ use wasmtime_wasi::subscribe;
 #[async_trait]
 impl<Ctx: WorkerCtx> HostWasmRpc for DurableWorkerCtx<Ctx> {
     async fn new(&mut self, location: Uri) -> anyhow::Result<Resource<WasmRpcEntry>> {
-        record_host_function_call("golem::rpc::wasm-rpc", "new");
+        let _timer = record_host_function_call("golem::rpc::wasm-rpc", "new");
 
         match location.parse_as_golem_uri() {
             Some((remote_worker_id, None)) => {
@@ -72,7 +72,7 @@ impl<Ctx: WorkerCtx> HostWasmRpc for DurableWorkerCtx<Ctx> {
         function_name: String,
         function_params: Vec<WitValue>,
     ) -> anyhow::Result<Result<WitValue, golem_wasm_rpc::RpcError>> {
-        record_host_function_call("golem::rpc::wasm-rpc", "invoke-and-await");
+        let _timer = record_host_function_call("golem::rpc::wasm-rpc", "invoke-and-await");
 
         let entry = self.table().get(&self_)?;
         let payload = entry.payload.downcast_ref::<WasmRpcEntryPayload>().unwrap();
@@ -138,7 +138,7 @@ impl<Ctx: WorkerCtx> HostWasmRpc for DurableWorkerCtx<Ctx> {
         function_name: String,
         function_params: Vec<WitValue>,
     ) -> anyhow::Result<Result<(), golem_wasm_rpc::RpcError>> {
-        record_host_function_call("golem::rpc::wasm-rpc", "invoke");
+        let _timer = record_host_function_call("golem::rpc::wasm-rpc", "invoke");
 
         let entry = self.table().get(&self_)?;
         let payload = entry.payload.downcast_ref::<WasmRpcEntryPayload>().unwrap();
@@ -201,7 +201,7 @@ impl<Ctx: WorkerCtx> HostWasmRpc for DurableWorkerCtx<Ctx> {
         function_name: String,
         function_params: Vec<WitValue>,
     ) -> anyhow::Result<Resource<FutureInvokeResult>> {
-        record_host_function_call("golem::rpc::wasm-rpc", "async-invoke-and-await");
+        let _timer = record_host_function_call("golem::rpc::wasm-rpc", "async-invoke-and-await");
         let begin_index = self
             .state
             .begin_function(&WrappedFunctionType::WriteRemote)
@@ -285,7 +285,7 @@ impl<Ctx: WorkerCtx> HostWasmRpc for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, rep: Resource<WasmRpcEntry>) -> anyhow::Result<()> {
-        record_host_function_call("golem::rpc::wasm-rpc", "drop");
+        let _timer = record_host_function_call("golem::rpc::wasm-rpc", "drop");
 
         let _ = self.table().delete(rep)?;
         Ok(())
@@ -350,7 +350,7 @@ impl<Ctx: WorkerCtx> HostFutureInvokeResult for DurableWorkerCtx<Ctx> {
         &mut self,
         this: Resource<FutureInvokeResult>,
     ) -> anyhow::Result<Resource<Pollable>> {
-        record_host_function_call("golem::rpc::future-invoke-result", "subscribe");
+        let _timer = record_host_function_call("golem::rpc::future-invoke-result", "subscribe");
         subscribe(self.table(), this, None)
     }
 
@@ -358,7 +358,7 @@ impl<Ctx: WorkerCtx> HostFutureInvokeResult for DurableWorkerCtx<Ctx> {
         &mut self,
         this: Resource<FutureInvokeResult>,
     ) -> anyhow::Result<Option<Result<WitValue, golem_wasm_rpc::RpcError>>> {
-        record_host_function_call("golem::rpc::future-invoke-result", "get");
+        let _timer = record_host_function_call("golem::rpc::future-invoke-result", "get");
         let rpc = self.rpc();
 
         let handle = this.rep();
@@ -521,7 +521,7 @@ impl<Ctx: WorkerCtx> HostFutureInvokeResult for DurableWorkerCtx<Ctx> {
     }
 
     fn drop(&mut self, this: Resource<FutureInvokeResult>) -> anyhow::Result<()> {
-        record_host_function_call("golem::rpc::future-invoke-result", "drop");
+        let _timer = record_host_function_call("golem::rpc::future-invoke-result", "drop");
         let _ = self.table().delete(this)?;
         Ok(())
     }
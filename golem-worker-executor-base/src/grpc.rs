@@ -36,6 +36,7 @@ use golem_common::model::{
     WorkerMetadata, WorkerStatus, WorkerStatusRecord,
 };
 use golem_wasm_rpc::protobuf::Val;
+use tokio::sync::broadcast::error::RecvError;
 use tokio::sync::mpsc;
 use tokio_stream::wrappers::ReceiverStream;
 use tonic::{Request, Response, Status};
@@ -51,10 +52,10 @@ use crate::services::worker_activator::{DefaultWorkerActivator, LazyWorkerActiva
 use crate::services::worker_event::LogLevel;
 use crate::services::{
     worker_event, All, HasActiveWorkers, HasAll, HasPromiseService,
-    HasRunningWorkerEnumerationService, HasShardManagerService, HasShardService,
-    HasWorkerEnumerationService, HasWorkerService, UsesAllDeps,
+    HasRunningWorkerEnumerationService, HasSchedulerService, HasShardManagerService,
+    HasShardService, HasWorkerEnumerationService, HasWorkerService, UsesAllDeps,
 };
-use crate::worker::Worker;
+use crate::worker::{Worker, WorkerInUse};
 use crate::workerctx::WorkerCtx;
 
 pub enum GrpcError<E> {
@@ -167,6 +168,11 @@ impl<Ctx: WorkerCtx, Svcs: HasAll<Ctx> + UsesAllDeps<Ctx = Ctx> + Send + Sync +
             shard_assignment.number_of_shards,
             &shard_assignment.shard_ids,
         );
+        worker_executor
+            .scheduler_service()
+            .load_assigned()
+            .await
+            .map_err(GolemError::unknown)?;
 
         info!("Registered worker executor, waiting for shard assignment...");
 
@@ -540,10 +546,52 @@ impl<Ctx: WorkerCtx, Svcs: HasAll<Ctx> + UsesAllDeps<Ctx = Ctx> + Send + Sync +
         Ok(golem::workerexecutor::InvokeAndAwaitWorkerSuccess { output })
     }
 
+    async fn invoke_and_await_worker_batch_internal(
+        &self,
+        request: &golem::workerexecutor::InvokeAndAwaitWorkerBatchRequest,
+    ) -> Result<golem::workerexecutor::InvokeAndAwaitWorkerBatchSuccess, GolemError> {
+        let mut invocations = Vec::new();
+        for invocation in &request.invocations {
+            let function_input = invocation
+                .input
+                .iter()
+                .map(|val| val.clone().try_into())
+                .collect::<Result<Vec<_>, _>>()
+                .map_err(|msg| GolemError::ValueMismatch { details: msg })?;
+            let calling_convention = match invocation.calling_convention() {
+                golem::worker::CallingConvention::Component => CallingConvention::Component,
+                golem::worker::CallingConvention::Stdio => CallingConvention::Stdio,
+            };
+            let idempotency_key = invocation
+                .idempotency_key
+                .clone()
+                .map(IdempotencyKey::from)
+                .unwrap_or(IdempotencyKey::fresh());
+            invocations.push((
+                idempotency_key,
+                calling_convention,
+                invocation.name.clone(),
+                function_input,
+            ));
+        }
+
+        let worker = self.get_or_create(request).await?;
+        let results = worker.invoke_and_await_batch(invocations).await?;
+        let results = results
+            .into_iter()
+            .map(
+                |values| golem::workerexecutor::InvokeAndAwaitWorkerSuccess {
+                    output: values.into_iter().map(|val| val.into()).collect(),
+                },
+            )
+            .collect();
+        Ok(golem::workerexecutor::InvokeAndAwaitWorkerBatchSuccess { results })
+    }
+
     async fn get_or_create<Req: GrpcInvokeRequest>(
         &self,
         request: &Req,
-    ) -> Result<Arc<Worker<Ctx>>, GolemError> {
+    ) -> Result<WorkerInUse<Ctx>, GolemError> {
         let worker = self.get_or_create_pending(request).await?;
         Worker::start_if_needed(worker.clone()).await?;
         Ok(worker)
@@ -552,7 +600,7 @@ impl<Ctx: WorkerCtx, Svcs: HasAll<Ctx> + UsesAllDeps<Ctx = Ctx> + Send + Sync +
     async fn get_or_create_pending<Req: GrpcInvokeRequest>(
         &self,
         request: &Req,
-    ) -> Result<Arc<Worker<Ctx>>, GolemError> {
+    ) -> Result<WorkerInUse<Ctx>, GolemError> {
         let worker_id = request.worker_id()?;
         let account_id: AccountId = request.account_id()?;
         let owned_worker_id = OwnedWorkerId::new(&account_id, &worker_id);
@@ -645,6 +693,10 @@ impl<Ctx: WorkerCtx, Svcs: HasAll<Ctx> + UsesAllDeps<Ctx = Ctx> + Send + Sync +
         let shard_ids = proto_shard_ids.into_iter().map(ShardId::from).collect();
 
         self.shard_service().assign_shards(&shard_ids);
+        self.scheduler_service()
+            .load_assigned()
+            .await
+            .map_err(GolemError::unknown)?;
         Ctx::on_shard_assignment_changed(self).await?;
 
         Ok(())
@@ -951,94 +1003,71 @@ impl<Ctx: WorkerCtx, Svcs: HasAll<Ctx> + UsesAllDeps<Ctx = Ctx> + Send + Sync +
 
                 tokio::spawn(
                     async move {
-                        while let Ok(item) = receiver.recv().await {
-                            match item {
-                                worker_event::WorkerEvent::Close => {
-                                    break;
-                                }
-                                worker_event::WorkerEvent::StdOut(line) => {
-                                    match tx
-                                        .send(Result::<_, Status>::Ok(golem::worker::LogEvent {
-                                            event: Some(golem::worker::log_event::Event::Stdout(
-                                                golem::worker::StdOutLog {
-                                                    message: String::from_utf8(line).unwrap(),
-                                                },
-                                            )),
-                                        }))
-                                        .await
-                                    {
-                                        Ok(_) => {
-                                            // item (server response) was queued to be send to client
-                                        }
-                                        Err(_item) => {
-                                            // output_stream was build from rx and both are dropped
-                                            break;
-                                        }
-                                    }
-                                }
-                                worker_event::WorkerEvent::StdErr(line) => {
-                                    match tx
-                                        .send(Result::<_, Status>::Ok(golem::worker::LogEvent {
-                                            event: Some(golem::worker::log_event::Event::Stderr(
-                                                golem::worker::StdErrLog {
-                                                    message: String::from_utf8(line).unwrap(),
-                                                },
-                                            )),
-                                        }))
-                                        .await
-                                    {
-                                        Ok(_) => {
-                                            // item (server response) was queued to be send to client
-                                        }
-                                        Err(_item) => {
-                                            // output_stream was build from rx and both are dropped
-                                            break;
-                                        }
+                        loop {
+                            let event = match receiver.recv().await {
+                                Ok(event) => match &*event {
+                                    worker_event::WorkerEvent::Close => {
+                                        break;
                                     }
-                                }
-                                worker_event::WorkerEvent::Log {
-                                    level,
-                                    context,
-                                    message,
-                                } => match tx
-                                    .send(Result::<_, Status>::Ok(golem::worker::LogEvent {
-                                        event: Some(golem::worker::log_event::Event::Log(
-                                            golem::worker::Log {
-                                                level: match level {
-                                                    LogLevel::Trace => {
-                                                        golem::worker::Level::Trace.into()
-                                                    }
-                                                    LogLevel::Debug => {
-                                                        golem::worker::Level::Debug.into()
-                                                    }
-                                                    LogLevel::Info => {
-                                                        golem::worker::Level::Info.into()
-                                                    }
-                                                    LogLevel::Warn => {
-                                                        golem::worker::Level::Warn.into()
-                                                    }
-                                                    LogLevel::Error => {
-                                                        golem::worker::Level::Error.into()
-                                                    }
-                                                    LogLevel::Critical => {
-                                                        golem::worker::Level::Critical.into()
-                                                    }
-                                                },
-                                                context,
-                                                message,
+                                    worker_event::WorkerEvent::StdOut(line) => {
+                                        golem::worker::log_event::Event::Stdout(
+                                            golem::worker::StdOutLog {
+                                                message: String::from_utf8_lossy(line)
+                                                    .into_owned(),
                                             },
-                                        )),
-                                    }))
-                                    .await
-                                {
-                                    Ok(_) => {
-                                        // item (server response) was queued to be send to client
+                                        )
                                     }
-                                    Err(_item) => {
-                                        // output_stream was build from rx and both are dropped
-                                        break;
+                                    worker_event::WorkerEvent::StdErr(line) => {
+                                        golem::worker::log_event::Event::Stderr(
+                                            golem::worker::StdErrLog {
+                                                message: String::from_utf8_lossy(line)
+                                                    .into_owned(),
+                                            },
+                                        )
                                     }
+                                    worker_event::WorkerEvent::Log {
+                                        level,
+                                        context,
+                                        message,
+                                    } => golem::worker::log_event::Event::Log(golem::worker::Log {
+                                        level: match level {
+                                            LogLevel::Trace => golem::worker::Level::Trace.into(),
+                                            LogLevel::Debug => golem::worker::Level::Debug.into(),
+                                            LogLevel::Info => golem::worker::Level::Info.into(),
+                                            LogLevel::Warn => golem::worker::Level::Warn.into(),
+                                            LogLevel::Error => golem::worker::Level::Error.into(),
+                                            LogLevel::Critical => {
+                                                golem::worker::Level::Critical.into()
+                                            }
+                                        },
+                                        context: context.clone(),
+                                        message: message.clone(),
+                                    }),
                                 },
+                                Err(RecvError::Lagged(missed)) => {
+                                    // The client is told about the gap instead of slowing down the worker
+                                    golem::worker::log_event::Event::Log(golem::worker::Log {
+                                        level: golem::worker::Level::Warn.into(),
+                                        context: "golem".to_string(),
+                                        message: format!(
+                                            "{missed} events were dropped because the client could not keep up"
+                                        ),
+                                    })
+                                }
+                                Err(RecvError::Closed) => {
+                                    break;
+                                }
+                            };
+
+                            if tx
+                                .send(Result::<_, Status>::Ok(golem::worker::LogEvent {
+                                    event: Some(event),
+                                }))
+                                .await
+                                .is_err()
+                            {
+                                // output_stream was build from rx and both are dropped
+                                break;
                             }
                         }
 
@@ -1272,6 +1301,45 @@ impl<Ctx: WorkerCtx, Svcs: HasAll<Ctx> + UsesAllDeps<Ctx = Ctx> + Send + Sync +
         }
     }
 
+    async fn invoke_and_await_worker_batch(
+        &self,
+        request: Request<golem::workerexecutor::InvokeAndAwaitWorkerBatchRequest>,
+    ) -> Result<Response<golem::workerexecutor::InvokeAndAwaitWorkerBatchResponse>, Status> {
+        let request = request.into_inner();
+        let record = recorded_grpc_request!(
+            "invoke_and_await_worker_batch",
+            worker_id = proto_worker_id_string(&request.worker_id),
+            size = request.invocations.len(),
+            account_id = proto_account_id_string(&request.account_id),
+        );
+
+        match self
+            .invoke_and_await_worker_batch_internal(&request)
+            .instrument(record.span.clone())
+            .await
+        {
+            Ok(result) => record.succeed(Ok(Response::new(
+                golem::workerexecutor::InvokeAndAwaitWorkerBatchResponse {
+                    result: Some(
+                        golem::workerexecutor::invoke_and_await_worker_batch_response::Result::Success(result),
+                    ),
+                },
+            ))),
+            Err(err) => record.fail(
+                Ok(Response::new(
+                    golem::workerexecutor::InvokeAndAwaitWorkerBatchResponse {
+                        result: Some(
+                            golem::workerexecutor::invoke_and_await_worker_batch_response::Result::Failure(
+                                err.clone().into(),
+                            ),
+                        ),
+                    },
+                )),
+                &err,
+            ),
+        }
+    }
+
     async fn invoke_worker(
         &self,
         request: Request<golem::workerexecutor::InvokeWorkerRequest>,
@@ -1842,6 +1910,81 @@ impl GrpcInvokeRequest for golem::workerexecutor::InvokeAndAwaitWorkerRequest {
     }
 }
 
+/// Used for getting or creating the target worker of a batch. The invocation specific methods
+/// are describing the first invocation of the batch.
+impl GrpcInvokeRequest for golem::workerexecutor::InvokeAndAwaitWorkerBatchRequest {
+    fn account_id(&self) -> Result<AccountId, GolemError> {
+        Ok(self
+            .account_id
+            .clone()
+            .ok_or(GolemError::invalid_request("account_id not found"))?
+            .into())
+    }
+
+    fn account_limits(&self) -> Option<GrpcResourceLimits> {
+        self.account_limits.clone()
+    }
+
+    fn calling_convention(&self) -> CallingConvention {
+        match self
+            .invocations
+            .first()
+            .map(|invocation| invocation.calling_convention())
+        {
+            Some(golem::worker::CallingConvention::Stdio) => CallingConvention::Stdio,
+            _ => CallingConvention::Component,
+        }
+    }
+
+    fn input(&self) -> Vec<Val> {
+        self.invocations
+            .first()
+            .map(|invocation| invocation.input.clone())
+            .unwrap_or_default()
+    }
+
+    fn worker_id(&self) -> Result<common_model::WorkerId, GolemError> {
+        self.worker_id
+            .clone()
+            .ok_or(GolemError::invalid_request("worker_id not found"))?
+            .try_into()
+            .map_err(GolemError::invalid_request)
+    }
+
+    fn idempotency_key(&self) -> Result<Option<IdempotencyKey>, GolemError> {
+        Ok(self
+            .invocations
+            .first()
+            .and_then(|invocation| invocation.idempotency_key.clone())
+            .map(IdempotencyKey::from))
+    }
+
+    fn name(&self) -> String {
+        self.invocations
+            .first()
+            .map(|invocation| invocation.name.clone())
+            .unwrap_or_default()
+    }
+
+    fn args(&self) -> Option<Vec<String>> {
+        self.context.as_ref().map(|ctx| ctx.args.clone())
+    }
+
+    fn env(&self) -> Option<Vec<(String, String)>> {
+        self.context
+            .as_ref()
+            .map(|ctx| ctx.env.clone().into_iter().collect::<Vec<_>>())
+    }
+
+    fn parent(&self) -> Option<WorkerId> {
+        self.context.as_ref().and_then(|ctx| {
+            ctx.parent
+                .as_ref()
+                .and_then(|worker_id| worker_id.clone().try_into().ok())
+        })
+    }
+}
+
 pub trait UriBackConversion {
     fn as_http_02(&self) -> http_02::Uri;
 }
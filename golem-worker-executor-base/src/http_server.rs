@@ -14,7 +14,10 @@
 
 use std::fmt::Display;
 use std::net::SocketAddr;
+use std::str::FromStr;
+use std::sync::Arc;
 
+use golem_common::model::WorkerId;
 use http_02::{Response, StatusCode};
 use prometheus::{Encoder, Registry, TextEncoder};
 use tokio::task::JoinHandle;
@@ -22,7 +25,15 @@ use tracing::info;
 use warp::hyper::Body;
 use warp::Filter;
 
-/// The worker executor's HTTP interface provides Prometheus metrics and a healthcheck endpoint
+use crate::profiling::GuestProfiler;
+
+/// The worker executor's HTTP interface provides Prometheus metrics and a healthcheck endpoint,
+/// and optionally controls the guest profiler through unauthenticated endpoints:
+/// - `POST /profiler/<worker_id>/start` starts profiling a worker
+/// - `GET /profiler/<worker_id>` returns the folded stacks sampled so far
+/// - `POST /profiler/<worker_id>/stop` stops profiling, returning the folded stacks
+///
+/// where `<worker_id>` is `<component_id>:<worker_name>`.
 pub struct HttpServerImpl {
     handle: JoinHandle<()>,
 }
@@ -33,7 +44,17 @@ impl HttpServerImpl {
         registry: Registry,
         body_message: &'static str,
     ) -> HttpServerImpl {
-        let handle = tokio::spawn(server(addr, registry, body_message));
+        let handle = tokio::spawn(server(addr, registry, body_message, None));
+        HttpServerImpl { handle }
+    }
+
+    pub fn with_guest_profiler(
+        addr: impl Into<SocketAddr> + Display + Send + 'static,
+        registry: Registry,
+        body_message: &'static str,
+        guest_profiler: Arc<GuestProfiler>,
+    ) -> HttpServerImpl {
+        let handle = tokio::spawn(server(addr, registry, body_message, Some(guest_profiler)));
         HttpServerImpl { handle }
     }
 }
@@ -49,6 +70,7 @@ async fn server(
     addr: impl Into<SocketAddr> + Display + Send,
     registry: Registry,
     body_message: &'static str,
+    guest_profiler: Option<Arc<GuestProfiler>>,
 ) {
     let healthcheck = warp::path!("healthcheck").map(move || {
         Response::builder()
@@ -60,7 +82,57 @@ async fn server(
     let metrics = warp::path!("metrics").map(move || prometheus_metrics(registry.clone()));
 
     info!("Http server started on {addr}");
-    warp::serve(healthcheck.or(metrics)).run(addr).await;
+    if let Some(guest_profiler) = guest_profiler {
+        let profiler = guest_profiler.clone();
+        let start = warp::path!("profiler" / String / "start")
+            .and(warp::post())
+            .map(move |worker_id: String| {
+                profiler_response(&worker_id, |worker_id| {
+                    if profiler.start(worker_id) {
+                        Some(format!("Started profiling {worker_id}\n"))
+                    } else {
+                        Some(format!("{worker_id} is already being profiled\n"))
+                    }
+                })
+            });
+        let profiler = guest_profiler.clone();
+        let report = warp::path!("profiler" / String)
+            .and(warp::get())
+            .map(move |worker_id: String| profiler_response(&worker_id, |id| profiler.report(id)));
+        let profiler = guest_profiler;
+        let stop = warp::path!("profiler" / String / "stop")
+            .and(warp::post())
+            .map(move |worker_id: String| profiler_response(&worker_id, |id| profiler.stop(id)));
+
+        warp::serve(healthcheck.or(metrics).or(start).or(report).or(stop))
+            .run(addr)
+            .await;
+    } else {
+        warp::serve(healthcheck.or(metrics)).run(addr).await;
+    }
+}
+
+fn profiler_response(
+    worker_id: &str,
+    f: impl FnOnce(&WorkerId) -> Option<String>,
+) -> Response<Body> {
+    match WorkerId::from_str(worker_id) {
+        Ok(worker_id) => match f(&worker_id) {
+            Some(body) => Response::builder()
+                .status(StatusCode::OK)
+                .header("Content-Type", "text/plain")
+                .body(Body::from(body))
+                .unwrap(),
+            None => Response::builder()
+                .status(StatusCode::NOT_FOUND)
+                .body(Body::from(format!("{worker_id} is not being profiled\n")))
+                .unwrap(),
+        },
+        Err(err) => Response::builder()
+            .status(StatusCode::BAD_REQUEST)
+            .body(Body::from(err))
+            .unwrap(),
+    }
 }
 
 fn prometheus_metrics(registry: Registry) -> Response<Body> {
@@ -20,6 +20,7 @@ pub mod invocation;
 pub mod metrics;
 pub mod model;
 pub mod preview2;
+pub mod profiling;
 pub mod services;
 pub mod storage;
 pub mod wasi_host;
@@ -37,16 +38,20 @@ use prometheus::Registry;
 use std::sync::Arc;
 use tokio::runtime::Handle;
 use tonic::transport::Server;
-use tracing::info;
+use tracing::{info, warn};
 use uuid::Uuid;
 use wasmtime::component::Linker;
-use wasmtime::{Config, Engine};
+use wasmtime::{Config, Engine, OptLevel};
 
+use crate::durable_host::filesystem::initial::InitialFileSystemService;
+use crate::durable_host::http::connection_pool::HttpConnectionPool;
 use crate::grpc::WorkerExecutorImpl;
 use crate::http_server::HttpServerImpl;
+use crate::profiling::GuestProfiler;
 use crate::services::active_workers::ActiveWorkers;
 use crate::services::blob_store::{BlobStoreService, DefaultBlobStoreService};
-use crate::services::component::ComponentService;
+use crate::services::compiled_component::CpuFeatureLevel;
+use crate::services::component::{ComponentService, TieredCompilation};
 use crate::services::events::Events;
 use crate::services::golem_config::{
     BlobStorageConfig, GolemConfig, IndexedStorageConfig, KeyValueStorageConfig,
@@ -67,7 +72,8 @@ use crate::services::worker_enumeration::{
     RunningWorkerEnumerationServiceDefault, WorkerEnumerationService,
 };
 use crate::services::worker_proxy::{RemoteWorkerProxy, WorkerProxy};
-use crate::services::{component, shard_manager, All};
+use crate::services::worker_template::WorkerTemplates;
+use crate::services::{component, shard_manager, All, HasGuestProfiler};
 use crate::storage::blob::s3::S3BlobStorage;
 use crate::storage::blob::BlobStorage;
 use crate::storage::indexed::redis::RedisIndexedStorage;
@@ -93,6 +99,7 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
         active_workers: Arc<ActiveWorkers<Ctx>>,
         engine: Arc<Engine>,
         linker: Arc<Linker<Ctx>>,
+        worker_templates: Arc<WorkerTemplates<Ctx>>,
         runtime: Handle,
         component_service: Arc<dyn ComponentService + Send + Sync>,
         shard_manager_service: Arc<dyn ShardManagerService + Send + Sync>,
@@ -109,6 +116,9 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
         events: Arc<Events>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
+        guest_profiler: Arc<GuestProfiler>,
     ) -> anyhow::Result<All<Ctx>>;
 
     /// Can be overridden to customize the wasmtime configuration
@@ -121,6 +131,9 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
         config.epoch_interruption(true);
         config.consume_fuel(true);
 
+        // Loads the components compiled for the best CPU feature level of this node
+        CpuFeatureLevel::host().configure(&mut config);
+
         config
     }
 
@@ -157,12 +170,53 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
             .build()
             .unwrap();
 
-        let http_server = HttpServerImpl::new(
-            golem_config.http_addr()?,
-            prometheus_registry,
-            "Worker executor is running",
-        );
+        let (services, lazy_worker_activator) =
+            self.create_all_services(&golem_config, runtime).await?;
+
+        let http_server = if golem_config.guest_profiler.enabled {
+            HttpServerImpl::with_guest_profiler(
+                golem_config.http_addr()?,
+                prometheus_registry,
+                "Worker executor is running",
+                services.guest_profiler(),
+            )
+        } else {
+            HttpServerImpl::new(
+                golem_config.http_addr()?,
+                prometheus_registry,
+                "Worker executor is running",
+            )
+        };
 
+        let addr = golem_config.grpc_addr()?;
+        let worker_executor =
+            WorkerExecutorImpl::<Ctx, All<Ctx>>::new(services, lazy_worker_activator, addr.port())
+                .await?;
+
+        let service = WorkerExecutorServer::new(worker_executor);
+
+        info!("Starting gRPC server on port {}", addr.port());
+        Server::builder()
+            .concurrency_limit_per_connection(golem_config.limits.concurrency_limit_per_connection)
+            .max_concurrent_streams(Some(golem_config.limits.max_concurrent_streams))
+            .add_service(reflection_service)
+            .add_service(service)
+            .add_service(health_service)
+            .serve(addr)
+            .await?;
+
+        drop(http_server); // explicitly keeping it alive until the end
+        Ok(())
+    }
+
+    /// Creates all the services of the worker executor without starting any server.
+    /// The returned `LazyWorkerActivator` has to be set up (as done by `WorkerExecutorImpl::new`)
+    /// before any worker is started.
+    async fn create_all_services(
+        &self,
+        golem_config: &GolemConfig,
+        runtime: Handle,
+    ) -> anyhow::Result<(All<Ctx>, Arc<LazyWorkerActivator>)> {
         let (redis, key_value_storage): (
             Option<RedisPool>,
             Arc<dyn KeyValueStorage + Send + Sync>,
@@ -223,11 +277,24 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
             }
         };
 
+        let tiered_compilation = if golem_config.tiered_compilation.enabled {
+            // The baseline engine only compiles, so it keeps the default instance allocator
+            let mut baseline_config = self.create_wasmtime_config();
+            baseline_config.cranelift_opt_level(OptLevel::None);
+            Some(TieredCompilation::new(
+                Engine::new(&baseline_config)?,
+                &golem_config.tiered_compilation,
+            ))
+        } else {
+            None
+        };
+
         let component_service = component::configured(
             &golem_config.component_service,
             &golem_config.component_cache,
             &golem_config.compiled_component_service,
             blob_storage.clone(),
+            tiered_compilation,
         )
         .await;
 
@@ -258,6 +325,8 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
                     blob_storage.clone(),
                     golem_config.oplog.max_operations_before_commit,
                     golem_config.oplog.max_payload_size,
+                    golem_config.oplog.group_commit_window,
+                    golem_config.oplog.group_commit_max_entries,
                 )
                 .await,
             ),
@@ -268,6 +337,8 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
                         blob_storage.clone(),
                         golem_config.oplog.max_operations_before_commit,
                         golem_config.oplog.max_payload_size,
+                        golem_config.oplog.group_commit_window,
+                        golem_config.oplog.group_commit_max_entries,
                     )
                     .await,
                 );
@@ -284,6 +355,7 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
             key_value_storage.clone(),
             shard_service.clone(),
             oplog_service.clone(),
+            golem_config.worker_index.enabled,
         ));
         let worker_enumeration_service = Arc::new(DefaultWorkerEnumerationService::new(
             worker_service.clone(),
@@ -299,7 +371,49 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
 
         let shard_manager_service = shard_manager::configured(&golem_config.shard_manager_service);
 
-        let config = self.create_wasmtime_config();
+        if golem_config.rpc_affinity.enabled {
+            let mut report_interval =
+                tokio::time::interval(golem_config.rpc_affinity.report_interval);
+            let shard_manager_service = shard_manager_service.clone();
+            tokio::spawn(async move {
+                loop {
+                    report_interval.tick().await;
+                    let edges = metrics::rpc::take_rpc_affinity_edges();
+                    if !edges.is_empty() {
+                        if let Err(err) = shard_manager_service.report_rpc_affinity(edges).await {
+                            warn!("Failed to report RPC affinity to the shard manager: {err}");
+                        }
+                    }
+                }
+            });
+        }
+
+        if golem_config.memory_headroom.enabled {
+            let mut report_interval =
+                tokio::time::interval(golem_config.memory_headroom.report_interval);
+            let shard_manager_service = shard_manager_service.clone();
+            let active_workers = active_workers.clone();
+            tokio::spawn(async move {
+                loop {
+                    report_interval.tick().await;
+                    if let Err(err) = shard_manager_service
+                        .report_memory_headroom(
+                            active_workers.worker_memory(),
+                            active_workers.used_memory(),
+                        )
+                        .await
+                    {
+                        warn!("Failed to report memory headroom to the shard manager: {err}");
+                    }
+                }
+            });
+        }
+
+        let mut config = self.create_wasmtime_config();
+        golem_config
+            .limits
+            .instance_allocation
+            .configure(&mut config);
         let engine = Arc::new(Engine::new(&config)?);
         let linker = self.create_wasmtime_linker(&engine)?;
 
@@ -313,6 +427,11 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
         });
 
         let linker = Arc::new(linker);
+        let worker_templates = Arc::new(WorkerTemplates::new(
+            linker.clone(),
+            golem_config.component_cache.max_capacity,
+            golem_config.component_cache.time_to_idle,
+        ));
 
         let key_value_service = Arc::new(DefaultKeyValueService::new(key_value_storage.clone()));
 
@@ -338,12 +457,19 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
 
         let events = Arc::new(Events::new());
 
+        let http_connection_pool = Arc::new(HttpConnectionPool::new(&golem_config.outgoing_http));
+        let initial_file_system_service = Arc::new(InitialFileSystemService::new(
+            &golem_config.initial_file_system,
+        ));
+        let guest_profiler = Arc::new(GuestProfiler::new());
+
         let services = self
             .create_services(
                 active_workers,
                 engine,
                 linker,
-                runtime.clone(),
+                worker_templates,
+                runtime,
                 component_service,
                 shard_manager_service,
                 worker_service,
@@ -359,27 +485,12 @@ pub trait Bootstrap<Ctx: WorkerCtx> {
                 scheduler_service,
                 worker_proxy,
                 events,
+                http_connection_pool,
+                initial_file_system_service,
+                guest_profiler,
             )
             .await?;
 
-        let addr = golem_config.grpc_addr()?;
-        let worker_executor =
-            WorkerExecutorImpl::<Ctx, All<Ctx>>::new(services, lazy_worker_activator, addr.port())
-                .await?;
-
-        let service = WorkerExecutorServer::new(worker_executor);
-
-        info!("Starting gRPC server on port {}", addr.port());
-        Server::builder()
-            .concurrency_limit_per_connection(golem_config.limits.concurrency_limit_per_connection)
-            .max_concurrent_streams(Some(golem_config.limits.max_concurrent_streams))
-            .add_service(reflection_service)
-            .add_service(service)
-            .add_service(health_service)
-            .serve(addr)
-            .await?;
-
-        drop(http_server); // explicitly keeping it alive until the end
-        Ok(())
+        Ok((services, lazy_worker_activator))
     }
 }
@@ -73,11 +73,46 @@ pub mod component {
             DEFAULT_TIME_BUCKETS.to_vec()
         )
         .unwrap();
+        static ref BASELINE_COMPILATION_TIME_SECONDS: Histogram = register_histogram!(
+            "baseline_compilation_time_seconds",
+            "Time to compile a WASM component to unoptimized native code",
+            DEFAULT_TIME_BUCKETS.to_vec()
+        )
+        .unwrap();
+        static ref COMPILED_COMPONENT_LOAD_SECONDS: Histogram = register_histogram!(
+            "compiled_component_load_seconds",
+            "Time to deserialize a precompiled component",
+            DEFAULT_TIME_BUCKETS.to_vec()
+        )
+        .unwrap();
+        static ref COMPILED_COMPONENT_STORE_LOOKUP_TOTAL: CounterVec = register_counter_vec!(
+            "compiled_component_store_lookup_total",
+            "Number of lookups of precompiled components in the compiled component store",
+            &["result"]
+        )
+        .unwrap();
     }
 
     pub fn record_compilation_time(duration: Duration) {
         COMPILATION_TIME_SECONDS.observe(duration.as_secs_f64());
     }
+
+    pub fn record_baseline_compilation_time(duration: Duration) {
+        BASELINE_COMPILATION_TIME_SECONDS.observe(duration.as_secs_f64());
+    }
+
+    pub fn record_compiled_component_load(duration: Duration) {
+        COMPILED_COMPONENT_STORE_LOOKUP_TOTAL
+            .with_label_values(&["found"])
+            .inc();
+        COMPILED_COMPONENT_LOAD_SECONDS.observe(duration.as_secs_f64());
+    }
+
+    pub fn record_compiled_component_not_found() {
+        COMPILED_COMPONENT_STORE_LOOKUP_TOTAL
+            .with_label_values(&["not_found"])
+            .inc();
+    }
 }
 
 pub mod events {
@@ -97,6 +132,11 @@ pub mod events {
             &["event"]
         )
         .unwrap();
+        static ref EVENT_LAGGED_TOTAL: Counter = register_counter!(
+            "event_lagged_total",
+            "Number of events missed by subscribers falling behind"
+        )
+        .unwrap();
     }
 
     pub fn record_event(event: &'static str) {
@@ -106,6 +146,10 @@ pub mod events {
     pub fn record_broadcast_event(event: &'static str) {
         EVENT_BROADCAST_TOTAL.with_label_values(&[event]).inc();
     }
+
+    pub fn record_lagged_events(count: u64) {
+        EVENT_LAGGED_TOTAL.inc_by(count as f64);
+    }
 }
 
 pub mod grpc {
@@ -307,8 +351,50 @@ pub mod sharding {
     }
 }
 
+pub mod rpc {
+    use std::collections::HashMap;
+    use std::sync::Mutex;
+
+    use golem_common::model::ShardId;
+    use lazy_static::lazy_static;
+    use prometheus::*;
+
+    lazy_static! {
+        static ref RPC_CALLS_TOTAL: CounterVec = register_counter_vec!(
+            "rpc_calls_total",
+            "Number of worker to worker RPC calls, by whether the callee was on the same node",
+            &["target"]
+        )
+        .unwrap();
+        /// Number of calls between the shards of the callers and the callees since the last
+        /// time they were reported to the shard manager. Kept out of prometheus because of
+        /// the number of possible shard pairs.
+        static ref RPC_AFFINITY_EDGES: Mutex<HashMap<(ShardId, ShardId), u64>> =
+            Mutex::new(HashMap::new());
+    }
+
+    pub fn record_rpc_call(local: bool) {
+        RPC_CALLS_TOTAL
+            .with_label_values(&[if local { "local" } else { "remote" }])
+            .inc();
+    }
+
+    pub fn record_rpc_affinity_edge(caller: ShardId, callee: ShardId) {
+        *RPC_AFFINITY_EDGES
+            .lock()
+            .unwrap()
+            .entry((caller, callee))
+            .or_default() += 1;
+    }
+
+    /// Takes the RPC call counts recorded since the previous call
+    pub fn take_rpc_affinity_edges() -> HashMap<(ShardId, ShardId), u64> {
+        std::mem::take(&mut *RPC_AFFINITY_EDGES.lock().unwrap())
+    }
+}
+
 pub mod wasm {
-    use std::time::Duration;
+    use std::time::{Duration, Instant};
 
     use lazy_static::lazy_static;
     use prometheus::*;
@@ -343,10 +429,20 @@ pub mod wasm {
         .unwrap();
         static ref ALLOCATED_MEMORY_BYTES: Histogram = register_histogram!(
             "allocated_memory_bytes",
-            "Amount of memory allocated by a single memory.grow instruction",
+            "Growth of a worker's total linear memory beyond its previously recorded size, per oplog entry recording it",
             crate::metrics::MEMORY_SIZE_BUCKETS.to_vec()
         )
         .unwrap();
+        static ref ACTIVE_WORKERS_MEMORY_BYTES: Gauge = register_gauge!(
+            "active_workers_memory_bytes",
+            "Estimated memory requirement of all the active workers"
+        )
+        .unwrap();
+        static ref WORKER_MEMORY_HEADROOM_BYTES: Gauge = register_gauge!(
+            "worker_memory_headroom_bytes",
+            "Memory still available for activating workers"
+        )
+        .unwrap();
     }
 
     lazy_static! {
@@ -356,6 +452,27 @@ pub mod wasm {
             &["interface", "name"]
         )
         .unwrap();
+        static ref HOST_FUNCTION_CALL_SECONDS: HistogramVec = register_histogram_vec!(
+            "host_function_call_seconds",
+            "Total time spent in specific host functions",
+            &["interface", "name"],
+            HOST_FUNCTION_TIME_BUCKETS.to_vec()
+        )
+        .unwrap();
+        static ref DURABLE_FUNCTION_IO_SECONDS: HistogramVec = register_histogram_vec!(
+            "durable_function_io_seconds",
+            "Time spent performing the operation of durable host functions in live mode",
+            &["function"],
+            HOST_FUNCTION_TIME_BUCKETS.to_vec()
+        )
+        .unwrap();
+        static ref DURABLE_FUNCTION_PERSIST_SECONDS: HistogramVec = register_histogram_vec!(
+            "durable_function_persist_seconds",
+            "Time spent persisting the results of durable host functions to the oplog, including commits",
+            &["function"],
+            HOST_FUNCTION_TIME_BUCKETS.to_vec()
+        )
+        .unwrap();
         static ref RESUME_WORKER_SECONDS: Histogram = register_histogram!(
             "resume_worker_seconds",
             "Time taken to resume a worker",
@@ -370,11 +487,53 @@ pub mod wasm {
         .unwrap();
     }
 
-    pub fn record_host_function_call(iface: &'static str, name: &'static str) {
+    /// Host function calls mostly take microseconds, except the ones doing remote I/O
+    const HOST_FUNCTION_TIME_BUCKETS: &[f64; 12] = &[
+        0.000001, 0.000005, 0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.1, 1.0, 10.0,
+    ];
+
+    /// Records a call of a host function. The time spent in the host function is recorded when
+    /// the returned timer is dropped, so it has to be kept alive until the function returns.
+    #[must_use]
+    pub fn record_host_function_call(
+        iface: &'static str,
+        name: &'static str,
+    ) -> HostFunctionCallTimer {
         debug!("golem {iface}::{name} called");
         HOST_FUNCTION_CALL_TOTAL
             .with_label_values(&[iface, name])
             .inc();
+        HostFunctionCallTimer {
+            iface,
+            name,
+            start: Instant::now(),
+        }
+    }
+
+    pub struct HostFunctionCallTimer {
+        iface: &'static str,
+        name: &'static str,
+        start: Instant,
+    }
+
+    impl Drop for HostFunctionCallTimer {
+        fn drop(&mut self) {
+            HOST_FUNCTION_CALL_SECONDS
+                .with_label_values(&[self.iface, self.name])
+                .observe(self.start.elapsed().as_secs_f64());
+        }
+    }
+
+    pub fn record_durable_function_io(function_name: &str, duration: Duration) {
+        DURABLE_FUNCTION_IO_SECONDS
+            .with_label_values(&[function_name])
+            .observe(duration.as_secs_f64());
+    }
+
+    pub fn record_durable_function_persist(function_name: &str, duration: Duration) {
+        DURABLE_FUNCTION_PERSIST_SECONDS
+            .with_label_values(&[function_name])
+            .observe(duration.as_secs_f64());
     }
 
     pub fn record_resume_worker(duration: Duration) {
@@ -407,6 +566,11 @@ pub mod wasm {
     pub fn record_allocated_memory(amount: usize) {
         ALLOCATED_MEMORY_BYTES.observe(amount as f64);
     }
+
+    pub fn record_active_workers_memory(used: u64, available: u64) {
+        ACTIVE_WORKERS_MEMORY_BYTES.set(used as f64);
+        WORKER_MEMORY_HEADROOM_BYTES.set(available.saturating_sub(used) as f64);
+    }
 }
 
 pub mod oplog {
@@ -420,9 +584,32 @@ pub mod oplog {
             &["api"]
         )
         .unwrap();
+        static ref OPLOG_GROUP_COMMIT_SIZE: Histogram = register_histogram!(
+            "oplog_group_commit_size",
+            "Number of oplog commits per group commit write to the indexed storage",
+            GROUP_COMMIT_BUCKETS.to_vec()
+        )
+        .unwrap();
+        static ref OPLOG_GROUP_COMMIT_ENTRIES: Histogram = register_histogram!(
+            "oplog_group_commit_entries",
+            "Number of oplog entries per group commit write to the indexed storage",
+            GROUP_COMMIT_BUCKETS.to_vec()
+        )
+        .unwrap();
     }
 
+    const GROUP_COMMIT_BUCKETS: &[f64; 8] = &[1.0, 2.0, 4.0, 16.0, 64.0, 256.0, 1024.0, 4096.0];
+
     pub fn record_oplog_call(api_name: &'static str) {
         OPLOG_SVC_CALL_TOTAL.with_label_values(&[api_name]).inc();
     }
+
+    /// Records one write of the group commit to the indexed storage. Both histograms are
+    /// observed once per write, so their `_count` is the number of writes, while the `_sum` of
+    /// `oplog_group_commit_size` is the number of commits and the `_sum` of
+    /// `oplog_group_commit_entries` is the number of entries written.
+    pub fn record_oplog_group_commit(commits: usize, entries: usize) {
+        OPLOG_GROUP_COMMIT_SIZE.observe(commits as f64);
+        OPLOG_GROUP_COMMIT_ENTRIES.observe(entries as f64);
+    }
 }
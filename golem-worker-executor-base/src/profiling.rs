@@ -0,0 +1,155 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! On-demand sampling profiler for the guest code of individual workers.
+//!
+//! While a worker is being profiled, its WebAssembly call stack is captured every time its epoch
+//! deadline is reached (every `limits.epoch_interval * limits.epoch_ticks`). The samples are
+//! aggregated as folded stacks, one `outermost;...;innermost count` line per distinct stack,
+//! which is the input format of `flamegraph.pl` and `inferno-flamegraph`. The deadline is only
+//! reached while guest code runs, so time spent in host functions is not sampled; it is covered
+//! by the `host_function_call_seconds` metric instead.
+//!
+//! The executor's profiler is one of its services, and it is controlled through the HTTP server
+//! only when `guest_profiler.enabled` is set.
+
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+
+use golem_common::model::WorkerId;
+use wasmtime::{AsContext, WasmBacktrace};
+
+pub struct GuestProfiler {
+    /// Number of workers being profiled, checked before taking the lock on every epoch deadline
+    active: AtomicUsize,
+    profiles: Mutex<HashMap<WorkerId, FoldedStacks>>,
+}
+
+impl GuestProfiler {
+    pub fn new() -> Self {
+        Self {
+            active: AtomicUsize::new(0),
+            profiles: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Starts profiling a worker, returns false if it was already being profiled
+    pub fn start(&self, worker_id: &WorkerId) -> bool {
+        let mut profiles = self.profiles.lock().unwrap();
+        if profiles.contains_key(worker_id) {
+            false
+        } else {
+            profiles.insert(worker_id.clone(), FoldedStacks::default());
+            self.active.fetch_add(1, Ordering::Release);
+            true
+        }
+    }
+
+    /// Stops profiling a worker, returning its folded stacks
+    pub fn stop(&self, worker_id: &WorkerId) -> Option<String> {
+        let mut profiles = self.profiles.lock().unwrap();
+        let stacks = profiles.remove(worker_id)?;
+        self.active.fetch_sub(1, Ordering::Release);
+        Some(stacks.to_string())
+    }
+
+    /// The folded stacks sampled so far from a worker being profiled
+    pub fn report(&self, worker_id: &WorkerId) -> Option<String> {
+        let profiles = self.profiles.lock().unwrap();
+        profiles.get(worker_id).map(|stacks| stacks.to_string())
+    }
+
+    /// Samples the current call stack of the worker, if it is being profiled
+    pub fn sample(&self, worker_id: &WorkerId, store: impl AsContext) {
+        if self.active.load(Ordering::Acquire) == 0
+            || !self.profiles.lock().unwrap().contains_key(worker_id)
+        {
+            return;
+        }
+
+        let backtrace = WasmBacktrace::capture(store);
+        // Frames are captured from the innermost one
+        let frames = backtrace
+            .frames()
+            .iter()
+            .rev()
+            .map(|frame| match frame.func_name() {
+                Some(name) => name.to_string(),
+                None => format!("wasm-function[{}]", frame.func_index()),
+            })
+            .collect::<Vec<_>>();
+
+        if let Some(stacks) = self.profiles.lock().unwrap().get_mut(worker_id) {
+            stacks.add(&frames);
+        }
+    }
+}
+
+impl Default for GuestProfiler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[derive(Debug, Default)]
+struct FoldedStacks {
+    samples: HashMap<String, u64>,
+}
+
+impl FoldedStacks {
+    fn add(&mut self, frames: &[String]) {
+        if !frames.is_empty() {
+            // Semicolons separate the frames and spaces the count in the folded format
+            let stack = frames
+                .iter()
+                .map(|frame| frame.replace([';', ' '], "_"))
+                .collect::<Vec<_>>()
+                .join(";");
+            *self.samples.entry(stack).or_insert(0) += 1;
+        }
+    }
+}
+
+impl std::fmt::Display for FoldedStacks {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let mut stacks = self.samples.iter().collect::<Vec<_>>();
+        stacks.sort();
+        for (stack, count) in stacks {
+            writeln!(f, "{stack} {count}")?;
+        }
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::profiling::FoldedStacks;
+
+    #[test]
+    fn samples_are_folded_by_stack() {
+        let mut stacks = FoldedStacks::default();
+        let frames = |names: &[&str]| names.iter().map(|n| n.to_string()).collect::<Vec<_>>();
+        stacks.add(&frames(&["main", "print", "write"]));
+        stacks.add(&frames(&["main", "compute"]));
+        stacks.add(&frames(&["main", "print", "write"]));
+        stacks.add(&frames(&["main", "<T as Trait>::f;x"]));
+        stacks.add(&frames(&[]));
+
+        assert_eq!(
+            stacks.to_string(),
+            "main;<T_as_Trait>::f_x 1\nmain;compute 1\nmain;print;write 2\n"
+        );
+    }
+}
@@ -15,48 +15,86 @@
 use std::cmp::max;
 use std::future::Future;
 use std::pin::Pin;
+use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
 use std::time::Duration;
 
 use golem_common::cache::{BackgroundEvictionMode, Cache, FullCacheEvictionMode, SimpleCache};
 use golem_common::model::WorkerId;
+use tokio::task::JoinHandle;
+use tracing::debug;
 
 use crate::error::GolemError;
+use crate::metrics::wasm::record_active_workers_memory;
 use crate::worker::Worker;
 use crate::workerctx::WorkerCtx;
 
 /// Holds the metadata and wasmtime structures of the active Golem workers
+///
+/// Workers are only evicted when they are idle and not in use (see `Worker::try_mark_evicted`),
+/// and evicted workers are stopped, which returns their memory and table slots to the instance
+/// allocator. The cache's own eviction would drop workers without these checks, so the limits
+/// are enforced here instead:
+/// - the number of active workers is kept under `max_active_workers`
+/// - the sum of the estimated memory requirements of the active workers is kept under
+///   `worker_memory`
+/// - workers not accessed for longer than `ttl` are evicted periodically
 pub struct ActiveWorkers<Ctx: WorkerCtx> {
     cache: Cache<WorkerId, (), Arc<Worker<Ctx>>, GolemError>, // TODO: SimpleCache?
+    max_active_workers: Option<usize>,
+    drop_count: usize,
+    worker_memory: u64,
+    background_handle: Option<JoinHandle<()>>,
 }
 
 impl<Ctx: WorkerCtx> ActiveWorkers<Ctx> {
-    pub fn bounded(max_active_workers: usize, drop_when_full: f64, ttl: Duration) -> Self {
+    pub fn bounded(
+        max_active_workers: usize,
+        drop_when_full: f64,
+        ttl: Duration,
+        worker_memory: u64,
+    ) -> Self {
         let drop_count = max(1, (max_active_workers as f64 * drop_when_full) as usize);
+        let cache = Self::create_cache();
+
+        let cache_clone = cache.clone();
+        let background_handle = tokio::task::spawn(async move {
+            loop {
+                tokio::time::sleep(Duration::from_secs(60)).await;
+                Self::evict_older_than(&cache_clone, ttl).await;
+            }
+        });
+
         ActiveWorkers {
-            cache: Cache::new(
-                Some(max_active_workers),
-                FullCacheEvictionMode::LeastRecentlyUsed(drop_count),
-                BackgroundEvictionMode::OlderThan {
-                    ttl,
-                    period: Duration::from_secs(60),
-                },
-                "active_workers",
-            ),
+            cache,
+            max_active_workers: Some(max_active_workers),
+            drop_count,
+            worker_memory,
+            background_handle: Some(background_handle),
         }
     }
 
-    pub fn unbounded() -> Self {
+    /// Creates an active worker cache without a limit on the number of workers. It is still
+    /// bounded by the memory requirements of the workers.
+    pub fn unbounded(worker_memory: u64) -> Self {
         ActiveWorkers {
-            cache: Cache::new(
-                None,
-                FullCacheEvictionMode::None,
-                BackgroundEvictionMode::None,
-                "active_workers",
-            ),
+            cache: Self::create_cache(),
+            max_active_workers: None,
+            drop_count: 1,
+            worker_memory,
+            background_handle: None,
         }
     }
 
+    fn create_cache() -> Cache<WorkerId, (), Arc<Worker<Ctx>>, GolemError> {
+        Cache::new(
+            None,
+            FullCacheEvictionMode::None,
+            BackgroundEvictionMode::None,
+            "active_workers",
+        )
+    }
+
     pub async fn get_with<F>(
         &self,
         worker_id: &WorkerId,
@@ -66,7 +104,22 @@ impl<Ctx: WorkerCtx> ActiveWorkers<Ctx> {
         F: FnOnce() -> Pin<Box<dyn Future<Output = Result<Arc<Worker<Ctx>>, GolemError>> + Send>>
             + Send,
     {
-        self.cache.get_or_insert_simple(worker_id, f).await
+        let inserted = Arc::new(AtomicBool::new(false));
+        let inserted_clone = inserted.clone();
+        let worker = self
+            .cache
+            .get_or_insert_simple(worker_id, || {
+                Box::pin(async move {
+                    let worker = f().await?;
+                    inserted_clone.store(true, Ordering::Release);
+                    Ok(worker)
+                })
+            })
+            .await?;
+        if inserted.load(Ordering::Acquire) {
+            self.evict_to_fit(worker_id).await;
+        }
+        Ok(worker)
     }
 
     pub fn remove(&self, worker_id: &WorkerId) {
@@ -76,4 +129,94 @@ impl<Ctx: WorkerCtx> ActiveWorkers<Ctx> {
     pub fn enum_workers(&self) -> Vec<(WorkerId, Arc<Worker<Ctx>>)> {
         self.cache.iter().collect()
     }
+
+    /// The memory available for the active workers
+    pub fn worker_memory(&self) -> u64 {
+        self.worker_memory
+    }
+
+    /// The sum of the estimated memory requirements of the active workers
+    pub fn used_memory(&self) -> u64 {
+        self.cache
+            .iter()
+            .map(|(_, worker)| worker.memory_requirement())
+            .sum()
+    }
+
+    /// Evicts the least recently used idle workers until both the number of active workers and
+    /// their memory requirement fit into the limits. The worker identified by `keep` is never
+    /// evicted.
+    async fn evict_to_fit(&self, keep: &WorkerId) {
+        // Only the sizes are kept, the references to the workers would prevent their eviction
+        let workers: Vec<(WorkerId, u64)> = self
+            .cache
+            .iter_least_recently_used()
+            .into_iter()
+            .map(|(worker_id, worker, _)| (worker_id, worker.memory_requirement()))
+            .collect();
+        let mut count = workers.len();
+        let mut used: u64 = workers.iter().map(|(_, memory)| *memory).sum();
+
+        // Like the cache's full eviction, exceeding the count evicts `drop_count` workers at once
+        let max_count = match self.max_active_workers {
+            Some(max_active_workers) if count > max_active_workers => {
+                (max_active_workers + 1).saturating_sub(self.drop_count)
+            }
+            _ => usize::MAX,
+        };
+
+        for (worker_id, memory) in &workers {
+            if count <= max_count && used <= self.worker_memory {
+                break;
+            }
+            if worker_id != keep && Self::try_evict(&self.cache, worker_id).await {
+                debug!("Evicted idle worker {worker_id}, freeing {memory} bytes of worker memory");
+                count -= 1;
+                used -= memory;
+            }
+        }
+
+        record_active_workers_memory(used, self.worker_memory);
+    }
+
+    /// Evicts the idle workers which have not been accessed for longer than `ttl`
+    async fn evict_older_than(
+        cache: &Cache<WorkerId, (), Arc<Worker<Ctx>>, GolemError>,
+        ttl: Duration,
+    ) {
+        let expired: Vec<WorkerId> = cache
+            .iter_least_recently_used()
+            .into_iter()
+            .take_while(|(_, _, last_access)| last_access.elapsed() >= ttl)
+            .map(|(worker_id, _, _)| worker_id)
+            .collect();
+        for worker_id in expired {
+            if Self::try_evict(cache, &worker_id).await {
+                debug!("Evicted worker {worker_id} not accessed for {ttl:?}");
+            }
+        }
+    }
+
+    /// Removes the worker from the cache and stops it if it is evictable. The check and the
+    /// removal happen atomically, so the worker cannot be looked up in between.
+    async fn try_evict(
+        cache: &Cache<WorkerId, (), Arc<Worker<Ctx>>, GolemError>,
+        worker_id: &WorkerId,
+    ) -> bool {
+        match cache.remove_if(worker_id, Worker::try_mark_evicted) {
+            Some(worker) => {
+                worker.stop().await;
+                true
+            }
+            None => false,
+        }
+    }
+}
+
+impl<Ctx: WorkerCtx> Drop for ActiveWorkers<Ctx> {
+    fn drop(&mut self) {
+        if let Some(handle) = self.background_handle.take() {
+            handle.abort();
+        }
+    }
 }
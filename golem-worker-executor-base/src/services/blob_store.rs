@@ -18,6 +18,8 @@ use std::sync::Arc;
 use anyhow::anyhow;
 use async_trait::async_trait;
 use bincode::{Decode, Encode};
+use bytes::Bytes;
+use futures::StreamExt;
 use serde::{Deserialize, Serialize};
 
 use golem_common::model::AccountId;
@@ -119,7 +121,7 @@ pub trait BlobStoreService {
         account_id: AccountId,
         container_name: String,
         object_name: String,
-        data: Vec<u8>,
+        data: Bytes,
     ) -> anyhow::Result<()>;
 }
 
@@ -300,7 +302,7 @@ impl BlobStoreService for DefaultBlobStoreService {
             .map_err(|err| anyhow!(err))?;
 
         match data {
-            Some(data) => Ok(data.to_vec()),
+            Some(data) => Ok(Vec::from(data)),
             None => anyhow::bail!("Object does not exist"),
         }
     }
@@ -401,15 +403,15 @@ impl BlobStoreService for DefaultBlobStoreService {
         account_id: AccountId,
         container_name: String,
         object_name: String,
-        data: Vec<u8>,
+        data: Bytes,
     ) -> anyhow::Result<()> {
         self.blob_storage
-            .put_raw(
+            .put_stream(
                 "blob_store",
                 "write_data",
                 BlobStorageNamespace::CustomStorage(account_id),
                 &Path::new(&container_name).join(&object_name),
-                &data,
+                futures::stream::once(async move { Ok(data) }).boxed(),
             )
             .await
             .map_err(|err| anyhow!(err))
@@ -497,7 +499,7 @@ mod tests {
                 account1.clone(),
                 "container1".to_string(),
                 "obj1".to_string(),
-                original_data.clone(),
+                original_data.clone().into(),
             )
             .await
             .unwrap();
@@ -544,13 +546,13 @@ mod tests {
             .unwrap()
             .is_empty());
 
-        let original_data = vec![1, 2, 3, 4];
+        let original_data: Vec<u8> = vec![1, 2, 3, 4];
         blob_store
             .write_data(
                 account1.clone(),
                 "container1".to_string(),
                 "obj1".to_string(),
-                original_data.clone(),
+                original_data.clone().into(),
             )
             .await
             .unwrap();
@@ -16,32 +16,174 @@ use std::path::{Path, PathBuf};
 use std::sync::Arc;
 
 use async_trait::async_trait;
+use serde::Deserialize;
+use tokio::task::spawn_blocking;
 use tokio::time::Instant;
-use tracing::debug;
+use tracing::{debug, warn};
 use wasmtime::component::Component;
+use wasmtime::Config;
 
 use golem_common::model::ComponentId;
 
 use crate::error::GolemError;
+use crate::metrics::component::{
+    record_compiled_component_load, record_compiled_component_not_found,
+};
 use crate::services::golem_config::CompiledComponentServiceConfig;
-use crate::storage::blob::{BlobStorage, BlobStorageNamespace};
+use crate::storage::blob::{BlobStorage, BlobStorageNamespace, ExistsResult};
 use crate::Engine;
 
-/// Service for storing compiled native binaries of WebAssembly components
+/// Sets of host CPU features the components are compiled for.
+///
+/// An artifact compiled for a level enables all the instructions of that level, and can be
+/// loaded on every node supporting at least the same level, so a heterogeneous fleet can share
+/// the artifacts of each level while nodes with more capable CPUs still get code using their
+/// wider vector instructions.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, PartialOrd, Ord, Hash, Deserialize)]
+pub enum CpuFeatureLevel {
+    /// x86-64-v2 (SSE4.2 and POPCNT) on x86-64, and NEON on aarch64
+    Baseline,
+    /// x86-64-v3: AVX2, FMA, BMI1, BMI2 and LZCNT
+    Avx2,
+    /// x86-64-v4: AVX-512 F, DQ and VL on top of the AVX2 level
+    Avx512,
+}
+
+impl CpuFeatureLevel {
+    /// The levels of the architecture the executor is built for, from the lowest
+    pub fn all() -> Vec<CpuFeatureLevel> {
+        if cfg!(target_arch = "x86_64") {
+            vec![
+                CpuFeatureLevel::Baseline,
+                CpuFeatureLevel::Avx2,
+                CpuFeatureLevel::Avx512,
+            ]
+        } else {
+            vec![CpuFeatureLevel::Baseline]
+        }
+    }
+
+    /// The highest level supported by the host. The baseline level is the minimum requirement.
+    pub fn host() -> CpuFeatureLevel {
+        Self::all()
+            .into_iter()
+            .rev()
+            .find(|level| level.is_supported_by_host())
+            .unwrap_or(CpuFeatureLevel::Baseline)
+    }
+
+    #[cfg(target_arch = "x86_64")]
+    pub fn is_supported_by_host(&self) -> bool {
+        let baseline = std::is_x86_feature_detected!("sse3")
+            && std::is_x86_feature_detected!("ssse3")
+            && std::is_x86_feature_detected!("sse4.1")
+            && std::is_x86_feature_detected!("sse4.2")
+            && std::is_x86_feature_detected!("popcnt");
+        let avx2 = baseline
+            && std::is_x86_feature_detected!("avx")
+            && std::is_x86_feature_detected!("avx2")
+            && std::is_x86_feature_detected!("fma")
+            && std::is_x86_feature_detected!("bmi1")
+            && std::is_x86_feature_detected!("bmi2")
+            && std::is_x86_feature_detected!("lzcnt");
+        match self {
+            CpuFeatureLevel::Baseline => baseline,
+            CpuFeatureLevel::Avx2 => avx2,
+            CpuFeatureLevel::Avx512 => {
+                avx2 && std::is_x86_feature_detected!("avx512f")
+                    && std::is_x86_feature_detected!("avx512dq")
+                    && std::is_x86_feature_detected!("avx512vl")
+            }
+        }
+    }
+
+    #[cfg(not(target_arch = "x86_64"))]
+    pub fn is_supported_by_host(&self) -> bool {
+        *self == CpuFeatureLevel::Baseline
+    }
+
+    /// Configures wasmtime to compile for exactly this level instead of inferring the features
+    /// of the host, and enables the SIMD proposals. Relaxed SIMD instructions are made
+    /// deterministic, as a worker may be replayed on a node with a different CPU.
+    pub fn configure(&self, config: &mut Config) {
+        config
+            .target(&target_lexicon::HOST.to_string())
+            .expect("The host target is supported by wasmtime");
+        for flag in self.cranelift_flags() {
+            // Safety: only flags of features verified by `is_supported_by_host` on the nodes
+            // loading the artifacts are enabled
+            unsafe {
+                config.cranelift_flag_enable(flag);
+            }
+        }
+        config.wasm_simd(true);
+        config.wasm_relaxed_simd(true);
+        config.relaxed_simd_deterministic(true);
+    }
+
+    fn cranelift_flags(&self) -> Vec<&'static str> {
+        if !cfg!(target_arch = "x86_64") {
+            return vec![];
+        }
+        let mut flags = vec![
+            "has_sse3",
+            "has_ssse3",
+            "has_sse41",
+            "has_sse42",
+            "has_popcnt",
+        ];
+        if *self >= CpuFeatureLevel::Avx2 {
+            flags.extend([
+                "has_avx",
+                "has_avx2",
+                "has_fma",
+                "has_bmi1",
+                "has_bmi2",
+                "has_lzcnt",
+            ]);
+        }
+        if *self >= CpuFeatureLevel::Avx512 {
+            flags.extend(["has_avx512f", "has_avx512dq", "has_avx512vl"]);
+        }
+        flags
+    }
+
+    fn name(&self) -> &'static str {
+        match self {
+            CpuFeatureLevel::Baseline => "baseline",
+            CpuFeatureLevel::Avx2 => "avx2",
+            CpuFeatureLevel::Avx512 => "avx512",
+        }
+    }
+}
+
+/// Service for storing compiled native binaries of WebAssembly components, one for each
+/// [`CpuFeatureLevel`]
 #[async_trait]
 pub trait CompiledComponentService {
+    /// Gets the best artifact loadable by an engine configured for `feature_level`: the one
+    /// compiled for the same level, or if it does not exist yet, for a lower one
     async fn get(
         &self,
         component_id: &ComponentId,
         component_version: u64,
+        feature_level: CpuFeatureLevel,
         engine: &Engine,
     ) -> Result<Option<Component>, GolemError>;
     async fn put(
         &self,
         component_id: &ComponentId,
         component_version: u64,
+        feature_level: CpuFeatureLevel,
         component: &Component,
     ) -> Result<(), GolemError>;
+    /// Checks if the artifact compiled for exactly `feature_level` is stored
+    async fn exists(
+        &self,
+        component_id: &ComponentId,
+        component_version: u64,
+        feature_level: CpuFeatureLevel,
+    ) -> Result<bool, GolemError>;
 }
 
 pub struct DefaultCompiledComponentService {
@@ -53,17 +195,22 @@ impl DefaultCompiledComponentService {
         Self { blob_storage }
     }
 
-    fn key(component_id: &ComponentId, component_version: u64) -> PathBuf {
-        Path::new(&component_id.to_string()).join(format!("{component_version}.cwasm"))
+    fn key(
+        component_id: &ComponentId,
+        component_version: u64,
+        feature_level: CpuFeatureLevel,
+    ) -> PathBuf {
+        Path::new(&component_id.to_string()).join(format!(
+            "{component_version}.{}.cwasm",
+            feature_level.name()
+        ))
     }
-}
 
-#[async_trait]
-impl CompiledComponentService for DefaultCompiledComponentService {
-    async fn get(
+    async fn get_level(
         &self,
         component_id: &ComponentId,
         component_version: u64,
+        feature_level: CpuFeatureLevel,
         engine: &Engine,
     ) -> Result<Option<Component>, GolemError> {
         match self
@@ -72,28 +219,35 @@ impl CompiledComponentService for DefaultCompiledComponentService {
                 "compiled_component",
                 "get",
                 BlobStorageNamespace::CompilationCache,
-                &Self::key(component_id, component_version),
+                &Self::key(component_id, component_version, feature_level),
             )
             .await
         {
             Ok(None) => Ok(None),
             Ok(Some(bytes)) => {
                 let start = Instant::now();
-                let component = unsafe {
-                    Component::deserialize(engine, &bytes).map_err(|err| {
+                let engine = engine.clone();
+                let component_id_clone = component_id.clone();
+                // Deserializing a large component takes a while, so it is not done on the async executor
+                let component = spawn_blocking(move || unsafe {
+                    Component::deserialize(&engine, &bytes).map_err(|err| {
                         GolemError::component_download_failed(
-                            component_id.clone(),
+                            component_id_clone,
                             component_version,
                             format!("Could not deserialize compiled component: {}", err),
                         )
-                    })?
-                };
+                    })
+                })
+                .await
+                .map_err(|join_err| GolemError::unknown(join_err.to_string()))??;
                 let end = Instant::now();
 
                 let load_time = end.duration_since(start);
+                record_compiled_component_load(load_time);
                 debug!(
-                    "Loaded precompiled image for {} in {}ms",
+                    "Loaded precompiled image for {} ({}) in {}ms",
                     component_id,
+                    feature_level.name(),
                     load_time.as_millis(),
                 );
 
@@ -106,11 +260,44 @@ impl CompiledComponentService for DefaultCompiledComponentService {
             )),
         }
     }
+}
+
+#[async_trait]
+impl CompiledComponentService for DefaultCompiledComponentService {
+    async fn get(
+        &self,
+        component_id: &ComponentId,
+        component_version: u64,
+        feature_level: CpuFeatureLevel,
+        engine: &Engine,
+    ) -> Result<Option<Component>, GolemError> {
+        let mut levels = CpuFeatureLevel::all();
+        levels.retain(|level| *level <= feature_level);
+        for level in levels.into_iter().rev() {
+            match self
+                .get_level(component_id, component_version, level, engine)
+                .await
+            {
+                Ok(Some(component)) => return Ok(Some(component)),
+                Ok(None) => {}
+                Err(err) if level < feature_level => {
+                    warn!(
+                        "Could not load compiled component {component_id}#{component_version} for {}: {err}",
+                        level.name()
+                    );
+                }
+                Err(err) => return Err(err),
+            }
+        }
+        record_compiled_component_not_found();
+        Ok(None)
+    }
 
     async fn put(
         &self,
         component_id: &ComponentId,
         component_version: u64,
+        feature_level: CpuFeatureLevel,
         component: &Component,
     ) -> Result<(), GolemError> {
         let bytes = component
@@ -121,7 +308,7 @@ impl CompiledComponentService for DefaultCompiledComponentService {
                 "compiled_component",
                 "put",
                 BlobStorageNamespace::CompilationCache,
-                &Self::key(component_id, component_version),
+                &Self::key(component_id, component_version, feature_level),
                 &bytes,
             )
             .await
@@ -133,6 +320,30 @@ impl CompiledComponentService for DefaultCompiledComponentService {
                 )
             })
     }
+
+    async fn exists(
+        &self,
+        component_id: &ComponentId,
+        component_version: u64,
+        feature_level: CpuFeatureLevel,
+    ) -> Result<bool, GolemError> {
+        self.blob_storage
+            .exists(
+                "compiled_component",
+                "exists",
+                BlobStorageNamespace::CompilationCache,
+                &Self::key(component_id, component_version, feature_level),
+            )
+            .await
+            .map(|result| result == ExistsResult::File)
+            .map_err(|err| {
+                GolemError::component_download_failed(
+                    component_id.clone(),
+                    component_version,
+                    format!("Could not check compiled component: {err}"),
+                )
+            })
+    }
 }
 
 pub fn configured(
@@ -169,6 +380,7 @@ impl CompiledComponentService for CompiledComponentServiceDisabled {
         &self,
         _component_id: &ComponentId,
         _component_version: u64,
+        _feature_level: CpuFeatureLevel,
         _engine: &Engine,
     ) -> Result<Option<Component>, GolemError> {
         Ok(None)
@@ -178,8 +390,45 @@ impl CompiledComponentService for CompiledComponentServiceDisabled {
         &self,
         _component_id: &ComponentId,
         _component_version: u64,
+        _feature_level: CpuFeatureLevel,
         _component: &Component,
     ) -> Result<(), GolemError> {
         Ok(())
     }
+
+    async fn exists(
+        &self,
+        _component_id: &ComponentId,
+        _component_version: u64,
+        _feature_level: CpuFeatureLevel,
+    ) -> Result<bool, GolemError> {
+        Ok(false)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::services::compiled_component::CpuFeatureLevel;
+
+    #[test]
+    fn host_feature_level_is_supported() {
+        let host = CpuFeatureLevel::host();
+        assert!(host.is_supported_by_host());
+        assert!(CpuFeatureLevel::all()
+            .into_iter()
+            .filter(|level| *level <= host)
+            .all(|level| level.is_supported_by_host()));
+    }
+
+    #[test]
+    fn feature_levels_are_cumulative() {
+        let levels = CpuFeatureLevel::all();
+        for (lower, higher) in levels.iter().zip(levels.iter().skip(1)) {
+            let higher_flags = higher.cranelift_flags();
+            assert!(lower
+                .cranelift_flags()
+                .iter()
+                .all(|flag| higher_flags.contains(flag)));
+        }
+    }
 }
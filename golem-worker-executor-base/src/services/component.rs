@@ -41,11 +41,12 @@ use wasmtime::Engine;
 
 use crate::error::GolemError;
 use crate::grpc::{authorised_grpc_request, is_grpc_retriable, GrpcError, UriBackConversion};
-use crate::metrics::component::record_compilation_time;
+use crate::metrics::component::{record_baseline_compilation_time, record_compilation_time};
 use crate::services::compiled_component;
-use crate::services::compiled_component::CompiledComponentService;
+use crate::services::compiled_component::{CompiledComponentService, CpuFeatureLevel};
 use crate::services::golem_config::{
     CompiledComponentServiceConfig, ComponentCacheConfig, ComponentServiceConfig,
+    TieredCompilationConfig,
 };
 use crate::storage::blob::BlobStorage;
 
@@ -84,6 +85,7 @@ pub async fn configured(
     cache_config: &ComponentCacheConfig,
     compiled_config: &CompiledComponentServiceConfig,
     blob_storage: Arc<dyn BlobStorage + Send + Sync>,
+    tiered_compilation: Option<TieredCompilation>,
 ) -> Arc<dyn ComponentService + Send + Sync> {
     let compiled_component_service = compiled_component::configured(compiled_config, blob_storage);
     match config {
@@ -100,6 +102,7 @@ pub async fn configured(
                 config.retries.clone(),
                 compiled_component_service,
                 config.max_component_size,
+                tiered_compilation,
             ))
         }
         ComponentServiceConfig::Local(config) => Arc::new(ComponentServiceLocalFileSystem::new(
@@ -107,6 +110,7 @@ pub async fn configured(
             cache_config.max_capacity,
             cache_config.time_to_idle,
             compiled_component_service,
+            tiered_compilation,
         )),
     }
 }
@@ -124,6 +128,7 @@ pub struct ComponentServiceGrpc {
     retry_config: RetryConfig,
     compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
     max_component_size: usize,
+    tiered_compilation: Option<TieredCompilation>,
 }
 
 impl ComponentServiceGrpc {
@@ -135,6 +140,7 @@ impl ComponentServiceGrpc {
         retry_config: RetryConfig,
         compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
         max_component_size: usize,
+        tiered_compilation: Option<TieredCompilation>,
     ) -> Self {
         Self {
             endpoint,
@@ -143,6 +149,7 @@ impl ComponentServiceGrpc {
             retry_config,
             compiled_component_service,
             max_component_size,
+            tiered_compilation,
         }
     }
 }
@@ -166,12 +173,19 @@ impl ComponentService for ComponentServiceGrpc {
         let retry_config_clone = self.retry_config.clone();
         let max_component_size = self.max_component_size;
         let compiled_component_service = self.compiled_component_service.clone();
+        let tiered_compilation = self.tiered_compilation.clone();
+        let component_cache = self.component_cache.clone();
         let component = self
             .component_cache
             .get_or_insert_simple(&key.clone(), || {
                 Box::pin(async move {
                     let result = compiled_component_service
-                        .get(&component_id_clone, component_version, &engine)
+                        .get(
+                            &component_id_clone,
+                            component_version,
+                            CpuFeatureLevel::host(),
+                            &engine,
+                        )
                         .await;
 
                     let component = match result {
@@ -185,50 +199,40 @@ impl ComponentService for ComponentServiceGrpc {
                     match component {
                         Some(component) => Ok(component),
                         None => {
-                            let bytes = download_via_grpc(
-                                &endpoint_clone,
-                                &access_token,
-                                &retry_config_clone,
-                                &component_id_clone,
-                                component_version,
-                                max_component_size,
-                            )
-                            .await?;
-
-                            let start = Instant::now();
-                            let component_id_clone2 = component_id_clone.clone();
-                            let component = spawn_blocking(move || {
-                                Component::from_binary(&engine, &bytes).map_err(|e| {
-                                    GolemError::ComponentParseFailed {
-                                        component_id: component_id_clone2,
-                                        component_version,
-                                        reason: format!("{}", e),
-                                    }
-                                })
-                            })
-                            .await
-                            .map_err(|join_err| GolemError::unknown(join_err.to_string()))??;
-                            let end = Instant::now();
-
-                            let compilation_time = end.duration_since(start);
-                            record_compilation_time(compilation_time);
-                            debug!(
-                                "Compiled {} in {}ms",
-                                component_id_clone,
-                                compilation_time.as_millis(),
+                            let bytes = Arc::new(
+                                download_via_grpc(
+                                    &endpoint_clone,
+                                    &access_token,
+                                    &retry_config_clone,
+                                    &component_id_clone,
+                                    component_version,
+                                    max_component_size,
+                                )
+                                .await?,
                             );
 
-                            let result = compiled_component_service
-                                .put(&component_id_clone, component_version, &component)
-                                .await;
-
-                            match result {
-                                Ok(_) => Ok(component),
-                                Err(err) => {
-                                    warn!("Failed to upload compiled component {:?}: {}", key, err);
-                                    Ok(component)
-                                }
+                            if let Some(tiered_compilation) = tiered_compilation {
+                                let component = tiered_compilation
+                                    .compile_baseline(
+                                        &engine,
+                                        &component_id_clone,
+                                        component_version,
+                                        bytes.clone(),
+                                    )
+                                    .await?;
+                                tiered_compilation.optimize_in_background(
+                                    component_cache,
+                                    key,
+                                    engine,
+                                    compiled_component_service,
+                                    bytes,
+                                    true,
+                                );
+                                return Ok(component);
                             }
+
+                            compile_and_store(&engine, &key, &compiled_component_service, bytes)
+                                .await
                         }
                     }
                 })
@@ -447,6 +451,192 @@ fn grpc_get_latest_version_error(
     }
 }
 
+/// Compiles the component with full optimizations, and stores it in the compiled component
+/// service, so it is not compiled again
+async fn compile_and_store(
+    engine: &Engine,
+    key: &ComponentKey,
+    compiled_component_service: &Arc<dyn CompiledComponentService + Send + Sync>,
+    bytes: Arc<Vec<u8>>,
+) -> Result<Component, GolemError> {
+    let start = Instant::now();
+    let engine_clone = engine.clone();
+    let component_id = key.component_id.clone();
+    let component_version = key.component_version;
+    let component = spawn_blocking(move || {
+        Component::from_binary(&engine_clone, &bytes).map_err(|e| {
+            GolemError::ComponentParseFailed {
+                component_id,
+                component_version,
+                reason: format!("{}", e),
+            }
+        })
+    })
+    .await
+    .map_err(|join_err| GolemError::unknown(join_err.to_string()))??;
+    let end = Instant::now();
+
+    let compilation_time = end.duration_since(start);
+    record_compilation_time(compilation_time);
+    debug!(
+        "Compiled {} in {}ms",
+        key.component_id,
+        compilation_time.as_millis(),
+    );
+
+    let result = compiled_component_service
+        .put(
+            &key.component_id,
+            key.component_version,
+            CpuFeatureLevel::host(),
+            &component,
+        )
+        .await;
+
+    if let Err(err) = result {
+        warn!("Failed to upload compiled component {:?}: {}", key, err);
+    }
+    Ok(component)
+}
+
+/// Two-tier compilation of the component versions which have not been compiled yet.
+///
+/// The component is first compiled without optimizations, which is an order of magnitude faster
+/// than the optimizing compilation, so the first workers of a new component version can start
+/// right away. The optimized component is then taken from the compiled component service once
+/// the compilation service stored it there, or compiled locally if it does not show up in time,
+/// and replaces the unoptimized one in the component cache. Workers which are already running
+/// keep using the unoptimized code, all new instantiations get the optimized one.
+#[derive(Clone)]
+pub struct TieredCompilation {
+    /// Engine with the same configuration as the one running the workers except for the
+    /// optimization level, which does not affect the compatibility of the compiled code
+    baseline_engine: Engine,
+    poll_interval: Duration,
+    compilation_service_timeout: Duration,
+}
+
+impl TieredCompilation {
+    pub fn new(baseline_engine: Engine, config: &TieredCompilationConfig) -> Self {
+        Self {
+            baseline_engine,
+            poll_interval: config.poll_interval,
+            compilation_service_timeout: config.compilation_service_timeout,
+        }
+    }
+
+    /// Compiles the component without optimizations, loading it into `engine`
+    async fn compile_baseline(
+        &self,
+        engine: &Engine,
+        component_id: &ComponentId,
+        component_version: ComponentVersion,
+        bytes: Arc<Vec<u8>>,
+    ) -> Result<Component, GolemError> {
+        let start = Instant::now();
+        let baseline_engine = self.baseline_engine.clone();
+        let engine = engine.clone();
+        let component_id_clone = component_id.clone();
+        let component = spawn_blocking(move || {
+            baseline_engine
+                .precompile_component(&bytes)
+                .and_then(|precompiled| unsafe { Component::deserialize(&engine, &precompiled) })
+                .map_err(|e| GolemError::ComponentParseFailed {
+                    component_id: component_id_clone,
+                    component_version,
+                    reason: format!("{}", e),
+                })
+        })
+        .await
+        .map_err(|join_err| GolemError::unknown(join_err.to_string()))??;
+        let end = Instant::now();
+
+        let compilation_time = end.duration_since(start);
+        record_baseline_compilation_time(compilation_time);
+        debug!(
+            "Compiled the baseline tier of {} in {}ms",
+            component_id,
+            compilation_time.as_millis(),
+        );
+
+        Ok(component)
+    }
+
+    /// Replaces the cached baseline tier of a component with the optimized one in the background
+    fn optimize_in_background(
+        &self,
+        component_cache: Cache<ComponentKey, (), Component, GolemError>,
+        key: ComponentKey,
+        engine: Engine,
+        compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
+        bytes: Arc<Vec<u8>>,
+        wait_for_compilation_service: bool,
+    ) {
+        let this = self.clone();
+        tokio::spawn(async move {
+            let result = this
+                .optimized(
+                    &key,
+                    &engine,
+                    &compiled_component_service,
+                    bytes,
+                    wait_for_compilation_service,
+                )
+                .await;
+            match result {
+                // The component may have been evicted meanwhile, it is not loaded again then
+                Ok(component) => {
+                    if component_cache.replace(&key, component) {
+                        debug!("Switched {:?} to its optimized tier", key);
+                    }
+                }
+                Err(err) => {
+                    warn!(
+                        "Failed to compile the optimized tier of {:?}, keeping the baseline tier: {}",
+                        key, err
+                    );
+                }
+            }
+        });
+    }
+
+    async fn optimized(
+        &self,
+        key: &ComponentKey,
+        engine: &Engine,
+        compiled_component_service: &Arc<dyn CompiledComponentService + Send + Sync>,
+        bytes: Arc<Vec<u8>>,
+        wait_for_compilation_service: bool,
+    ) -> Result<Component, GolemError> {
+        if wait_for_compilation_service {
+            let deadline = Instant::now() + self.compilation_service_timeout;
+            while Instant::now() < deadline {
+                tokio::time::sleep(self.poll_interval).await;
+                let result = compiled_component_service
+                    .get(
+                        &key.component_id,
+                        key.component_version,
+                        CpuFeatureLevel::host(),
+                        engine,
+                    )
+                    .await;
+                match result {
+                    Ok(Some(component)) => return Ok(component),
+                    Ok(None) => {}
+                    Err(err) => {
+                        warn!("Failed to download compiled component {:?}: {}", key, err);
+                    }
+                }
+            }
+            debug!(
+                "The compilation service did not compile {:?} in time, compiling it locally",
+                key
+            );
+        }
+        compile_and_store(engine, key, compiled_component_service, bytes).await
+    }
+}
+
 fn create_component_cache(
     max_capacity: usize,
     time_to_idle: Duration,
@@ -474,6 +664,7 @@ pub struct ComponentServiceLocalFileSystem {
     root: PathBuf,
     component_cache: Cache<ComponentKey, (), Component, GolemError>,
     compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
+    tiered_compilation: Option<TieredCompilation>,
 }
 
 impl ComponentServiceLocalFileSystem {
@@ -482,6 +673,7 @@ impl ComponentServiceLocalFileSystem {
         max_capacity: usize,
         time_to_idle: Duration,
         compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync>,
+        tiered_compilation: Option<TieredCompilation>,
     ) -> Self {
         if !root.exists() {
             std::fs::create_dir_all(root).expect("Failed to create local component store");
@@ -490,6 +682,7 @@ impl ComponentServiceLocalFileSystem {
             root: root.to_path_buf(),
             component_cache: create_component_cache(max_capacity, time_to_idle),
             compiled_component_service,
+            tiered_compilation,
         }
     }
 
@@ -507,13 +700,20 @@ impl ComponentServiceLocalFileSystem {
         let component_id = component_id.clone();
         let engine = engine.clone();
         let compiled_component_service = self.compiled_component_service.clone();
+        let tiered_compilation = self.tiered_compilation.clone();
+        let component_cache = self.component_cache.clone();
         let path = path.to_path_buf();
         debug!("Loading component from {:?}", path);
         self.component_cache
             .get_or_insert_simple(&key.clone(), || {
                 Box::pin(async move {
                     let result = compiled_component_service
-                        .get(&component_id, component_version, &engine)
+                        .get(
+                            &component_id,
+                            component_version,
+                            CpuFeatureLevel::host(),
+                            &engine,
+                        )
                         .await;
 
                     let component = match result {
@@ -527,38 +727,31 @@ impl ComponentServiceLocalFileSystem {
                     match component {
                         Some(component) => Ok(component),
                         None => {
-                            let bytes = tokio::fs::read(path).await?;
+                            let bytes = Arc::new(tokio::fs::read(path).await?);
 
-                            let start = Instant::now();
-                            let component =
-                                Component::from_binary(&engine, &bytes).map_err(|e| {
-                                    GolemError::ComponentParseFailed {
-                                        component_id: component_id.clone(),
+                            if let Some(tiered_compilation) = tiered_compilation {
+                                let component = tiered_compilation
+                                    .compile_baseline(
+                                        &engine,
+                                        &component_id,
                                         component_version,
-                                        reason: format!("{}", e),
-                                    }
-                                })?;
-                            let end = Instant::now();
-
-                            let compilation_time = end.duration_since(start);
-                            record_compilation_time(compilation_time);
-                            debug!(
-                                "Compiled {} in {}ms",
-                                component_id,
-                                compilation_time.as_millis(),
-                            );
-
-                            let result = compiled_component_service
-                                .put(&component_id, component_version, &component)
-                                .await;
-
-                            match result {
-                                Ok(_) => Ok(component),
-                                Err(err) => {
-                                    warn!("Failed to upload compiled component {:?}: {}", key, err);
-                                    Ok(component)
-                                }
+                                        bytes.clone(),
+                                    )
+                                    .await?;
+                                // There is no compilation service compiling the local components
+                                tiered_compilation.optimize_in_background(
+                                    component_cache,
+                                    key,
+                                    engine,
+                                    compiled_component_service,
+                                    bytes,
+                                    false,
+                                );
+                                return Ok(component);
                             }
+
+                            compile_and_store(&engine, &key, &compiled_component_service, bytes)
+                                .await
                         }
                     }
                 })
@@ -754,3 +947,96 @@ impl ComponentService for ComponentServiceMock {
         unimplemented!()
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use std::sync::Arc;
+    use std::time::{Duration, Instant};
+
+    use golem_common::model::ComponentId;
+    use uuid::Uuid;
+    use wasmtime::{Config, Engine, InstanceAllocationStrategy, OptLevel};
+
+    use crate::services::compiled_component::{
+        CompiledComponentService, CpuFeatureLevel, DefaultCompiledComponentService,
+    };
+    use crate::services::component::{create_component_cache, ComponentKey, TieredCompilation};
+    use crate::services::golem_config::TieredCompilationConfig;
+    use crate::storage::blob::memory::InMemoryBlobStorage;
+
+    #[tokio::test]
+    async fn baseline_tier_is_replaced_by_the_optimized_one() {
+        let mut config = Config::new();
+        config.wasm_component_model(true);
+        let engine = Engine::new(&config).unwrap();
+        config.cranelift_opt_level(OptLevel::None);
+        config.allocation_strategy(InstanceAllocationStrategy::OnDemand);
+        let tiered_compilation = TieredCompilation::new(
+            Engine::new(&config).unwrap(),
+            &TieredCompilationConfig {
+                enabled: true,
+                poll_interval: Duration::from_millis(10),
+                compilation_service_timeout: Duration::from_secs(1),
+            },
+        );
+        let compiled_component_service: Arc<dyn CompiledComponentService + Send + Sync> = Arc::new(
+            DefaultCompiledComponentService::new(Arc::new(InMemoryBlobStorage::new())),
+        );
+        let component_cache = create_component_cache(10, Duration::from_secs(60));
+        let key = ComponentKey {
+            component_id: ComponentId(Uuid::new_v4()),
+            component_version: 0,
+        };
+        let bytes = Arc::new(std::fs::read("../test-components/rust-echo.wasm").unwrap());
+
+        let baseline = tiered_compilation
+            .compile_baseline(
+                &engine,
+                &key.component_id,
+                key.component_version,
+                bytes.clone(),
+            )
+            .await
+            .unwrap();
+        let baseline_clone = baseline.clone();
+        let _ = component_cache
+            .get_or_insert_simple(&key, || Box::pin(async move { Ok(baseline_clone) }))
+            .await
+            .unwrap();
+
+        tiered_compilation.optimize_in_background(
+            component_cache.clone(),
+            key.clone(),
+            engine.clone(),
+            compiled_component_service.clone(),
+            bytes,
+            false,
+        );
+
+        let deadline = Instant::now() + Duration::from_secs(60);
+        let optimized = loop {
+            let cached = component_cache.try_get(&key).unwrap();
+            if cached.image_range() != baseline.image_range() {
+                break cached;
+            }
+            assert!(
+                Instant::now() < deadline,
+                "The baseline tier was not replaced"
+            );
+            tokio::time::sleep(Duration::from_millis(10)).await;
+        };
+
+        // The optimized tier is stored, so it is not compiled again by the next executor
+        let stored = compiled_component_service
+            .get(
+                &key.component_id,
+                key.component_version,
+                CpuFeatureLevel::host(),
+                &engine,
+            )
+            .await
+            .unwrap();
+        assert!(stored.is_some());
+        assert_ne!(optimized.image_range(), baseline.image_range());
+    }
+}
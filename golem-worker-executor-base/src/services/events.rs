@@ -12,13 +12,26 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use crate::error::GolemError;
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+
 use golem_common::model::{IdempotencyKey, WorkerId};
 use golem_wasm_rpc::Value;
+use tokio::sync::oneshot;
+
+use crate::error::GolemError;
 
+type InvocationResultSenders =
+    HashMap<(WorkerId, IdempotencyKey), Vec<oneshot::Sender<Result<Vec<Value>, GolemError>>>>;
+
+/// Hands over the results of the completed invocations to the callers awaiting them, no matter
+/// whether they are waiting through the gRPC API or a worker-to-worker RPC call on the same
+/// executor.
+///
+/// Waiters are registered by worker and idempotency key, so a completion only wakes up its
+/// own waiters, and it cannot be missed by a waiter registered before it was published.
 pub struct Events {
-    sender: tokio::sync::broadcast::Sender<Event>,
-    _receiver: tokio::sync::broadcast::Receiver<Event>,
+    waiters: Arc<Mutex<InvocationResultSenders>>,
 }
 
 impl Default for Events {
@@ -29,32 +42,79 @@ impl Default for Events {
 
 impl Events {
     pub fn new() -> Self {
-        let (sender, receiver) = tokio::sync::broadcast::channel(100);
         Self {
-            sender,
-            _receiver: receiver,
+            waiters: Arc::new(Mutex::new(HashMap::new())),
         }
     }
 
     pub fn publish(&self, event: Event) {
-        let _ = self.sender.send(event);
+        match event {
+            Event::InvocationCompleted {
+                worker_id,
+                idempotency_key,
+                result,
+            } => {
+                let senders = self
+                    .waiters
+                    .lock()
+                    .unwrap()
+                    .remove(&(worker_id, idempotency_key));
+                for sender in senders.into_iter().flatten() {
+                    let _ = sender.send(result.clone());
+                }
+            }
+        }
     }
 
-    pub async fn wait_for<F, R>(&self, f: F) -> R
-    where
-        F: Fn(&Event) -> Option<R>,
-    {
-        let mut receiver = self.sender.subscribe();
-        loop {
-            match receiver.recv().await {
-                Ok(event) => {
-                    if let Some(result) = f(&event) {
-                        break result;
-                    } else {
-                        continue;
-                    }
-                }
-                Err(_) => continue,
+    /// Registers a waiter for the completion of the given invocation. The result has to be
+    /// looked up again after registering, in case the invocation completed in the meantime.
+    pub fn subscribe_to_invocation_result(
+        &self,
+        worker_id: WorkerId,
+        idempotency_key: IdempotencyKey,
+    ) -> InvocationResultWaiter {
+        let (sender, receiver) = oneshot::channel();
+        let key = (worker_id, idempotency_key);
+        self.waiters
+            .lock()
+            .unwrap()
+            .entry(key.clone())
+            .or_default()
+            .push(sender);
+        InvocationResultWaiter {
+            key,
+            receiver: Some(receiver),
+            waiters: self.waiters.clone(),
+        }
+    }
+}
+
+pub struct InvocationResultWaiter {
+    key: (WorkerId, IdempotencyKey),
+    receiver: Option<oneshot::Receiver<Result<Vec<Value>, GolemError>>>,
+    waiters: Arc<Mutex<InvocationResultSenders>>,
+}
+
+impl InvocationResultWaiter {
+    pub async fn wait(mut self) -> Result<Vec<Value>, GolemError> {
+        match self.receiver.as_mut() {
+            Some(receiver) => receiver
+                .await
+                .unwrap_or_else(|_| Err(GolemError::unknown("Invocation result was dropped"))),
+            None => Err(GolemError::unknown("Invocation result was already awaited")),
+        }
+    }
+}
+
+impl Drop for InvocationResultWaiter {
+    fn drop(&mut self) {
+        // Unregistering the waiter if it was dropped before the invocation completed
+        drop(self.receiver.take());
+        let mut waiters = self.waiters.lock().unwrap();
+        if let Some(senders) = waiters.get_mut(&self.key) {
+            senders.retain(|sender| !sender.is_closed());
+            if senders.is_empty() {
+                waiters.remove(&self.key);
             }
         }
     }
@@ -68,3 +128,41 @@ pub enum Event {
         result: Result<Vec<Value>, GolemError>,
     },
 }
+
+#[cfg(test)]
+mod tests {
+    use golem_common::model::{ComponentId, IdempotencyKey, WorkerId};
+    use golem_wasm_rpc::Value;
+    use uuid::Uuid;
+
+    use crate::services::events::{Event, Events};
+
+    fn worker_id(name: &str) -> WorkerId {
+        WorkerId {
+            component_id: ComponentId(Uuid::nil()),
+            worker_name: name.to_string(),
+        }
+    }
+
+    #[tokio::test]
+    async fn completion_is_handed_over_to_its_own_waiters() {
+        let events = Events::new();
+        let key = IdempotencyKey::fresh();
+        let waiter1 = events.subscribe_to_invocation_result(worker_id("w1"), key.clone());
+        let waiter2 = events.subscribe_to_invocation_result(worker_id("w1"), key.clone());
+        let other = events.subscribe_to_invocation_result(worker_id("w2"), key.clone());
+
+        events.publish(Event::InvocationCompleted {
+            worker_id: worker_id("w1"),
+            idempotency_key: key.clone(),
+            result: Ok(vec![Value::U32(1)]),
+        });
+
+        assert_eq!(waiter1.wait().await.unwrap(), vec![Value::U32(1)]);
+        assert_eq!(waiter2.wait().await.unwrap(), vec![Value::U32(1)]);
+        assert_eq!(events.waiters.lock().unwrap().len(), 1);
+
+        drop(other);
+        assert!(events.waiters.lock().unwrap().is_empty());
+    }
+}
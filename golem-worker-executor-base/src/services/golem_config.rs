@@ -22,6 +22,7 @@ use figment::Figment;
 use http::Uri;
 use serde::Deserialize;
 use url::Url;
+use wasmtime::{Config, InstanceAllocationStrategy};
 
 use golem_common::config::{RedisConfig, RetryConfig};
 
@@ -43,6 +44,16 @@ pub struct GolemConfig {
     pub scheduler: SchedulerConfig,
     pub public_worker_api: WorkerServiceGrpcConfig,
     pub memory: MemoryConfig,
+    pub worker_output: WorkerOutputConfig,
+    pub key_value_write_behind: KeyValueWriteBehindConfig,
+    pub rpc_affinity: RpcAffinityConfig,
+    pub memory_headroom: MemoryHeadroomConfig,
+    pub clock_snapshot: ClockSnapshotConfig,
+    pub tiered_compilation: TieredCompilationConfig,
+    pub outgoing_http: OutgoingHttpConfig,
+    pub worker_index: WorkerIndexConfig,
+    pub initial_file_system: InitialFileSystemConfig,
+    pub guest_profiler: GuestProfilerConfig,
     pub enable_tracing_console: bool,
     pub enable_json_log: bool,
     pub grpc_address: String,
@@ -56,12 +67,83 @@ pub struct Limits {
     pub max_active_workers: usize,
     pub concurrency_limit_per_connection: usize,
     pub max_concurrent_streams: u32,
+    /// Number of events a subscriber of a worker's events can fall behind by, in addition to
+    /// the history, before missing some
     pub event_broadcast_capacity: usize,
+    /// Number of recent events of a worker replayed to new subscribers
     pub event_history_size: usize,
     pub fuel_to_borrow: i64,
     #[serde(with = "humantime_serde")]
     pub epoch_interval: Duration,
     pub epoch_ticks: u64,
+    /// Maximum number of workers started concurrently when recovering the workers of newly
+    /// assigned shards
+    pub max_concurrent_recoveries: usize,
+    pub instance_allocation: InstanceAllocationConfig,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+#[serde(tag = "type", content = "config")]
+pub enum InstanceAllocationConfig {
+    /// Every instance maps and unmaps its own linear memories and tables
+    OnDemand,
+    /// Instances are allocated from pre-reserved slots, which are reset with `madvise` and kept
+    /// warm for the component they were last used by instead of being unmapped
+    Pooling(PoolingAllocationConfig),
+}
+
+impl InstanceAllocationConfig {
+    /// The maximum number of component instances that can be alive at the same time, if limited
+    pub fn max_instances(&self) -> Option<usize> {
+        match self {
+            InstanceAllocationConfig::OnDemand => None,
+            InstanceAllocationConfig::Pooling(config) => {
+                Some(config.total_component_instances as usize)
+            }
+        }
+    }
+
+    /// Sets the instance allocation strategy of the wasmtime configuration
+    pub fn configure(&self, config: &mut Config) {
+        match self {
+            InstanceAllocationConfig::OnDemand => {}
+            InstanceAllocationConfig::Pooling(pooling_config) => {
+                // Linear memory limits of the pooling allocator are given in 64KiB wasm pages
+                let memory_pages = pooling_config.max_memory_size / 65536;
+                let mut pooling = wasmtime::PoolingAllocationConfig::default();
+                pooling
+                    .total_component_instances(pooling_config.total_component_instances)
+                    .total_core_instances(pooling_config.total_core_instances)
+                    .total_memories(pooling_config.total_memories)
+                    .total_tables(pooling_config.total_tables)
+                    .total_stacks(pooling_config.total_stacks)
+                    .memory_pages(memory_pages)
+                    .max_unused_warm_slots(pooling_config.max_unused_warm_slots)
+                    .linear_memory_keep_resident(pooling_config.linear_memory_keep_resident)
+                    .table_keep_resident(pooling_config.table_keep_resident);
+                config.allocation_strategy(InstanceAllocationStrategy::Pooling(pooling));
+            }
+        }
+    }
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct PoolingAllocationConfig {
+    pub total_component_instances: u32,
+    pub total_core_instances: u32,
+    pub total_memories: u32,
+    pub total_tables: u32,
+    /// Number of fiber stacks for the async calls into instances, at most one used by each
+    /// running worker
+    pub total_stacks: u32,
+    /// Maximum size of a single linear memory in bytes
+    pub max_memory_size: u64,
+    /// Number of slots kept warm without being assigned to any component
+    pub max_unused_warm_slots: u32,
+    /// Number of bytes of each linear memory slot which are reset with `memset` and kept
+    /// resident instead of being decommitted with `madvise`
+    pub linear_memory_keep_resident: usize,
+    pub table_keep_resident: usize,
 }
 
 #[derive(Clone, Debug, Deserialize)]
@@ -216,6 +298,119 @@ pub struct SchedulerConfig {
     pub refresh_interval: Duration,
 }
 
+#[derive(Clone, Debug, Deserialize)]
+pub struct WorkerOutputConfig {
+    /// Coalesce consecutive stdout/stderr writes of a worker into fewer worker events
+    pub coalesce: bool,
+    pub max_buffered_bytes: usize,
+    #[serde(with = "humantime_serde")]
+    pub max_delay: Duration,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct KeyValueWriteBehindConfig {
+    /// Buffer the key-value mutations of a worker and write them in batches at the end of each
+    /// invocation, instead of one round trip to the key-value storage per call. The setting is
+    /// recorded in the oplog of each worker, so existing workers keep the mode they started with.
+    pub enabled: bool,
+    /// Number of buffered mutations (after coalescing writes to the same key) triggering a flush
+    /// before the end of the invocation
+    pub max_buffered_writes: usize,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct RpcAffinityConfig {
+    /// Count the worker to worker RPC calls between each pair of shards and periodically report
+    /// them to the shard manager, which can use them to place communicating workers on the same
+    /// node
+    pub enabled: bool,
+    #[serde(with = "humantime_serde")]
+    pub report_interval: Duration,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct MemoryHeadroomConfig {
+    /// Periodically report the memory available for the workers and the memory requirement of
+    /// the active workers to the shard manager, which avoids assigning more shards to worker
+    /// executors running out of worker memory
+    pub enabled: bool,
+    #[serde(with = "humantime_serde")]
+    pub report_interval: Duration,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct ClockSnapshotConfig {
+    /// Read the wall and monotonic clocks durably only once per invocation, and derive all the
+    /// clock readings of the invocation from that snapshot, instead of persisting every reading.
+    /// The setting is recorded in the oplog of each worker, so existing workers keep the mode
+    /// they started with.
+    pub enabled: bool,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct TieredCompilationConfig {
+    /// Start the workers of a component version which has not been compiled yet on a quickly
+    /// compiled, unoptimized version of it, and switch to the optimized one in the background
+    pub enabled: bool,
+    /// How often to check if the compilation service has stored the optimized component
+    #[serde(with = "humantime_serde")]
+    pub poll_interval: Duration,
+    /// How long to wait for the compilation service before compiling the optimized component
+    /// locally
+    #[serde(with = "humantime_serde")]
+    pub compilation_service_timeout: Duration,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct OutgoingHttpConfig {
+    /// Send the outgoing HTTP requests of all workers through an executor-wide connection pool,
+    /// instead of opening a new connection for each request
+    pub connection_pool: bool,
+    pub max_idle_connections_per_host: usize,
+    #[serde(with = "humantime_serde")]
+    pub idle_timeout: Duration,
+    /// Requests to the same host above this limit wait for one of the previous ones to finish.
+    /// On HTTP/2 connections these are multiplexed streams, not connections.
+    pub max_concurrent_requests_per_host: usize,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct WorkerIndexConfig {
+    /// Enumerate the workers of a component through the index of their statuses, scanning only
+    /// the statuses the filter can match, instead of scanning all of their oplogs.
+    /// Maintaining the index makes every status update read the previous status and move the
+    /// worker between the index entries. While it is disabled the index is not updated, so it
+    /// must be cleared (the `worker:component:*` keys) before enabling it again.
+    pub enabled: bool,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct GuestProfilerConfig {
+    /// Serve the `/profiler` endpoints starting, reading and stopping the profiling of workers
+    /// on the HTTP port. The endpoints are not authenticated, so this must only be enabled when
+    /// the HTTP port is not reachable by the users of the workers.
+    pub enabled: bool,
+}
+
+#[derive(Clone, Debug, Deserialize)]
+pub struct InitialFileSystemConfig {
+    /// Mount the initial file system image of the component into the workers' root directories.
+    /// The workers' copies of the files are hard links to a shared read-only snapshot, which is
+    /// replaced by a private copy before a worker writes to it. The read-only permission does not
+    /// protect the shared files from an executor running as root, so it should not run as root
+    /// with this enabled.
+    pub enabled: bool,
+    /// Directory of the initial file system images of the components, one
+    /// `{component_id}/{component_version}` directory for each. The images are not modified, each
+    /// is copied once into a temporary directory the workers' files are linked to.
+    pub root: PathBuf,
+    /// The number of component versions whose snapshots are kept
+    pub max_capacity: usize,
+    /// Snapshots not used by new workers for this long are dropped
+    #[serde(with = "humantime_serde")]
+    pub time_to_idle: Duration,
+}
+
 #[derive(Clone, Debug, Deserialize)]
 pub struct OplogConfig {
     pub max_operations_before_commit: u64,
@@ -225,6 +420,22 @@ pub struct OplogConfig {
     pub entry_count_limit: u64,
     #[serde(with = "humantime_serde")]
     pub archive_interval: Duration,
+    /// Number of oplog entries written since the last snapshot after which an idle worker is
+    /// checkpointed by saving a snapshot of its state. Recovery then starts from the snapshot and
+    /// only replays the entries written after it. Checkpointing is disabled if not set, and it is
+    /// only performed for components exporting both the save and load snapshot interfaces.
+    pub checkpoint_interval: Option<u64>,
+    /// Time the node level group commit waits for commits of other workers before writing a
+    /// batch to the indexed storage. With zero, only the commits already waiting while the
+    /// previous batch is written are grouped together.
+    #[serde(with = "humantime_serde")]
+    pub group_commit_window: Duration,
+    /// Maximum number of oplog entries in a group commit batch. It also bounds the number of
+    /// commits waiting for the next batch, and committing waits while that many are queued.
+    pub group_commit_max_entries: usize,
+    /// Number of oplog entries read in one chunk during replay. The next chunk is fetched in
+    /// the background while the previous one is replayed.
+    pub replay_prefetch_size: u64,
 }
 
 #[derive(Clone, Debug, Deserialize)]
@@ -261,6 +472,11 @@ pub struct S3BlobStorageConfig {
     pub oplog_payload_bucket: String,
     pub compressed_oplog_buckets: Vec<String>,
     pub use_minio_credentials: bool,
+    /// Blobs larger than this are uploaded with multipart uploads and downloaded with ranged
+    /// requests of this size. S3 requires parts of at least 5 MiB.
+    pub multipart_part_size: usize,
+    /// Maximum number of parts transferred concurrently for a single blob
+    pub transfer_parallelism: usize,
 }
 
 #[derive(Clone, Debug, Deserialize)]
@@ -313,6 +529,16 @@ impl Default for GolemConfig {
             active_workers: ActiveWorkersConfig::default(),
             public_worker_api: WorkerServiceGrpcConfig::default(),
             memory: MemoryConfig::default(),
+            worker_output: WorkerOutputConfig::default(),
+            key_value_write_behind: KeyValueWriteBehindConfig::default(),
+            rpc_affinity: RpcAffinityConfig::default(),
+            memory_headroom: MemoryHeadroomConfig::default(),
+            clock_snapshot: ClockSnapshotConfig::default(),
+            tiered_compilation: TieredCompilationConfig::default(),
+            outgoing_http: OutgoingHttpConfig::default(),
+            worker_index: WorkerIndexConfig::default(),
+            initial_file_system: InitialFileSystemConfig::default(),
+            guest_profiler: GuestProfilerConfig::default(),
             enable_tracing_console: false,
             enable_json_log: false,
             grpc_address: "0.0.0.0".to_string(),
@@ -334,6 +560,117 @@ impl Default for Limits {
             fuel_to_borrow: 10000,
             epoch_interval: Duration::from_millis(10),
             epoch_ticks: 1,
+            max_concurrent_recoveries: 16,
+            instance_allocation: InstanceAllocationConfig::default(),
+        }
+    }
+}
+
+impl Default for InstanceAllocationConfig {
+    fn default() -> Self {
+        Self::OnDemand
+    }
+}
+
+impl Default for PoolingAllocationConfig {
+    fn default() -> Self {
+        Self {
+            total_component_instances: 1000,
+            total_core_instances: 10000,
+            total_memories: 2000,
+            total_tables: 4000,
+            total_stacks: 1000,
+            max_memory_size: 4 * 1024 * 1024 * 1024,
+            max_unused_warm_slots: 100,
+            linear_memory_keep_resident: 0,
+            table_keep_resident: 0,
+        }
+    }
+}
+
+impl Default for WorkerOutputConfig {
+    fn default() -> Self {
+        Self {
+            coalesce: false,
+            max_buffered_bytes: 8 * 1024,
+            max_delay: Duration::from_millis(100),
+        }
+    }
+}
+
+impl Default for KeyValueWriteBehindConfig {
+    fn default() -> Self {
+        Self {
+            enabled: false,
+            max_buffered_writes: 1024,
+        }
+    }
+}
+
+impl Default for RpcAffinityConfig {
+    fn default() -> Self {
+        Self {
+            enabled: false,
+            report_interval: Duration::from_secs(60),
+        }
+    }
+}
+
+impl Default for MemoryHeadroomConfig {
+    fn default() -> Self {
+        Self {
+            enabled: false,
+            report_interval: Duration::from_secs(30),
+        }
+    }
+}
+
+impl Default for ClockSnapshotConfig {
+    fn default() -> Self {
+        Self { enabled: false }
+    }
+}
+
+impl Default for TieredCompilationConfig {
+    fn default() -> Self {
+        Self {
+            enabled: false,
+            poll_interval: Duration::from_secs(1),
+            compilation_service_timeout: Duration::from_secs(60),
+        }
+    }
+}
+
+impl Default for OutgoingHttpConfig {
+    fn default() -> Self {
+        Self {
+            connection_pool: false,
+            max_idle_connections_per_host: 32,
+            idle_timeout: Duration::from_secs(90),
+            max_concurrent_requests_per_host: 256,
+        }
+    }
+}
+
+impl Default for WorkerIndexConfig {
+    fn default() -> Self {
+        Self { enabled: false }
+    }
+}
+
+impl Default for GuestProfilerConfig {
+    fn default() -> Self {
+        Self { enabled: false }
+    }
+}
+
+impl Default for InitialFileSystemConfig {
+    fn default() -> Self {
+        Self {
+            enabled: false,
+            root: PathBuf::from("data/initial_file_system"),
+            max_capacity: 32,
+            time_to_idle: Duration::from_secs(60 * 60),
         }
     }
 }
@@ -383,6 +720,8 @@ impl Default for S3BlobStorageConfig {
             aws_endpoint_url: None,
             compressed_oplog_buckets: vec!["oplog-archive-1".to_string()],
             use_minio_credentials: false,
+            multipart_part_size: 8 * 1024 * 1024,
+            transfer_parallelism: 4,
         }
     }
 }
@@ -412,6 +751,10 @@ impl Default for OplogConfig {
             blob_storage_layers: 1,
             entry_count_limit: 1024,
             archive_interval: Duration::from_secs(60 * 60 * 24), // 24 hours
+            checkpoint_interval: None,
+            group_commit_window: Duration::ZERO,
+            group_commit_max_entries: 1024,
+            replay_prefetch_size: 256,
         }
     }
 }
@@ -18,6 +18,9 @@ use std::time::Duration;
 
 use crate::services::worker_activator::WorkerActivator;
 
+use crate::durable_host::filesystem::initial::InitialFileSystemService;
+use crate::durable_host::http::connection_pool::HttpConnectionPool;
+use crate::profiling::GuestProfiler;
 use crate::services::events::Events;
 use tokio::runtime::Handle;
 
@@ -41,6 +44,7 @@ pub mod worker_activator;
 pub mod worker_enumeration;
 pub mod worker_event;
 pub mod worker_proxy;
+pub mod worker_template;
 
 // HasXXX traits for fine-grained control of which dependencies a function needs
 
@@ -87,6 +91,7 @@ pub trait HasPromiseService {
 pub trait HasWasmtimeEngine<Ctx> {
     fn engine(&self) -> Arc<wasmtime::Engine>;
     fn linker(&self) -> Arc<wasmtime::component::Linker<Ctx>>;
+    fn worker_templates(&self) -> Arc<worker_template::WorkerTemplates<Ctx>>;
     fn runtime(&self) -> Handle;
 }
 
@@ -134,6 +139,18 @@ pub trait HasEvents {
     fn events(&self) -> Arc<Events>;
 }
 
+pub trait HasHttpConnectionPool {
+    fn http_connection_pool(&self) -> Arc<HttpConnectionPool>;
+}
+
+pub trait HasInitialFileSystemService {
+    fn initial_file_system_service(&self) -> Arc<InitialFileSystemService>;
+}
+
+pub trait HasGuestProfiler {
+    fn guest_profiler(&self) -> Arc<GuestProfiler>;
+}
+
 /// HasAll is a shortcut for requiring all available service dependencies
 pub trait HasAll<Ctx: WorkerCtx>:
     HasActiveWorkers<Ctx>
@@ -152,6 +169,9 @@ pub trait HasAll<Ctx: WorkerCtx>:
     + HasWorkerActivator
     + HasWorkerProxy
     + HasEvents
+    + HasHttpConnectionPool
+    + HasInitialFileSystemService
+    + HasGuestProfiler
     + HasShardManagerService
     + HasShardService
     + HasExtraDeps<Ctx>
@@ -177,6 +197,9 @@ impl<
             + HasWorkerActivator
             + HasWorkerProxy
             + HasEvents
+            + HasHttpConnectionPool
+            + HasInitialFileSystemService
+            + HasGuestProfiler
             + HasShardManagerService
             + HasShardService
             + HasExtraDeps<Ctx>
@@ -191,6 +214,7 @@ pub struct All<Ctx: WorkerCtx> {
     active_workers: Arc<active_workers::ActiveWorkers<Ctx>>,
     engine: Arc<wasmtime::Engine>,
     linker: Arc<wasmtime::component::Linker<Ctx>>,
+    worker_templates: Arc<worker_template::WorkerTemplates<Ctx>>,
     runtime: Handle,
     component_service: Arc<dyn component::ComponentService + Send + Sync>,
     shard_manager_service: Arc<dyn shard_manager::ShardManagerService + Send + Sync>,
@@ -209,6 +233,9 @@ pub struct All<Ctx: WorkerCtx> {
     worker_activator: Arc<dyn WorkerActivator + Send + Sync>,
     worker_proxy: Arc<dyn worker_proxy::WorkerProxy + Send + Sync>,
     events: Arc<Events>,
+    http_connection_pool: Arc<HttpConnectionPool>,
+    initial_file_system_service: Arc<InitialFileSystemService>,
+    guest_profiler: Arc<GuestProfiler>,
     extra_deps: Ctx::ExtraDeps,
 }
 
@@ -218,6 +245,7 @@ impl<Ctx: WorkerCtx> Clone for All<Ctx> {
             active_workers: self.active_workers.clone(),
             engine: self.engine.clone(),
             linker: self.linker.clone(),
+            worker_templates: self.worker_templates.clone(),
             runtime: self.runtime.clone(),
             component_service: self.component_service.clone(),
             shard_manager_service: self.shard_manager_service.clone(),
@@ -235,6 +263,9 @@ impl<Ctx: WorkerCtx> Clone for All<Ctx> {
             worker_activator: self.worker_activator.clone(),
             worker_proxy: self.worker_proxy.clone(),
             events: self.events.clone(),
+            http_connection_pool: self.http_connection_pool.clone(),
+            initial_file_system_service: self.initial_file_system_service.clone(),
+            guest_profiler: self.guest_profiler.clone(),
             extra_deps: self.extra_deps.clone(),
         }
     }
@@ -246,6 +277,7 @@ impl<Ctx: WorkerCtx> All<Ctx> {
         active_workers: Arc<active_workers::ActiveWorkers<Ctx>>,
         engine: Arc<wasmtime::Engine>,
         linker: Arc<wasmtime::component::Linker<Ctx>>,
+        worker_templates: Arc<worker_template::WorkerTemplates<Ctx>>,
         runtime: Handle,
         component_service: Arc<dyn component::ComponentService + Send + Sync>,
         shard_manager_service: Arc<dyn shard_manager::ShardManagerService + Send + Sync>,
@@ -267,12 +299,16 @@ impl<Ctx: WorkerCtx> All<Ctx> {
         worker_activator: Arc<dyn WorkerActivator + Send + Sync>,
         worker_proxy: Arc<dyn worker_proxy::WorkerProxy + Send + Sync>,
         events: Arc<Events>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
+        guest_profiler: Arc<GuestProfiler>,
         extra_deps: Ctx::ExtraDeps,
     ) -> Self {
         Self {
             active_workers,
             engine,
             linker,
+            worker_templates,
             runtime,
             component_service,
             shard_manager_service,
@@ -290,6 +326,9 @@ impl<Ctx: WorkerCtx> All<Ctx> {
             worker_activator,
             worker_proxy,
             events,
+            http_connection_pool,
+            initial_file_system_service,
+            guest_profiler,
             extra_deps,
         }
     }
@@ -300,9 +339,15 @@ impl<Ctx: WorkerCtx> All<Ctx> {
             100,
             0.01,
             Duration::from_secs(60),
+            u64::MAX,
         ));
         let engine = Arc::new(wasmtime::Engine::default());
         let linker = Arc::new(wasmtime::component::Linker::new(&engine));
+        let worker_templates = Arc::new(worker_template::WorkerTemplates::new(
+            linker.clone(),
+            100,
+            Duration::from_secs(60),
+        ));
         let runtime = Handle::current();
         let component_service = Arc::new(component::ComponentServiceMock::new());
         let worker_service = Arc::new(worker::WorkerServiceMock::new());
@@ -327,10 +372,16 @@ impl<Ctx: WorkerCtx> All<Ctx> {
         let worker_activator = Arc::new(worker_activator::WorkerActivatorMock::new());
         let worker_proxy = Arc::new(worker_proxy::WorkerProxyMock::new());
         let events = Arc::new(Events::new());
+        let http_connection_pool = Arc::new(HttpConnectionPool::new(&golem_config.outgoing_http));
+        let initial_file_system_service = Arc::new(InitialFileSystemService::new(
+            &golem_config.initial_file_system,
+        ));
+        let guest_profiler = Arc::new(GuestProfiler::new());
         Self {
             active_workers,
             engine,
             linker,
+            worker_templates,
             runtime,
             component_service,
             shard_manager_service,
@@ -348,6 +399,9 @@ impl<Ctx: WorkerCtx> All<Ctx> {
             worker_activator,
             worker_proxy,
             events,
+            http_connection_pool,
+            initial_file_system_service,
+            guest_profiler,
             extra_deps: mocked_extra_deps,
         }
     }
@@ -357,6 +411,7 @@ impl<Ctx: WorkerCtx> All<Ctx> {
             this.active_workers(),
             this.engine(),
             this.linker(),
+            this.worker_templates(),
             this.runtime(),
             this.component_service(),
             this.shard_manager_service(),
@@ -374,6 +429,9 @@ impl<Ctx: WorkerCtx> All<Ctx> {
             this.worker_activator(),
             this.worker_proxy(),
             this.events(),
+            this.http_connection_pool(),
+            this.initial_file_system_service(),
+            this.guest_profiler(),
             this.extra_deps(),
         )
     }
@@ -460,6 +518,10 @@ impl<Ctx: WorkerCtx, T: UsesAllDeps<Ctx = Ctx>> HasWasmtimeEngine<Ctx> for T {
         self.all().linker.clone()
     }
 
+    fn worker_templates(&self) -> Arc<worker_template::WorkerTemplates<Ctx>> {
+        self.all().worker_templates.clone()
+    }
+
     fn runtime(&self) -> Handle {
         self.all().runtime.clone()
     }
@@ -513,6 +575,24 @@ impl<Ctx: WorkerCtx, T: UsesAllDeps<Ctx = Ctx>> HasEvents for T {
     }
 }
 
+impl<Ctx: WorkerCtx, T: UsesAllDeps<Ctx = Ctx>> HasHttpConnectionPool for T {
+    fn http_connection_pool(&self) -> Arc<HttpConnectionPool> {
+        self.all().http_connection_pool.clone()
+    }
+}
+
+impl<Ctx: WorkerCtx, T: UsesAllDeps<Ctx = Ctx>> HasInitialFileSystemService for T {
+    fn initial_file_system_service(&self) -> Arc<InitialFileSystemService> {
+        self.all().initial_file_system_service.clone()
+    }
+}
+
+impl<Ctx: WorkerCtx, T: UsesAllDeps<Ctx = Ctx>> HasGuestProfiler for T {
+    fn guest_profiler(&self) -> Arc<GuestProfiler> {
+        self.all().guest_profiler.clone()
+    }
+}
+
 impl<Ctx: WorkerCtx, T: UsesAllDeps<Ctx = Ctx>> HasExtraDeps<Ctx> for T {
     fn extra_deps(&self) -> Ctx::ExtraDeps {
         self.all().extra_deps.clone()
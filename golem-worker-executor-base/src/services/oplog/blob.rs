@@ -275,7 +275,13 @@ impl BlobOplogArchive {
         path
     }
 
-    async fn read_and_cache_chunk(&self, idx: OplogIndex) -> Result<Option<OplogIndex>, String> {
+    /// Reads the chunk containing `idx` and caches a window of its entries that includes `idx`,
+    /// starting no earlier than `lower`, the first index the caller is interested in.
+    async fn read_and_cache_chunk(
+        &self,
+        idx: OplogIndex,
+        lower: OplogIndex,
+    ) -> Result<Option<OplogIndex>, String> {
         let entries = self.entries.read().await;
         let last_idx = entries.keys().find(|k| **k >= idx);
         if let Some(last_idx) = last_idx {
@@ -293,13 +299,16 @@ impl BlobOplogArchive {
                 .await?
                 .ok_or(format!("compressed chunk for {last_idx} not found"))?;
 
-            let entries = chunk.decompress()?;
+            let (from, to) = CompressedOplogChunk::cache_window(
+                (*last_idx).into(),
+                chunk.count,
+                lower.into(),
+                idx.into(),
+            );
+            let entries = chunk.decompress_range((*last_idx).into(), from, to)?;
             let mut cache = self.cache.write().await;
-
-            let mut idx = Into::<u64>::into(*last_idx) - chunk.count + 1;
-            for entry in entries {
-                cache.insert(OplogIndex::from_u64(idx), entry);
-                idx += 1;
+            for (idx, entry) in entries {
+                cache.insert(idx, entry);
             }
 
             Ok(Some(*last_idx))
@@ -343,7 +352,7 @@ impl OplogArchive for BlobOplogArchive {
                 break;
             }
 
-            let fetched_last_idx = self.read_and_cache_chunk(last_idx).await.unwrap_or_else(|err| {
+            let fetched_last_idx = self.read_and_cache_chunk(last_idx, idx).await.unwrap_or_else(|err| {
                 panic!("failed to read compressed oplog for worker {owned_worker_id} in blob storage: {err}")
             });
             if fetched_last_idx.is_some() {
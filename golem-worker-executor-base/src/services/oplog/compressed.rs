@@ -12,19 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use std::cmp::min;
-use std::collections::BTreeMap;
-use std::sync::Arc;
+use std::cmp::{max, min};
+use std::collections::{BTreeMap, HashMap};
+use std::io::BufReader;
+use std::sync::{Arc, Mutex, Weak};
 
 use async_trait::async_trait;
 use bincode::{Decode, Encode};
 use evicting_cache_map::EvictingCacheMap;
 use tokio::sync::RwLock;
+use tokio::task::JoinHandle;
 
 use crate::error::GolemError;
 use golem_common::model::oplog::{OplogEntry, OplogIndex};
 use golem_common::model::{AccountId, ComponentId, OwnedWorkerId, ScanCursor, WorkerId};
-use golem_common::serialization::{deserialize, serialize};
+use golem_common::serialization::{deserialize_vec_from_reader, serialize, VecDeserializer};
 
 use crate::services::oplog::multilayer::{OplogArchive, OplogArchiveService};
 use crate::services::oplog::PrimaryOplogService;
@@ -34,6 +36,9 @@ use crate::storage::indexed::{IndexedStorage, IndexedStorageLabelledApi, Indexed
 pub struct CompressedOplogArchiveService {
     indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
     level: usize,
+    /// Archives currently in use. Sharing them lets the entry-by-entry reads of a replay use
+    /// the chunk already decompressed and the next one prefetched by the previous read.
+    open_archives: Mutex<HashMap<WorkerId, Weak<CompressedOplogArchive>>>,
 }
 
 impl CompressedOplogArchiveService {
@@ -44,6 +49,27 @@ impl CompressedOplogArchiveService {
         Self {
             indexed_storage,
             level,
+            open_archives: Mutex::new(HashMap::new()),
+        }
+    }
+
+    fn open_archive(&self, worker_id: WorkerId) -> Arc<CompressedOplogArchive> {
+        let mut open_archives = self.open_archives.lock().unwrap();
+        let existing = open_archives
+            .get(&worker_id)
+            .and_then(|archive| archive.upgrade());
+        match existing {
+            Some(archive) => archive,
+            None => {
+                open_archives.retain(|_, archive| archive.strong_count() > 0);
+                let archive = Arc::new(CompressedOplogArchive::new(
+                    worker_id.clone(),
+                    self.indexed_storage.clone(),
+                    self.level,
+                ));
+                open_archives.insert(worker_id, Arc::downgrade(&archive));
+                archive
+            }
         }
     }
 
@@ -55,14 +81,21 @@ impl CompressedOplogArchiveService {
 #[async_trait]
 impl OplogArchiveService for CompressedOplogArchiveService {
     async fn open(&self, owned_worker_id: &OwnedWorkerId) -> Arc<dyn OplogArchive + Send + Sync> {
-        Arc::new(CompressedOplogArchive::new(
-            owned_worker_id.worker_id(),
-            self.indexed_storage.clone(),
-            self.level,
-        ))
+        self.open_archive(owned_worker_id.worker_id())
     }
 
     async fn delete(&self, owned_worker_id: &OwnedWorkerId) {
+        let open_archive = self
+            .open_archives
+            .lock()
+            .unwrap()
+            .remove(&owned_worker_id.worker_id)
+            .and_then(|archive| archive.upgrade());
+        if let Some(archive) = open_archive {
+            // A new worker with the same id would get different entries for the same indices
+            archive.clear_cache().await;
+        }
+
         self.indexed_storage
             .with("compressed_oplog", "delete")
             .delete(IndexedStorageNamespace::CompressedOpLog { level: self.level }, &Self::compressed_oplog_key(&owned_worker_id.worker_id))
@@ -143,6 +176,14 @@ pub struct CompressedOplogArchive {
         >,
     >,
     level: usize,
+    prefetched: Mutex<Option<PrefetchedChunk>>,
+}
+
+/// Background fetch of the chunk containing the entries following `from`
+#[derive(Debug)]
+struct PrefetchedChunk {
+    from: u64,
+    handle: JoinHandle<Result<Option<(u64, CompressedOplogChunk)>, String>>,
 }
 
 impl CompressedOplogArchive {
@@ -158,28 +199,95 @@ impl CompressedOplogArchive {
             indexed_storage,
             cache: RwLock::new(EvictingCacheMap::new()),
             level,
+            prefetched: Mutex::new(None),
         }
     }
 
-    async fn read_and_cache_chunk(&self, idx: OplogIndex) -> Result<Option<OplogIndex>, String> {
-        if let Some((last_idx, chunk)) = self
-            .indexed_storage
+    async fn clear_cache(&self) {
+        *self.cache.write().await = EvictingCacheMap::new();
+        if let Some(prefetched) = self.prefetched.lock().unwrap().take() {
+            prefetched.handle.abort();
+        }
+    }
+
+    async fn fetch_chunk(
+        indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
+        key: String,
+        level: usize,
+        idx: u64,
+    ) -> Result<Option<(u64, CompressedOplogChunk)>, String> {
+        indexed_storage
             .with_entity("compressed_oplog", "read", "compressed_entry")
             .closest::<CompressedOplogChunk>(
-                IndexedStorageNamespace::CompressedOpLog { level: self.level },
-                &self.key,
-                idx.into(),
+                IndexedStorageNamespace::CompressedOpLog { level },
+                &key,
+                idx,
             )
-            .await?
+            .await
+    }
+
+    /// Gets the chunk containing `idx`, using the prefetched one if it is the right chunk
+    async fn get_chunk(&self, idx: u64) -> Result<Option<(u64, CompressedOplogChunk)>, String> {
+        let prefetched = self.prefetched.lock().unwrap().take();
+        if let Some(prefetched) = prefetched {
+            if idx >= prefetched.from {
+                if let Ok(Ok(Some((last_idx, chunk)))) = prefetched.handle.await {
+                    if idx <= last_idx && idx + chunk.count > last_idx {
+                        return Ok(Some((last_idx, chunk)));
+                    }
+                }
+            } else {
+                prefetched.handle.abort();
+            }
+        }
+
+        Self::fetch_chunk(
+            self.indexed_storage.clone(),
+            self.key.clone(),
+            self.level,
+            idx,
+        )
+        .await
+    }
+
+    /// Starts fetching the chunk containing the entries following `last_idx` in the background,
+    /// so a replay reading the oplog forward does not have to wait for it
+    fn prefetch_after(&self, last_idx: u64) {
+        let from = last_idx + 1;
+        let handle = tokio::spawn(Self::fetch_chunk(
+            self.indexed_storage.clone(),
+            self.key.clone(),
+            self.level,
+            from,
+        ));
+        if let Some(previous) = self
+            .prefetched
+            .lock()
+            .unwrap()
+            .replace(PrefetchedChunk { from, handle })
         {
-            let entries = chunk.decompress()?;
-            let mut cache = self.cache.write().await;
+            previous.handle.abort();
+        }
+    }
 
-            let mut idx = last_idx - chunk.count + 1;
-            for entry in entries {
-                cache.insert(OplogIndex::from_u64(idx), entry);
-                idx += 1;
+    /// Reads the chunk containing `idx` and caches a window of its entries that includes `idx`,
+    /// starting no earlier than `lower`, the first index the caller is interested in.
+    async fn read_and_cache_chunk(
+        &self,
+        idx: OplogIndex,
+        lower: OplogIndex,
+    ) -> Result<Option<OplogIndex>, String> {
+        if let Some((last_idx, chunk)) = self.get_chunk(idx.into()).await? {
+            let (from, to) =
+                CompressedOplogChunk::cache_window(last_idx, chunk.count, lower.into(), idx.into());
+            let entries = chunk.decompress_range(last_idx, from, to)?;
+            let mut cache = self.cache.write().await;
+            for (idx, entry) in entries {
+                cache.insert(idx, entry);
             }
+            drop(cache);
+
+            self.prefetch_after(last_idx);
 
             Ok(Some(OplogIndex::from_u64(last_idx)))
         } else {
@@ -188,6 +296,14 @@ impl CompressedOplogArchive {
     }
 }
 
+impl Drop for CompressedOplogArchive {
+    fn drop(&mut self) {
+        if let Some(prefetched) = self.prefetched.lock().unwrap().take() {
+            prefetched.handle.abort();
+        }
+    }
+}
+
 /// Currently only the background-transfer fiber calls `append` and `drop_prefix` on oplog archives,
 /// so here it is not protected by a lock. If this changes, we need to add a lock here, similar
 /// to the `PrimaryOplog` implementation.
@@ -229,7 +345,7 @@ impl OplogArchive for CompressedOplogArchive {
                 break;
             }
 
-            let fetched_last_idx = self.read_and_cache_chunk(last_idx).await.unwrap_or_else(|err| {
+            let fetched_last_idx = self.read_and_cache_chunk(last_idx, idx).await.unwrap_or_else(|err| {
                 panic!("failed to read compressed oplog for worker {worker_id} in indexed storage: {err}")
             });
             if fetched_last_idx.is_some() {
@@ -355,10 +471,120 @@ impl CompressedOplogChunk {
         })
     }
 
-    pub fn decompress(&self) -> Result<Vec<OplogEntry>, String> {
-        let uncompressed_data = zstd::decode_all(&*self.compressed_data)
+    /// Maximum number of entries decoded at once by the archives reading a chunk
+    pub const MAX_CACHED_ENTRIES: u64 = 4096;
+
+    /// Selects the inclusive range of indices worth decoding from the chunk ending at `last_idx`
+    /// when entry `needed` is requested and nothing before `lower` is. At most
+    /// `MAX_CACHED_ENTRIES` entries are selected, always including `needed` and preferring the
+    /// entries following it, as those are the ones read next when replaying.
+    pub fn cache_window(last_idx: u64, count: u64, lower: u64, needed: u64) -> (u64, u64) {
+        let first_idx = last_idx + 1 - count;
+        let mut from = max(first_idx, min(lower, needed));
+        if needed >= from + Self::MAX_CACHED_ENTRIES {
+            from = needed + 1 - Self::MAX_CACHED_ENTRIES;
+        }
+        let to = min(last_idx, from + Self::MAX_CACHED_ENTRIES - 1);
+        (from, to)
+    }
+
+    /// Decompresses and decodes the entries of the chunk one by one, without materializing the
+    /// whole uncompressed chunk
+    pub fn entries(&self) -> Result<CompressedOplogChunkEntries<'_>, String> {
+        let decoder = zstd::stream::read::Decoder::new(&*self.compressed_data)
             .map_err(|err| format!("failed to decompress oplog chunk: {err}"))?;
-        deserialize(&uncompressed_data)
+        deserialize_vec_from_reader(decoder)
             .map_err(|err| format!("failed to deserialize oplog chunk: {err}"))
     }
+
+    /// Decodes the entries with indices in the inclusive range `from..=to` of the chunk ending at
+    /// `last_idx`, stopping as soon as `to` is reached
+    pub fn decompress_range(
+        &self,
+        last_idx: u64,
+        from: u64,
+        to: u64,
+    ) -> Result<Vec<(OplogIndex, OplogEntry)>, String> {
+        let first_idx = last_idx + 1 - self.count;
+        let mut result = Vec::new();
+        let entries = self.entries()?.take((to + 1 - first_idx) as usize);
+        for (idx, entry) in (first_idx..).zip(entries) {
+            let entry = entry?;
+            if idx >= from {
+                result.push((OplogIndex::from_u64(idx), entry));
+            }
+        }
+        Ok(result)
+    }
+
+    pub fn decompress(&self) -> Result<Vec<OplogEntry>, String> {
+        self.entries()?.collect()
+    }
+}
+
+/// Iterator decoding the entries of a `CompressedOplogChunk` from its compressed stream
+pub type CompressedOplogChunkEntries<'a> =
+    VecDeserializer<OplogEntry, zstd::stream::read::Decoder<'static, BufReader<&'a [u8]>>>;
+
+#[cfg(test)]
+mod tests {
+    use golem_common::model::oplog::{OplogEntry, OplogIndex, WorkerError};
+    use golem_common::model::Timestamp;
+
+    use crate::services::oplog::CompressedOplogChunk;
+
+    fn entries(count: usize) -> Vec<OplogEntry> {
+        let timestamp = Timestamp::now_utc();
+        (0..count)
+            .map(|i| OplogEntry::Error {
+                timestamp,
+                error: WorkerError::Unknown(i.to_string()),
+            })
+            .collect()
+    }
+
+    #[test]
+    fn streaming_decompression_matches_compressed_entries() {
+        let entries = entries(100);
+        let chunk = CompressedOplogChunk::compress(entries.clone()).unwrap();
+        assert_eq!(chunk.decompress().unwrap(), entries);
+    }
+
+    #[test]
+    fn decompress_range_stops_at_the_end_of_the_range() {
+        let entries = entries(100);
+        let chunk = CompressedOplogChunk::compress(entries.clone()).unwrap();
+        // The chunk holds the entries 101..=200
+        let range = chunk.decompress_range(200, 110, 119).unwrap();
+        let expected: Vec<(OplogIndex, OplogEntry)> = (110..=119)
+            .map(|idx| {
+                (
+                    OplogIndex::from_u64(idx),
+                    entries[(idx - 101) as usize].clone(),
+                )
+            })
+            .collect();
+        assert_eq!(range, expected);
+    }
+
+    #[test]
+    fn cache_window_includes_the_needed_entry() {
+        let max = CompressedOplogChunk::MAX_CACHED_ENTRIES;
+        assert_eq!(
+            CompressedOplogChunk::cache_window(200, 100, 0, 150),
+            (101, 200)
+        );
+        assert_eq!(
+            CompressedOplogChunk::cache_window(200, 100, 120, 150),
+            (120, 200)
+        );
+        assert_eq!(
+            CompressedOplogChunk::cache_window(3 * max, 3 * max, 1, 2 * max),
+            (max + 1, 2 * max)
+        );
+        assert_eq!(
+            CompressedOplogChunk::cache_window(3 * max, 3 * max, 2 * max, 2 * max),
+            (2 * max, 3 * max - 1)
+        );
+    }
 }
@@ -468,6 +468,25 @@ impl MultiLayerOplog {
         Some(Self::archive(this).await)
     }
 
+    /// Moves the entries of the primary oplog up to and including `last_idx` to the next layer,
+    /// for example when they are no longer replayed because a snapshot replaces them. Returns
+    /// `None` if the oplog has no layers to move them to.
+    pub fn try_archive_prefix(
+        this: &Arc<dyn Oplog + Send + Sync>,
+        last_idx: OplogIndex,
+    ) -> Option<()> {
+        let this = downcast_oplog::<MultiLayerOplog>(this)?;
+        if this.primary_length.get() > 0 {
+            this.transfer
+                .send(TransferFromPrimary {
+                    last_transferred_idx: last_idx,
+                    keep_alive: Some(this.clone()),
+                })
+                .expect("Failed to enqueue transfer of primary oplog entries");
+        }
+        Some(())
+    }
+
     async fn archive(this: Arc<Self>) -> bool {
         if this.primary_length.get() > 0 {
             // transferring the whole primary oplog to the next layer
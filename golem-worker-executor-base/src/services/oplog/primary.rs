@@ -13,7 +13,7 @@
 // limitations under the License.
 
 use crate::error::GolemError;
-use crate::metrics::oplog::record_oplog_call;
+use crate::metrics::oplog::{record_oplog_call, record_oplog_group_commit};
 use crate::services::oplog::{OpenOplogs, Oplog, OplogConstructor, OplogService};
 use crate::storage::blob::{BlobStorage, BlobStorageNamespace};
 use crate::storage::indexed::{IndexedStorage, IndexedStorageLabelledApi, IndexedStorageNamespace};
@@ -22,11 +22,14 @@ use async_trait::async_trait;
 use bytes::Bytes;
 use golem_common::model::oplog::{OplogEntry, OplogIndex, OplogPayload, PayloadId};
 use golem_common::model::{AccountId, ComponentId, OwnedWorkerId, ScanCursor, WorkerId};
+use golem_common::serialization::serialize;
 use std::collections::{BTreeMap, VecDeque};
 use std::fmt::{Debug, Formatter};
 use std::path::Path;
 use std::sync::Arc;
 use std::time::Duration;
+use tokio::sync::{mpsc, oneshot};
+use tokio::time::Instant;
 use tracing::error;
 
 /// The primary oplog service implementation, suitable for direct use (top level of a multi-layered setup).
@@ -41,6 +44,7 @@ pub struct PrimaryOplogService {
     max_operations_before_commit: u64,
     max_payload_size: usize,
     oplogs: OpenOplogs,
+    group_commit: Arc<OplogGroupCommit>,
 }
 
 impl PrimaryOplogService {
@@ -49,6 +53,8 @@ impl PrimaryOplogService {
         blob_storage: Arc<dyn BlobStorage + Send + Sync>,
         max_operations_before_commit: u64,
         max_payload_size: usize,
+        group_commit_window: Duration,
+        group_commit_max_entries: usize,
     ) -> Self {
         let replicas = indexed_storage
             .with("oplog", "new")
@@ -57,6 +63,11 @@ impl PrimaryOplogService {
             .unwrap_or_else(|err| {
                 panic!("failed to get the number of replicas of the indexed storage: {err}")
             });
+        let group_commit = Arc::new(OplogGroupCommit::new(
+            indexed_storage.clone(),
+            group_commit_window,
+            group_commit_max_entries,
+        ));
         Self {
             indexed_storage,
             blob_storage,
@@ -64,6 +75,7 @@ impl PrimaryOplogService {
             max_operations_before_commit,
             max_payload_size,
             oplogs: OpenOplogs::new("primary oplog"),
+            group_commit,
         }
     }
 
@@ -137,6 +149,7 @@ impl OplogService for PrimaryOplogService {
                 CreateOplogConstructor::new(
                     self.indexed_storage.clone(),
                     self.blob_storage.clone(),
+                    self.group_commit.clone(),
                     self.replicas,
                     self.max_operations_before_commit,
                     self.max_payload_size,
@@ -273,10 +286,132 @@ impl OplogService for PrimaryOplogService {
     }
 }
 
+/// Node level group commit of the primary oplogs.
+///
+/// The commits of all the open oplogs are sent to a single background task, which collects the
+/// ones arriving within the configured window (and all the ones queued up while the previous
+/// batch was written) and appends their entries to the indexed storage together, in a single
+/// round trip if the storage supports it. A commit only returns when its own entries have been
+/// written, so the durability guarantees of each oplog are unchanged.
+///
+/// At most `max_entries` commits can wait for the background task. When the storage falls
+/// behind, new commits wait for room in this queue instead of piling up in memory.
+#[derive(Debug)]
+struct OplogGroupCommit {
+    sender: mpsc::Sender<CommitRequest>,
+}
+
+#[derive(Debug)]
+struct CommitRequest {
+    key: String,
+    entries: Vec<(u64, Bytes)>,
+    done: oneshot::Sender<Vec<Result<(), String>>>,
+}
+
+impl OplogGroupCommit {
+    fn new(
+        indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
+        window: Duration,
+        max_entries: usize,
+    ) -> Self {
+        let (sender, receiver) = mpsc::channel(max_entries.max(1));
+        // The task stops when the last oplog referring to the group commit is dropped
+        tokio::spawn(Self::run(indexed_storage, window, max_entries, receiver));
+        Self { sender }
+    }
+
+    /// Commits the entries of one oplog together with the ones of the other oplogs, returning
+    /// the result of each entry. Once an entry failed, none of the following ones are written.
+    async fn commit(&self, key: String, entries: Vec<(u64, Bytes)>) -> Vec<Result<(), String>> {
+        let count = entries.len();
+        let (done, result) = oneshot::channel();
+        if self
+            .sender
+            .send(CommitRequest { key, entries, done })
+            .await
+            .is_err()
+        {
+            return vec![Err("oplog group commit is not running".to_string()); count];
+        }
+        result.await.unwrap_or_else(|_| {
+            vec![Err("oplog group commit dropped the commit".to_string()); count]
+        })
+    }
+
+    async fn run(
+        indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
+        window: Duration,
+        max_entries: usize,
+        mut receiver: mpsc::Receiver<CommitRequest>,
+    ) {
+        while let Some(first) = receiver.recv().await {
+            let mut entry_count = first.entries.len();
+            let mut batch = vec![first];
+
+            if !window.is_zero() {
+                let deadline = Instant::now() + window;
+                while entry_count < max_entries {
+                    match tokio::time::timeout_at(deadline, receiver.recv()).await {
+                        Ok(Some(request)) => {
+                            entry_count += request.entries.len();
+                            batch.push(request);
+                        }
+                        _ => break,
+                    }
+                }
+            }
+            while entry_count < max_entries {
+                match receiver.try_recv() {
+                    Ok(request) => {
+                        entry_count += request.entries.len();
+                        batch.push(request);
+                    }
+                    Err(_) => break,
+                }
+            }
+
+            Self::write(&indexed_storage, batch, entry_count).await;
+        }
+    }
+
+    async fn write(
+        indexed_storage: &Arc<dyn IndexedStorage + Send + Sync>,
+        batch: Vec<CommitRequest>,
+        entry_count: usize,
+    ) {
+        record_oplog_group_commit(batch.len(), entry_count);
+
+        let mut entries = Vec::with_capacity(entry_count);
+        for request in &batch {
+            for (id, value) in &request.entries {
+                entries.push((request.key.clone(), *id, value.clone()));
+            }
+        }
+
+        let mut results = indexed_storage
+            .with_entity("oplog", "append", "entry")
+            .append_many_raw(IndexedStorageNamespace::OpLog, &entries)
+            .await
+            .into_iter();
+
+        // Each commit gets the results of its own entries, and retrying the failed ones is
+        // left to the committing oplog, so one failing oplog does not delay the others
+        for request in batch {
+            let results = results
+                .by_ref()
+                .take(request.entries.len())
+                .collect::<Vec<_>>();
+            // The committing oplog may have been dropped in the meantime
+            let _ = request.done.send(results);
+        }
+    }
+}
+
 #[derive(Clone)]
 struct CreateOplogConstructor {
     indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
     blob_storage: Arc<dyn BlobStorage + Send + Sync>,
+    group_commit: Arc<OplogGroupCommit>,
     replicas: u8,
     max_operations_before_commit: u64,
     max_payload_size: usize,
@@ -289,6 +424,7 @@ impl CreateOplogConstructor {
     fn new(
         indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
         blob_storage: Arc<dyn BlobStorage + Send + Sync>,
+        group_commit: Arc<OplogGroupCommit>,
         replicas: u8,
         max_operations_before_commit: u64,
         max_payload_size: usize,
@@ -299,6 +435,7 @@ impl CreateOplogConstructor {
         Self {
             indexed_storage,
             blob_storage,
+            group_commit,
             replicas,
             max_operations_before_commit,
             max_payload_size,
@@ -318,6 +455,7 @@ impl OplogConstructor for CreateOplogConstructor {
         Arc::new(PrimaryOplog::new(
             self.indexed_storage,
             self.blob_storage,
+            self.group_commit,
             self.replicas,
             self.max_operations_before_commit,
             self.max_payload_size,
@@ -347,6 +485,7 @@ impl PrimaryOplog {
     fn new(
         indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
         blob_storage: Arc<dyn BlobStorage + Send + Sync>,
+        group_commit: Arc<OplogGroupCommit>,
         replicas: u8,
         max_operations_before_commit: u64,
         max_payload_size: usize,
@@ -359,6 +498,7 @@ impl PrimaryOplog {
             state: Arc::new(Mutex::new(PrimaryOplogState {
                 indexed_storage,
                 blob_storage,
+                group_commit,
                 replicas,
                 max_operations_before_commit,
                 max_payload_size,
@@ -377,6 +517,7 @@ impl PrimaryOplog {
 struct PrimaryOplogState {
     indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
     blob_storage: Arc<dyn BlobStorage + Send + Sync>,
+    group_commit: Arc<OplogGroupCommit>,
     replicas: u8,
     max_operations_before_commit: u64,
     max_payload_size: usize,
@@ -391,25 +532,48 @@ impl PrimaryOplogState {
     async fn append(&mut self, arrays: &[OplogEntry]) {
         record_oplog_call("append");
 
+        if arrays.is_empty() {
+            return;
+        }
+
+        let mut oplog_idx = self.last_committed_idx;
+        let mut entries = Vec::with_capacity(arrays.len());
         for entry in arrays {
-            let oplog_idx = self.last_committed_idx.next();
-            self.indexed_storage
+            oplog_idx = oplog_idx.next();
+            let value = serialize(entry).unwrap_or_else(|err| {
+                panic!("failed to serialize oplog entry for {}: {err}", self.key)
+            });
+            entries.push((oplog_idx.into(), value));
+        }
+
+        let results = self
+            .group_commit
+            .commit(self.key.clone(), entries.clone())
+            .await;
+
+        // The entries from the first failed one are retried once, without the group commit
+        let first_failed = results
+            .iter()
+            .position(|result| result.is_err())
+            .or((results.len() < entries.len()).then_some(results.len()));
+        if let Some(first_failed) = first_failed {
+            let failed = entries[first_failed..]
+                .iter()
+                .map(|(id, value)| (self.key.clone(), *id, value.clone()))
+                .collect::<Vec<_>>();
+            let retried = self
+                .indexed_storage
                 .with_entity("oplog", "append", "entry")
-                .append(
-                    IndexedStorageNamespace::OpLog,
-                    &self.key,
-                    oplog_idx.into(),
-                    entry,
+                .append_many_raw(IndexedStorageNamespace::OpLog, &failed)
+                .await;
+            if let Some(Err(err)) = retried.into_iter().find(|result| result.is_err()) {
+                panic!(
+                    "failed to append oplog entry for {} in indexed storage: {err}",
+                    self.key
                 )
-                .await
-                .unwrap_or_else(|err| {
-                    panic!(
-                        "failed to append oplog entry for {} in indexed storage: {err}",
-                        self.key
-                    )
-                });
-            self.last_committed_idx = oplog_idx;
+            }
         }
+        self.last_committed_idx = oplog_idx;
     }
 
     async fn add(&mut self, entry: OplogEntry) {
@@ -18,7 +18,7 @@ use crate::services::oplog::multilayer::OplogArchiveService;
 use crate::storage::blob::memory::InMemoryBlobStorage;
 use crate::storage::indexed::memory::InMemoryIndexedStorage;
 use crate::storage::indexed::redis::RedisIndexedStorage;
-use crate::storage::indexed::IndexedStorage;
+use crate::storage::indexed::{IndexedStorage, IndexedStorageNamespace, ScanCursor};
 use assert2::check;
 use golem_common::config::RedisConfig;
 use golem_common::model::oplog::WorkerError;
@@ -171,6 +171,24 @@ fn rounded(entry: OplogEntry) -> OplogEntry {
             timestamp: rounded_ts(timestamp),
             invocation,
         },
+        OplogEntry::GrowMemory { timestamp, delta } => OplogEntry::GrowMemory {
+            timestamp: rounded_ts(timestamp),
+            delta,
+        },
+        OplogEntry::Snapshot { timestamp, payload } => OplogEntry::Snapshot {
+            timestamp: rounded_ts(timestamp),
+            payload,
+        },
+        OplogEntry::KeyValueWriteBehind {
+            timestamp,
+            max_buffered_writes,
+        } => OplogEntry::KeyValueWriteBehind {
+            timestamp: rounded_ts(timestamp),
+            max_buffered_writes,
+        },
+        OplogEntry::ClockSnapshotMode { timestamp } => OplogEntry::ClockSnapshotMode {
+            timestamp: rounded_ts(timestamp),
+        },
     }
 }
 
@@ -178,7 +196,8 @@ fn rounded(entry: OplogEntry) -> OplogEntry {
 async fn open_add_and_read_back() {
     let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
-    let oplog_service = PrimaryOplogService::new(indexed_storage, blob_storage, 1, 100).await;
+    let oplog_service =
+        PrimaryOplogService::new(indexed_storage, blob_storage, 1, 100, Duration::ZERO, 1024).await;
     let account_id = AccountId {
         value: "user1".to_string(),
     };
@@ -219,11 +238,67 @@ async fn open_add_and_read_back() {
     );
 }
 
+#[tokio::test]
+async fn group_commit_of_concurrent_workers() {
+    let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
+    let blob_storage = Arc::new(InMemoryBlobStorage::new());
+    let oplog_service = Arc::new(
+        PrimaryOplogService::new(
+            indexed_storage,
+            blob_storage,
+            1,
+            100,
+            Duration::from_millis(5),
+            16,
+        )
+        .await,
+    );
+    let account_id = AccountId {
+        value: "user1".to_string(),
+    };
+    let component_id = ComponentId(Uuid::new_v4());
+
+    let mut fibers = Vec::new();
+    for n in 0..8 {
+        let oplog_service = oplog_service.clone();
+        let owned_worker_id = OwnedWorkerId::new(
+            &account_id,
+            &WorkerId {
+                component_id: component_id.clone(),
+                worker_name: format!("worker-{n}"),
+            },
+        );
+        fibers.push(tokio::spawn(async move {
+            let oplog = oplog_service.open(&owned_worker_id).await;
+            let mut expected = Vec::new();
+            for i in 0..5 {
+                let entry = rounded(OplogEntry::jump(OplogRegion {
+                    start: OplogIndex::from_u64(n),
+                    end: OplogIndex::from_u64(i),
+                }));
+                oplog.add_and_commit(entry.clone()).await;
+                expected.push(entry);
+            }
+            drop(oplog);
+
+            let entries = oplog_service
+                .read(&owned_worker_id, OplogIndex::INITIAL, 100)
+                .await;
+            assert_eq!(entries.into_values().collect::<Vec<_>>(), expected);
+        }));
+    }
+
+    for fiber in fibers {
+        fiber.await.unwrap();
+    }
+}
+
 #[tokio::test]
 async fn entries_with_small_payload() {
     let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
-    let oplog_service = PrimaryOplogService::new(indexed_storage, blob_storage, 1, 100).await;
+    let oplog_service =
+        PrimaryOplogService::new(indexed_storage, blob_storage, 1, 100, Duration::ZERO, 1024).await;
     let account_id = AccountId {
         value: "user1".to_string(),
     };
@@ -330,7 +405,8 @@ async fn entries_with_small_payload() {
 async fn entries_with_large_payload() {
     let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
-    let oplog_service = PrimaryOplogService::new(indexed_storage, blob_storage, 1, 100).await;
+    let oplog_service =
+        PrimaryOplogService::new(indexed_storage, blob_storage, 1, 100, Duration::ZERO, 1024).await;
     let account_id = AccountId {
         value: "user1".to_string(),
     };
@@ -488,7 +564,15 @@ async fn multilayer_transfers_entries_after_limit_reached(
 
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
     let primary_oplog_service = Arc::new(
-        PrimaryOplogService::new(indexed_storage.clone(), blob_storage.clone(), 1, 100).await,
+        PrimaryOplogService::new(
+            indexed_storage.clone(),
+            blob_storage.clone(),
+            1,
+            100,
+            Duration::ZERO,
+            1024,
+        )
+        .await,
     );
     let secondary_layer: Arc<dyn OplogArchiveService + Send + Sync> = if use_blob {
         Arc::new(BlobOplogArchiveService::new(blob_storage.clone(), 1))
@@ -593,7 +677,15 @@ async fn read_from_archive_impl(use_blob: bool) {
     let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
     let primary_oplog_service = Arc::new(
-        PrimaryOplogService::new(indexed_storage.clone(), blob_storage.clone(), 1, 100).await,
+        PrimaryOplogService::new(
+            indexed_storage.clone(),
+            blob_storage.clone(),
+            1,
+            100,
+            Duration::ZERO,
+            1024,
+        )
+        .await,
     );
     let secondary_layer: Arc<dyn OplogArchiveService + Send + Sync> = if use_blob {
         Arc::new(BlobOplogArchiveService::new(blob_storage.clone(), 1))
@@ -681,7 +773,15 @@ async fn empty_layer_gets_deleted_impl(use_blob: bool) {
     let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
     let primary_oplog_service = Arc::new(
-        PrimaryOplogService::new(indexed_storage.clone(), blob_storage.clone(), 1, 100).await,
+        PrimaryOplogService::new(
+            indexed_storage.clone(),
+            blob_storage.clone(),
+            1,
+            100,
+            Duration::ZERO,
+            1024,
+        )
+        .await,
     );
     let secondary_layer: Arc<dyn OplogArchiveService + Send + Sync> = if use_blob {
         Arc::new(BlobOplogArchiveService::new(blob_storage.clone(), 1))
@@ -780,7 +880,15 @@ async fn scheduled_archive_impl(use_blob: bool) {
     let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
     let blob_storage = Arc::new(InMemoryBlobStorage::new());
     let primary_oplog_service = Arc::new(
-        PrimaryOplogService::new(indexed_storage.clone(), blob_storage.clone(), 1, 100).await,
+        PrimaryOplogService::new(
+            indexed_storage.clone(),
+            blob_storage.clone(),
+            1,
+            100,
+            Duration::ZERO,
+            1024,
+        )
+        .await,
     );
     let secondary_layer: Arc<dyn OplogArchiveService + Send + Sync> = if use_blob {
         Arc::new(BlobOplogArchiveService::new(blob_storage.clone(), 1))
@@ -881,3 +989,271 @@ async fn scheduled_archive_impl(use_blob: bool) {
     assert_eq!(tertiary_length, 1);
     assert_eq!(archive_result2, Some(false));
 }
+
+/// In-memory indexed storage failing the appends to the keys containing `failing_key`, until
+/// `remaining_failures` of them have failed
+#[derive(Debug)]
+struct FailingIndexedStorage {
+    inner: InMemoryIndexedStorage,
+    failing_key: String,
+    remaining_failures: std::sync::atomic::AtomicUsize,
+}
+
+impl FailingIndexedStorage {
+    fn new(failing_key: &str, failures: usize) -> Self {
+        Self {
+            inner: InMemoryIndexedStorage::new(),
+            failing_key: failing_key.to_string(),
+            remaining_failures: std::sync::atomic::AtomicUsize::new(failures),
+        }
+    }
+}
+
+#[async_trait]
+impl IndexedStorage for FailingIndexedStorage {
+    async fn number_of_replicas(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+    ) -> Result<u8, String> {
+        self.inner.number_of_replicas(svc_name, api_name).await
+    }
+
+    async fn wait_for_replicas(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        replicas: u8,
+        timeout: Duration,
+    ) -> Result<u8, String> {
+        self.inner
+            .wait_for_replicas(svc_name, api_name, replicas, timeout)
+            .await
+    }
+
+    async fn exists(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+    ) -> Result<bool, String> {
+        self.inner.exists(svc_name, api_name, namespace, key).await
+    }
+
+    async fn scan(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        pattern: &str,
+        cursor: ScanCursor,
+        count: u64,
+    ) -> Result<(ScanCursor, Vec<String>), String> {
+        self.inner
+            .scan(svc_name, api_name, namespace, pattern, cursor, count)
+            .await
+    }
+
+    async fn append(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+        id: u64,
+        value: &[u8],
+    ) -> Result<(), String> {
+        if key.contains(&self.failing_key)
+            && self
+                .remaining_failures
+                .fetch_update(Ordering::AcqRel, Ordering::Acquire, |n| n.checked_sub(1))
+                .is_ok()
+        {
+            Err(format!("simulated failure appending to {key}"))
+        } else {
+            self.inner
+                .append(svc_name, api_name, entity_name, namespace, key, id, value)
+                .await
+        }
+    }
+
+    async fn length(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+    ) -> Result<u64, String> {
+        self.inner.length(svc_name, api_name, namespace, key).await
+    }
+
+    async fn delete(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+    ) -> Result<(), String> {
+        self.inner.delete(svc_name, api_name, namespace, key).await
+    }
+
+    async fn read(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+        start_id: u64,
+        end_id: u64,
+    ) -> Result<Vec<(u64, Bytes)>, String> {
+        self.inner
+            .read(
+                svc_name,
+                api_name,
+                entity_name,
+                namespace,
+                key,
+                start_id,
+                end_id,
+            )
+            .await
+    }
+
+    async fn first(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+    ) -> Result<Option<(u64, Bytes)>, String> {
+        self.inner
+            .first(svc_name, api_name, entity_name, namespace, key)
+            .await
+    }
+
+    async fn last(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+    ) -> Result<Option<(u64, Bytes)>, String> {
+        self.inner
+            .last(svc_name, api_name, entity_name, namespace, key)
+            .await
+    }
+
+    async fn closest(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+        id: u64,
+    ) -> Result<Option<(u64, Bytes)>, String> {
+        self.inner
+            .closest(svc_name, api_name, entity_name, namespace, key, id)
+            .await
+    }
+
+    async fn drop_prefix(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        key: &str,
+        last_dropped_id: u64,
+    ) -> Result<(), String> {
+        self.inner
+            .drop_prefix(svc_name, api_name, namespace, key, last_dropped_id)
+            .await
+    }
+}
+
+/// Commits five entries to the oplogs of four workers concurrently through the given storage,
+/// returning whether the commits of each worker succeeded and read back the committed entries
+async fn group_commit_of_concurrent_workers_to(
+    indexed_storage: Arc<dyn IndexedStorage + Send + Sync>,
+    max_entries: usize,
+) -> Vec<bool> {
+    let blob_storage = Arc::new(InMemoryBlobStorage::new());
+    let oplog_service = Arc::new(
+        PrimaryOplogService::new(
+            indexed_storage,
+            blob_storage,
+            1,
+            100,
+            Duration::from_millis(5),
+            max_entries,
+        )
+        .await,
+    );
+    let account_id = AccountId {
+        value: "user1".to_string(),
+    };
+    let component_id = ComponentId(Uuid::new_v4());
+
+    let mut fibers = Vec::new();
+    for n in 0..4 {
+        let oplog_service = oplog_service.clone();
+        let owned_worker_id = OwnedWorkerId::new(
+            &account_id,
+            &WorkerId {
+                component_id: component_id.clone(),
+                worker_name: format!("worker-{n}"),
+            },
+        );
+        fibers.push(tokio::spawn(async move {
+            let oplog = oplog_service.open(&owned_worker_id).await;
+            let mut expected = Vec::new();
+            for i in 0..5 {
+                let entry = rounded(OplogEntry::jump(OplogRegion {
+                    start: OplogIndex::from_u64(n),
+                    end: OplogIndex::from_u64(i),
+                }));
+                oplog.add_and_commit(entry.clone()).await;
+                expected.push(entry);
+            }
+            drop(oplog);
+
+            let entries = oplog_service
+                .read(&owned_worker_id, OplogIndex::INITIAL, 100)
+                .await;
+            assert_eq!(entries.into_values().collect::<Vec<_>>(), expected);
+        }));
+    }
+
+    let mut succeeded = Vec::new();
+    for fiber in fibers {
+        succeeded.push(fiber.await.is_ok());
+    }
+    succeeded
+}
+
+#[tokio::test]
+async fn group_commit_retries_failed_entries() {
+    let indexed_storage = Arc::new(FailingIndexedStorage::new("worker-1", 1));
+    let succeeded = group_commit_of_concurrent_workers_to(indexed_storage, 16).await;
+    check!(succeeded == vec![true, true, true, true]);
+}
+
+#[tokio::test]
+async fn group_commit_failure_only_fails_its_own_oplog() {
+    let indexed_storage = Arc::new(FailingIndexedStorage::new("worker-1", usize::MAX));
+    let succeeded = group_commit_of_concurrent_workers_to(indexed_storage, 16).await;
+    check!(succeeded == vec![true, false, true, true]);
+}
+
+#[tokio::test]
+async fn group_commit_waits_for_room_in_the_queue() {
+    // Only one commit can wait for the next batch, the others wait for it to be written
+    let indexed_storage = Arc::new(InMemoryIndexedStorage::new());
+    let succeeded = group_commit_of_concurrent_workers_to(indexed_storage, 1).await;
+    check!(succeeded == vec![true, true, true, true]);
+}
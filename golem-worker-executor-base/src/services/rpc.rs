@@ -23,19 +23,23 @@ use serde::{Deserialize, Serialize};
 use tokio::runtime::Handle;
 use tracing::debug;
 
-use golem_common::model::{IdempotencyKey, OwnedWorkerId, WorkerId};
+use golem_common::model::{IdempotencyKey, OwnedWorkerId, ShardId, WorkerId};
 
+use crate::durable_host::filesystem::initial::InitialFileSystemService;
+use crate::durable_host::http::connection_pool::HttpConnectionPool;
 use crate::error::GolemError;
+use crate::metrics::rpc::{record_rpc_affinity_edge, record_rpc_call};
+use crate::profiling::GuestProfiler;
 use crate::services::events::Events;
 use crate::services::worker_proxy::{WorkerProxy, WorkerProxyError};
 use crate::services::{
     active_workers, blob_store, component, golem_config, key_value, oplog, promise, scheduler,
-    shard, shard_manager, worker, worker_activator, worker_enumeration, HasActiveWorkers,
-    HasBlobStoreService, HasComponentService, HasConfig, HasEvents, HasExtraDeps,
-    HasKeyValueService, HasOplogService, HasPromiseService, HasRpc,
-    HasRunningWorkerEnumerationService, HasSchedulerService, HasShardManagerService,
-    HasShardService, HasWasmtimeEngine, HasWorkerActivator, HasWorkerEnumerationService,
-    HasWorkerProxy, HasWorkerService,
+    shard, shard_manager, worker, worker_activator, worker_enumeration, worker_template,
+    HasActiveWorkers, HasBlobStoreService, HasComponentService, HasConfig, HasEvents, HasExtraDeps,
+    HasGuestProfiler, HasHttpConnectionPool, HasInitialFileSystemService, HasKeyValueService,
+    HasOplogService, HasPromiseService, HasRpc, HasRunningWorkerEnumerationService,
+    HasSchedulerService, HasShardManagerService, HasShardService, HasWasmtimeEngine,
+    HasWorkerActivator, HasWorkerEnumerationService, HasWorkerProxy, HasWorkerService,
 };
 use crate::worker::Worker;
 use crate::workerctx::WorkerCtx;
@@ -233,6 +237,7 @@ pub struct DirectWorkerInvocationRpc<Ctx: WorkerCtx> {
     active_workers: Arc<active_workers::ActiveWorkers<Ctx>>,
     engine: Arc<wasmtime::Engine>,
     linker: Arc<wasmtime::component::Linker<Ctx>>,
+    worker_templates: Arc<worker_template::WorkerTemplates<Ctx>>,
     runtime: Handle,
     component_service: Arc<dyn component::ComponentService + Send + Sync>,
     shard_manager_service: Arc<dyn shard_manager::ShardManagerService + Send + Sync>,
@@ -249,6 +254,9 @@ pub struct DirectWorkerInvocationRpc<Ctx: WorkerCtx> {
     scheduler_service: Arc<dyn scheduler::SchedulerService + Send + Sync>,
     worker_activator: Arc<dyn worker_activator::WorkerActivator + Send + Sync>,
     events: Arc<Events>,
+    http_connection_pool: Arc<HttpConnectionPool>,
+    initial_file_system_service: Arc<InitialFileSystemService>,
+    guest_profiler: Arc<GuestProfiler>,
     extra_deps: Ctx::ExtraDeps,
 }
 
@@ -259,6 +267,7 @@ impl<Ctx: WorkerCtx> Clone for DirectWorkerInvocationRpc<Ctx> {
             active_workers: self.active_workers.clone(),
             engine: self.engine.clone(),
             linker: self.linker.clone(),
+            worker_templates: self.worker_templates.clone(),
             runtime: self.runtime.clone(),
             component_service: self.component_service.clone(),
             shard_manager_service: self.shard_manager_service.clone(),
@@ -274,6 +283,9 @@ impl<Ctx: WorkerCtx> Clone for DirectWorkerInvocationRpc<Ctx> {
             scheduler_service: self.scheduler_service.clone(),
             worker_activator: self.worker_activator.clone(),
             events: self.events.clone(),
+            http_connection_pool: self.http_connection_pool.clone(),
+            initial_file_system_service: self.initial_file_system_service.clone(),
+            guest_profiler: self.guest_profiler.clone(),
             extra_deps: self.extra_deps.clone(),
         }
     }
@@ -285,6 +297,24 @@ impl<Ctx: WorkerCtx> HasEvents for DirectWorkerInvocationRpc<Ctx> {
     }
 }
 
+impl<Ctx: WorkerCtx> HasHttpConnectionPool for DirectWorkerInvocationRpc<Ctx> {
+    fn http_connection_pool(&self) -> Arc<HttpConnectionPool> {
+        self.http_connection_pool.clone()
+    }
+}
+
+impl<Ctx: WorkerCtx> HasInitialFileSystemService for DirectWorkerInvocationRpc<Ctx> {
+    fn initial_file_system_service(&self) -> Arc<InitialFileSystemService> {
+        self.initial_file_system_service.clone()
+    }
+}
+
+impl<Ctx: WorkerCtx> HasGuestProfiler for DirectWorkerInvocationRpc<Ctx> {
+    fn guest_profiler(&self) -> Arc<GuestProfiler> {
+        self.guest_profiler.clone()
+    }
+}
+
 impl<Ctx: WorkerCtx> HasActiveWorkers<Ctx> for DirectWorkerInvocationRpc<Ctx> {
     fn active_workers(&self) -> Arc<active_workers::ActiveWorkers<Ctx>> {
         self.active_workers.clone()
@@ -340,6 +370,10 @@ impl<Ctx: WorkerCtx> HasWasmtimeEngine<Ctx> for DirectWorkerInvocationRpc<Ctx> {
         self.linker.clone()
     }
 
+    fn worker_templates(&self) -> Arc<worker_template::WorkerTemplates<Ctx>> {
+        self.worker_templates.clone()
+    }
+
     fn runtime(&self) -> Handle {
         self.runtime.clone()
     }
@@ -411,6 +445,7 @@ impl<Ctx: WorkerCtx> DirectWorkerInvocationRpc<Ctx> {
         active_workers: Arc<active_workers::ActiveWorkers<Ctx>>,
         engine: Arc<wasmtime::Engine>,
         linker: Arc<wasmtime::component::Linker<Ctx>>,
+        worker_templates: Arc<worker_template::WorkerTemplates<Ctx>>,
         runtime: Handle,
         component_service: Arc<dyn component::ComponentService + Send + Sync>,
         worker_service: Arc<dyn worker::WorkerService + Send + Sync>,
@@ -430,6 +465,9 @@ impl<Ctx: WorkerCtx> DirectWorkerInvocationRpc<Ctx> {
         scheduler_service: Arc<dyn scheduler::SchedulerService + Send + Sync>,
         worker_activator: Arc<dyn worker_activator::WorkerActivator + Send + Sync>,
         events: Arc<Events>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
+        guest_profiler: Arc<GuestProfiler>,
         extra_deps: Ctx::ExtraDeps,
     ) -> Self {
         Self {
@@ -437,6 +475,7 @@ impl<Ctx: WorkerCtx> DirectWorkerInvocationRpc<Ctx> {
             active_workers,
             engine,
             linker,
+            worker_templates,
             runtime,
             component_service,
             shard_manager_service,
@@ -452,9 +491,27 @@ impl<Ctx: WorkerCtx> DirectWorkerInvocationRpc<Ctx> {
             scheduler_service,
             worker_activator,
             events,
+            http_connection_pool,
+            initial_file_system_service,
+            guest_profiler,
             extra_deps,
         }
     }
+
+    /// Records a worker to worker call in the metrics, and if enabled, for the RPC affinity
+    /// periodically reported to the shard manager
+    fn record_rpc_call(&self, caller: &WorkerId, callee: &WorkerId, local: bool) {
+        record_rpc_call(local);
+        if self.golem_config.rpc_affinity.enabled {
+            let number_of_shards = self.shard_service.number_of_shards();
+            if number_of_shards > 0 {
+                record_rpc_affinity_edge(
+                    ShardId::from_worker_id(caller, number_of_shards),
+                    ShardId::from_worker_id(callee, number_of_shards),
+                );
+            }
+        }
+    }
 }
 
 #[async_trait]
@@ -476,11 +533,13 @@ impl<Ctx: WorkerCtx> Rpc for DirectWorkerInvocationRpc<Ctx> {
     ) -> Result<WitValue, RpcError> {
         let idempotency_key = idempotency_key.unwrap_or(IdempotencyKey::fresh());
 
-        if self
+        let local = self
             .shard_service()
             .check_worker(&owned_worker_id.worker_id)
-            .is_ok()
-        {
+            .is_ok();
+        self.record_rpc_call(self_worker_id, &owned_worker_id.worker_id, local);
+
+        if local {
             debug!("Invoking local worker function {function_name} with parameters {function_params:?}");
 
             let input_values = function_params
@@ -534,11 +593,13 @@ impl<Ctx: WorkerCtx> Rpc for DirectWorkerInvocationRpc<Ctx> {
     ) -> Result<(), RpcError> {
         let idempotency_key = idempotency_key.unwrap_or(IdempotencyKey::fresh());
 
-        if self
+        let local = self
             .shard_service()
-            .check_worker(&owned_worker_id.worker_id())
-            .is_ok()
-        {
+            .check_worker(&owned_worker_id.worker_id)
+            .is_ok();
+        self.record_rpc_call(self_worker_id, &owned_worker_id.worker_id, local);
+
+        if local {
             debug!("Invoking local worker function {function_name} with parameters {function_params:?} without awaiting for the result");
 
             let input_values = function_params
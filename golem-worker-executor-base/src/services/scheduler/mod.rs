@@ -19,8 +19,9 @@ use std::time::Duration;
 
 use async_trait::async_trait;
 use chrono::{DateTime, TimeZone, Utc};
+use tokio::sync::Notify;
 use tokio::task::JoinHandle;
-use tracing::{error, span, warn, Instrument, Level};
+use tracing::{debug, error, span, Instrument, Level};
 
 use golem_common::model::{ScheduleId, ScheduledAction};
 
@@ -32,14 +33,28 @@ use crate::services::worker_activator::WorkerActivator;
 use crate::storage::keyvalue::{
     KeyValueStorage, KeyValueStorageLabelledApi, KeyValueStorageNamespace,
 };
+use timer_wheel::TimerWheel;
+
+mod timer_wheel;
 
 #[async_trait]
 pub trait SchedulerService {
     async fn schedule(&self, time: DateTime<Utc>, action: ScheduledAction) -> ScheduleId;
 
     async fn cancel(&self, id: ScheduleId);
+
+    /// Loads the pending actions of the workers of the currently assigned shards. Has to be
+    /// called when the shard assignment changes.
+    async fn load_assigned(&self) -> Result<(), String>;
 }
 
+/// Scheduler persisting the scheduled actions in hourly sorted sets of the key-value storage.
+///
+/// The actions of the workers belonging to the assigned shards are also kept in an in-memory
+/// timer wheel, which the background task sleeps on, so actions are executed on time without
+/// polling the storage. The storage is only read when the shard assignment changes, and once
+/// per hour to pick up actions of the new hour which were scheduled by other executors before
+/// their shards got assigned to this one.
 #[derive(Clone)]
 pub struct SchedulerServiceDefault {
     key_value_storage: Arc<dyn KeyValueStorage + Send + Sync>,
@@ -48,16 +63,21 @@ pub struct SchedulerServiceDefault {
     promise_service: Arc<dyn PromiseService + Send + Sync>,
     worker_activator: Arc<dyn WorkerActivator + Send + Sync>,
     oplog_service: Arc<dyn OplogService + Send + Sync>,
+    timers: Arc<Mutex<TimerWheel<ScheduledAction>>>,
+    timers_changed: Arc<Notify>,
 }
 
 impl SchedulerServiceDefault {
+    /// Creates the scheduler and starts its background task. `refresh_interval` is the maximum
+    /// time the task sleeps before checking the timers again, bounding the effect of wall clock
+    /// adjustments; it does not cause any storage access.
     pub fn new(
         key_value_storage: Arc<dyn KeyValueStorage + Send + Sync>,
         shard_service: Arc<dyn ShardService + Send + Sync>,
         promise_service: Arc<dyn PromiseService + Send + Sync>,
         worker_activator: Arc<dyn WorkerActivator + Send + Sync>,
         oplog_service: Arc<dyn OplogService + Send + Sync>,
-        process_interval: Duration,
+        refresh_interval: Duration,
     ) -> Arc<Self> {
         let svc = Self {
             key_value_storage,
@@ -66,15 +86,44 @@ impl SchedulerServiceDefault {
             promise_service,
             oplog_service,
             worker_activator,
+            timers: Arc::new(Mutex::new(TimerWheel::new(Self::millis(Utc::now())))),
+            timers_changed: Arc::new(Notify::new()),
         };
         let svc = Arc::new(svc);
         let svc_clone = svc.clone();
         let background_handle = tokio::spawn(async move {
+            let (mut loaded_hour, _) = Self::split_time(Utc::now());
             loop {
-                tokio::time::sleep(process_interval).await;
-                let r = svc_clone.process(Utc::now()).await;
-                if let Err(err) = r {
-                    error!("Error in scheduler background task: {}", err);
+                let now = Utc::now();
+                let (hours_since_epoch, _) = Self::split_time(now);
+                if hours_since_epoch > loaded_hour {
+                    match svc_clone.load_hour(hours_since_epoch).await {
+                        Ok(()) => loaded_hour = hours_since_epoch,
+                        Err(err) => error!("Error loading scheduled actions: {}", err),
+                    }
+                }
+
+                let delay = match svc_clone.process(now).await {
+                    Ok(()) => {
+                        let next_hour = (loaded_hour + 1) * Self::HOUR_IN_MILLIS;
+                        let next_wake_up = svc_clone
+                            .timers
+                            .lock()
+                            .unwrap()
+                            .next_wake_up()
+                            .map_or(next_hour, |wake_up| (wake_up as i64).min(next_hour));
+                        let until_wake_up = (next_wake_up - Utc::now().timestamp_millis()).max(0);
+                        Duration::from_millis(until_wake_up as u64).min(refresh_interval)
+                    }
+                    Err(err) => {
+                        error!("Error in scheduler background task: {}", err);
+                        refresh_interval
+                    }
+                };
+
+                tokio::select! {
+                    _ = tokio::time::sleep(delay) => {}
+                    _ = svc_clone.timers_changed.notified() => {}
                 }
             }
         });
@@ -83,95 +132,31 @@ impl SchedulerServiceDefault {
         svc
     }
 
+    /// Executes the actions due at `now`. If executing an action fails, it and the rest of the
+    /// due actions are put back to be retried.
     async fn process(&self, now: DateTime<Utc>) -> Result<(), String> {
-        let (hours_since_epoch, remainder) = Self::split_time(now);
-        let previous_hours_since_epoch = hours_since_epoch - 1;
-
-        let previous_hour_key = Self::schedule_key_from_timestamp(previous_hours_since_epoch);
-        let current_hour_key = Self::schedule_key_from_timestamp(hours_since_epoch);
-
-        let all_from_prev_hour: Vec<(f64, ScheduledAction)> = self
-            .key_value_storage
-            .with_entity("scheduler", "process", "scheduled_action")
-            .get_sorted_set(KeyValueStorageNamespace::Schedule, &previous_hour_key)
-            .await?;
-
-        let mut all: Vec<(&str, ScheduledAction)> = all_from_prev_hour
-            .into_iter()
-            .map(|(_score, action)| (previous_hour_key.as_str(), action))
-            .collect();
-
-        let all_from_this_hour: Vec<(f64, ScheduledAction)> = self
-            .key_value_storage
-            .with_entity("scheduler", "process", "scheduled_action")
-            .query_sorted_set(
-                KeyValueStorageNamespace::Schedule,
-                &current_hour_key,
-                0.0,
-                remainder,
-            )
-            .await?;
-
-        all.extend(
-            all_from_this_hour
-                .into_iter()
-                .map(|(_score, action)| (current_hour_key.as_str(), action)),
-        );
-
-        let matching: Vec<(&str, ScheduledAction)> = all
-            .into_iter()
-            .filter(|(_, action)| {
-                self.shard_service
-                    .check_worker(&action.owned_worker_id().worker_id)
-                    .is_ok()
-            })
-            .collect::<Vec<_>>();
+        let due = self.timers.lock().unwrap().advance(Self::millis(now));
 
         let mut owned_worker_ids = HashSet::new();
-        for (key, action) in matching {
-            owned_worker_ids.insert(action.owned_worker_id().clone());
-            self.key_value_storage
-                .with_entity("scheduler", "process", "scheduled_action")
-                .remove_from_sorted_set(KeyValueStorageNamespace::Schedule, key, &action)
-                .await?;
-
-            match action {
-                ScheduledAction::CompletePromise { promise_id, .. } => {
-                    self.promise_service
-                        .complete(promise_id, vec![])
-                        .await
-                        .map_err(|golem_err| format!("{golem_err}"))?;
-
-                    record_scheduled_promise_completed();
-                }
-                ScheduledAction::ArchiveOplog {
-                    owned_worker_id,
-                    last_oplog_index,
-                    next_after,
-                } => {
-                    if self.oplog_service.exists(&owned_worker_id).await {
-                        let current_last_index =
-                            self.oplog_service.get_last_index(&owned_worker_id).await;
-                        if current_last_index == last_oplog_index {
-                            let oplog = self.oplog_service.open(&owned_worker_id).await;
-                            if let Some(more) = MultiLayerOplog::try_archive(&oplog).await {
-                                if more {
-                                    self.schedule(
-                                        now.add(next_after),
-                                        ScheduledAction::ArchiveOplog {
-                                            owned_worker_id,
-                                            last_oplog_index,
-                                            next_after,
-                                        },
-                                    )
-                                    .await;
-                                }
-                            }
-                        }
+        let mut due = due.into_iter();
+        while let Some((deadline, action)) = due.next() {
+            if self
+                .shard_service
+                .check_worker(&action.owned_worker_id().worker_id)
+                .is_err()
+            {
+                // The shard has been revoked, the action is executed by its new owner
+                continue;
+            }
 
-                        // TODO: metrics
-                    }
+            owned_worker_ids.insert(action.owned_worker_id().clone());
+            if let Err(err) = self.execute(now, deadline, action.clone()).await {
+                let mut timers = self.timers.lock().unwrap();
+                timers.insert(deadline, action);
+                for (deadline, action) in due {
+                    timers.insert(deadline, action);
                 }
+                return Err(err);
             }
         }
 
@@ -181,7 +166,6 @@ impl SchedulerServiceDefault {
                 "scheduler",
                 worker_id = owned_worker_id.worker_id.to_string()
             );
-            warn!("SCHEDULE PROCESS CALLS ACTIVATE_WORKER");
             self.worker_activator
                 .activate_worker(&owned_worker_id)
                 .instrument(span)
@@ -191,10 +175,105 @@ impl SchedulerServiceDefault {
         Ok(())
     }
 
+    async fn execute(
+        &self,
+        now: DateTime<Utc>,
+        deadline: u64,
+        action: ScheduledAction,
+    ) -> Result<(), String> {
+        let (hours_since_epoch, _) = Self::split_millis(deadline as i64);
+        self.key_value_storage
+            .with_entity("scheduler", "process", "scheduled_action")
+            .remove_from_sorted_set(
+                KeyValueStorageNamespace::Schedule,
+                &Self::schedule_key_from_timestamp(hours_since_epoch),
+                &action,
+            )
+            .await?;
+
+        match action {
+            ScheduledAction::CompletePromise { promise_id, .. } => {
+                self.promise_service
+                    .complete(promise_id, vec![])
+                    .await
+                    .map_err(|golem_err| format!("{golem_err}"))?;
+
+                record_scheduled_promise_completed();
+            }
+            ScheduledAction::ArchiveOplog {
+                owned_worker_id,
+                last_oplog_index,
+                next_after,
+            } => {
+                if self.oplog_service.exists(&owned_worker_id).await {
+                    let current_last_index =
+                        self.oplog_service.get_last_index(&owned_worker_id).await;
+                    if current_last_index == last_oplog_index {
+                        let oplog = self.oplog_service.open(&owned_worker_id).await;
+                        if let Some(more) = MultiLayerOplog::try_archive(&oplog).await {
+                            if more {
+                                self.schedule(
+                                    now.add(next_after),
+                                    ScheduledAction::ArchiveOplog {
+                                        owned_worker_id,
+                                        last_oplog_index,
+                                        next_after,
+                                    },
+                                )
+                                .await;
+                            }
+                        }
+                    }
+
+                    // TODO: metrics
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Adds the actions stored for the given hour which belong to the assigned shards to the
+    /// timers
+    async fn load_hour(&self, hours_since_epoch: i64) -> Result<(), String> {
+        let key = Self::schedule_key_from_timestamp(hours_since_epoch);
+        let actions: Vec<(f64, ScheduledAction)> = self
+            .key_value_storage
+            .with_entity("scheduler", "load", "scheduled_action")
+            .get_sorted_set(KeyValueStorageNamespace::Schedule, &key)
+            .await?;
+
+        let mut timers = self.timers.lock().unwrap();
+        for (remainder, action) in actions {
+            if self
+                .shard_service
+                .check_worker(&action.owned_worker_id().worker_id)
+                .is_ok()
+            {
+                let deadline = hours_since_epoch * Self::HOUR_IN_MILLIS + remainder as i64;
+                timers.insert(deadline.max(0) as u64, action);
+            }
+        }
+        debug!(
+            "Loaded scheduled actions of {key}, {} pending",
+            timers.len()
+        );
+        drop(timers);
+
+        self.timers_changed.notify_one();
+        Ok(())
+    }
+
     const HOUR_IN_MILLIS: i64 = 1000 * 60 * 60;
 
+    fn millis<Tz: TimeZone>(time: DateTime<Tz>) -> u64 {
+        time.timestamp_millis().max(0) as u64
+    }
+
     fn split_time<Tz: TimeZone>(time: DateTime<Tz>) -> (i64, f64) {
-        let millis = time.timestamp_millis();
+        Self::split_millis(time.timestamp_millis())
+    }
+
+    fn split_millis(millis: i64) -> (i64, f64) {
         let hours_since_epoch = millis / Self::HOUR_IN_MILLIS;
         let remainder = (millis % Self::HOUR_IN_MILLIS) as f64;
         (hours_since_epoch, remainder)
@@ -240,6 +319,18 @@ impl SchedulerService for SchedulerServiceDefault {
                 panic!("failed to add schedule for action {action} in KV storage: {err}")
             });
 
+        if self
+            .shard_service
+            .check_worker(&action.owned_worker_id().worker_id)
+            .is_ok()
+        {
+            self.timers
+                .lock()
+                .unwrap()
+                .insert(Self::millis(time), action);
+            self.timers_changed.notify_one();
+        }
+
         id
     }
 
@@ -258,6 +349,16 @@ impl SchedulerService for SchedulerServiceDefault {
                     id.action
                 )
             });
+
+        self.timers.lock().unwrap().remove(&id.action);
+    }
+
+    async fn load_assigned(&self) -> Result<(), String> {
+        // Actions left in storage from before the previous hour are not picked up, like
+        // with the earlier polling implementation
+        let (hours_since_epoch, _) = Self::split_time(Utc::now());
+        self.load_hour(hours_since_epoch - 1).await?;
+        self.load_hour(hours_since_epoch).await
     }
 }
 
@@ -288,6 +389,10 @@ impl SchedulerService for SchedulerServiceMock {
     async fn cancel(&self, _id: ScheduleId) {
         unimplemented!()
     }
+
+    async fn load_assigned(&self) -> Result<(), String> {
+        Ok(())
+    }
 }
 
 #[cfg(test)]
@@ -299,7 +404,7 @@ mod tests {
 
     use bincode::Encode;
 
-    use chrono::DateTime;
+    use chrono::{DateTime, Utc};
 
     use uuid::Uuid;
 
@@ -312,6 +417,7 @@ mod tests {
     use crate::services::shard::ShardServiceMock;
     use crate::services::worker_activator::WorkerActivatorMock;
     use crate::storage::keyvalue::memory::InMemoryKeyValueStorage;
+    use crate::storage::keyvalue::{KeyValueStorageLabelledApi, KeyValueStorageNamespace};
 
     fn serialized_bytes<T: Encode>(entry: &T) -> Vec<u8> {
         golem_common::serialization::serialize(entry)
@@ -944,4 +1050,112 @@ mod tests {
         assert!(completed_promises.contains(&p3));
         assert!(completed_promises.contains(&p2));
     }
+
+    #[tokio::test]
+    pub async fn background_task_fires_at_deadline() {
+        let worker_id = WorkerId {
+            component_id: ComponentId(Uuid::new_v4()),
+            worker_name: "inst1".to_string(),
+        };
+        let account_id = AccountId {
+            value: "test-account".to_string(),
+        };
+        let p1 = PromiseId {
+            worker_id: worker_id.clone(),
+            oplog_idx: OplogIndex::from_u64(101),
+        };
+
+        let kvs = Arc::new(InMemoryKeyValueStorage::new());
+        let promise_service = Arc::new(PromiseServiceMock::new());
+
+        let svc = SchedulerServiceDefault::new(
+            kvs.clone(),
+            Arc::new(ShardServiceMock::new()),
+            promise_service.clone(),
+            Arc::new(WorkerActivatorMock::new()),
+            Arc::new(OplogServiceMock::new()),
+            Duration::from_secs(1000), // the wake up must not depend on the refresh interval
+        );
+
+        svc.schedule(
+            Utc::now() + chrono::Duration::milliseconds(50),
+            ScheduledAction::CompletePromise {
+                promise_id: p1.clone(),
+                account_id: account_id.clone(),
+            },
+        )
+        .await;
+
+        tokio::time::sleep(Duration::from_millis(500)).await;
+
+        assert!(promise_service.all_completed().await.contains(&p1));
+        assert!(kvs
+            .sorted_sets()
+            .iter()
+            .all(|entry| entry.value().is_empty()));
+    }
+
+    #[tokio::test]
+    pub async fn load_assigned_picks_up_stored_schedules() {
+        let worker_id = WorkerId {
+            component_id: ComponentId(Uuid::new_v4()),
+            worker_name: "inst1".to_string(),
+        };
+        let account_id = AccountId {
+            value: "test-account".to_string(),
+        };
+        let p1 = PromiseId {
+            worker_id: worker_id.clone(),
+            oplog_idx: OplogIndex::from_u64(101),
+        };
+        let p2 = PromiseId {
+            worker_id: worker_id.clone(),
+            oplog_idx: OplogIndex::from_u64(123),
+        };
+
+        let kvs = Arc::new(InMemoryKeyValueStorage::new());
+        let now = Utc::now();
+
+        // Scheduled by the previous owner of the shard
+        for (time, promise_id) in [
+            (now - chrono::Duration::minutes(1), &p1),
+            (now + chrono::Duration::minutes(10), &p2),
+        ] {
+            let (hours_since_epoch, remainder) = SchedulerServiceDefault::split_time(time);
+            kvs.with_entity("test", "schedule", "scheduled_action")
+                .add_to_sorted_set(
+                    KeyValueStorageNamespace::Schedule,
+                    &SchedulerServiceDefault::schedule_key_from_timestamp(hours_since_epoch),
+                    remainder,
+                    &ScheduledAction::CompletePromise {
+                        promise_id: promise_id.clone(),
+                        account_id: account_id.clone(),
+                    },
+                )
+                .await
+                .unwrap();
+        }
+
+        let promise_service = Arc::new(PromiseServiceMock::new());
+        let svc = SchedulerServiceDefault::new(
+            kvs.clone(),
+            Arc::new(ShardServiceMock::new()),
+            promise_service.clone(),
+            Arc::new(WorkerActivatorMock::new()),
+            Arc::new(OplogServiceMock::new()),
+            Duration::from_secs(1000), // explicitly calling process for testing
+        );
+        svc.load_assigned().await.unwrap();
+
+        svc.process(now).await.unwrap();
+        let completed_promises = promise_service.all_completed().await;
+        assert!(completed_promises.contains(&p1));
+        assert!(!completed_promises.contains(&p2));
+
+        svc.process(now + chrono::Duration::minutes(10))
+            .await
+            .unwrap();
+        let completed_promises = promise_service.all_completed().await;
+        assert!(completed_promises.contains(&p2));
+    }
 }
@@ -0,0 +1,328 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::collections::{BTreeMap, HashMap};
+use std::hash::Hash;
+
+/// Hierarchical timer wheel with millisecond resolution.
+///
+/// Level `n` has 64 slots of 64^n milliseconds each, so six levels cover a bit more than two
+/// years ahead of the current time; items scheduled even later wait in an overflow map. An item
+/// is stored in the lowest level where its deadline and the current time fall into the same
+/// aligned range, and is moved down to lower levels as the time advances, until it expires from
+/// level 0 exactly at its deadline. Inserting and removing items is constant time, and advancing
+/// the time only visits the occupied slots.
+///
+/// Every item can be scheduled only once: inserting it again replaces its previous deadline.
+pub struct TimerWheel<T> {
+    /// Current time of the wheel, in milliseconds since the epoch
+    now: u64,
+    levels: Vec<Level<T>>,
+    /// Items inserted with a deadline not after the current time
+    overdue: BTreeMap<u64, Vec<T>>,
+    /// Items too far in the future for the highest level
+    overflow: BTreeMap<u64, Vec<T>>,
+    deadlines: HashMap<T, u64>,
+}
+
+struct Level<T> {
+    /// Bit `n` is set if slot `n` is not empty
+    occupied: u64,
+    slots: Vec<Vec<(u64, T)>>,
+}
+
+impl<T> Level<T> {
+    fn new() -> Self {
+        Self {
+            occupied: 0,
+            slots: (0..SLOTS).map(|_| Vec::new()).collect(),
+        }
+    }
+}
+
+const BITS: u32 = 6;
+const SLOTS: usize = 1 << BITS;
+const LEVELS: usize = 6;
+
+impl<T: Clone + Eq + Hash> TimerWheel<T> {
+    pub fn new(now: u64) -> Self {
+        Self {
+            now,
+            levels: (0..LEVELS).map(|_| Level::new()).collect(),
+            overdue: BTreeMap::new(),
+            overflow: BTreeMap::new(),
+            deadlines: HashMap::new(),
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.deadlines.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.deadlines.is_empty()
+    }
+
+    /// Schedules `item` to expire at `deadline`, replacing its previous deadline if it was
+    /// already scheduled
+    pub fn insert(&mut self, deadline: u64, item: T) {
+        if let Some(previous) = self.deadlines.insert(item.clone(), deadline) {
+            self.remove_at(previous, &item);
+        }
+        self.place(deadline, item);
+    }
+
+    /// Removes `item`, returning its deadline if it was scheduled
+    pub fn remove(&mut self, item: &T) -> Option<u64> {
+        let deadline = self.deadlines.remove(item)?;
+        self.remove_at(deadline, item);
+        Some(deadline)
+    }
+
+    /// A time not later than the earliest deadline, to wait for before calling
+    /// [`TimerWheel::advance`] again. It is the exact deadline unless the earliest item is
+    /// still stored on a higher level.
+    pub fn next_wake_up(&self) -> Option<u64> {
+        if let Some((deadline, _)) = self.overdue.first_key_value() {
+            return Some(*deadline);
+        }
+        if let Some((_, _, start)) = self.next_slot() {
+            return Some(start);
+        }
+        self.overflow
+            .first_key_value()
+            .map(|(deadline, _)| *deadline)
+    }
+
+    /// Advances the wheel to `to` and returns all the items with a deadline not after it, in
+    /// the order of their deadlines. The wheel never goes back in time, but overdue items are
+    /// still only returned once `to` reaches their deadline.
+    pub fn advance(&mut self, to: u64) -> Vec<(u64, T)> {
+        let mut expired = Vec::new();
+
+        while self.now < to {
+            self.cascade_overflow();
+            match self.next_slot() {
+                Some((level, slot, start)) if start <= to => {
+                    self.now = start;
+                    let level = &mut self.levels[level];
+                    level.occupied &= !(1 << slot);
+                    let items = std::mem::take(&mut level.slots[slot]);
+                    for (deadline, item) in items {
+                        if deadline <= self.now {
+                            expired.push((deadline, item));
+                        } else {
+                            self.place(deadline, item);
+                        }
+                    }
+                }
+                _ => match self.overflow.first_key_value() {
+                    // The wheel is empty, jumping to the range of the next overflown item
+                    Some((deadline, _)) if *deadline <= to => {
+                        self.now = self.now.max(deadline & !Self::range_mask(LEVELS));
+                    }
+                    _ => self.now = to,
+                },
+            }
+        }
+        self.cascade_overflow();
+
+        let later = self.overdue.split_off(&(to.saturating_add(1)));
+        let due = std::mem::replace(&mut self.overdue, later);
+        for (deadline, items) in due {
+            expired.extend(items.into_iter().map(|item| (deadline, item)));
+        }
+
+        for (_, item) in &expired {
+            self.deadlines.remove(item);
+        }
+        expired.sort_by_key(|(deadline, _)| *deadline);
+        expired
+    }
+
+    /// Mask of the bits of a time within an aligned range covered by the first `levels` levels
+    fn range_mask(levels: usize) -> u64 {
+        (1u64 << (BITS as usize * levels)) - 1
+    }
+
+    /// The first occupied slot of the lowest non-empty level, with the time it starts at
+    fn next_slot(&self) -> Option<(usize, usize, u64)> {
+        self.levels
+            .iter()
+            .enumerate()
+            .find(|(_, level)| level.occupied != 0)
+            .map(|(idx, level)| {
+                let slot = level.occupied.trailing_zeros() as u64;
+                let start =
+                    (self.now & !Self::range_mask(idx + 1)) | (slot << (BITS as usize * idx));
+                (idx, slot as usize, start)
+            })
+    }
+
+    /// Moves the overflown items which got close enough to the current time into the levels
+    fn cascade_overflow(&mut self) {
+        while let Some(deadline) = self.overflow.keys().next().copied() {
+            if deadline > self.now && self.level_of(deadline) >= LEVELS {
+                break;
+            }
+            let items = self.overflow.remove(&deadline).unwrap_or_default();
+            for item in items {
+                self.place(deadline, item);
+            }
+        }
+    }
+
+    /// The level of a future deadline: the highest group of bits it differs from the current
+    /// time in
+    fn level_of(&self, deadline: u64) -> usize {
+        let diff = deadline ^ self.now;
+        ((63 - diff.leading_zeros()) / BITS) as usize
+    }
+
+    fn slot_of(deadline: u64, level: usize) -> usize {
+        ((deadline >> (BITS as usize * level)) as usize) & (SLOTS - 1)
+    }
+
+    fn place(&mut self, deadline: u64, item: T) {
+        if deadline <= self.now {
+            self.overdue.entry(deadline).or_default().push(item);
+        } else {
+            let level = self.level_of(deadline);
+            if level >= LEVELS {
+                self.overflow.entry(deadline).or_default().push(item);
+            } else {
+                let slot = Self::slot_of(deadline, level);
+                let level = &mut self.levels[level];
+                level.slots[slot].push((deadline, item));
+                level.occupied |= 1 << slot;
+            }
+        }
+    }
+
+    fn remove_at(&mut self, deadline: u64, item: &T) {
+        if deadline <= self.now {
+            Self::remove_from_map(&mut self.overdue, deadline, item);
+        } else {
+            let level = self.level_of(deadline);
+            if level >= LEVELS {
+                Self::remove_from_map(&mut self.overflow, deadline, item);
+            } else {
+                let slot = Self::slot_of(deadline, level);
+                let level = &mut self.levels[level];
+                let items = &mut level.slots[slot];
+                if let Some(idx) = items.iter().position(|(_, other)| other == item) {
+                    items.swap_remove(idx);
+                }
+                if items.is_empty() {
+                    level.occupied &= !(1 << slot);
+                }
+            }
+        }
+    }
+
+    fn remove_from_map(map: &mut BTreeMap<u64, Vec<T>>, deadline: u64, item: &T) {
+        if let Some(items) = map.get_mut(&deadline) {
+            if let Some(idx) = items.iter().position(|other| other == item) {
+                items.swap_remove(idx);
+            }
+            if items.is_empty() {
+                map.remove(&deadline);
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::services::scheduler::timer_wheel::TimerWheel;
+
+    const START: u64 = 1_700_000_000_123;
+
+    #[test]
+    fn items_expire_exactly_at_their_deadline() {
+        let mut wheel = TimerWheel::new(START);
+        let offsets = [1, 63, 64, 65, 4095, 4097, 300_000, 3_600_000, 86_400_000];
+        for offset in offsets {
+            wheel.insert(START + offset, offset);
+        }
+        assert_eq!(wheel.len(), offsets.len());
+
+        for offset in offsets {
+            let deadline = START + offset;
+            // Following the wake up times never gets past a deadline
+            while let Some(wake_up) = wheel.next_wake_up() {
+                assert!(wake_up <= deadline);
+                if wake_up == deadline {
+                    break;
+                }
+                assert_eq!(wheel.advance(wake_up), vec![]);
+            }
+            assert_eq!(wheel.advance(deadline - 1), vec![]);
+            assert_eq!(wheel.advance(deadline), vec![(deadline, offset)]);
+        }
+        assert!(wheel.is_empty());
+        assert_eq!(wheel.next_wake_up(), None);
+    }
+
+    #[test]
+    fn advancing_far_returns_items_in_deadline_order() {
+        let mut wheel = TimerWheel::new(START);
+        wheel.insert(START + 5_000, "b");
+        wheel.insert(START + 10, "a");
+        wheel.insert(START + 1_000_000_000_000, "overflow");
+        wheel.insert(START + 7_200_000, "c");
+
+        assert_eq!(
+            wheel.advance(START + 7_200_000),
+            vec![
+                (START + 10, "a"),
+                (START + 5_000, "b"),
+                (START + 7_200_000, "c")
+            ]
+        );
+        assert_eq!(wheel.next_wake_up(), Some(START + 1_000_000_000_000));
+        assert_eq!(
+            wheel.advance(START + 2_000_000_000_000),
+            vec![(START + 1_000_000_000_000, "overflow")]
+        );
+    }
+
+    #[test]
+    fn removed_and_rescheduled_items() {
+        let mut wheel = TimerWheel::new(START);
+        wheel.insert(START + 100, "a");
+        wheel.insert(START + 200, "b");
+        wheel.insert(START + 300, "c");
+
+        assert_eq!(wheel.remove(&"b"), Some(START + 200));
+        assert_eq!(wheel.remove(&"b"), None);
+        wheel.insert(START + 50, "c");
+
+        assert_eq!(
+            wheel.advance(START + 1000),
+            vec![(START + 50, "c"), (START + 100, "a")]
+        );
+    }
+
+    #[test]
+    fn overdue_items_wait_for_their_deadline() {
+        let mut wheel = TimerWheel::new(START);
+        wheel.insert(START - 2000, "a");
+        wheel.insert(START - 1000, "b");
+
+        assert_eq!(wheel.next_wake_up(), Some(START - 2000));
+        assert_eq!(wheel.advance(START - 1500), vec![(START - 2000, "a")]);
+        assert_eq!(wheel.advance(START), vec![(START - 1000, "b")]);
+    }
+}
@@ -28,6 +28,7 @@ pub trait ShardService {
     fn register(&self, number_of_shards: usize, shard_ids: &HashSet<ShardId>);
     fn revoke_shards(&self, shard_ids: &HashSet<ShardId>);
     fn current_assignment(&self) -> ShardAssignment;
+    fn number_of_shards(&self) -> usize;
 }
 
 pub struct ShardServiceDefault {
@@ -67,6 +68,10 @@ impl ShardService for ShardServiceDefault {
         self.shard_assignment.read().unwrap().clone()
     }
 
+    fn number_of_shards(&self) -> usize {
+        self.shard_assignment.read().unwrap().number_of_shards
+    }
+
     fn register(&self, number_of_shards: usize, shard_ids: &HashSet<ShardId>) {
         let mut shard_assignment = self.shard_assignment.write().unwrap();
         shard_assignment.register(number_of_shards, shard_ids);
@@ -122,4 +127,8 @@ impl ShardService for ShardServiceMock {
     fn current_assignment(&self) -> ShardAssignment {
         ShardAssignment::default()
     }
+
+    fn number_of_shards(&self) -> usize {
+        1
+    }
 }
@@ -12,8 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use std::collections::HashSet;
-use std::sync::Arc;
+use std::collections::{HashMap, HashSet};
+use std::sync::{Arc, RwLock};
 
 use async_trait::async_trait;
 use golem_api_grpc::proto::golem::shardmanager;
@@ -29,6 +29,20 @@ use crate::services::golem_config::{ShardManagerServiceConfig, ShardManagerServi
 #[async_trait]
 pub trait ShardManagerService {
     async fn register(&self, host: String, port: u16) -> Result<ShardAssignment, GolemError>;
+
+    /// Reports the number of worker to worker RPC calls observed between pairs of shards
+    async fn report_rpc_affinity(
+        &self,
+        edges: HashMap<(ShardId, ShardId), u64>,
+    ) -> Result<(), GolemError>;
+
+    /// Reports the memory available for the workers of this worker executor and the estimated
+    /// memory requirement of its active workers. Nothing is reported before registering.
+    async fn report_memory_headroom(
+        &self,
+        worker_memory: u64,
+        used_memory: u64,
+    ) -> Result<(), GolemError>;
 }
 
 pub fn configured(
@@ -44,11 +58,16 @@ pub fn configured(
 
 pub struct ShardManagerServiceGrpc {
     config: ShardManagerServiceGrpcConfig,
+    /// The host and port this worker executor registered with, identifying it in the reports
+    registered_as: RwLock<Option<(String, u16)>>,
 }
 
 impl ShardManagerServiceGrpc {
     pub fn new(config: ShardManagerServiceGrpcConfig) -> Self {
-        Self { config }
+        Self {
+            config,
+            registered_as: RwLock::new(None),
+        }
     }
 }
 
@@ -60,6 +79,7 @@ impl ShardManagerService for ShardManagerServiceGrpc {
         let desc = format!(
             "Registering worker executor with shard manager at {uri} using pod name {pod_name:?}"
         );
+        *self.registered_as.write().unwrap() = Some((host.clone(), port));
         with_retries(
             &desc,
             "shard_manager",
@@ -120,6 +140,99 @@ impl ShardManagerService for ShardManagerServiceGrpc {
         )
         .await
     }
+
+    async fn report_rpc_affinity(
+        &self,
+        edges: HashMap<(ShardId, ShardId), u64>,
+    ) -> Result<(), GolemError> {
+        let uri: hyper::Uri = self.config.url().to_string().parse().unwrap();
+        let mut shard_manager_client =
+            shard_manager_service_client::ShardManagerServiceClient::connect(uri.as_http_02())
+                .await
+                .map_err(|err| {
+                    GolemError::unknown(format!("Connecting to shard manager failed with {}", err))
+                })?;
+        let response = shard_manager_client
+            .report_rpc_affinity(shardmanager::ReportRpcAffinityRequest {
+                edges: edges
+                    .into_iter()
+                    .map(|((caller, callee), calls)| shardmanager::RpcAffinityEdge {
+                        caller: Some(caller.into()),
+                        callee: Some(callee.into()),
+                        calls,
+                    })
+                    .collect(),
+            })
+            .await
+            .map_err(|err| {
+                GolemError::unknown(format!(
+                    "Reporting RPC affinity to shard manager failed with {}",
+                    err
+                ))
+            })?;
+        match response.into_inner() {
+            shardmanager::ReportRpcAffinityResponse {
+                result: Some(shardmanager::report_rpc_affinity_response::Result::Success(_)),
+            } => Ok(()),
+            shardmanager::ReportRpcAffinityResponse {
+                result: Some(shardmanager::report_rpc_affinity_response::Result::Failure(failure)),
+            } => Err(GolemError::unknown(format!(
+                "Reporting RPC affinity to shard manager failed with shard manager error {:?}",
+                failure
+            ))),
+            shardmanager::ReportRpcAffinityResponse { .. } => Err(GolemError::unknown(
+                "Reporting RPC affinity to shard manager failed with unknown error",
+            )),
+        }
+    }
+
+    async fn report_memory_headroom(
+        &self,
+        worker_memory: u64,
+        used_memory: u64,
+    ) -> Result<(), GolemError> {
+        let Some((host, port)) = self.registered_as.read().unwrap().clone() else {
+            return Ok(());
+        };
+        let uri: hyper::Uri = self.config.url().to_string().parse().unwrap();
+        let pod_name = std::env::var_os("POD_NAME").map(|s| s.to_string_lossy().to_string());
+        let mut shard_manager_client =
+            shard_manager_service_client::ShardManagerServiceClient::connect(uri.as_http_02())
+                .await
+                .map_err(|err| {
+                    GolemError::unknown(format!("Connecting to shard manager failed with {}", err))
+                })?;
+        let response = shard_manager_client
+            .report_memory_headroom(shardmanager::ReportMemoryHeadroomRequest {
+                host,
+                port: port as i32,
+                pod_name,
+                worker_memory,
+                used_memory,
+            })
+            .await
+            .map_err(|err| {
+                GolemError::unknown(format!(
+                    "Reporting memory headroom to shard manager failed with {}",
+                    err
+                ))
+            })?;
+        match response.into_inner() {
+            shardmanager::ReportMemoryHeadroomResponse {
+                result: Some(shardmanager::report_memory_headroom_response::Result::Success(_)),
+            } => Ok(()),
+            shardmanager::ReportMemoryHeadroomResponse {
+                result:
+                    Some(shardmanager::report_memory_headroom_response::Result::Failure(failure)),
+            } => Err(GolemError::unknown(format!(
+                "Reporting memory headroom to shard manager failed with shard manager error {:?}",
+                failure
+            ))),
+            shardmanager::ReportMemoryHeadroomResponse { .. } => Err(GolemError::unknown(
+                "Reporting memory headroom to shard manager failed with unknown error",
+            )),
+        }
+    }
 }
 
 pub struct ShardManagerServiceSingleShard {}
@@ -144,4 +257,19 @@ impl ShardManagerService for ShardManagerServiceSingleShard {
             HashSet::from_iter(vec![ShardId::new(0)]),
         ))
     }
+
+    async fn report_rpc_affinity(
+        &self,
+        _edges: HashMap<(ShardId, ShardId), u64>,
+    ) -> Result<(), GolemError> {
+        Ok(())
+    }
+
+    async fn report_memory_headroom(
+        &self,
+        _worker_memory: u64,
+        _used_memory: u64,
+    ) -> Result<(), GolemError> {
+        Ok(())
+    }
 }
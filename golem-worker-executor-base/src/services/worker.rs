@@ -15,11 +15,16 @@
 use std::sync::Arc;
 
 use async_trait::async_trait;
+use dashmap::DashMap;
+use futures::future::{BoxFuture, Shared};
+use futures::FutureExt;
 use golem_common::model::oplog::{OplogEntry, OplogIndex};
 use golem_common::model::{
-    OwnedWorkerId, ShardId, WorkerId, WorkerMetadata, WorkerStatus, WorkerStatusRecord,
+    AccountId, ComponentId, OwnedWorkerId, ScanCursor, ShardId, WorkerId, WorkerMetadata,
+    WorkerStatus, WorkerStatusRecord,
 };
-use tracing::debug;
+use golem_common::serialization::deserialize;
+use tracing::{debug, warn};
 
 use crate::error::GolemError;
 use crate::metrics::workers::record_worker_call;
@@ -46,25 +51,53 @@ pub trait WorkerService {
         owned_worker_id: &OwnedWorkerId,
         status_value: &WorkerStatusRecord,
     );
+
+    /// Returns a page of the workers of a component having the given last known status, and the
+    /// cursor to continue with, which is 0 when the scan is finished.
+    ///
+    /// The workers are indexed by component and status when they are added or their status
+    /// changes. The existing workers of a component are indexed on its first scan, which waits
+    /// for it. The indexing runs in a background task shared by the concurrent scans, and its
+    /// progress is saved after each page, so an interrupted indexing continues where it stopped.
+    /// During the indexing a worker can be returned for a status it no longer has, so callers
+    /// must check the statuses of the returned workers.
+    async fn scan_component_by_status(
+        &self,
+        account_id: &AccountId,
+        component_id: &ComponentId,
+        status: &WorkerStatus,
+        cursor: u64,
+        count: u64,
+    ) -> Result<(u64, Vec<OwnedWorkerId>), GolemError>;
 }
 
+/// The background task adding the existing workers of a component to the component index
+type ComponentIndexing = Shared<BoxFuture<'static, Result<(), GolemError>>>;
+
 #[derive(Clone)]
 pub struct DefaultWorkerService {
     key_value_storage: Arc<dyn KeyValueStorage + Send + Sync>,
     shard_service: Arc<dyn ShardService + Send + Sync>,
     oplog_service: Arc<dyn OplogService + Send + Sync>,
+    component_index: bool,
+    indexing: Arc<DashMap<ComponentId, ComponentIndexing>>,
 }
 
 impl DefaultWorkerService {
+    const INDEXING_PAGE_SIZE: u64 = 1000;
+
     pub fn new(
         key_value_storage: Arc<dyn KeyValueStorage + Send + Sync>,
         shard_service: Arc<dyn ShardService + Send + Sync>,
         oplog_service: Arc<dyn OplogService + Send + Sync>,
+        component_index: bool,
     ) -> Self {
         Self {
             key_value_storage,
             shard_service,
             oplog_service,
+            component_index,
+            indexing: Arc::new(DashMap::new()),
         }
     }
 
@@ -98,6 +131,238 @@ impl DefaultWorkerService {
     fn running_in_shard_key(shard_id: &ShardId) -> String {
         format!("worker:running_in_shard:{shard_id}")
     }
+
+    fn component_status_key(component_id: &ComponentId, status: &WorkerStatus) -> String {
+        format!("worker:component:{component_id}:{status:?}")
+    }
+
+    fn component_indexed_key(component_id: &ComponentId) -> String {
+        format!("worker:component:{component_id}:indexed")
+    }
+
+    fn component_indexing_cursor_key(component_id: &ComponentId) -> String {
+        format!("worker:component:{component_id}:indexing_cursor")
+    }
+
+    /// Gets the cached status of the worker. A status stored in an earlier layout of the record
+    /// cannot be decoded, and is treated as missing, so it is calculated again from the oplog.
+    async fn get_status(&self, owned_worker_id: &OwnedWorkerId) -> Option<WorkerStatusRecord> {
+        let bytes = self
+            .key_value_storage
+            .with_entity("worker", "get", "worker_status")
+            .get_raw(
+                KeyValueStorageNamespace::Worker,
+                &Self::status_key(&owned_worker_id.worker_id),
+            )
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to get worker status for {owned_worker_id} from KV storage: {err}")
+            })?;
+        match deserialize::<WorkerStatusRecord>(&bytes) {
+            Ok(status) => Some(status),
+            Err(err) => {
+                warn!("Ignoring the stored status of {owned_worker_id}, it is recalculated from the oplog: {err}");
+                None
+            }
+        }
+    }
+
+    async fn add_to_component_index(&self, owned_worker_id: &OwnedWorkerId, status: &WorkerStatus) {
+        self.key_value_storage
+            .with_entity("worker", "index", "worker_id")
+            .add_to_set(
+                KeyValueStorageNamespace::Worker,
+                &Self::component_status_key(&owned_worker_id.worker_id.component_id, status),
+                owned_worker_id,
+            )
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to add worker to the component index in KV storage: {err}")
+            });
+    }
+
+    async fn remove_from_component_index(
+        &self,
+        owned_worker_id: &OwnedWorkerId,
+        status: &WorkerStatus,
+    ) {
+        self.key_value_storage
+            .with_entity("worker", "index", "worker_id")
+            .remove_from_set(
+                KeyValueStorageNamespace::Worker,
+                &Self::component_status_key(&owned_worker_id.worker_id.component_id, status),
+                owned_worker_id,
+            )
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to remove worker from the component index in KV storage: {err}")
+            });
+    }
+
+    /// Sets the status of the worker. With the component index enabled the worker is moved to
+    /// the status's entry of the index in the same atomic step. The status is only replaced if it
+    /// is still the one the worker is moved out of, otherwise the move is retried from the
+    /// concurrently set status.
+    async fn set_status(&self, owned_worker_id: &OwnedWorkerId, status_value: &WorkerStatusRecord) {
+        let status_key = Self::status_key(&owned_worker_id.worker_id);
+
+        if !self.component_index {
+            self.key_value_storage
+                .with_entity("worker", "set_status", "worker_status")
+                .set(KeyValueStorageNamespace::Worker, &status_key, status_value)
+                .await
+                .unwrap_or_else(|err| panic!("failed to set worker status in KV storage: {err}"));
+            return;
+        }
+
+        let component_id = &owned_worker_id.worker_id.component_id;
+        let destination_key = Self::component_status_key(component_id, &status_value.status);
+
+        loop {
+            let previous_value = self
+                .key_value_storage
+                .with_entity("worker", "set_status", "worker_status")
+                .get_raw(KeyValueStorageNamespace::Worker, &status_key)
+                .await
+                .unwrap_or_else(|err| {
+                    panic!(
+                        "failed to get worker status for {owned_worker_id} from KV storage: {err}"
+                    )
+                });
+            let source_key = previous_value
+                .as_ref()
+                .and_then(|bytes| deserialize::<WorkerStatusRecord>(bytes).ok())
+                .map(|previous_value| {
+                    Self::component_status_key(component_id, &previous_value.status)
+                });
+
+            let replaced = self
+                .key_value_storage
+                .with_entity("worker", "set_status", "worker_status")
+                .replace_and_move_between_sets(
+                    KeyValueStorageNamespace::Worker,
+                    &status_key,
+                    previous_value.as_deref(),
+                    status_value,
+                    source_key.as_deref(),
+                    &destination_key,
+                    owned_worker_id,
+                )
+                .await
+                .unwrap_or_else(|err| panic!("failed to set worker status in KV storage: {err}"));
+
+            if replaced {
+                break;
+            }
+        }
+    }
+
+    /// Waits until the workers created before the component index existed are added to the
+    /// index. The indexing runs in a background task, so it is not cancelled with the scan
+    /// waiting for it, and concurrent scans of the component wait for the same task.
+    async fn ensure_component_indexed(
+        &self,
+        account_id: &AccountId,
+        component_id: &ComponentId,
+    ) -> Result<(), GolemError> {
+        let indexing = self
+            .indexing
+            .entry(component_id.clone())
+            .or_insert_with(|| {
+                let service = self.clone();
+                let account_id = account_id.clone();
+                let component_id = component_id.clone();
+                let handle = tokio::spawn(async move {
+                    service.index_component(&account_id, &component_id).await
+                });
+                async move {
+                    handle.await.unwrap_or_else(|err| {
+                        Err(GolemError::unknown(format!(
+                            "indexing the workers of the component failed: {err}"
+                        )))
+                    })
+                }
+                .boxed()
+                .shared()
+            })
+            .clone();
+
+        let result = indexing.clone().await;
+        // A failed indexing is retried, from its last saved cursor, by the next scan
+        self.indexing
+            .remove_if(component_id, |_, current| current.ptr_eq(&indexing));
+        result
+    }
+
+    /// Adds the workers created before the component index existed to the index, continuing
+    /// from the cursor saved by an earlier, interrupted indexing
+    async fn index_component(
+        &self,
+        account_id: &AccountId,
+        component_id: &ComponentId,
+    ) -> Result<(), GolemError> {
+        let cursor_key = Self::component_indexing_cursor_key(component_id);
+        let mut cursor: ScanCursor = self
+            .key_value_storage
+            .with_entity("worker", "index", "indexing_cursor")
+            .get(KeyValueStorageNamespace::Worker, &cursor_key)
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to get the component indexing cursor from KV storage: {err}")
+            })
+            .unwrap_or_default();
+
+        debug!("Indexing the existing workers of component {component_id} from {cursor}");
+
+        loop {
+            let (next_cursor, owned_worker_ids) = self
+                .oplog_service
+                .scan_for_component(account_id, component_id, cursor, Self::INDEXING_PAGE_SIZE)
+                .await?;
+            for owned_worker_id in owned_worker_ids {
+                if let Some(metadata) = self.get(&owned_worker_id).await {
+                    self.add_to_component_index(
+                        &owned_worker_id,
+                        &metadata.last_known_status.status,
+                    )
+                    .await;
+                }
+            }
+            if next_cursor.is_finished() {
+                break;
+            }
+            self.key_value_storage
+                .with_entity("worker", "index", "indexing_cursor")
+                .set(KeyValueStorageNamespace::Worker, &cursor_key, &next_cursor)
+                .await
+                .unwrap_or_else(|err| {
+                    panic!("failed to save the component indexing cursor in KV storage: {err}")
+                });
+            cursor = next_cursor;
+        }
+
+        self.key_value_storage
+            .with_entity("worker", "index", "component_indexed")
+            .set(
+                KeyValueStorageNamespace::Worker,
+                &Self::component_indexed_key(component_id),
+                &true,
+            )
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to mark component as indexed in KV storage: {err}")
+            });
+
+        self.key_value_storage
+            .with("worker", "index")
+            .del(KeyValueStorageNamespace::Worker, &cursor_key)
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to remove the component indexing cursor from KV storage: {err}")
+            });
+
+        Ok(())
+    }
 }
 
 #[async_trait]
@@ -122,15 +387,8 @@ impl WorkerService for DefaultWorkerService {
             .create(&owned_worker_id, initial_oplog_entry)
             .await;
 
-        self.key_value_storage
-            .with_entity("worker", "add", "worker_status")
-            .set(
-                KeyValueStorageNamespace::Worker,
-                &Self::status_key(worker_id),
-                &worker_metadata.last_known_status,
-            )
-            .await
-            .unwrap_or_else(|err| panic!("failed to set worker status in KV storage: {err}"));
+        self.set_status(&owned_worker_id, &worker_metadata.last_known_status)
+            .await;
 
         if worker_metadata.last_known_status.status == WorkerStatus::Running {
             let shard_assignment = self.shard_service.current_assignment();
@@ -196,19 +454,7 @@ impl WorkerService for DefaultWorkerService {
                     },
                 };
 
-                let status_value: Option<WorkerStatusRecord> = self
-                    .key_value_storage
-                    .with_entity("worker", "get", "worker_status")
-                    .get(
-                        KeyValueStorageNamespace::Worker,
-                        &Self::status_key(&owned_worker_id.worker_id),
-                    )
-                    .await
-                    .unwrap_or_else(|err| {
-                        panic!("failed to get worker status for {owned_worker_id} from KV storage: {err}")
-                    });
-
-                if let Some(status) = status_value {
+                if let Some(status) = self.get_status(owned_worker_id).await {
                     details.last_known_status = status;
                 }
 
@@ -236,6 +482,13 @@ impl WorkerService for DefaultWorkerService {
 
         self.oplog_service.delete(owned_worker_id).await;
 
+        if self.component_index {
+            if let Some(status_value) = self.get_status(owned_worker_id).await {
+                self.remove_from_component_index(owned_worker_id, &status_value.status)
+                    .await;
+            }
+        }
+
         self.key_value_storage
             .with("worker", "remove")
             .del(
@@ -273,15 +526,7 @@ impl WorkerService for DefaultWorkerService {
         record_worker_call("update_status");
 
         debug!("Updating worker status to {status_value:?}");
-        self.key_value_storage
-            .with_entity("worker", "update_status", "worker_status")
-            .set(
-                KeyValueStorageNamespace::Worker,
-                &Self::status_key(&owned_worker_id.worker_id),
-                status_value,
-            )
-            .await
-            .unwrap_or_else(|err| panic!("failed to set worker status in KV storage: {err}"));
+        self.set_status(owned_worker_id, status_value).await;
 
         let shard_assignment = self.shard_service.current_assignment();
         let shard_id = ShardId::from_worker_id(
@@ -317,6 +562,51 @@ impl WorkerService for DefaultWorkerService {
                 });
         }
     }
+
+    async fn scan_component_by_status(
+        &self,
+        account_id: &AccountId,
+        component_id: &ComponentId,
+        status: &WorkerStatus,
+        cursor: u64,
+        count: u64,
+    ) -> Result<(u64, Vec<OwnedWorkerId>), GolemError> {
+        record_worker_call("scan_component_by_status");
+
+        if cursor == 0 {
+            let indexed = self
+                .key_value_storage
+                .with("worker", "scan_component_by_status")
+                .exists(
+                    KeyValueStorageNamespace::Worker,
+                    &Self::component_indexed_key(component_id),
+                )
+                .await
+                .unwrap_or_else(|err| {
+                    panic!("failed to check if component is indexed in KV storage: {err}")
+                });
+            if !indexed {
+                self.ensure_component_indexed(account_id, component_id)
+                    .await?;
+            }
+        }
+
+        let (cursor, owned_worker_ids) = self
+            .key_value_storage
+            .with_entity("worker", "scan_component_by_status", "worker_id")
+            .scan_set(
+                KeyValueStorageNamespace::Worker,
+                &Self::component_status_key(component_id, status),
+                cursor,
+                count,
+            )
+            .await
+            .unwrap_or_else(|err| {
+                panic!("failed to scan the component index in KV storage: {err}")
+            });
+
+        Ok((cursor, owned_worker_ids))
+    }
 }
 
 #[cfg(any(feature = "mocks", test))]
@@ -362,4 +652,15 @@ impl WorkerService for WorkerServiceMock {
     ) {
         unimplemented!()
     }
+
+    async fn scan_component_by_status(
+        &self,
+        _account_id: &AccountId,
+        _component_id: &ComponentId,
+        _status: &WorkerStatus,
+        _cursor: u64,
+        _count: u64,
+    ) -> Result<(u64, Vec<OwnedWorkerId>), GolemError> {
+        unimplemented!()
+    }
 }
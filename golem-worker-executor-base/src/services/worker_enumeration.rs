@@ -178,6 +178,106 @@ impl DefaultWorkerEnumerationService {
 
         Ok((new_cursor, workers))
     }
+
+    /// Gets a page of workers through the worker index. The cursor's layer selects the status
+    /// being scanned from the candidate statuses of the filter, and its cursor is the position
+    /// in the index of that status.
+    async fn get_indexed(
+        &self,
+        account_id: &AccountId,
+        component_id: &ComponentId,
+        filter: Option<WorkerFilter>,
+        cursor: ScanCursor,
+        count: u64,
+        precise: bool,
+    ) -> Result<(Option<ScanCursor>, Vec<WorkerMetadata>), GolemError> {
+        let mut workers: Vec<WorkerMetadata> = vec![];
+
+        // With precise, the status is calculated from the oplog, so it can differ from the one
+        // the worker is indexed by
+        let statuses = if precise {
+            ALL_WORKER_STATUSES.to_vec()
+        } else {
+            candidate_statuses(&filter)
+        };
+        let Some(status) = statuses.get(cursor.layer) else {
+            return Ok((None, workers));
+        };
+
+        let (new_index_cursor, keys) = self
+            .worker_service
+            .scan_component_by_status(account_id, component_id, status, cursor.cursor, count)
+            .await?;
+
+        for owned_worker_id in keys {
+            let worker_metadata = self.worker_service.get(&owned_worker_id).await;
+
+            if let Some(worker_metadata) = worker_metadata {
+                // Stale index entries, and the entry under the previous status of a worker
+                // which is being updated, are skipped so each worker is returned once
+                if worker_metadata.last_known_status.status != *status {
+                    continue;
+                }
+
+                let metadata = if precise {
+                    let last_known_status = calculate_last_known_status(
+                        self,
+                        &owned_worker_id,
+                        &Some(worker_metadata.clone()),
+                    )
+                    .await?;
+                    WorkerMetadata {
+                        last_known_status,
+                        ..worker_metadata
+                    }
+                } else {
+                    worker_metadata
+                };
+
+                if filter.clone().map_or(true, |f| f.matches(&metadata)) {
+                    workers.push(metadata);
+                }
+            }
+        }
+
+        let new_cursor = if new_index_cursor != 0 {
+            Some(ScanCursor {
+                cursor: new_index_cursor,
+                layer: cursor.layer,
+            })
+        } else if cursor.layer + 1 < statuses.len() {
+            Some(ScanCursor {
+                cursor: 0,
+                layer: cursor.layer + 1,
+            })
+        } else {
+            None
+        };
+
+        Ok((new_cursor, workers))
+    }
+}
+
+const ALL_WORKER_STATUSES: [WorkerStatus; 7] = [
+    WorkerStatus::Running,
+    WorkerStatus::Idle,
+    WorkerStatus::Suspended,
+    WorkerStatus::Interrupted,
+    WorkerStatus::Retrying,
+    WorkerStatus::Failed,
+    WorkerStatus::Exited,
+];
+
+/// The statuses of the workers the filter can match
+fn candidate_statuses(filter: &Option<WorkerFilter>) -> Vec<WorkerStatus> {
+    ALL_WORKER_STATUSES
+        .into_iter()
+        .filter(|status| {
+            filter
+                .as_ref()
+                .map_or(true, |f| f.matches_status(status) != Some(false))
+        })
+        .collect()
 }
 
 impl HasOplogService for DefaultWorkerEnumerationService {
@@ -226,8 +326,18 @@ impl WorkerEnumerationService for DefaultWorkerEnumerationService {
         while new_cursor.is_some() && (workers.len() as u64) < count {
             let new_count = count - (workers.len() as u64);
 
-            let (next_cursor, workers_page) = self
-                .get_internal(
+            let (next_cursor, workers_page) = if self.golem_config.worker_index.enabled {
+                self.get_indexed(
+                    account_id,
+                    component_id,
+                    filter.clone(),
+                    new_cursor.unwrap_or_default(),
+                    new_count,
+                    precise,
+                )
+                .await?
+            } else {
+                self.get_internal(
                     account_id,
                     component_id,
                     filter.clone(),
@@ -235,7 +345,8 @@ impl WorkerEnumerationService for DefaultWorkerEnumerationService {
                     new_count,
                     precise,
                 )
-                .await?;
+                .await?
+            };
 
             workers.extend(workers_page);
 
@@ -278,3 +389,54 @@ impl WorkerEnumerationService for WorkerEnumerationServiceMock {
         unimplemented!()
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use golem_common::model::{
+        FilterComparator, StringFilterComparator, WorkerFilter, WorkerStatus,
+    };
+
+    use crate::services::worker_enumeration::{candidate_statuses, ALL_WORKER_STATUSES};
+
+    #[test]
+    fn candidate_statuses_of_filters() {
+        assert_eq!(candidate_statuses(&None), ALL_WORKER_STATUSES.to_vec());
+
+        let name = WorkerFilter::new_name(StringFilterComparator::Like, "worker".to_string());
+        assert_eq!(
+            candidate_statuses(&Some(name.clone())),
+            ALL_WORKER_STATUSES.to_vec()
+        );
+
+        let failed = WorkerFilter::new_status(FilterComparator::GreaterEqual, WorkerStatus::Failed);
+        assert_eq!(
+            candidate_statuses(&Some(name.and(failed.clone()))),
+            vec![WorkerStatus::Failed, WorkerStatus::Exited]
+        );
+        assert_eq!(
+            candidate_statuses(&Some(name.or(failed.clone()))),
+            ALL_WORKER_STATUSES.to_vec()
+        );
+        assert_eq!(
+            candidate_statuses(&Some(
+                WorkerFilter::new_status(FilterComparator::Equal, WorkerStatus::Idle)
+                    .or(failed.clone())
+            )),
+            vec![
+                WorkerStatus::Idle,
+                WorkerStatus::Failed,
+                WorkerStatus::Exited
+            ]
+        );
+        assert_eq!(
+            candidate_statuses(&Some(failed.not())),
+            vec![
+                WorkerStatus::Running,
+                WorkerStatus::Idle,
+                WorkerStatus::Suspended,
+                WorkerStatus::Interrupted,
+                WorkerStatus::Retrying
+            ]
+        );
+    }
+}
@@ -12,12 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use ringbuf::*;
 use std::fmt::{Display, Formatter};
+use std::sync::atomic::{fence, AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Arc, RwLock};
+use std::time::{Duration, Instant};
 use tokio::sync::broadcast::error::RecvError;
-use tokio::sync::broadcast::*;
+use tokio::sync::Notify;
 
-use crate::metrics::events::{record_broadcast_event, record_event};
+use crate::metrics::events::{record_broadcast_event, record_event, record_lagged_events};
+use crate::services::golem_config::WorkerOutputConfig;
 
 #[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub enum LogLevel {
@@ -95,31 +98,58 @@ pub trait WorkerEventService {
     fn receiver(&self) -> WorkerEventReceiver;
 }
 
+/// Subscription to the events of a worker, starting with the most recent ones emitted before
+/// subscribing
 pub struct WorkerEventReceiver {
-    history: Vec<WorkerEvent>,
-    receiver: Receiver<WorkerEvent>,
+    ring: Arc<EventRing<WorkerEvent>>,
+    position: u64,
 }
 
 impl WorkerEventReceiver {
-    pub async fn recv(&mut self) -> Result<WorkerEvent, RecvError> {
-        match self.history.pop() {
-            Some(event) => Ok(event),
-            None => self.receiver.recv().await,
+    /// Receives the next event. The events are shared by all subscribers.
+    ///
+    /// If the subscriber fell behind by more than the capacity of the ring, it fails with
+    /// `RecvError::Lagged` holding the number of events missed, and the next call continues
+    /// with the oldest event still available.
+    pub async fn recv(&mut self) -> Result<Arc<WorkerEvent>, RecvError> {
+        loop {
+            match self.ring.get(self.position) {
+                Slot::Ready(event) => {
+                    self.position += 1;
+                    return Ok(event);
+                }
+                Slot::Overwritten => {
+                    let oldest = self.ring.oldest();
+                    let missed = oldest.saturating_sub(self.position);
+                    self.position = oldest;
+                    record_lagged_events(missed);
+                    return Err(RecvError::Lagged(missed));
+                }
+                Slot::Pending => self.ring.wait(self.position).await,
+            }
         }
     }
 }
 
+impl Drop for WorkerEventReceiver {
+    fn drop(&mut self) {
+        self.ring.subscribers.fetch_sub(1, Ordering::Relaxed);
+    }
+}
+
 pub struct WorkerEventServiceDefault {
-    sender: Sender<WorkerEvent>,
-    ring: HeapRb<WorkerEvent>,
+    ring: Arc<EventRing<WorkerEvent>>,
+    history_size: usize,
 }
 
 impl WorkerEventServiceDefault {
-    pub fn new(channel_capacity: usize, ring_capacity: usize) -> WorkerEventServiceDefault {
-        let (tx, _) = channel(channel_capacity);
-        let ring = HeapRb::new(ring_capacity);
-        // ring.sub
-        WorkerEventServiceDefault { sender: tx, ring }
+    /// New subscribers first receive the last `history_size` events, and can fall behind by
+    /// `broadcast_capacity` more before missing any
+    pub fn new(broadcast_capacity: usize, history_size: usize) -> WorkerEventServiceDefault {
+        WorkerEventServiceDefault {
+            ring: Arc::new(EventRing::new(broadcast_capacity + history_size)),
+            history_size,
+        }
     }
 }
 
@@ -133,18 +163,19 @@ impl WorkerEventService for WorkerEventServiceDefault {
     fn emit_event(&self, event: WorkerEvent) {
         record_event(label(&event));
 
-        if self.sender.receiver_count() > 0 {
+        if self.ring.subscribers.load(Ordering::Relaxed) > 0 {
             record_broadcast_event(label(&event));
-
-            let _ = self.sender.send(event.clone());
         }
-        let _ = unsafe { Producer::new(&self.ring) }.push(event);
+        self.ring.push(event);
     }
 
     fn receiver(&self) -> WorkerEventReceiver {
-        let receiver = self.sender.subscribe();
-        let history = self.ring.iter().cloned().rev().collect();
-        WorkerEventReceiver { history, receiver }
+        self.ring.subscribers.fetch_add(1, Ordering::Relaxed);
+        let position = self.ring.head().saturating_sub(self.history_size as u64);
+        WorkerEventReceiver {
+            ring: self.ring.clone(),
+            position,
+        }
     }
 }
 
@@ -157,14 +188,212 @@ fn label(event: &WorkerEvent) -> &'static str {
     }
 }
 
+/// Bounded ring of the most recent events of a worker, shared by the worker and its subscribers.
+///
+/// Every subscriber keeps its own position, so emitting an event never waits for them. The
+/// slots have their own locks, held only to replace or clone the `Arc` of an event, so the
+/// worker can only contend with a subscriber reading the very slot it overwrites, and there is
+/// no lock shared by all of them. Subscribers waiting for new events are only notified if there
+/// are any.
+struct EventRing<T> {
+    /// Every slot holds its position and event, the position telling whether it was overwritten
+    slots: Box<[RwLock<Option<(u64, Arc<T>)>>]>,
+    /// Position of the next event
+    head: AtomicU64,
+    subscribers: AtomicUsize,
+    waiting: AtomicUsize,
+    notify: Notify,
+}
+
+enum Slot<T> {
+    Ready(Arc<T>),
+    Overwritten,
+    Pending,
+}
+
+impl<T> EventRing<T> {
+    fn new(capacity: usize) -> Self {
+        Self {
+            slots: (0..capacity.max(1)).map(|_| RwLock::new(None)).collect(),
+            head: AtomicU64::new(0),
+            subscribers: AtomicUsize::new(0),
+            waiting: AtomicUsize::new(0),
+            notify: Notify::new(),
+        }
+    }
+
+    fn push(&self, event: T) {
+        let event = Arc::new(event);
+        let position = self.head.fetch_add(1, Ordering::AcqRel);
+        {
+            let mut slot = self.slot(position).write().unwrap();
+            // With concurrent producers an event one lap later may already be stored
+            if slot.as_ref().map_or(true, |(stored, _)| *stored < position) {
+                *slot = Some((position, event));
+            }
+        }
+
+        // Pairs with the fence in `wait`, so either the waiting subscriber sees the event or
+        // its registration is seen here
+        fence(Ordering::SeqCst);
+        if self.waiting.load(Ordering::Relaxed) > 0 {
+            self.notify.notify_waiters();
+        }
+    }
+
+    fn head(&self) -> u64 {
+        self.head.load(Ordering::Acquire)
+    }
+
+    /// Position of the oldest event which can still be in the ring
+    fn oldest(&self) -> u64 {
+        self.head().saturating_sub(self.slots.len() as u64)
+    }
+
+    fn get(&self, position: u64) -> Slot<T> {
+        match &*self.slot(position).read().unwrap() {
+            Some((stored, event)) if *stored == position => Slot::Ready(event.clone()),
+            Some((stored, _)) if *stored > position => Slot::Overwritten,
+            _ => Slot::Pending,
+        }
+    }
+
+    /// Waits until the slot of the given position changes
+    async fn wait(&self, position: u64) {
+        let notified = self.notify.notified();
+        tokio::pin!(notified);
+        notified.as_mut().enable();
+
+        let _waiting = WaitingGuard::new(&self.waiting);
+        fence(Ordering::SeqCst);
+        if matches!(self.get(position), Slot::Pending) {
+            notified.await;
+        }
+    }
+
+    fn slot(&self, position: u64) -> &RwLock<Option<(u64, Arc<T>)>> {
+        &self.slots[(position % self.slots.len() as u64) as usize]
+    }
+}
+
+/// Counts a subscriber as waiting until dropped, including when its `recv` is cancelled
+struct WaitingGuard<'a>(&'a AtomicUsize);
+
+impl<'a> WaitingGuard<'a> {
+    fn new(waiting: &'a AtomicUsize) -> Self {
+        waiting.fetch_add(1, Ordering::Relaxed);
+        Self(waiting)
+    }
+}
+
+impl Drop for WaitingGuard<'_> {
+    fn drop(&mut self) {
+        self.0.fetch_sub(1, Ordering::Relaxed);
+    }
+}
+
+/// Output stream a buffered chunk of guest output belongs to
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum OutputStreamKind {
+    StdOut,
+    StdErr,
+}
+
+/// Coalesces consecutive stdout/stderr writes of a worker into fewer `WorkerEvent`s.
+///
+/// Writes are appended to the pending chunk as long as they target the same stream; switching
+/// to the other stream or exceeding `max_buffered_bytes` flushes it, so the emitted events
+/// preserve the original order of the writes. The buffer has no timer of its own: its owner
+/// calls `flush_expired` once `max_delay` has passed since `pending_since`, and `flush` when the
+/// invocation ends or the worker starts waiting. With coalescing disabled every write is returned
+/// as its own event.
+pub struct WorkerOutputBuffer {
+    enabled: bool,
+    max_buffered_bytes: usize,
+    max_delay: Duration,
+    pending: Option<(OutputStreamKind, Vec<u8>, Instant)>,
+}
+
+impl WorkerOutputBuffer {
+    pub fn new(config: &WorkerOutputConfig) -> Self {
+        Self {
+            enabled: config.coalesce,
+            max_buffered_bytes: config.max_buffered_bytes,
+            max_delay: config.max_delay,
+            pending: None,
+        }
+    }
+
+    /// Buffers a write, returning the events which have to be emitted now, in order
+    pub fn push(&mut self, kind: OutputStreamKind, data: &[u8]) -> Vec<WorkerEvent> {
+        if !self.enabled {
+            return vec![Self::to_event(kind, data.to_vec())];
+        }
+
+        let mut result = Vec::new();
+        let same_stream =
+            matches!(&self.pending, Some((pending_kind, _, _)) if *pending_kind == kind);
+        if !same_stream {
+            result.extend(self.flush());
+        }
+
+        match &mut self.pending {
+            Some((_, buffer, _)) => buffer.extend_from_slice(data),
+            None => self.pending = Some((kind, data.to_vec(), Instant::now())),
+        }
+
+        if let Some((_, buffer, since)) = &self.pending {
+            if buffer.len() >= self.max_buffered_bytes || since.elapsed() >= self.max_delay {
+                result.extend(self.flush());
+            }
+        }
+
+        result
+    }
+
+    /// The time the pending chunk has been started at, if any
+    pub fn pending_since(&self) -> Option<Instant> {
+        self.pending.as_ref().map(|(_, _, since)| *since)
+    }
+
+    pub fn max_delay(&self) -> Duration {
+        self.max_delay
+    }
+
+    /// Takes the pending chunk if it has been held for at least `max_delay`
+    pub fn flush_expired(&mut self) -> Option<WorkerEvent> {
+        match &self.pending {
+            Some((_, _, since)) if since.elapsed() >= self.max_delay => self.flush(),
+            _ => None,
+        }
+    }
+
+    /// Takes the pending chunk, if any
+    pub fn flush(&mut self) -> Option<WorkerEvent> {
+        self.pending
+            .take()
+            .map(|(kind, buffer, _)| Self::to_event(kind, buffer))
+    }
+
+    fn to_event(kind: OutputStreamKind, data: Vec<u8>) -> WorkerEvent {
+        match kind {
+            OutputStreamKind::StdOut => WorkerEvent::StdOut(data),
+            OutputStreamKind::StdErr => WorkerEvent::StdErr(data),
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use std::sync::Arc;
 
+    use tokio::sync::broadcast::error::RecvError;
     use tokio::sync::Mutex;
 
+    use crate::services::golem_config::WorkerOutputConfig;
     use crate::services::worker_event::{
-        WorkerEvent, WorkerEventService, WorkerEventServiceDefault,
+        OutputStreamKind, WorkerEvent, WorkerEventService, WorkerEventServiceDefault,
+        WorkerOutputBuffer,
     };
 
     #[tokio::test]
@@ -179,10 +408,11 @@ mod tests {
             let mut rx1 = svc1.receiver();
             drop(svc1);
             loop {
-                match rx1.recv().await.unwrap() {
+                let event = rx1.recv().await.unwrap();
+                match *event {
                     WorkerEvent::Close => break,
-                    event => {
-                        rx1_events_clone.lock().await.push(event);
+                    _ => {
+                        rx1_events_clone.lock().await.push((*event).clone());
                     }
                 }
             }
@@ -198,10 +428,11 @@ mod tests {
             let mut rx2 = svc2.receiver();
             drop(svc2);
             loop {
-                match rx2.recv().await.unwrap() {
+                let event = rx2.recv().await.unwrap();
+                match *event {
                     WorkerEvent::Close => break,
-                    event => {
-                        rx2_events_clone.lock().await.push(event);
+                    _ => {
+                        rx2_events_clone.lock().await.push((*event).clone());
                     }
                 }
             }
@@ -255,10 +486,11 @@ mod tests {
             let mut rx1 = svc1.receiver();
             drop(svc1);
             loop {
-                match rx1.recv().await.unwrap() {
+                let event = rx1.recv().await.unwrap();
+                match *event {
                     WorkerEvent::Close => break,
-                    event => {
-                        rx1_events_clone.lock().await.push(event);
+                    _ => {
+                        rx1_events_clone.lock().await.push((*event).clone());
                     }
                 }
             }
@@ -275,10 +507,11 @@ mod tests {
             let mut rx2 = svc2.receiver();
             drop(svc2);
             loop {
-                match rx2.recv().await.unwrap() {
+                let event = rx2.recv().await.unwrap();
+                match *event {
                     WorkerEvent::Close => break,
-                    event => {
-                        rx2_events_clone.lock().await.push(event);
+                    _ => {
+                        rx2_events_clone.lock().await.push((*event).clone());
                     }
                 }
             }
@@ -312,4 +545,110 @@ mod tests {
                 ]
         )
     }
+
+    #[tokio::test]
+    pub async fn lagging_subscriber_is_told_how_many_events_it_missed() {
+        let svc = WorkerEventServiceDefault::new(2, 2);
+        let mut rx = svc.receiver();
+
+        for b in 0..10u8 {
+            svc.emit_event(WorkerEvent::StdOut(vec![b]));
+        }
+
+        assert!(matches!(rx.recv().await, Err(RecvError::Lagged(6))));
+        for b in 6..10u8 {
+            assert_eq!(*rx.recv().await.unwrap(), WorkerEvent::StdOut(vec![b]));
+        }
+
+        svc.emit_event(WorkerEvent::StdOut(vec![10]));
+        assert_eq!(*rx.recv().await.unwrap(), WorkerEvent::StdOut(vec![10]));
+    }
+
+    #[tokio::test]
+    pub async fn subscribers_share_the_events() {
+        let svc = WorkerEventServiceDefault::new(4, 4);
+        let mut rx1 = svc.receiver();
+        let mut rx2 = svc.receiver();
+
+        let task = tokio::task::spawn(async move { rx1.recv().await.unwrap() });
+        tokio::task::yield_now().await;
+        svc.emit_event(WorkerEvent::StdOut(vec![1]));
+
+        let event1 = task.await.unwrap();
+        let event2 = rx2.recv().await.unwrap();
+        assert_eq!(*event1, WorkerEvent::StdOut(vec![1]));
+        assert!(Arc::ptr_eq(&event1, &event2));
+    }
+
+    fn coalescing_config(max_buffered_bytes: usize) -> WorkerOutputConfig {
+        WorkerOutputConfig {
+            coalesce: true,
+            max_buffered_bytes,
+            max_delay: std::time::Duration::from_secs(60),
+        }
+    }
+
+    #[test]
+    pub fn output_buffer_flushes_expired_chunk() {
+        let mut buffer = WorkerOutputBuffer::new(&WorkerOutputConfig {
+            coalesce: true,
+            max_buffered_bytes: 1024,
+            max_delay: std::time::Duration::from_millis(10),
+        });
+        assert_eq!(buffer.push(OutputStreamKind::StdOut, b"a"), vec![]);
+        assert!(buffer.pending_since().is_some());
+        assert_eq!(buffer.flush_expired(), None);
+
+        std::thread::sleep(std::time::Duration::from_millis(20));
+        assert_eq!(
+            buffer.flush_expired(),
+            Some(WorkerEvent::StdOut(b"a".to_vec()))
+        );
+        assert_eq!(buffer.pending_since(), None);
+    }
+
+    #[test]
+    pub fn output_buffer_passes_through_when_disabled() {
+        let mut buffer = WorkerOutputBuffer::new(&WorkerOutputConfig::default());
+        assert_eq!(
+            buffer.push(OutputStreamKind::StdOut, b"a"),
+            vec![WorkerEvent::StdOut(b"a".to_vec())]
+        );
+        assert_eq!(
+            buffer.push(OutputStreamKind::StdOut, b"b"),
+            vec![WorkerEvent::StdOut(b"b".to_vec())]
+        );
+        assert_eq!(buffer.flush(), None);
+    }
+
+    #[test]
+    pub fn output_buffer_coalesces_and_preserves_order() {
+        let mut buffer = WorkerOutputBuffer::new(&coalescing_config(1024));
+        let mut events = Vec::new();
+        events.extend(buffer.push(OutputStreamKind::StdOut, b"hello "));
+        events.extend(buffer.push(OutputStreamKind::StdOut, b"world\n"));
+        events.extend(buffer.push(OutputStreamKind::StdErr, b"oops\n"));
+        events.extend(buffer.push(OutputStreamKind::StdOut, b"bye\n"));
+        events.extend(buffer.flush());
+
+        assert_eq!(
+            events,
+            vec![
+                WorkerEvent::StdOut(b"hello world\n".to_vec()),
+                WorkerEvent::StdErr(b"oops\n".to_vec()),
+                WorkerEvent::StdOut(b"bye\n".to_vec()),
+            ]
+        );
+    }
+
+    #[test]
+    pub fn output_buffer_flushes_when_full() {
+        let mut buffer = WorkerOutputBuffer::new(&coalescing_config(4));
+        assert_eq!(buffer.push(OutputStreamKind::StdOut, b"ab"), vec![]);
+        assert_eq!(
+            buffer.push(OutputStreamKind::StdOut, b"cd"),
+            vec![WorkerEvent::StdOut(b"abcd".to_vec())]
+        );
+        assert_eq!(buffer.flush(), None);
+    }
 }
@@ -0,0 +1,160 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+use std::sync::Arc;
+use std::time::Duration;
+
+use golem_common::cache::{BackgroundEvictionMode, Cache, FullCacheEvictionMode, SimpleCache};
+use golem_common::model::{ComponentId, ComponentVersion};
+use wasmtime::component::{Component, InstancePre, Linker};
+
+use crate::error::GolemError;
+
+/// Pre-instantiated components shared by all the workers of the same component version.
+///
+/// Pre-instantiating a component resolves and type-checks all of its imports against the
+/// linker, which only has to be done once per component version instead of once per worker
+/// start. Instantiating a worker from the template then only allocates its instance, with the
+/// linear memories initialized copy-on-write from the compiled component's data segments.
+///
+/// A template is only used for the same loaded component it was created from, so it is
+/// recreated when the component service replaces the component, for example with its optimized
+/// tier.
+pub struct WorkerTemplates<Ctx: Send + 'static> {
+    linker: Arc<Linker<Ctx>>,
+    cache: Cache<(ComponentId, ComponentVersion), (), (usize, InstancePre<Ctx>), GolemError>,
+}
+
+impl<Ctx: Send + 'static> WorkerTemplates<Ctx> {
+    pub fn new(linker: Arc<Linker<Ctx>>, max_capacity: usize, time_to_idle: Duration) -> Self {
+        Self {
+            linker,
+            cache: Cache::new(
+                Some(max_capacity),
+                FullCacheEvictionMode::LeastRecentlyUsed(1),
+                BackgroundEvictionMode::OlderThan {
+                    ttl: time_to_idle,
+                    period: Duration::from_secs(60),
+                },
+                "worker_template",
+            ),
+        }
+    }
+
+    /// Gets the template of a component version, pre-instantiating `component` on first use
+    pub async fn get(
+        &self,
+        component_id: &ComponentId,
+        component_version: ComponentVersion,
+        component: &Component,
+    ) -> Result<InstancePre<Ctx>, GolemError> {
+        let key = (component_id.clone(), component_version);
+        // The address of the compiled code identifies the loaded component
+        let image = component.image_range().start as usize;
+        let (cached_image, instance_pre) = self.get_or_insert(&key, image, component).await?;
+        if cached_image == image {
+            Ok(instance_pre)
+        } else {
+            self.cache.remove(&key);
+            let (_, instance_pre) = self.get_or_insert(&key, image, component).await?;
+            Ok(instance_pre)
+        }
+    }
+
+    async fn get_or_insert(
+        &self,
+        key: &(ComponentId, ComponentVersion),
+        image: usize,
+        component: &Component,
+    ) -> Result<(usize, InstancePre<Ctx>), GolemError> {
+        let linker = self.linker.clone();
+        let component = component.clone();
+        self.cache
+            .get_or_insert_simple(key, || {
+                Box::pin(async move {
+                    let instance_pre = linker.instantiate_pre(&component).map_err(|e| {
+                        GolemError::runtime(format!("Failed to pre-instantiate component: {e}"))
+                    })?;
+                    Ok((image, instance_pre))
+                })
+            })
+            .await
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::Arc;
+    use std::time::Duration;
+
+    use golem_common::model::ComponentId;
+    use uuid::Uuid;
+    use wasmtime::component::{Component, Linker};
+    use wasmtime::{Config, Engine};
+
+    use crate::services::worker_template::WorkerTemplates;
+
+    fn cache_counter(name: &str) -> f64 {
+        prometheus::gather()
+            .iter()
+            .filter(|family| family.get_name() == name)
+            .flat_map(|family| family.get_metric().iter())
+            .filter(|metric| {
+                metric.get_label().iter().any(|label| {
+                    label.get_name() == "cache" && label.get_value() == "worker_template"
+                })
+            })
+            .map(|metric| metric.get_counter().get_value())
+            .sum()
+    }
+
+    #[tokio::test]
+    async fn templates_are_shared_until_the_component_is_replaced() {
+        let mut config = Config::new();
+        config.wasm_component_model(true);
+        let engine = Engine::new(&config).unwrap();
+        let bytes = std::fs::read("../test-components/rust-echo.wasm").unwrap();
+        let baseline = Component::from_binary(&engine, &bytes).unwrap();
+        // Compiling the component again loads it to a different address, like a tier swap does
+        let optimized = Component::from_binary(&engine, &bytes).unwrap();
+
+        let mut linker = Linker::<()>::new(&engine);
+        linker.define_unknown_imports_as_traps(&baseline).unwrap();
+        let templates = WorkerTemplates::new(Arc::new(linker), 10, Duration::from_secs(60));
+        let component_id = ComponentId(Uuid::new_v4());
+
+        let misses = cache_counter("cache_miss_total");
+        let hits = cache_counter("cache_hit_total");
+
+        templates.get(&component_id, 0, &baseline).await.unwrap();
+        templates
+            .get(&component_id, 0, &baseline.clone())
+            .await
+            .unwrap();
+        assert_eq!(cache_counter("cache_miss_total") - misses, 1.0);
+        assert_eq!(cache_counter("cache_hit_total") - hits, 1.0);
+
+        // The replaced component is pre-instantiated again, and then shared like the first one
+        templates.get(&component_id, 0, &optimized).await.unwrap();
+        templates.get(&component_id, 0, &optimized).await.unwrap();
+        assert_eq!(cache_counter("cache_miss_total") - misses, 2.0);
+        assert_eq!(cache_counter("cache_hit_total") - hits, 3.0);
+
+        let instance_pre = templates.get(&component_id, 0, &optimized).await.unwrap();
+        assert_eq!(
+            instance_pre.component().image_range(),
+            optimized.image_range()
+        );
+    }
+}
@@ -18,6 +18,8 @@ use std::path::{Path, PathBuf};
 use async_trait::async_trait;
 use bincode::{Decode, Encode};
 use bytes::Bytes;
+use futures::stream::BoxStream;
+use futures::{StreamExt, TryStreamExt};
 
 use golem_common::model::{AccountId, ComponentId, Timestamp, WorkerId};
 use golem_common::serialization::{deserialize, serialize};
@@ -26,6 +28,9 @@ pub mod fs;
 pub mod memory;
 pub mod s3;
 
+/// Chunks of a blob being streamed from or to the blob storage
+pub type BlobStream = BoxStream<'static, Result<Bytes, String>>;
+
 #[async_trait]
 pub trait BlobStorage: Debug {
     async fn get_raw(
@@ -51,6 +56,21 @@ pub trait BlobStorage: Debug {
         Ok(data.map(|data| data.slice((start as usize)..(end as usize))))
     }
 
+    /// Reads a blob as a stream of chunks. Implementations supporting it download the chunks
+    /// on demand, so the whole blob is never buffered in memory.
+    async fn get_stream(
+        &self,
+        target_label: &'static str,
+        op_label: &'static str,
+        namespace: BlobStorageNamespace,
+        path: &Path,
+    ) -> Result<Option<BlobStream>, String> {
+        let data = self
+            .get_raw(target_label, op_label, namespace, path)
+            .await?;
+        Ok(data.map(|data| futures::stream::once(async move { Ok(data) }).boxed()))
+    }
+
     async fn get_metadata(
         &self,
         target_label: &'static str,
@@ -68,6 +88,21 @@ pub trait BlobStorage: Debug {
         data: &[u8],
     ) -> Result<(), String>;
 
+    /// Writes a blob from a stream of chunks. Implementations supporting it upload the chunks
+    /// as they arrive, so the whole blob is never buffered in memory.
+    async fn put_stream(
+        &self,
+        target_label: &'static str,
+        op_label: &'static str,
+        namespace: BlobStorageNamespace,
+        path: &Path,
+        stream: BlobStream,
+    ) -> Result<(), String> {
+        let chunks: Vec<Bytes> = stream.try_collect().await?;
+        self.put_raw(target_label, op_label, namespace, path, &chunks.concat())
+            .await
+    }
+
     async fn delete(
         &self,
         target_label: &'static str,
@@ -203,6 +238,16 @@ impl<'a, S: BlobStorage + ?Sized + Sync> LabelledBlobStorage<'a, S> {
             .await
     }
 
+    pub async fn get_stream(
+        &self,
+        namespace: BlobStorageNamespace,
+        path: &Path,
+    ) -> Result<Option<BlobStream>, String> {
+        self.storage
+            .get_stream(self.svc_name, self.api_name, namespace, path)
+            .await
+    }
+
     pub async fn get_metadata(
         &self,
         namespace: BlobStorageNamespace,
@@ -224,6 +269,17 @@ impl<'a, S: BlobStorage + ?Sized + Sync> LabelledBlobStorage<'a, S> {
             .await
     }
 
+    pub async fn put_stream(
+        &self,
+        namespace: BlobStorageNamespace,
+        path: &Path,
+        stream: BlobStream,
+    ) -> Result<(), String> {
+        self.storage
+            .put_stream(self.svc_name, self.api_name, namespace, path, stream)
+            .await
+    }
+
     pub async fn delete(&self, namespace: BlobStorageNamespace, path: &Path) -> Result<(), String> {
         self.storage
             .delete(self.svc_name, self.api_name, namespace, path)
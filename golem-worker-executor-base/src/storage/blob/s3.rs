@@ -13,20 +13,28 @@
 // limitations under the License.
 
 use crate::services::golem_config::S3BlobStorageConfig;
-use crate::storage::blob::{BlobMetadata, BlobStorage, BlobStorageNamespace, ExistsResult};
+use crate::storage::blob::{
+    BlobMetadata, BlobStorage, BlobStorageNamespace, BlobStream, ExistsResult,
+};
 use async_trait::async_trait;
 use aws_sdk_s3::config::{BehaviorVersion, Credentials, Region};
-use aws_sdk_s3::error::SdkError;
+use aws_sdk_s3::error::{ProvideErrorMetadata, SdkError};
 use aws_sdk_s3::operation::copy_object::CopyObjectError;
 use aws_sdk_s3::operation::get_object::GetObjectError::NoSuchKey;
 use aws_sdk_s3::operation::head_object::HeadObjectError;
 use aws_sdk_s3::primitives::ByteStream;
-use aws_sdk_s3::types::{Delete, Object, ObjectIdentifier};
-use bytes::Bytes;
+use aws_sdk_s3::types::{
+    CompletedMultipartUpload, CompletedPart, Delete, Object, ObjectIdentifier,
+};
+use bytes::{Bytes, BytesMut};
+use futures::stream::{self, StreamExt, TryStreamExt};
+use golem_common::config::RetryConfig;
 use golem_common::model::Timestamp;
 use golem_common::retries::with_retries;
+use std::collections::VecDeque;
 use std::path::{Path, PathBuf};
-use tracing::info;
+use tokio::task::JoinSet;
+use tracing::{info, warn};
 
 #[derive(Debug)]
 pub struct S3BlobStorage {
@@ -126,6 +134,152 @@ impl S3BlobStorage {
         }
     }
 
+    fn object(
+        &self,
+        target_label: &'static str,
+        op_label: &'static str,
+        namespace: &BlobStorageNamespace,
+        path: &Path,
+    ) -> S3Object {
+        S3Object {
+            client: self.client.clone(),
+            retries: self.config.retries.clone(),
+            target_label,
+            op_label,
+            bucket: self.bucket_of(namespace).clone(),
+            key: self
+                .prefix_of(namespace)
+                .join(path)
+                .to_string_lossy()
+                .to_string(),
+            e_tag: None,
+        }
+    }
+
+    /// Downloads the bytes of an object from `start` to `end` (exclusive), or to the end of the
+    /// object, returning the number of bytes to be downloaded and the stream of the parts.
+    ///
+    /// The first part is requested right away, and the size of the object is taken from its
+    /// `Content-Range`. The rest of the parts are only requested if the object is larger, with
+    /// `If-Match` on the ETag of the first part, so an object replaced during the download fails
+    /// it instead of mixing the parts of two versions.
+    async fn get_from(
+        &self,
+        object: S3Object,
+        start: u64,
+        end: Option<u64>,
+    ) -> Result<Option<(u64, BlobStream)>, String> {
+        let part_size = self.config.multipart_part_size as u64;
+        let first_end = end
+            .map_or(start + part_size, |end| end.min(start + part_size))
+            .max(start + 1);
+        let first = match object.get(Some((start, first_end - 1))).await {
+            Err(GetError::InvalidRange) if start == 0 => {
+                // Only an empty object has no byte at offset 0
+                object.get(None).await
+            }
+            result => result,
+        }
+        .map_err(|err| err.to_string())?;
+        let Some(ObjectPart { data, size, e_tag }) = first else {
+            return Ok(None);
+        };
+
+        let size = size.unwrap_or(start + data.len() as u64);
+        let end = end.map_or(size, |end| end.min(size));
+        let length = end.saturating_sub(start);
+        let data = data.slice(..(data.len() as u64).min(length) as usize);
+        let rest_start = start + data.len() as u64;
+        let first_part = stream::once(async move { Ok(data) });
+        if rest_start >= end {
+            Ok(Some((length, first_part.boxed())))
+        } else {
+            let rest = self.get_parts(object.pinned_to(e_tag), rest_start, end);
+            Ok(Some((length, first_part.chain(rest).boxed())))
+        }
+    }
+
+    /// Downloads the bytes `start..end` of an object with ranged requests of
+    /// `multipart_part_size`, keeping at most `transfer_parallelism` of them in flight
+    fn get_parts(&self, object: S3Object, start: u64, end: u64) -> BlobStream {
+        let part_size = self.config.multipart_part_size as u64;
+        let ranges = (start..end)
+            .step_by(part_size as usize)
+            .map(move |start| (start, (start + part_size).min(end) - 1));
+        stream::iter(ranges)
+            .map(move |range| {
+                let object = object.clone();
+                async move {
+                    match object.get(Some(range)).await {
+                        Ok(Some(part)) => Ok(part.data),
+                        Ok(None) | Err(GetError::PreconditionFailed) => Err(format!(
+                            "Blob {}::{} was modified while being downloaded",
+                            object.bucket, object.key
+                        )),
+                        Err(err) => Err(err.to_string()),
+                    }
+                }
+            })
+            .buffered(self.config.transfer_parallelism.max(1))
+            .boxed()
+    }
+
+    async fn collect_parts(length: u64, mut parts: BlobStream) -> Result<Bytes, String> {
+        let mut data = BytesMut::with_capacity(length as usize);
+        while let Some(part) = parts.try_next().await? {
+            data.extend_from_slice(&part);
+        }
+        Ok(data.freeze())
+    }
+
+    /// Uploads the parts of a multipart upload as they are read from the stream, keeping at most
+    /// `transfer_parallelism` of them in flight
+    async fn upload_parts(
+        &self,
+        object: &S3Object,
+        upload_id: &str,
+        mut ready: VecDeque<Bytes>,
+        mut splitter: PartSplitter,
+        mut stream: BlobStream,
+    ) -> Result<Vec<CompletedPart>, String> {
+        let parallelism = self.config.transfer_parallelism.max(1);
+        let mut in_flight = JoinSet::new();
+        let mut completed = Vec::new();
+        let mut part_number = 0;
+        let mut finished = false;
+
+        loop {
+            while in_flight.len() < parallelism {
+                if let Some(part) = ready.pop_front() {
+                    part_number += 1;
+                    let object = object.clone();
+                    let upload_id = upload_id.to_string();
+                    in_flight.spawn(async move {
+                        object.upload_part(&upload_id, part_number, part).await
+                    });
+                } else if finished {
+                    break;
+                } else {
+                    match stream.try_next().await? {
+                        Some(chunk) => ready.extend(splitter.push(chunk)),
+                        None => {
+                            finished = true;
+                            ready.extend(splitter.finish());
+                        }
+                    }
+                }
+            }
+
+            match in_flight.join_next().await {
+                Some(result) => completed.push(result.map_err(|err| err.to_string())??),
+                None => break,
+            }
+        }
+
+        completed.sort_by_key(|part| part.part_number());
+        Ok(completed)
+    }
+
     async fn list_objects(
         &self,
         target_label: &'static str,
@@ -175,7 +329,11 @@ impl S3BlobStorage {
         error: &SdkError<aws_sdk_s3::operation::get_object::GetObjectError>,
     ) -> bool {
         match error {
-            SdkError::ServiceError(service_error) => !matches!(service_error.err(), NoSuchKey(_)),
+            SdkError::ServiceError(service_error) => {
+                let err = service_error.err();
+                !matches!(err, NoSuchKey(_))
+                    && !matches!(err.code(), Some("InvalidRange" | "PreconditionFailed"))
+            }
             _ => true,
         }
     }
@@ -195,6 +353,34 @@ impl S3BlobStorage {
         true
     }
 
+    fn is_create_multipart_upload_error_retriable(
+        _error: &SdkError<
+            aws_sdk_s3::operation::create_multipart_upload::CreateMultipartUploadError,
+        >,
+    ) -> bool {
+        true
+    }
+
+    fn is_upload_part_error_retriable(
+        _error: &SdkError<aws_sdk_s3::operation::upload_part::UploadPartError>,
+    ) -> bool {
+        true
+    }
+
+    fn is_complete_multipart_upload_error_retriable(
+        _error: &SdkError<
+            aws_sdk_s3::operation::complete_multipart_upload::CompleteMultipartUploadError,
+        >,
+    ) -> bool {
+        true
+    }
+
+    fn is_abort_multipart_upload_error_retriable(
+        _error: &SdkError<aws_sdk_s3::operation::abort_multipart_upload::AbortMultipartUploadError>,
+    ) -> bool {
+        true
+    }
+
     fn is_list_objects_v2_error_retriable(
         _error: &SdkError<aws_sdk_s3::operation::list_objects_v2::ListObjectsV2Error>,
     ) -> bool {
@@ -233,42 +419,10 @@ impl BlobStorage for S3BlobStorage {
         namespace: BlobStorageNamespace,
         path: &Path,
     ) -> Result<Option<Bytes>, String> {
-        let bucket = self.bucket_of(&namespace);
-        let key = self.prefix_of(&namespace).join(path);
-        let description = format!("Downloading blob from {bucket}::{key:?}");
-        let result = with_retries(
-            &description,
-            target_label,
-            op_label,
-            &self.config.retries,
-            &(self.client.clone(), bucket, key),
-            |(client, bucket, key)| {
-                Box::pin(async move {
-                    client
-                        .get_object()
-                        .bucket(*bucket)
-                        .key(key.to_string_lossy())
-                        .send()
-                        .await
-                })
-            },
-            Self::is_get_object_error_retriable,
-        )
-        .await;
-
-        match result {
-            Ok(response) => {
-                let body = response.body;
-                let aggregated_bytes = body.collect().await.map_err(|err| err.to_string())?;
-                let bytes = aggregated_bytes.into_bytes();
-
-                Ok(Some(bytes))
-            }
-            Err(SdkError::ServiceError(service_error)) => match service_error.err() {
-                NoSuchKey(_) => Ok(None),
-                err => Err(err.to_string()),
-            },
-            Err(err) => Err(err.to_string()),
+        let object = self.object(target_label, op_label, &namespace, path);
+        match self.get_from(object, 0, None).await? {
+            None => Ok(None),
+            Some((length, parts)) => Ok(Some(Self::collect_parts(length, parts).await?)),
         }
     }
 
@@ -281,46 +435,31 @@ impl BlobStorage for S3BlobStorage {
         start: u64,
         end: u64,
     ) -> Result<Option<Bytes>, String> {
-        let bucket = self.bucket_of(&namespace);
-        let key = self.prefix_of(&namespace).join(path);
-        let description = format!("Downloading blob from {bucket}::{key:?}");
-        let result = with_retries(
-            &description,
-            target_label,
-            op_label,
-            &self.config.retries,
-            &(self.client.clone(), bucket, key),
-            |(client, bucket, key)| {
-                Box::pin(async move {
-                    client
-                        .get_object()
-                        .bucket(*bucket)
-                        .key(key.to_string_lossy())
-                        .range(format!("bytes={}-{}", start, end))
-                        .send()
-                        .await
-                })
-            },
-            Self::is_get_object_error_retriable,
-        )
-        .await;
-
-        match result {
-            Ok(response) => {
-                let body = response.body;
-                let aggregated_bytes = body.collect().await.map_err(|err| err.to_string())?;
-                let bytes = aggregated_bytes.into_bytes();
-
-                Ok(Some(bytes))
-            }
-            Err(SdkError::ServiceError(service_error)) => match service_error.err() {
-                NoSuchKey(_) => Ok(None),
-                err => Err(err.to_string()),
-            },
-            Err(err) => Err(err.to_string()),
+        // `end` is inclusive and may point beyond the end of the object
+        let object = self.object(target_label, op_label, &namespace, path);
+        match self
+            .get_from(object, start, Some(end.saturating_add(1)))
+            .await?
+        {
+            None => Ok(None),
+            Some((length, parts)) => Ok(Some(Self::collect_parts(length, parts).await?)),
         }
     }
 
+    async fn get_stream(
+        &self,
+        target_label: &'static str,
+        op_label: &'static str,
+        namespace: BlobStorageNamespace,
+        path: &Path,
+    ) -> Result<Option<BlobStream>, String> {
+        let object = self.object(target_label, op_label, &namespace, path);
+        Ok(self
+            .get_from(object, 0, None)
+            .await?
+            .map(|(_, parts)| parts))
+    }
+
     async fn get_metadata(
         &self,
         target_label: &'static str,
@@ -417,32 +556,54 @@ impl BlobStorage for S3BlobStorage {
         path: &Path,
         data: &[u8],
     ) -> Result<(), String> {
-        let bucket = self.bucket_of(&namespace);
-        let key = self.prefix_of(&namespace).join(path);
-        let description = format!("Uploading blob to {bucket}::{key:?}");
+        let data = Bytes::copy_from_slice(data);
+        if data.len() <= self.config.multipart_part_size {
+            self.object(target_label, op_label, &namespace, path)
+                .put(data)
+                .await
+        } else {
+            let stream = stream::once(async move { Ok(data) }).boxed();
+            self.put_stream(target_label, op_label, namespace, path, stream)
+                .await
+        }
+    }
 
-        with_retries(
-            &description,
-            target_label,
-            op_label,
-            &self.config.retries,
-            &(self.client.clone(), bucket, key, data),
-            |(client, bucket, key, bytes)| {
-                Box::pin(async move {
-                    client
-                        .put_object()
-                        .bucket(*bucket)
-                        .key(key.to_string_lossy())
-                        .body(ByteStream::from(bytes.to_vec()))
-                        .send()
-                        .await
-                })
-            },
-            Self::is_put_object_error_retriable,
-        )
-        .await
-        .map(|_| ())
-        .map_err(|err| err.to_string())
+    async fn put_stream(
+        &self,
+        target_label: &'static str,
+        op_label: &'static str,
+        namespace: BlobStorageNamespace,
+        path: &Path,
+        mut stream: BlobStream,
+    ) -> Result<(), String> {
+        let object = self.object(target_label, op_label, &namespace, path);
+        let mut splitter = PartSplitter::new(self.config.multipart_part_size);
+
+        // Blobs not filling a single part are uploaded with a single request
+        let mut ready = VecDeque::new();
+        while ready.is_empty() {
+            match stream.try_next().await? {
+                Some(chunk) => ready.extend(splitter.push(chunk)),
+                None => return object.put(splitter.finish().unwrap_or_default()).await,
+            }
+        }
+
+        let upload_id = object.create_multipart_upload().await?;
+        match self
+            .upload_parts(&object, &upload_id, ready, splitter, stream)
+            .await
+        {
+            Ok(parts) => object.complete_multipart_upload(&upload_id, parts).await,
+            Err(err) => {
+                if let Err(abort_err) = object.abort_multipart_upload(&upload_id).await {
+                    warn!(
+                        "Failed to abort multipart upload {upload_id} of {}::{}: {abort_err}",
+                        object.bucket, object.key
+                    );
+                }
+                Err(err)
+            }
+        }
     }
 
     async fn delete(
@@ -769,3 +930,352 @@ impl BlobStorage for S3BlobStorage {
         Ok(())
     }
 }
+
+/// A single object of the S3 blob storage, owning everything needed to transfer it, so its
+/// parts can be transferred by independent tasks
+#[derive(Clone)]
+struct S3Object {
+    client: aws_sdk_s3::Client,
+    retries: RetryConfig,
+    target_label: &'static str,
+    op_label: &'static str,
+    bucket: String,
+    key: String,
+    /// The ETag the downloaded parts must match, if they must come from the same version
+    e_tag: Option<String>,
+}
+
+/// A downloaded part of an object
+struct ObjectPart {
+    data: Bytes,
+    /// The size of the whole object, from the `Content-Range` of a ranged request
+    size: Option<u64>,
+    e_tag: Option<String>,
+}
+
+/// Failures of downloading an object which are handled by the callers
+enum GetError {
+    /// The requested range starts beyond the end of the object
+    InvalidRange,
+    /// The object no longer matches the requested ETag
+    PreconditionFailed,
+    Other(String),
+}
+
+impl std::fmt::Display for GetError {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        match self {
+            GetError::InvalidRange => write!(f, "The requested range is not satisfiable"),
+            GetError::PreconditionFailed => write!(f, "The object does not match the ETag"),
+            GetError::Other(err) => write!(f, "{err}"),
+        }
+    }
+}
+
+impl S3Object {
+    fn pinned_to(self, e_tag: Option<String>) -> Self {
+        Self { e_tag, ..self }
+    }
+
+    /// Downloads the whole object, or only the given inclusive byte range of it
+    async fn get(&self, range: Option<(u64, u64)>) -> Result<Option<ObjectPart>, GetError> {
+        let description = format!("Downloading blob from {}::{}", self.bucket, self.key);
+        let range = range.map(|(start, end)| format!("bytes={start}-{end}"));
+        let result = with_retries(
+            &description,
+            self.target_label,
+            self.op_label,
+            &self.retries,
+            &(self, range),
+            |(object, range)| {
+                Box::pin(async move {
+                    object
+                        .client
+                        .get_object()
+                        .bucket(&object.bucket)
+                        .key(&object.key)
+                        .set_range(range.clone())
+                        .set_if_match(object.e_tag.clone())
+                        .send()
+                        .await
+                })
+            },
+            S3BlobStorage::is_get_object_error_retriable,
+        )
+        .await;
+
+        match result {
+            Ok(response) => {
+                // The total size follows the range, as in `bytes 0-99/1000`
+                let size = response
+                    .content_range()
+                    .and_then(|content_range| content_range.rsplit_once('/'))
+                    .and_then(|(_, size)| size.parse().ok());
+                let e_tag = response.e_tag().map(|e_tag| e_tag.to_string());
+                let body = response.body;
+                let aggregated_bytes = body
+                    .collect()
+                    .await
+                    .map_err(|err| GetError::Other(err.to_string()))?;
+                let data = aggregated_bytes.into_bytes();
+
+                Ok(Some(ObjectPart { data, size, e_tag }))
+            }
+            Err(SdkError::ServiceError(service_error)) => match service_error.err() {
+                NoSuchKey(_) => Ok(None),
+                err if err.code() == Some("InvalidRange") => Err(GetError::InvalidRange),
+                err if err.code() == Some("PreconditionFailed") => {
+                    Err(GetError::PreconditionFailed)
+                }
+                err => Err(GetError::Other(err.to_string())),
+            },
+            Err(err) => Err(GetError::Other(err.to_string())),
+        }
+    }
+
+    async fn put(&self, data: Bytes) -> Result<(), String> {
+        let description = format!("Uploading blob to {}::{}", self.bucket, self.key);
+        with_retries(
+            &description,
+            self.target_label,
+            self.op_label,
+            &self.retries,
+            &(self, data),
+            |(object, data)| {
+                Box::pin(async move {
+                    object
+                        .client
+                        .put_object()
+                        .bucket(&object.bucket)
+                        .key(&object.key)
+                        .body(ByteStream::from(data.clone()))
+                        .send()
+                        .await
+                })
+            },
+            S3BlobStorage::is_put_object_error_retriable,
+        )
+        .await
+        .map(|_| ())
+        .map_err(|err| err.to_string())
+    }
+
+    async fn create_multipart_upload(&self) -> Result<String, String> {
+        let description = format!("Starting multipart upload to {}::{}", self.bucket, self.key);
+        let response = with_retries(
+            &description,
+            self.target_label,
+            self.op_label,
+            &self.retries,
+            self,
+            |object| {
+                Box::pin(async move {
+                    object
+                        .client
+                        .create_multipart_upload()
+                        .bucket(&object.bucket)
+                        .key(&object.key)
+                        .send()
+                        .await
+                })
+            },
+            S3BlobStorage::is_create_multipart_upload_error_retriable,
+        )
+        .await
+        .map_err(|err| err.to_string())?;
+
+        response
+            .upload_id()
+            .map(|upload_id| upload_id.to_string())
+            .ok_or_else(|| format!("No upload id returned for {description}"))
+    }
+
+    async fn upload_part(
+        &self,
+        upload_id: &str,
+        part_number: i32,
+        data: Bytes,
+    ) -> Result<CompletedPart, String> {
+        let description = format!(
+            "Uploading part {part_number} of blob to {}::{}",
+            self.bucket, self.key
+        );
+        let response = with_retries(
+            &description,
+            self.target_label,
+            self.op_label,
+            &self.retries,
+            &(self, upload_id, data),
+            |(object, upload_id, data)| {
+                Box::pin(async move {
+                    object
+                        .client
+                        .upload_part()
+                        .bucket(&object.bucket)
+                        .key(&object.key)
+                        .upload_id(*upload_id)
+                        .part_number(part_number)
+                        .body(ByteStream::from(data.clone()))
+                        .send()
+                        .await
+                })
+            },
+            S3BlobStorage::is_upload_part_error_retriable,
+        )
+        .await
+        .map_err(|err| err.to_string())?;
+
+        Ok(CompletedPart::builder()
+            .set_e_tag(response.e_tag().map(|e_tag| e_tag.to_string()))
+            .part_number(part_number)
+            .build())
+    }
+
+    async fn complete_multipart_upload(
+        &self,
+        upload_id: &str,
+        parts: Vec<CompletedPart>,
+    ) -> Result<(), String> {
+        let description = format!(
+            "Completing multipart upload to {}::{}",
+            self.bucket, self.key
+        );
+        let upload = CompletedMultipartUpload::builder()
+            .set_parts(Some(parts))
+            .build();
+        with_retries(
+            &description,
+            self.target_label,
+            self.op_label,
+            &self.retries,
+            &(self, upload_id, upload),
+            |(object, upload_id, upload)| {
+                Box::pin(async move {
+                    object
+                        .client
+                        .complete_multipart_upload()
+                        .bucket(&object.bucket)
+                        .key(&object.key)
+                        .upload_id(*upload_id)
+                        .multipart_upload(upload.clone())
+                        .send()
+                        .await
+                })
+            },
+            S3BlobStorage::is_complete_multipart_upload_error_retriable,
+        )
+        .await
+        .map(|_| ())
+        .map_err(|err| err.to_string())
+    }
+
+    async fn abort_multipart_upload(&self, upload_id: &str) -> Result<(), String> {
+        let description = format!("Aborting multipart upload to {}::{}", self.bucket, self.key);
+        with_retries(
+            &description,
+            self.target_label,
+            self.op_label,
+            &self.retries,
+            &(self, upload_id),
+            |(object, upload_id)| {
+                Box::pin(async move {
+                    object
+                        .client
+                        .abort_multipart_upload()
+                        .bucket(&object.bucket)
+                        .key(&object.key)
+                        .upload_id(*upload_id)
+                        .send()
+                        .await
+                })
+            },
+            S3BlobStorage::is_abort_multipart_upload_error_retriable,
+        )
+        .await
+        .map(|_| ())
+        .map_err(|err| err.to_string())
+    }
+}
+
+/// Regroups the chunks of a stream into parts of a fixed size, followed by a smaller last
+/// part. Chunks spanning whole parts are sliced without copying them.
+struct PartSplitter {
+    part_size: usize,
+    pending: BytesMut,
+}
+
+impl PartSplitter {
+    fn new(part_size: usize) -> Self {
+        Self {
+            part_size,
+            pending: BytesMut::new(),
+        }
+    }
+
+    /// Adds a chunk, returning the parts completed by it
+    fn push(&mut self, mut chunk: Bytes) -> Vec<Bytes> {
+        let mut parts = Vec::new();
+        if !self.pending.is_empty() {
+            let missing = self.part_size - self.pending.len();
+            let taken = chunk.split_to(missing.min(chunk.len()));
+            self.pending.extend_from_slice(&taken);
+            if self.pending.len() == self.part_size {
+                parts.push(self.pending.split().freeze());
+            }
+        }
+        while chunk.len() >= self.part_size {
+            parts.push(chunk.split_to(self.part_size));
+        }
+        if !chunk.is_empty() {
+            self.pending.extend_from_slice(&chunk);
+        }
+        parts
+    }
+
+    /// The last, incomplete part
+    fn finish(&mut self) -> Option<Bytes> {
+        if self.pending.is_empty() {
+            None
+        } else {
+            Some(self.pending.split().freeze())
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::storage::blob::s3::PartSplitter;
+    use bytes::Bytes;
+
+    #[test]
+    fn chunks_are_regrouped_into_parts() {
+        let mut splitter = PartSplitter::new(4);
+        assert_eq!(
+            splitter.push(Bytes::from_static(b"ab")),
+            Vec::<Bytes>::new()
+        );
+        assert_eq!(
+            splitter.push(Bytes::from_static(b"cdefghijk")),
+            vec![Bytes::from_static(b"abcd"), Bytes::from_static(b"efgh")]
+        );
+        assert_eq!(
+            splitter.push(Bytes::from_static(b"l")),
+            vec![Bytes::from_static(b"ijkl")]
+        );
+        assert_eq!(
+            splitter.push(Bytes::from_static(b"mnopq")),
+            vec![Bytes::from_static(b"mnop")]
+        );
+        assert_eq!(splitter.finish(), Some(Bytes::from_static(b"q")));
+    }
+
+    #[test]
+    fn aligned_chunks_leave_no_last_part() {
+        let mut splitter = PartSplitter::new(2);
+        assert_eq!(
+            splitter.push(Bytes::from_static(b"abcd")),
+            vec![Bytes::from_static(b"ab"), Bytes::from_static(b"cd")]
+        );
+        assert_eq!(splitter.finish(), None);
+    }
+}
@@ -84,6 +84,44 @@ pub trait IndexedStorage: Debug {
         value: &[u8],
     ) -> Result<(), String>;
 
+    /// Appends entries to the indexes of multiple keys, given as `(key, id, value)` triples,
+    /// returning the result of each entry in the same order. The default implementation appends
+    /// them one by one, implementations should override it if they can write all of them in a
+    /// single round trip.
+    async fn append_many(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        entries: &[(String, u64, Bytes)],
+    ) -> Vec<Result<(), String>> {
+        let mut results: Vec<Result<(), String>> = Vec::with_capacity(entries.len());
+        let mut failed_keys = std::collections::HashSet::new();
+        for (key, id, value) in entries {
+            // Appending the rest of the entries of a key after a failure would leave a gap
+            let result = if failed_keys.contains(key) {
+                Err(format!("not appended after a previous failure for {key}"))
+            } else {
+                self.append(
+                    svc_name,
+                    api_name,
+                    entity_name,
+                    namespace.clone(),
+                    key,
+                    *id,
+                    value,
+                )
+                .await
+            };
+            if result.is_err() {
+                failed_keys.insert(key);
+            }
+            results.push(result);
+        }
+        results
+    }
+
     /// Gets the number of entries in the index of the given key
     async fn length(
         &self,
@@ -339,6 +377,24 @@ impl<'a, S: ?Sized + IndexedStorage> LabelledEntityIndexedStorage<'a, S> {
             .await
     }
 
+    /// Appends already serialized entries to the indexes of multiple keys, given as
+    /// `(key, id, value)` triples, returning the result of each entry
+    pub async fn append_many_raw(
+        &self,
+        namespace: IndexedStorageNamespace,
+        entries: &[(String, u64, Bytes)],
+    ) -> Vec<Result<(), String>> {
+        self.storage
+            .append_many(
+                self.svc_name,
+                self.api_name,
+                self.entity_name,
+                namespace,
+                entries,
+            )
+            .await
+    }
+
     /// Reads a closed range of entries from the index of the given key, deserializing each entry
     pub async fn read<V: Decode>(
         &self,
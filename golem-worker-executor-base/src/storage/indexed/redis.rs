@@ -17,7 +17,7 @@ use async_trait::async_trait;
 use bytes::Bytes;
 use fred::types::{RedisKey, RedisValue, XCapKind};
 use golem_common::metrics::redis::{record_redis_deserialized_size, record_redis_serialized_size};
-use golem_common::redis::RedisPool;
+use golem_common::redis::{RedisError, RedisPool};
 use std::collections::HashMap;
 use std::time::Duration;
 
@@ -42,6 +42,36 @@ impl RedisIndexedStorage {
 
     const KEY: &'static str = "key";
 
+    /// Appends `(id, value)` pairs given after the field name in `ARGV` to the stream `KEYS[1]`,
+    /// stopping at the first failure. Returns the number of appended entries, and the error of
+    /// the failed one, if any.
+    const APPEND_MANY_SCRIPT: &'static str = r#"
+local appended = 0
+for i = 2, #ARGV, 2 do
+    local result = redis.pcall('XADD', KEYS[1], ARGV[i], ARGV[1], ARGV[i + 1])
+    if type(result) == 'table' and result.err then
+        return {appended, result.err}
+    end
+    appended = appended + 1
+end
+return {appended}
+"#;
+
+    fn parse_append_many_result(result: Result<RedisValue, RedisError>) -> (usize, Option<String>) {
+        match result {
+            Ok(RedisValue::Array(values)) => {
+                let appended = values
+                    .first()
+                    .and_then(|value| value.as_u64())
+                    .unwrap_or_default() as usize;
+                let error = values.get(1).and_then(|value| value.as_string());
+                (appended, error)
+            }
+            Ok(other) => (0, Some(format!("unexpected append result: {other:?}"))),
+            Err(err) => (0, Some(err.to_string())),
+        }
+    }
+
     fn parse_entry_id(id: &str) -> Result<u64, String> {
         if let Some((id, _)) = id.split_once('-') {
             id.parse::<u64>()
@@ -163,6 +193,80 @@ impl IndexedStorage for RedisIndexedStorage {
         Ok(())
     }
 
+    async fn append_many(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: IndexedStorageNamespace,
+        entries: &[(String, u64, Bytes)],
+    ) -> Vec<Result<(), String>> {
+        for (_, _, value) in entries {
+            record_redis_serialized_size(svc_name, entity_name, value.len());
+        }
+
+        // The entries of each key are appended by a single script, which stops at the first
+        // failure, so a later entry can not be appended after a gap
+        let mut keys: Vec<&String> = Vec::new();
+        let mut key_args: HashMap<&String, Vec<RedisValue>> = HashMap::new();
+        for (key, id, value) in entries {
+            let args = key_args.entry(key).or_insert_with(|| {
+                keys.push(key);
+                vec![RedisValue::from(Self::KEY)]
+            });
+            args.push(RedisValue::from(id.to_string()));
+            args.push(RedisValue::Bytes(value.clone()));
+        }
+        let scripts = keys
+            .iter()
+            .map(|key| {
+                (
+                    Self::composite_key(namespace.clone(), key),
+                    key_args.remove(key).unwrap_or_default(),
+                )
+            })
+            .collect::<Vec<_>>();
+
+        let results = self
+            .redis
+            .with(svc_name, api_name)
+            .pipeline_each::<RedisValue, _, _>(|pipeline| async move {
+                for (key, args) in scripts {
+                    pipeline.eval(Self::APPEND_MANY_SCRIPT, key, args).await?;
+                }
+                Ok(pipeline)
+            })
+            .await;
+
+        // Number of appended entries and the error of the first failed one, for each key
+        let mut key_results: HashMap<&String, (usize, Option<String>)> = match results {
+            Ok(results) => keys
+                .iter()
+                .copied()
+                .zip(results.into_iter().map(Self::parse_append_many_result))
+                .collect(),
+            Err(err) => keys
+                .iter()
+                .map(|key| (*key, (0, Some(err.to_string()))))
+                .collect(),
+        };
+
+        entries
+            .iter()
+            .map(|(key, _, _)| match key_results.get_mut(key) {
+                Some((appended, _)) if *appended > 0 => {
+                    *appended -= 1;
+                    Ok(())
+                }
+                Some((_, error)) => match error.take() {
+                    Some(error) => Err(error),
+                    None => Err(format!("not appended after a previous failure for {key}")),
+                },
+                None => Err(format!("no result for {key}")),
+            })
+            .collect()
+    }
+
     async fn length(
         &self,
         svc_name: &'static str,
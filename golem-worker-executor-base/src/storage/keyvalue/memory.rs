@@ -227,6 +227,44 @@ impl KeyValueStorage for InMemoryKeyValueStorage {
         }
     }
 
+    async fn replace_and_move_between_sets(
+        &self,
+        _svc_name: &'static str,
+        _api_name: &'static str,
+        _entity_name: &'static str,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        expected_value: Option<&[u8]>,
+        value: &[u8],
+        source_key: Option<&str>,
+        destination_key: &str,
+        member: &[u8],
+    ) -> Result<bool, String> {
+        // The entry of the value is kept locked until the sets are updated
+        let entry = self.kvs.entry(Self::composite_key(&namespace, key));
+        let current_value = match &entry {
+            Entry::Occupied(entry) => Some(entry.get().as_slice()),
+            Entry::Vacant(_) => None,
+        };
+        if current_value != expected_value {
+            return Ok(false);
+        }
+        if let Some(source_key) = source_key {
+            if let Some(mut set) = self
+                .sets
+                .get_mut(&Self::composite_key(&namespace, source_key))
+            {
+                set.value_mut().remove(member);
+            }
+        }
+        self.sets
+            .entry(Self::composite_key(&namespace, destination_key))
+            .or_default()
+            .insert(member.to_vec());
+        entry.insert(value.to_vec());
+        Ok(true)
+    }
+
     async fn members_of_set(
         &self,
         _svc_name: &'static str,
@@ -245,6 +283,36 @@ impl KeyValueStorage for InMemoryKeyValueStorage {
         }
     }
 
+    async fn scan_set(
+        &self,
+        _svc_name: &'static str,
+        _api_name: &'static str,
+        _entity_name: &'static str,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        cursor: u64,
+        count: u64,
+    ) -> Result<(u64, Vec<Bytes>), String> {
+        // The cursor is the number of members already returned, in their sorted order
+        let mut members = match self.sets.get(&Self::composite_key(&namespace, key)) {
+            Some(entry) => entry.value().iter().map(|v| v.clone()).collect::<Vec<_>>(),
+            None => Vec::new(),
+        };
+        members.sort();
+
+        let start = (cursor as usize).min(members.len());
+        let end = start.saturating_add(count as usize).min(members.len());
+        let next_cursor = if end == members.len() { 0 } else { end as u64 };
+        Ok((
+            next_cursor,
+            members[start..end]
+                .iter()
+                .cloned()
+                .map(Bytes::from)
+                .collect(),
+        ))
+    }
+
     async fn add_to_sorted_set(
         &self,
         _svc_name: &'static str,
@@ -319,3 +387,96 @@ impl KeyValueStorage for InMemoryKeyValueStorage {
         }
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use crate::storage::keyvalue::{KeyValueStorageLabelledApi, KeyValueStorageNamespace};
+    use assert2::check;
+
+    #[tokio::test]
+    async fn scan_set_pages() {
+        let storage = super::InMemoryKeyValueStorage::new();
+        let api = storage.with_entity("test", "test", "test");
+        let key = "key";
+
+        for value in 0..5u64 {
+            api.add_to_set(KeyValueStorageNamespace::Worker, key, &value)
+                .await
+                .unwrap();
+        }
+
+        let mut cursor = 0;
+        let mut pages: Vec<Vec<u64>> = Vec::new();
+        loop {
+            let (next_cursor, page) = api
+                .scan_set(KeyValueStorageNamespace::Worker, key, cursor, 2)
+                .await
+                .unwrap();
+            pages.push(page);
+            if next_cursor == 0 {
+                break;
+            }
+            cursor = next_cursor;
+        }
+
+        let mut values = pages.iter().flatten().copied().collect::<Vec<_>>();
+        values.sort();
+
+        check!(pages.iter().map(|page| page.len()).collect::<Vec<_>>() == vec![2, 2, 1]);
+        check!(values == vec![0, 1, 2, 3, 4]);
+    }
+
+    #[tokio::test]
+    async fn scan_missing_set() {
+        let storage = super::InMemoryKeyValueStorage::new();
+        let api = storage.with_entity("test", "test", "test");
+
+        let result: (u64, Vec<u64>) = api
+            .scan_set(KeyValueStorageNamespace::Worker, "missing", 0, 10)
+            .await
+            .unwrap();
+
+        check!(result == (0, vec![]));
+    }
+
+    #[tokio::test]
+    async fn replace_and_move_between_sets_checks_the_replaced_value() {
+        let storage = super::InMemoryKeyValueStorage::new();
+        let api = storage.with_entity("test", "test", "test");
+        let ns = || KeyValueStorageNamespace::Worker;
+        let member = 42u64;
+
+        let added = api
+            .replace_and_move_between_sets(ns(), "key", None, &1u64, None, "a", &member)
+            .await
+            .unwrap();
+        let value = api.get_raw(ns(), "key").await.unwrap().unwrap();
+        let stale = api
+            .replace_and_move_between_sets(ns(), "key", None, &2u64, None, "b", &member)
+            .await
+            .unwrap();
+        let moved = api
+            .replace_and_move_between_sets(
+                ns(),
+                "key",
+                Some(&value[..]),
+                &2u64,
+                Some("a"),
+                "b",
+                &member,
+            )
+            .await
+            .unwrap();
+
+        let in_a: Vec<u64> = api.members_of_set(ns(), "a").await.unwrap();
+        let in_b: Vec<u64> = api.members_of_set(ns(), "b").await.unwrap();
+        let result: Option<u64> = api.get(ns(), "key").await.unwrap();
+
+        check!(added);
+        check!(!stale);
+        check!(moved);
+        check!(in_a == vec![]);
+        check!(in_b == vec![member]);
+        check!(result == Some(2));
+    }
+}
@@ -122,6 +122,25 @@ pub trait KeyValueStorage: Debug {
         value: &[u8],
     ) -> Result<(), String>;
 
+    /// Replaces the value at `key` with `value` if it is still `expected_value`, `None` meaning
+    /// that the key does not exist, and in the same atomic step removes `member` from the set at
+    /// `source_key`, if given, and adds it to the set at `destination_key`. Returns false without
+    /// changing anything if the value at `key` is no longer the expected one.
+    #[allow(clippy::too_many_arguments)]
+    async fn replace_and_move_between_sets(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        expected_value: Option<&[u8]>,
+        value: &[u8],
+        source_key: Option<&str>,
+        destination_key: &str,
+        member: &[u8],
+    ) -> Result<bool, String>;
+
     async fn members_of_set(
         &self,
         svc_name: &'static str,
@@ -131,6 +150,20 @@ pub trait KeyValueStorage: Debug {
         key: &str,
     ) -> Result<Vec<Bytes>, String>;
 
+    /// Returns a page of the members of a set, and the cursor to continue with, which is 0
+    /// when all members were returned. Members present during the whole scan are returned at
+    /// least once.
+    async fn scan_set(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        cursor: u64,
+        count: u64,
+    ) -> Result<(u64, Vec<Bytes>), String>;
+
     async fn add_to_sorted_set(
         &self,
         svc_name: &'static str,
@@ -485,6 +518,35 @@ impl<'a, S: ?Sized + KeyValueStorage> LabelledEntityKeyValueStorage<'a, S> {
             .await
     }
 
+    #[allow(clippy::too_many_arguments)]
+    pub async fn replace_and_move_between_sets<V: Encode, M: Encode>(
+        &self,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        expected_value: Option<&[u8]>,
+        value: &V,
+        source_key: Option<&str>,
+        destination_key: &str,
+        member: &M,
+    ) -> Result<bool, String> {
+        let serialized_value = serialize(value)?;
+        let serialized_member = serialize(member)?;
+        self.storage
+            .replace_and_move_between_sets(
+                self.svc_name,
+                self.api_name,
+                self.entity_name,
+                namespace,
+                key,
+                expected_value,
+                &serialized_value,
+                source_key,
+                destination_key,
+                &serialized_member,
+            )
+            .await
+    }
+
     pub async fn members_of_set<V: Decode>(
         &self,
         namespace: KeyValueStorageNamespace,
@@ -508,6 +570,33 @@ impl<'a, S: ?Sized + KeyValueStorage> LabelledEntityKeyValueStorage<'a, S> {
         Ok(values)
     }
 
+    pub async fn scan_set<V: Decode>(
+        &self,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        cursor: u64,
+        count: u64,
+    ) -> Result<(u64, Vec<V>), String> {
+        let (cursor, maybe_bytes) = self
+            .storage
+            .scan_set(
+                self.svc_name,
+                self.api_name,
+                self.entity_name,
+                namespace,
+                key,
+                cursor,
+                count,
+            )
+            .await?;
+        let mut values = Vec::new();
+        for bytes in maybe_bytes {
+            let value: V = deserialize(&bytes)?;
+            values.push(value);
+        }
+        Ok((cursor, values))
+    }
+
     pub async fn add_to_sorted_set<V: Encode>(
         &self,
         namespace: KeyValueStorageNamespace,
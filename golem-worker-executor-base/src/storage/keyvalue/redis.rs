@@ -14,7 +14,7 @@
 
 use async_trait::async_trait;
 use bytes::Bytes;
-use fred::types::SetOptions;
+use fred::types::{RedisValue, SetOptions};
 use std::collections::HashMap;
 
 use golem_common::metrics::redis::{record_redis_deserialized_size, record_redis_serialized_size};
@@ -32,6 +32,36 @@ impl RedisKeyValueStorage {
         Self { redis }
     }
 
+    /// Replaces the value at `KEYS[1]`, or at its hash field `ARGV[1]` if that is not empty, with
+    /// `ARGV[4]` if it is still `ARGV[3]`, or missing if `ARGV[2]` is `0`, and moves the member
+    /// `ARGV[5]` from the set `KEYS[3]`, if given, to the set `KEYS[2]`. Returns 1 if the value
+    /// was replaced, and 0 without changing anything otherwise.
+    const REPLACE_AND_MOVE_BETWEEN_SETS_SCRIPT: &'static str = r#"
+local current
+if ARGV[1] == '' then
+    current = redis.call('GET', KEYS[1])
+else
+    current = redis.call('HGET', KEYS[1], ARGV[1])
+end
+if ARGV[2] == '1' then
+    if current ~= ARGV[3] then
+        return 0
+    end
+elseif current then
+    return 0
+end
+if ARGV[1] == '' then
+    redis.call('SET', KEYS[1], ARGV[4])
+else
+    redis.call('HSET', KEYS[1], ARGV[1], ARGV[4])
+end
+if KEYS[3] then
+    redis.call('SREM', KEYS[3], ARGV[5])
+end
+redis.call('SADD', KEYS[2], ARGV[5])
+return 1
+"#;
+
     fn use_hash(namespace: &KeyValueStorageNamespace) -> Option<String> {
         match namespace {
             KeyValueStorageNamespace::Worker => None,
@@ -320,6 +350,51 @@ impl KeyValueStorage for RedisKeyValueStorage {
             .map_err(|e| e.to_string())
     }
 
+    async fn replace_and_move_between_sets(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        expected_value: Option<&[u8]>,
+        value: &[u8],
+        source_key: Option<&str>,
+        destination_key: &str,
+        member: &[u8],
+    ) -> Result<bool, String> {
+        record_redis_serialized_size(svc_name, entity_name, value.len());
+        record_redis_serialized_size(svc_name, entity_name, member.len());
+
+        let (value_key, field) = match Self::use_hash(&namespace) {
+            Some(ns) => (ns, key.to_string()),
+            None => (key.to_string(), String::new()),
+        };
+        let set_key = |key: &str| match Self::use_hash(&namespace) {
+            Some(ns) => format!("{}:{}", ns, key),
+            None => key.to_string(),
+        };
+        let mut keys = vec![value_key, set_key(destination_key)];
+        if let Some(source_key) = source_key {
+            keys.push(set_key(source_key));
+        }
+        let args: Vec<RedisValue> = vec![
+            field.into(),
+            if expected_value.is_some() { "1" } else { "0" }.into(),
+            Bytes::copy_from_slice(expected_value.unwrap_or_default()).into(),
+            Bytes::copy_from_slice(value).into(),
+            Bytes::copy_from_slice(member).into(),
+        ];
+
+        let replaced: i64 = self
+            .redis
+            .with(svc_name, api_name)
+            .eval(Self::REPLACE_AND_MOVE_BETWEEN_SETS_SCRIPT, keys, args)
+            .await
+            .map_err(|e| e.to_string())?;
+        Ok(replaced == 1)
+    }
+
     async fn members_of_set(
         &self,
         svc_name: &'static str,
@@ -346,6 +421,34 @@ impl KeyValueStorage for RedisKeyValueStorage {
         Ok(members)
     }
 
+    async fn scan_set(
+        &self,
+        svc_name: &'static str,
+        api_name: &'static str,
+        entity_name: &'static str,
+        namespace: KeyValueStorageNamespace,
+        key: &str,
+        cursor: u64,
+        count: u64,
+    ) -> Result<(u64, Vec<Bytes>), String> {
+        let key = match Self::use_hash(&namespace) {
+            Some(ns) => format!("{}:{}", ns, key),
+            None => key.to_string(),
+        };
+        let (cursor, members) = self
+            .redis
+            .with(svc_name, api_name)
+            .sscan(&key, cursor, count)
+            .await
+            .map_err(|e| e.to_string())?;
+
+        for member in &members {
+            record_redis_deserialized_size(svc_name, entity_name, member.len());
+        }
+
+        Ok((cursor, members))
+    }
+
     async fn add_to_sorted_set(
         &self,
         svc_name: &'static str,
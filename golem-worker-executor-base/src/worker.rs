@@ -12,9 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use std::collections::{BTreeMap, HashMap, VecDeque};
-use std::ops::DerefMut;
-use std::sync::atomic::{AtomicBool, Ordering};
+use std::collections::{BTreeMap, HashMap, HashSet, VecDeque};
+use std::ops::{Deref, DerefMut};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
 use std::sync::{Arc, RwLock};
 use std::time::Duration;
 
@@ -29,7 +29,8 @@ use wasmtime::{Store, UpdateDeadline};
 
 use golem_common::config::RetryConfig;
 use golem_common::model::oplog::{
-    OplogEntry, OplogIndex, TimestampedUpdateDescription, UpdateDescription, WorkerError,
+    KeyValueWriteBehindRecord, OplogEntry, OplogIndex, TimestampedUpdateDescription,
+    UpdateDescription, WorkerError, WorkerSnapshot,
 };
 use golem_common::model::regions::{DeletedRegions, DeletedRegionsBuilder, OplogRegion};
 use golem_common::model::{
@@ -46,9 +47,10 @@ use crate::services::oplog::{Oplog, OplogOps};
 use crate::services::worker_event::{WorkerEventService, WorkerEventServiceDefault};
 use crate::services::{
     All, HasActiveWorkers, HasAll, HasBlobStoreService, HasComponentService, HasConfig, HasEvents,
-    HasExtraDeps, HasKeyValueService, HasOplog, HasOplogService, HasPromiseService, HasRpc,
-    HasSchedulerService, HasWasmtimeEngine, HasWorker, HasWorkerEnumerationService, HasWorkerProxy,
-    HasWorkerService, UsesAllDeps,
+    HasExtraDeps, HasGuestProfiler, HasHttpConnectionPool, HasInitialFileSystemService,
+    HasKeyValueService, HasOplog, HasOplogService, HasPromiseService, HasRpc, HasSchedulerService,
+    HasWasmtimeEngine, HasWorker, HasWorkerEnumerationService, HasWorkerProxy, HasWorkerService,
+    UsesAllDeps,
 };
 use crate::workerctx::WorkerCtx;
 
@@ -78,10 +80,57 @@ pub struct Worker<Ctx: WorkerCtx> {
     execution_status: Arc<RwLock<ExecutionStatus>>,
     initial_worker_metadata: WorkerMetadata,
     stopping: AtomicBool,
+    /// Oplog index at the last checkpoint, kept across restarts so a failing checkpoint is not
+    /// retried before `checkpoint_interval` new entries are written
+    last_checkpoint_attempt: AtomicU64,
+    /// Number of `WorkerInUse` guards, or `EVICTED` once the worker has been evicted
+    users: AtomicUsize,
 
     running: Arc<Mutex<Option<RunningWorker>>>,
 }
 
+const EVICTED: usize = usize::MAX;
+
+/// A worker obtained from the active workers, which is not evicted while this is held.
+///
+/// Anyone holding a worker can enqueue invocations or updates to it, so the holders are counted
+/// in the worker and `Worker::try_mark_evicted` only succeeds if there are none. Clones of the
+/// inner `Arc` are not counted, so they must not be kept after the guard is dropped.
+pub struct WorkerInUse<Ctx: WorkerCtx> {
+    worker: Arc<Worker<Ctx>>,
+}
+
+impl<Ctx: WorkerCtx> WorkerInUse<Ctx> {
+    /// Starts using the worker, unless it has already been evicted
+    fn try_new(worker: Arc<Worker<Ctx>>) -> Option<Self> {
+        worker
+            .users
+            .fetch_update(Ordering::AcqRel, Ordering::Acquire, |users| {
+                if users == EVICTED {
+                    None
+                } else {
+                    Some(users + 1)
+                }
+            })
+            .ok()?;
+        Some(Self { worker })
+    }
+}
+
+impl<Ctx: WorkerCtx> Deref for WorkerInUse<Ctx> {
+    type Target = Arc<Worker<Ctx>>;
+
+    fn deref(&self) -> &Self::Target {
+        &self.worker
+    }
+}
+
+impl<Ctx: WorkerCtx> Drop for WorkerInUse<Ctx> {
+    fn drop(&mut self) {
+        self.worker.users.fetch_sub(1, Ordering::AcqRel);
+    }
+}
+
 impl<Ctx: WorkerCtx> HasOplog for Worker<Ctx> {
     fn oplog(&self) -> Arc<dyn Oplog + Send + Sync> {
         self.oplog.clone()
@@ -105,33 +154,46 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
         worker_env: Option<Vec<(String, String)>>,
         component_version: Option<u64>,
         parent: Option<WorkerId>,
-    ) -> Result<Arc<Self>, GolemError>
+    ) -> Result<WorkerInUse<Ctx>, GolemError>
     where
         T: HasAll<Ctx> + Clone + Send + Sync + 'static,
     {
-        let this_clone = deps.clone();
-        let owned_worker_id_clone = owned_worker_id.clone();
-
-        let worker_details = deps
-            .active_workers()
-            .get_with(&owned_worker_id.worker_id, || {
-                Box::pin(async move {
-                    Ok(Arc::new(
-                        Self::new(
-                            &this_clone,
-                            owned_worker_id_clone,
-                            worker_args,
-                            worker_env,
-                            component_version,
-                            parent,
-                        )
-                        .in_current_span()
-                        .await?,
-                    ))
+        loop {
+            let this_clone = deps.clone();
+            let owned_worker_id_clone = owned_worker_id.clone();
+            let worker_args = worker_args.clone();
+            let worker_env = worker_env.clone();
+            let parent = parent.clone();
+
+            let worker_details = deps
+                .active_workers()
+                .get_with(&owned_worker_id.worker_id, || {
+                    Box::pin(async move {
+                        Ok(Arc::new(
+                            Self::new(
+                                &this_clone,
+                                owned_worker_id_clone,
+                                worker_args,
+                                worker_env,
+                                component_version,
+                                parent,
+                            )
+                            .in_current_span()
+                            .await?,
+                        ))
+                    })
                 })
-            })
-            .await?;
-        Ok(worker_details)
+                .await?;
+
+            match WorkerInUse::try_new(worker_details) {
+                Some(worker) => return Ok(worker),
+                None => {
+                    // The worker has just been evicted and is being removed from the active
+                    // workers, so the next lookup creates a new instance
+                    tokio::task::yield_now().await;
+                }
+            }
+        }
     }
 
     /// Gets or creates a worker and makes sure it is running
@@ -142,7 +204,7 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
         worker_env: Option<Vec<(String, String)>>,
         component_version: Option<u64>,
         parent: Option<WorkerId>,
-    ) -> Result<Arc<Self>, GolemError>
+    ) -> Result<WorkerInUse<Ctx>, GolemError>
     where
         T: HasAll<Ctx> + Send + Sync + Clone + 'static,
     {
@@ -214,6 +276,8 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
         }));
 
         let stopping = AtomicBool::new(false);
+        let last_checkpoint_attempt = AtomicU64::new(OplogIndex::NONE.into());
+        let users = AtomicUsize::new(0);
 
         Ok(Worker {
             owned_worker_id,
@@ -229,6 +293,8 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
             running,
             execution_status,
             stopping,
+            last_checkpoint_attempt,
+            users,
             initial_worker_metadata: worker_metadata,
         })
     }
@@ -279,6 +345,8 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
                 this.scheduler_service(),
                 this.rpc(),
                 this.worker_proxy(),
+                this.http_connection_pool(),
+                this.initial_file_system_service(),
                 this.extra_deps(),
                 this.config(),
                 WorkerConfig::new(
@@ -287,6 +355,7 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
                     worker_metadata.args.clone(),
                     worker_metadata.env.clone(),
                     worker_metadata.last_known_status.deleted_regions.clone(),
+                    worker_metadata.last_known_status.total_linear_memory_size,
                 ),
                 this.execution_status.clone(),
             )
@@ -295,7 +364,10 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
             let mut store = Store::new(&this.engine(), context);
             store.set_epoch_deadline(this.config().limits.epoch_ticks);
             let worker_id_clone = worker_metadata.worker_id.clone();
+            let guest_profiler = this.guest_profiler();
             store.epoch_deadline_callback(move |mut store| {
+                guest_profiler.sample(&worker_id_clone, &store);
+
                 let current_level = store.get_fuel().unwrap_or(0);
                 if store.data().is_out_of_fuel(current_level as i64) {
                     debug!("{worker_id_clone} ran out of fuel, borrowing more");
@@ -313,15 +385,19 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
 
             store.limiter_async(|ctx| ctx.resource_limiter());
 
-            let instance_pre = this.linker().instantiate_pre(&component).map_err(|e| {
-                GolemError::worker_creation_failed(
-                    this.owned_worker_id.worker_id(),
-                    format!(
-                        "Failed to pre-instantiate worker {}: {e}",
-                        this.owned_worker_id
-                    ),
-                )
-            })?;
+            let instance_pre = this
+                .worker_templates()
+                .get(&component_id, component_version, &component)
+                .await
+                .map_err(|e| {
+                    GolemError::worker_creation_failed(
+                        this.owned_worker_id.worker_id(),
+                        format!(
+                            "Failed to pre-instantiate worker {}: {e}",
+                            this.owned_worker_id
+                        ),
+                    )
+                })?;
 
             let instance = instance_pre
                 .instantiate_async(&mut store)
@@ -390,6 +466,82 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
         })
     }
 
+    /// Returns true if the worker is currently executing an invocation
+    pub fn is_running(&self) -> bool {
+        self.execution_status.read().unwrap().is_running()
+    }
+
+    /// Marks the worker as evicted if it can be dropped from the active workers and stopped,
+    /// returning whether it did.
+    ///
+    /// The worker must be idle, have no pending invocations and must not be in use (see
+    /// `WorkerInUse`). Once marked, it cannot be taken into use anymore. The check is done under
+    /// the worker's lock, so it cannot interleave with starting the worker.
+    pub fn try_mark_evicted(this: &Arc<Worker<Ctx>>) -> bool {
+        match this.running.try_lock() {
+            Ok(_running) => {
+                let is_idle = matches!(
+                    *this.execution_status.read().unwrap(),
+                    ExecutionStatus::Suspended { .. }
+                );
+                is_idle
+                    && this.queue.read().unwrap().is_empty()
+                    && this
+                        .users
+                        .compare_exchange(0, EVICTED, Ordering::AcqRel, Ordering::Acquire)
+                        .is_ok()
+            }
+            Err(_) => false,
+        }
+    }
+
+    /// Checks whether the configured number of oplog entries have been written since both the
+    /// last snapshot of the worker and the last checkpoint attempt.
+    async fn is_checkpoint_due(&self) -> bool {
+        let last_attempt =
+            OplogIndex::from_u64(self.last_checkpoint_attempt.load(Ordering::Acquire));
+        match self.config().oplog.checkpoint_interval {
+            Some(interval) => self
+                .entries_since_last_snapshot(last_attempt)
+                .await
+                .is_some_and(|count| count >= interval),
+            None => false,
+        }
+    }
+
+    /// Counts the oplog entries written since both the last snapshot of the worker and `since`.
+    /// Returns `None` if the worker has pending updates, which must be performed before taking a
+    /// new snapshot.
+    async fn entries_since_last_snapshot(&self, since: OplogIndex) -> Option<u64> {
+        if !self.pending_updates.read().unwrap().is_empty() {
+            return None;
+        }
+        let last_snapshot = self
+            .execution_status
+            .read()
+            .unwrap()
+            .last_known_status()
+            .last_snapshot
+            .as_ref()
+            .map(|snapshot| snapshot.oplog_index)
+            .unwrap_or(OplogIndex::NONE);
+        let since: u64 = last_snapshot.max(since).into();
+        let current: u64 = self.oplog.current_oplog_index().await.into();
+        Some(current.saturating_sub(since))
+    }
+
+    /// Estimated amount of memory the worker needs while it is active, based on the highest
+    /// known total linear memory size of its instance
+    pub fn memory_requirement(&self) -> u64 {
+        let total_linear_memory_size = self
+            .execution_status
+            .read()
+            .unwrap()
+            .last_known_status()
+            .total_linear_memory_size;
+        (total_linear_memory_size as f64 * self.config().memory.worker_estimate_coefficient) as u64
+    }
+
     /// Marks the worker as interrupting - this should eventually make the worker interrupted.
     /// There are several interruption modes but not all of them are supported by all worker
     /// executor implementations.
@@ -494,6 +646,65 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
         }
     }
 
+    /// Invokes a sequence of exported functions and awaits all their results.
+    ///
+    /// The invocations which are not yet completed or pending are executed as a single batch,
+    /// one after the other within the same store access and with a single oplog commit. The
+    /// first failing invocation fails the whole request.
+    ///
+    /// Invocations repeating the idempotency key of an earlier one in the same batch are not
+    /// executed again, they get the result of the first one, like separately sent invocations
+    /// with the same key would.
+    pub async fn invoke_and_await_batch(
+        &self,
+        invocations: Vec<(IdempotencyKey, CallingConvention, String, Vec<Value>)>,
+    ) -> Result<Vec<Vec<Value>>, GolemError> {
+        let mut new_invocations = Vec::new();
+        let mut seen_keys = HashSet::new();
+        for (idempotency_key, calling_convention, full_function_name, function_input) in
+            &invocations
+        {
+            if !seen_keys.insert(idempotency_key) {
+                continue;
+            }
+            match self.lookup_invocation_result(idempotency_key).await {
+                LookupResult::New => new_invocations.push((
+                    idempotency_key.clone(),
+                    full_function_name.clone(),
+                    function_input.clone(),
+                    *calling_convention,
+                )),
+                LookupResult::Interrupted => return Err(InterruptKind::Interrupt.into()),
+                LookupResult::Complete(Err(err)) => return Err(err),
+                LookupResult::Pending | LookupResult::Complete(Ok(_)) => {}
+            }
+        }
+
+        if !new_invocations.is_empty() {
+            self.enqueue_batch(new_invocations).await;
+        }
+
+        let mut results = Vec::new();
+        for (idempotency_key, _, _, _) in &invocations {
+            match self.wait_for_invocation_result(idempotency_key).await {
+                LookupResult::Complete(Ok(output)) => results.push(output),
+                LookupResult::Complete(Err(err)) => return Err(err),
+                LookupResult::Interrupted => return Err(InterruptKind::Interrupt.into()),
+                LookupResult::Pending => {
+                    return Err(GolemError::unknown(
+                        "Unexpected pending result after invoke",
+                    ))
+                }
+                LookupResult::New => {
+                    return Err(GolemError::unknown(
+                        "Unexpected missing result after invoke",
+                    ))
+                }
+            }
+        }
+        Ok(results)
+    }
+
     /// Enqueue attempting an update.
     ///
     /// The update itself is not performed by the invocation queue's processing loop,
@@ -697,30 +908,50 @@ impl<Ctx: WorkerCtx> Worker<Ctx> {
         }
     }
 
+    /// Enqueue invocation of a batch of exported functions
+    async fn enqueue_batch(
+        &self,
+        invocations: Vec<(IdempotencyKey, String, Vec<Value>, CallingConvention)>,
+    ) {
+        let running = self.running.lock().await;
+        match running.as_ref() {
+            Some(running) => {
+                running.enqueue_batch(invocations).await;
+            }
+            None => {
+                drop(running);
+                for (idempotency_key, full_function_name, function_input, calling_convention) in
+                    invocations
+                {
+                    self.enqueue(
+                        idempotency_key,
+                        full_function_name,
+                        function_input,
+                        calling_convention,
+                    )
+                    .await;
+                }
+            }
+        }
+    }
+
     async fn wait_for_invocation_result(&self, key: &IdempotencyKey) -> LookupResult {
         match self.lookup_invocation_result(key).await {
-            LookupResult::Interrupted => LookupResult::Interrupted,
             LookupResult::New | LookupResult::Pending => {
-                self.events()
-                    .wait_for(|event| match event {
-                        Event::InvocationCompleted {
-                            worker_id,
-                            idempotency_key,
-                            result,
-                        } if *worker_id == self.owned_worker_id.worker_id
-                            && idempotency_key == key =>
-                        {
-                            debug!("wait_for_invocation_result: accepting event {:?}", event);
-                            Some(LookupResult::Complete(result.clone()))
-                        }
-                        _ => {
-                            debug!("wait_for_invocation_result: skipping event {:?}", event);
-                            None
-                        }
-                    })
-                    .await
+                let waiter = self
+                    .events()
+                    .subscribe_to_invocation_result(self.owned_worker_id.worker_id(), key.clone());
+                // The invocation may have completed before the waiter got registered
+                match self.lookup_invocation_result(key).await {
+                    LookupResult::New | LookupResult::Pending => {
+                        let result = waiter.wait().await;
+                        debug!("wait_for_invocation_result: received {result:?}");
+                        LookupResult::Complete(result)
+                    }
+                    result => result,
+                }
             }
-            LookupResult::Complete(result) => LookupResult::Complete(result),
+            result => result,
         }
     }
 
@@ -934,6 +1165,41 @@ impl RunningWorker {
         self.enqueue_worker_invocation(invocation).await;
     }
 
+    pub async fn enqueue_batch(
+        &self,
+        invocations: Vec<(IdempotencyKey, String, Vec<Value>, CallingConvention)>,
+    ) {
+        let is_running = self.execution_status.read().unwrap().is_running();
+        let mut timestamped_invocations = Vec::new();
+        for (idempotency_key, full_function_name, function_input, calling_convention) in invocations
+        {
+            let invocation = WorkerInvocation::ExportedFunction {
+                idempotency_key,
+                full_function_name,
+                function_input,
+                calling_convention,
+            };
+            let entry = OplogEntry::pending_worker_invocation(invocation.clone());
+            timestamped_invocations.push(TimestampedWorkerInvocation {
+                timestamp: entry.timestamp(),
+                invocation,
+            });
+            if is_running {
+                self.oplog.add(entry).await;
+            }
+        }
+        if is_running {
+            debug!("Worker is busy, persisting pending invocation batch");
+            self.oplog.commit().await;
+        }
+
+        let count = timestamped_invocations.len();
+        self.queue.write().unwrap().extend(timestamped_invocations);
+        self.sender
+            .send(WorkerCommand::InvocationBatch(count))
+            .unwrap()
+    }
+
     async fn enqueue_worker_invocation(&self, invocation: WorkerInvocation) {
         let entry = OplogEntry::pending_worker_invocation(invocation.clone());
         let timestamped_invocation = TimestampedWorkerInvocation {
@@ -992,226 +1258,215 @@ impl RunningWorker {
         if final_decision == RecoveryDecision::None {
             debug!("Invocation queue loop started");
 
-            // Exits when RunningWorker is dropped
-            while let Some(cmd) = receiver.recv().await {
-                match cmd {
-                    WorkerCommand::Invocation => {
-                        let message = active
-                            .write()
-                            .unwrap()
-                            .pop_front()
-                            .expect("Message should be present");
-                        debug!("Invocation queue processing {message:?}");
-
-                        let mut store_mutex = store.lock().await;
-                        let store = store_mutex.deref_mut();
-
-                        match message.invocation {
-                            WorkerInvocation::ExportedFunction {
-                                idempotency_key: invocation_key,
-                                full_function_name,
-                                function_input,
-                                calling_convention,
-                            } => {
-                                let span = span!(
-                                    Level::INFO,
-                                    "invocation",
-                                    worker_id = owned_worker_id.worker_id.to_string(),
-                                    idempotency_key = invocation_key.to_string(),
-                                    function = full_function_name
-                                );
-                                let do_break = async {
-                                    store
-                                        .data_mut()
-                                        .set_current_idempotency_key(invocation_key)
-                                        .await;
+            let supports_checkpoints = parent.config().oplog.checkpoint_interval.is_some() && {
+                let mut store = store.lock().await;
+                let mut exports = instance.exports(&mut *store);
+                exports.instance("golem:api/save-snapshot@0.2.0").is_some()
+                    && exports.instance("golem:api/load-snapshot@0.2.0").is_some()
+            };
+
+            loop {
+                // Exits when RunningWorker is dropped
+                let Some(cmd) = receiver.recv().await else {
+                    break;
+                };
+                let (count, batched) = match cmd {
+                    WorkerCommand::Invocation => (1, false),
+                    WorkerCommand::InvocationBatch(count) => (count, true),
+                    WorkerCommand::Interrupt(kind) => {
+                        match kind {
+                            InterruptKind::Restart | InterruptKind::Jump => {
+                                final_decision = RecoveryDecision::Immediate;
+                            }
+                            _ => {
+                                final_decision = RecoveryDecision::None;
+                            }
+                        }
+                        break;
+                    }
+                };
 
-                                    if let Some(idempotency_key) =
-                                        &store.data().get_current_idempotency_key().await
-                                    {
-                                        store
-                                            .data_mut()
-                                            .get_public_state()
-                                            .worker()
-                                            .store_invocation_resuming(idempotency_key)
-                                            .await;
-                                    }
+                let mut store_mutex = store.lock().await;
+                let store = store_mutex.deref_mut();
 
-                                    // Make sure to update the pending invocation queue in the status record before
-                                    // the invocation writes the invocation start oplog entry
-                                    store.data_mut().update_pending_invocations().await;
-
-                                    let result = invoke_worker(
-                                        full_function_name.clone(),
-                                        function_input.clone(),
-                                        store,
-                                        &instance,
-                                        calling_convention,
-                                        true, // We are always in live mode at this point
-                                    )
+                if batched {
+                    // The invocations of a batch are committed to the oplog together
+                    store.data_mut().on_invocation_batch_started();
+                }
+
+                let mut do_break = false;
+                for _ in 0..count {
+                    let message = active
+                        .write()
+                        .unwrap()
+                        .pop_front()
+                        .expect("Message should be present");
+                    debug!("Invocation queue processing {message:?}");
+
+                    do_break = match message.invocation {
+                        WorkerInvocation::ExportedFunction {
+                            idempotency_key: invocation_key,
+                            full_function_name,
+                            function_input,
+                            calling_convention,
+                        } => {
+                            let span = span!(
+                                Level::INFO,
+                                "invocation",
+                                worker_id = owned_worker_id.worker_id.to_string(),
+                                idempotency_key = invocation_key.to_string(),
+                                function = full_function_name
+                            );
+                            async {
+                                store
+                                    .data_mut()
+                                    .set_current_idempotency_key(invocation_key)
                                     .await;
 
-                                    match result {
-                                        Ok(InvokeResult::Succeeded {
-                                            output,
-                                            consumed_fuel,
-                                        }) => {
-                                            store
-                                                .data_mut()
-                                                .on_invocation_success(
-                                                    &full_function_name,
-                                                    &function_input,
-                                                    consumed_fuel,
-                                                    output,
-                                                )
-                                                .await
-                                                .unwrap(); // TODO: handle this error
-                                            false // do not break
-                                        }
-                                        _ => {
-                                            let trap_type = match result {
-                                                Ok(invoke_result) => {
-                                                    invoke_result.as_trap_type::<Ctx>()
-                                                }
-                                                Err(error) => Some(TrapType::from_error::<Ctx>(
-                                                    &anyhow!(error),
-                                                )),
-                                            };
-                                            let decision = match trap_type {
-                                                Some(trap_type) => {
-                                                    store
-                                                        .data_mut()
-                                                        .on_invocation_failure(&trap_type)
-                                                        .await
-                                                }
-                                                None => RecoveryDecision::None,
-                                            };
-
-                                            final_decision = decision;
-                                            true // break
-                                        }
-                                    }
+                                if let Some(idempotency_key) =
+                                    &store.data().get_current_idempotency_key().await
+                                {
+                                    store
+                                        .data_mut()
+                                        .get_public_state()
+                                        .worker()
+                                        .store_invocation_resuming(idempotency_key)
+                                        .await;
                                 }
-                                .instrument(span)
+
+                                // Make sure to update the pending invocation queue in the status record before
+                                // the invocation writes the invocation start oplog entry
+                                store.data_mut().update_pending_invocations().await;
+
+                                let result = invoke_worker(
+                                    full_function_name.clone(),
+                                    function_input.clone(),
+                                    store,
+                                    &instance,
+                                    calling_convention,
+                                    true, // We are always in live mode at this point
+                                )
                                 .await;
-                                if do_break {
-                                    break;
-                                }
-                            }
-                            WorkerInvocation::ManualUpdate { target_version } => {
-                                let span = span!(
-                                    Level::INFO,
-                                    "manual_update",
-                                    worker_id = owned_worker_id.worker_id.to_string(),
-                                    target_version = target_version.to_string()
-                                );
-                                let do_break = async {
-                                    let _idempotency_key = {
-                                        let ctx = store.data_mut();
-                                        let idempotency_key = IdempotencyKey::fresh();
-                                        ctx.set_current_idempotency_key(idempotency_key.clone())
-                                            .await;
-                                        idempotency_key
-                                    };
-                                    store.data_mut().begin_call_snapshotting_function();
-                                    let result = invoke_worker(
-                                        "golem:api/save-snapshot@0.2.0.{save}".to_string(),
-                                        vec![],
-                                        store,
-                                        &instance,
-                                        CallingConvention::Component,
-                                        true,
-                                    )
-                                        .await;
-                                    store.data_mut().end_call_snapshotting_function();
 
-                                    match result {
-                                        Ok(InvokeResult::Succeeded { output, .. }) =>
-                                            if let Some(bytes) = Self::decode_snapshot_result(output) {
-                                                match store
+                                match result {
+                                    Ok(InvokeResult::Succeeded {
+                                        output,
+                                        consumed_fuel,
+                                    }) => {
+                                        match store
+                                            .data_mut()
+                                            .on_invocation_success(
+                                                &full_function_name,
+                                                &function_input,
+                                                consumed_fuel,
+                                                output,
+                                            )
+                                            .await
+                                        {
+                                            Ok(()) => false, // do not break
+                                            Err(error) => {
+                                                // Failing to record the result fails this invocation and
+                                                // stops processing the rest of the batch
+                                                warn!(
+                                                    "Failed to record the result of {full_function_name}: {error}"
+                                                );
+                                                let trap_type = TrapType::Error(
+                                                    WorkerError::Unknown(error.to_string()),
+                                                );
+                                                final_decision = store
                                                     .data_mut()
-                                                    .get_public_state()
-                                                    .oplog()
-                                                    .create_snapshot_based_update_description(
-                                                        target_version,
-                                                        &bytes,
-                                                    )
-                                                    .await
-                                                {
-                                                    Ok(update_description) => {
-                                                        // Enqueue the update
-                                                        parent.enqueue_update(update_description).await;
-
-                                                        // Make sure to update the pending updates queue
-                                                        store.data_mut().update_pending_updates().await;
-
-                                                        // Reactivate the worker
-                                                        final_decision = RecoveryDecision::Immediate;
-
-                                                        // Stop processing the queue to avoid race conditions
-                                                        true
-                                                    }
-                                                    Err(error) => {
-                                                        Self::fail_update(target_version, format!("failed to store the snapshot for manual update: {error}"), store).await;
-                                                        false
-                                                    }
-                                                }
-                                            } else {
-                                                Self::fail_update(target_version, "failed to get a snapshot for manual update: invalid snapshot result".to_string(), store).await;
-                                                false
-                                            },
-                                        Ok(InvokeResult::Failed { error, .. }) => {
-                                            Self::fail_update(
-                                                target_version,
-                                                format!("failed to get a snapshot for manual update: {error}"),
-                                                store,
-                                            ).await;
-                                            false
-                                        }
-                                        Ok(InvokeResult::Exited { .. }) => {
-                                            Self::fail_update(
-                                                target_version,
-                                                "failed to get a snapshot for manual update: it called exit".to_string(),
-                                                store,
-                                            ).await;
-                                            false
-                                        }
-                                        Ok(InvokeResult::Interrupted { interrupt_kind, .. }) => {
-                                            Self::fail_update(
-                                                target_version,
-                                                format!("failed to get a snapshot for manual update: {interrupt_kind:?}"),
-                                                store,
-                                            ).await;
-                                            false
-                                        }
-                                        Err(error) => {
-                                            Self::fail_update(
-                                                target_version,
-                                                format!("failed to get a snapshot for manual update: {error:?}"),
-                                                store,
-                                            ).await;
-                                            false
+                                                    .on_invocation_failure(&trap_type)
+                                                    .await;
+                                                true // break
+                                            }
                                         }
                                     }
-                                }.instrument(span).await;
-                                if do_break {
-                                    break;
+                                    _ => {
+                                        let trap_type = match result {
+                                            Ok(invoke_result) => {
+                                                invoke_result.as_trap_type::<Ctx>()
+                                            }
+                                            Err(error) => {
+                                                Some(TrapType::from_error::<Ctx>(&anyhow!(error)))
+                                            }
+                                        };
+                                        let decision = match trap_type {
+                                            Some(trap_type) => {
+                                                store
+                                                    .data_mut()
+                                                    .on_invocation_failure(&trap_type)
+                                                    .await
+                                            }
+                                            None => RecoveryDecision::None,
+                                        };
+
+                                        final_decision = decision;
+                                        true // break
+                                    }
                                 }
                             }
+                            .instrument(span)
+                            .await
                         }
-                    }
-                    WorkerCommand::Interrupt(kind) => {
-                        match kind {
-                            InterruptKind::Restart | InterruptKind::Jump => {
+                        WorkerInvocation::ManualUpdate { target_version } => {
+                            let span = span!(
+                                Level::INFO,
+                                "manual_update",
+                                worker_id = owned_worker_id.worker_id.to_string(),
+                                target_version = target_version.to_string()
+                            );
+                            let enqueued = Self::save_snapshot_and_enqueue_update(
+                                target_version,
+                                &parent,
+                                store,
+                                &instance,
+                            )
+                            .instrument(span)
+                            .await;
+                            if enqueued {
+                                // Reactivate the worker
                                 final_decision = RecoveryDecision::Immediate;
                             }
-                            _ => {
-                                final_decision = RecoveryDecision::None;
-                            }
+                            // Stop processing the queue to avoid race conditions
+                            enqueued
                         }
+                    };
+                    if do_break {
                         break;
                     }
                 }
+
+                if batched {
+                    store.data_mut().on_invocation_batch_finished().await;
+                }
+
+                // Checkpointing only when the queue is drained, so it does not delay invocations
+                if !do_break
+                    && supports_checkpoints
+                    && active.read().unwrap().is_empty()
+                    && parent.is_checkpoint_due().await
+                {
+                    let span = span!(
+                        Level::INFO,
+                        "checkpoint",
+                        worker_id = owned_worker_id.worker_id.to_string(),
+                    );
+                    let current_oplog_index = parent.oplog.current_oplog_index().await;
+                    parent
+                        .last_checkpoint_attempt
+                        .store(current_oplog_index.into(), Ordering::Release);
+                    // The worker keeps running, only its next recovery starts from the snapshot
+                    if !Self::save_snapshot(store, &instance).instrument(span).await {
+                        // A failed save-snapshot call may leave the instance unusable, so the
+                        // worker is restarted and recovered by replaying its oplog
+                        final_decision = RecoveryDecision::Immediate;
+                        do_break = true;
+                    }
+                }
+
+                if do_break {
+                    break;
+                }
             }
             debug!("Invocation queue loop for finished");
         }
@@ -1238,6 +1493,112 @@ impl RunningWorker {
         }
     }
 
+    /// Saves a snapshot of the worker's state and enqueues a snapshot based update to the
+    /// given version. Returns whether the update was enqueued, in which case the worker has to
+    /// be restarted to perform it.
+    async fn save_snapshot_and_enqueue_update<Ctx: WorkerCtx>(
+        target_version: ComponentVersion,
+        parent: &Arc<Worker<Ctx>>,
+        store: &mut Store<Ctx>,
+        instance: &wasmtime::component::Instance,
+    ) -> bool {
+        match Self::call_save_snapshot(store, instance).await {
+            Ok(bytes) => {
+                match store
+                    .data_mut()
+                    .get_public_state()
+                    .oplog()
+                    .create_snapshot_based_update_description(target_version, &bytes)
+                    .await
+                {
+                    Ok(update_description) => {
+                        // Enqueue the update
+                        parent.enqueue_update(update_description).await;
+
+                        // Make sure to update the pending updates queue
+                        store.data_mut().update_pending_updates().await;
+
+                        true
+                    }
+                    Err(error) => {
+                        Self::fail_update(
+                            target_version,
+                            format!("failed to store the snapshot for manual update: {error}"),
+                            store,
+                        )
+                        .await;
+                        false
+                    }
+                }
+            }
+            Err(error) => {
+                Self::fail_update(
+                    target_version,
+                    format!("failed to get a snapshot for manual update: {error}"),
+                    store,
+                )
+                .await;
+                false
+            }
+        }
+    }
+
+    /// Saves a snapshot of the worker's state and records it in the oplog, so the worker is
+    /// recovered from it instead of replaying the entries before it. Returns whether the snapshot
+    /// was recorded; a failure is only logged, the worker keeps running without it.
+    async fn save_snapshot<Ctx: WorkerCtx>(
+        store: &mut Store<Ctx>,
+        instance: &wasmtime::component::Instance,
+    ) -> bool {
+        let result = match Self::call_save_snapshot(store, instance).await {
+            Ok(bytes) => store.data_mut().on_snapshot_saved(&bytes).await,
+            Err(error) => Err(error),
+        };
+        match result {
+            Ok(()) => true,
+            Err(error) => {
+                warn!("Failed to save a snapshot of the worker: {error}");
+                false
+            }
+        }
+    }
+
+    /// Calls the worker's save-snapshot export, returning the snapshot or the reason it failed
+    async fn call_save_snapshot<Ctx: WorkerCtx>(
+        store: &mut Store<Ctx>,
+        instance: &wasmtime::component::Instance,
+    ) -> Result<Vec<u8>, String> {
+        let _idempotency_key = {
+            let ctx = store.data_mut();
+            let idempotency_key = IdempotencyKey::fresh();
+            ctx.set_current_idempotency_key(idempotency_key.clone())
+                .await;
+            idempotency_key
+        };
+        store.data_mut().begin_call_snapshotting_function();
+        let result = invoke_worker(
+            "golem:api/save-snapshot@0.2.0.{save}".to_string(),
+            vec![],
+            store,
+            instance,
+            CallingConvention::Component,
+            true,
+        )
+        .await;
+        store.data_mut().end_call_snapshotting_function();
+
+        match result {
+            Ok(InvokeResult::Succeeded { output, .. }) => Self::decode_snapshot_result(output)
+                .ok_or_else(|| "invalid snapshot result".to_string()),
+            Ok(InvokeResult::Failed { error, .. }) => Err(error.to_string()),
+            Ok(InvokeResult::Exited { .. }) => Err("it called exit".to_string()),
+            Ok(InvokeResult::Interrupted { interrupt_kind, .. }) => {
+                Err(format!("{interrupt_kind:?}"))
+            }
+            Err(error) => Err(format!("{error:?}")),
+        }
+    }
+
     async fn fail_update<Ctx: WorkerCtx>(
         target_version: ComponentVersion,
         error: String,
@@ -1327,6 +1688,8 @@ pub enum RecoveryDecision {
 #[derive(Clone, Debug)]
 enum WorkerCommand {
     Invocation,
+    /// Processes the given number of queued invocations with a single oplog commit
+    InvocationBatch(usize),
     Interrupt(InterruptKind),
 }
 
@@ -1390,6 +1753,7 @@ where
             last_known.component_size,
             &new_entries,
         );
+        let last_snapshot = calculate_last_snapshot(last_known.last_snapshot, &new_entries);
 
         if let Some(TimestampedUpdateDescription {
             oplog_index,
@@ -1408,7 +1772,12 @@ where
             &new_entries,
         );
 
-        let total_linear_memory_size = last_known.total_linear_memory_size; // TODO: recalculate this once we record memory grow events in oplog
+        let total_linear_memory_size =
+            calculate_total_linear_memory_size(last_known.total_linear_memory_size, &new_entries);
+        let key_value_write_behind =
+            calculate_key_value_write_behind(last_known.key_value_write_behind, &new_entries);
+        let clock_snapshot_mode =
+            calculate_clock_snapshot_mode(last_known.clock_snapshot_mode, &new_entries);
 
         let result = WorkerStatusRecord {
             oplog_idx: last_oplog_index,
@@ -1419,11 +1788,14 @@ where
             pending_updates,
             failed_updates,
             successful_updates,
+            last_snapshot,
             invocation_results,
             current_idempotency_key,
             component_version,
             component_size,
             total_linear_memory_size,
+            key_value_write_behind,
+            clock_snapshot_mode,
         };
         Ok(result)
     }
@@ -1510,6 +1882,10 @@ fn calculate_latest_worker_status(
             }
             OplogEntry::FailedUpdate { .. } => {}
             OplogEntry::SuccessfulUpdate { .. } => {}
+            OplogEntry::GrowMemory { .. } => {}
+            OplogEntry::Snapshot { .. } => {}
+            OplogEntry::KeyValueWriteBehind { .. } => {}
+            OplogEntry::ClockSnapshotMode { .. } => {}
         }
     }
     result
@@ -1520,9 +1896,19 @@ fn calculate_deleted_regions(
     entries: &BTreeMap<OplogIndex, OplogEntry>,
 ) -> DeletedRegions {
     let mut builder = DeletedRegionsBuilder::from_regions(initial.into_regions());
-    for entry in entries.values() {
-        if let OplogEntry::Jump { jump, .. } = entry {
-            builder.add(jump.clone());
+    for (oplog_idx, entry) in entries {
+        match entry {
+            OplogEntry::Jump { jump, .. } => {
+                builder.add(jump.clone());
+            }
+            OplogEntry::Snapshot { .. } => {
+                // Everything before the snapshot is replaced by loading it
+                builder.add(OplogRegion {
+                    start: OplogIndex::INITIAL.next(),
+                    end: *oplog_idx,
+                });
+            }
+            _ => {}
         }
     }
     builder.build()
@@ -1667,6 +2053,69 @@ fn calculate_update_fields(
     )
 }
 
+fn calculate_last_snapshot(
+    initial: Option<WorkerSnapshot>,
+    entries: &BTreeMap<OplogIndex, OplogEntry>,
+) -> Option<WorkerSnapshot> {
+    let mut result = initial;
+    for (oplog_idx, entry) in entries {
+        if let OplogEntry::Snapshot { timestamp, payload } = entry {
+            result = Some(WorkerSnapshot {
+                timestamp: *timestamp,
+                oplog_index: *oplog_idx,
+                payload: payload.clone(),
+            });
+        }
+    }
+    result
+}
+
+fn calculate_total_linear_memory_size(
+    initial: u64,
+    entries: &BTreeMap<OplogIndex, OplogEntry>,
+) -> u64 {
+    let mut result = initial;
+    for entry in entries.values() {
+        if let OplogEntry::GrowMemory { delta, .. } = entry {
+            result += *delta;
+        }
+    }
+    result
+}
+
+fn calculate_key_value_write_behind(
+    initial: Option<KeyValueWriteBehindRecord>,
+    entries: &BTreeMap<OplogIndex, OplogEntry>,
+) -> Option<KeyValueWriteBehindRecord> {
+    let mut result = initial;
+    for (oplog_idx, entry) in entries {
+        if let OplogEntry::KeyValueWriteBehind {
+            max_buffered_writes,
+            ..
+        } = entry
+        {
+            result = Some(KeyValueWriteBehindRecord {
+                oplog_index: *oplog_idx,
+                max_buffered_writes: *max_buffered_writes,
+            });
+        }
+    }
+    result
+}
+
+fn calculate_clock_snapshot_mode(
+    initial: Option<OplogIndex>,
+    entries: &BTreeMap<OplogIndex, OplogEntry>,
+) -> Option<OplogIndex> {
+    let mut result = initial;
+    for (oplog_idx, entry) in entries {
+        if let OplogEntry::ClockSnapshotMode { .. } = entry {
+            result = Some(*oplog_idx);
+        }
+    }
+    result
+}
+
 fn calculate_invocation_results(
     invocation_results: HashMap<IdempotencyKey, OplogIndex>,
     current_idempotency_key: Option<IdempotencyKey>,
@@ -25,6 +25,8 @@ use golem_common::model::{
     WorkerMetadata, WorkerStatus, WorkerStatusRecord,
 };
 
+use crate::durable_host::filesystem::initial::InitialFileSystemService;
+use crate::durable_host::http::connection_pool::HttpConnectionPool;
 use crate::error::GolemError;
 use crate::model::{
     CurrentResourceLimits, ExecutionStatus, InterruptKind, LastError, TrapType, WorkerConfig,
@@ -84,6 +86,8 @@ pub trait WorkerCtx:
     /// - `recovery_management`: The service for deciding if a worker should be recovered
     /// - `rpc`: The RPC implementation used for worker to worker communication
     /// - `worker_proyx`: Access to the worker proxy above the worker executor cluster
+    /// - `http_connection_pool`: The connection pool for the outgoing HTTP requests of the workers
+    /// - `initial_file_system_service`: The initial file systems mounted into the workers' root directories
     /// - `extra_deps`: Extra dependencies that are required by this specific worker context
     /// - `config`: The shared worker configuration
     /// - `worker_config`: Configuration for this specific worker
@@ -107,6 +111,8 @@ pub trait WorkerCtx:
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         rpc: Arc<dyn Rpc + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
         extra_deps: Self::ExtraDeps,
         config: Arc<GolemConfig>,
         worker_config: WorkerConfig,
@@ -270,6 +276,15 @@ pub trait InvocationHooks {
         consumed_fuel: i64,
         output: Vec<Value>,
     ) -> Result<(), GolemError>;
+
+    /// Called before a batch of invocations is executed. Until `on_invocation_batch_finished`
+    /// is called, the invocations' oplog entries are not committed one by one, and their
+    /// results are not published.
+    fn on_invocation_batch_started(&mut self);
+
+    /// Called when a batch of invocations has been executed, committing the oplog once and
+    /// publishing the results of the invocations which succeeded
+    async fn on_invocation_batch_finished(&mut self);
 }
 
 #[async_trait]
@@ -287,6 +302,11 @@ pub trait UpdateManagement {
         details: Option<String>,
     );
 
+    /// Called when the worker's save-snapshot export returned a snapshot of its state outside
+    /// of an update. The worker's later recoveries load this snapshot instead of replaying the
+    /// oplog written so far.
+    async fn on_snapshot_saved(&mut self, snapshot: &[u8]) -> Result<(), String>;
+
     /// Called when an update attempt succeeded
     async fn on_worker_update_succeeded(
         &self,
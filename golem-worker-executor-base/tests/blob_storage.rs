@@ -296,6 +296,60 @@ macro_rules! test_blob_storage {
                         ]
                 );
             }
+
+            #[tokio::test]
+            #[tracing::instrument]
+            async fn put_get_large_stream() {
+                use futures::{StreamExt, TryStreamExt};
+
+                let test = $init().await;
+                let storage = test.get_blob_storage();
+                let namespace = $ns();
+
+                let path = Path::new("large-file");
+                // Larger than the default multipart part size, in chunks not aligned to it
+                let data = Bytes::from(
+                    (0..12 * 1024 * 1024 + 3)
+                        .map(|i| (i % 251) as u8)
+                        .collect::<Vec<_>>(),
+                );
+                let chunks = (0..data.len())
+                    .step_by(1024 * 1024 + 7)
+                    .map(|start| {
+                        Ok::<_, String>(
+                            data.slice(start..(start + 1024 * 1024 + 7).min(data.len())),
+                        )
+                    })
+                    .collect::<Vec<_>>();
+
+                storage
+                    .put_stream(
+                        "test-target",
+                        "test-op",
+                        namespace.clone(),
+                        path,
+                        futures::stream::iter(chunks).boxed(),
+                    )
+                    .await
+                    .unwrap();
+
+                let streamed = storage
+                    .get_stream("test-target", "test-op", namespace.clone(), path)
+                    .await
+                    .unwrap()
+                    .unwrap()
+                    .try_collect::<Vec<_>>()
+                    .await
+                    .unwrap()
+                    .concat();
+                let raw = storage
+                    .get_raw("test-target", "test-op", namespace.clone(), path)
+                    .await
+                    .unwrap();
+
+                check!(streamed == data.to_vec());
+                check!(raw == Some(data.clone()));
+            }
         }
     };
 }
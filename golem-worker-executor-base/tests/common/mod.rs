@@ -1,3 +1,5 @@
+mod dependencies;
+
 use anyhow::Error;
 use async_trait::async_trait;
 use ctor::ctor;
@@ -11,13 +13,14 @@ use std::string::FromUtf8Error;
 use std::sync::atomic::{AtomicU16, Ordering};
 use std::sync::{Arc, RwLock, Weak};
 
-use crate::{WorkerExecutorPerTestDependencies, BASE_DEPS};
+use dependencies::{WorkerExecutorPerTestDependencies, BASE_DEPS};
 
 use golem_api_grpc::proto::golem::workerexecutor::worker_executor_client::WorkerExecutorClient;
 
+use golem_common::model::oplog::{OplogEntry, OplogIndex};
 use golem_common::model::{
-    AccountId, ComponentId, ComponentVersion, IdempotencyKey, OwnedWorkerId, ScanCursor,
-    WorkerFilter, WorkerId, WorkerMetadata, WorkerStatus, WorkerStatusRecord,
+    AccountId, CallingConvention, ComponentId, ComponentVersion, IdempotencyKey, OwnedWorkerId,
+    ScanCursor, WorkerFilter, WorkerId, WorkerMetadata, WorkerStatus, WorkerStatusRecord,
 };
 use golem_worker_executor_base::error::GolemError;
 use golem_worker_executor_base::services::golem_config::{
@@ -27,9 +30,12 @@ use golem_worker_executor_base::services::golem_config::{
     WorkerServiceGrpcConfig,
 };
 
+use golem_worker_executor_base::durable_host::filesystem::initial::InitialFileSystemService;
+use golem_worker_executor_base::durable_host::http::connection_pool::HttpConnectionPool;
 use golem_worker_executor_base::durable_host::{
     DurableWorkerCtx, DurableWorkerCtxView, PublicDurableWorkerState,
 };
+use golem_worker_executor_base::grpc::WorkerExecutorImpl;
 use golem_worker_executor_base::model::{
     CurrentResourceLimits, ExecutionStatus, InterruptKind, LastError, TrapType, WorkerConfig,
 };
@@ -45,7 +51,7 @@ use golem_worker_executor_base::services::shard_manager::ShardManagerService;
 use golem_worker_executor_base::services::worker::WorkerService;
 use golem_worker_executor_base::services::worker_activator::WorkerActivator;
 use golem_worker_executor_base::services::worker_event::WorkerEventService;
-use golem_worker_executor_base::services::{All, HasAll};
+use golem_worker_executor_base::services::{All, HasAll, HasOplogService};
 use golem_worker_executor_base::wasi_host::create_linker;
 use golem_worker_executor_base::workerctx::{
     ExternalOperations, FuelManagement, IndexedResourceStore, InvocationHooks,
@@ -59,6 +65,7 @@ use tokio::task::JoinHandle;
 
 use golem::api;
 use golem_common::config::RedisConfig;
+use golem_common::serialization::serialize;
 
 use golem_api_grpc::proto::golem::workerexecutor::{
     get_running_workers_metadata_response, get_workers_metadata_response,
@@ -72,8 +79,9 @@ use golem_test_framework::components::redis_monitor::RedisMonitor;
 use golem_test_framework::components::shard_manager::ShardManager;
 use golem_test_framework::components::worker_executor_cluster::WorkerExecutorCluster;
 use golem_test_framework::config::TestDependencies;
-use golem_test_framework::dsl::to_worker_metadata;
+use golem_test_framework::dsl::{to_worker_metadata, TestDsl};
 use golem_worker_executor_base::preview2::golem;
+use golem_worker_executor_base::profiling::GuestProfiler;
 use golem_worker_executor_base::services::events::Events;
 use golem_worker_executor_base::services::rpc::{
     DirectWorkerInvocationRpc, RemoteInvocationRpc, Rpc,
@@ -82,6 +90,7 @@ use golem_worker_executor_base::services::worker_enumeration::{
     RunningWorkerEnumerationService, WorkerEnumerationService,
 };
 use golem_worker_executor_base::services::worker_proxy::WorkerProxy;
+use golem_worker_executor_base::services::worker_template::WorkerTemplates;
 use golem_worker_executor_base::worker::{RecoveryDecision, Worker};
 use tonic::transport::Channel;
 use tracing::{debug, error, info};
@@ -272,6 +281,14 @@ impl TestContext {
 }
 
 pub async fn start(context: &TestContext) -> anyhow::Result<TestWorkerExecutor> {
+    start_customized(context, |_| {}).await
+}
+
+/// Starts a worker executor with a configuration modified by `customize`
+pub async fn start_customized(
+    context: &TestContext,
+    customize: impl FnOnce(&mut GolemConfig),
+) -> anyhow::Result<TestWorkerExecutor> {
     let redis = BASE_DEPS.redis();
     let redis_monitor = BASE_DEPS.redis_monitor();
     redis.assert_valid();
@@ -279,32 +296,8 @@ pub async fn start(context: &TestContext) -> anyhow::Result<TestWorkerExecutor>
     println!("Using Redis on port {}", redis.public_port());
 
     let prometheus = golem_worker_executor_base::metrics::register_all();
-    let config = GolemConfig {
-        key_value_storage: KeyValueStorageConfig::Redis(RedisConfig {
-            port: redis.public_port(),
-            key_prefix: context.redis_prefix(),
-            ..Default::default()
-        }),
-        indexed_storage: IndexedStorageConfig::KVStoreRedis,
-        blob_storage: BlobStorageConfig::LocalFileSystem(LocalFileSystemBlobStorageConfig {
-            root: Path::new("data").to_path_buf(),
-        }),
-        port: context.grpc_port(),
-        http_port: context.http_port(),
-        component_service: ComponentServiceConfig::Local(ComponentServiceLocalConfig {
-            root: Path::new("data/components").to_path_buf(),
-        }),
-        compiled_component_service: CompiledComponentServiceConfig::Enabled(
-            CompiledComponentServiceEnabledConfig {},
-        ),
-        shard_manager_service: ShardManagerServiceConfig::SingleShard,
-        public_worker_api: WorkerServiceGrpcConfig {
-            host: "localhost".to_string(),
-            port: context.grpc_port(),
-            access_token: "03494299-B515-4427-8C37-4C1C915679B7".to_string(),
-        },
-        ..Default::default()
-    };
+    let mut config = test_config(context);
+    customize(&mut config);
 
     let handle = Handle::current();
 
@@ -351,6 +344,162 @@ async fn run(
         .await?)
 }
 
+/// The configuration of a worker executor using the shared Redis with the test's own prefix
+fn test_config(context: &TestContext) -> GolemConfig {
+    let redis = BASE_DEPS.redis();
+    GolemConfig {
+        key_value_storage: KeyValueStorageConfig::Redis(RedisConfig {
+            port: redis.public_port(),
+            key_prefix: context.redis_prefix(),
+            ..Default::default()
+        }),
+        indexed_storage: IndexedStorageConfig::KVStoreRedis,
+        blob_storage: BlobStorageConfig::LocalFileSystem(LocalFileSystemBlobStorageConfig {
+            root: Path::new("data").to_path_buf(),
+        }),
+        port: context.grpc_port(),
+        http_port: context.http_port(),
+        component_service: ComponentServiceConfig::Local(ComponentServiceLocalConfig {
+            root: Path::new("data/components").to_path_buf(),
+        }),
+        compiled_component_service: CompiledComponentServiceConfig::Enabled(
+            CompiledComponentServiceEnabledConfig {},
+        ),
+        shard_manager_service: ShardManagerServiceConfig::SingleShard,
+        public_worker_api: WorkerServiceGrpcConfig {
+            host: "localhost".to_string(),
+            port: context.grpc_port(),
+            access_token: "03494299-B515-4427-8C37-4C1C915679B7".to_string(),
+        },
+        ..Default::default()
+    }
+}
+
+/// The services of a worker executor created in-process, without starting its gRPC and HTTP
+/// servers. Invocations go directly to the `Worker`s, so they include the whole runtime
+/// overhead of an invocation but nothing of the API layer.
+pub struct InProcessWorkerExecutor {
+    services: All<TestWorkerCtx>,
+    deps: WorkerExecutorPerTestDependencies,
+}
+
+impl InProcessWorkerExecutor {
+    pub async fn store_component(&self, name: &str) -> ComponentId {
+        self.deps.store_component(name).await
+    }
+
+    pub async fn start_worker(
+        &self,
+        component_id: &ComponentId,
+        name: &str,
+    ) -> Result<OwnedWorkerId, GolemError> {
+        let owned_worker_id = OwnedWorkerId::new(
+            &AccountId {
+                value: "test-account".to_string(),
+            },
+            &WorkerId {
+                component_id: component_id.clone(),
+                worker_name: name.to_string(),
+            },
+        );
+        Worker::get_or_create_running(&self.services, &owned_worker_id, None, None, None, None)
+            .await?;
+        Ok(owned_worker_id)
+    }
+
+    pub async fn invoke_and_await(
+        &self,
+        owned_worker_id: &OwnedWorkerId,
+        function_name: &str,
+        params: Vec<Value>,
+    ) -> Result<Vec<Value>, GolemError> {
+        let worker =
+            Worker::get_or_create_running(&self.services, owned_worker_id, None, None, None, None)
+                .await?;
+        worker
+            .invoke_and_await(
+                IdempotencyKey::fresh(),
+                CallingConvention::Component,
+                function_name.to_string(),
+                params,
+            )
+            .await
+    }
+
+    /// The index of the last committed entry in the worker's oplog
+    pub async fn last_oplog_index(&self, owned_worker_id: &OwnedWorkerId) -> OplogIndex {
+        self.services
+            .oplog_service()
+            .get_last_index(owned_worker_id)
+            .await
+    }
+
+    /// All the committed entries of the worker's oplog
+    pub async fn oplog_entries(&self, owned_worker_id: &OwnedWorkerId) -> Vec<OplogEntry> {
+        let oplog_service = self.services.oplog_service();
+        let last = oplog_service.get_last_index(owned_worker_id).await;
+        oplog_service
+            .read_range(owned_worker_id, OplogIndex::INITIAL, last)
+            .await
+            .into_values()
+            .collect()
+    }
+
+    /// The total serialized size of the worker's oplog entries following `after`
+    pub async fn oplog_bytes_after(
+        &self,
+        owned_worker_id: &OwnedWorkerId,
+        after: OplogIndex,
+    ) -> u64 {
+        let oplog_service = self.services.oplog_service();
+        let last = oplog_service.get_last_index(owned_worker_id).await;
+        if last <= after {
+            return 0;
+        }
+        oplog_service
+            .read_range(owned_worker_id, after.next(), last)
+            .await
+            .values()
+            .map(|entry| {
+                serialize(entry)
+                    .expect("Failed to serialize oplog entry")
+                    .len() as u64
+            })
+            .sum()
+    }
+}
+
+/// Creates the services of a worker executor in-process, see `InProcessWorkerExecutor`
+pub async fn start_in_process(
+    context: &TestContext,
+    customize: impl FnOnce(&mut GolemConfig),
+) -> anyhow::Result<InProcessWorkerExecutor> {
+    let redis = BASE_DEPS.redis();
+    redis.assert_valid();
+    println!("Using Redis on port {}", redis.public_port());
+
+    let mut config = test_config(context);
+    customize(&mut config);
+
+    let (services, lazy_worker_activator) = ServerBootstrap {}
+        .create_all_services(&config, Handle::current())
+        .await?;
+    // Sets up the worker activator and the shard assignment, the server itself is not started
+    let _ = WorkerExecutorImpl::<TestWorkerCtx, All<TestWorkerCtx>>::new(
+        services.clone(),
+        lazy_worker_activator,
+        config.port,
+    )
+    .await?;
+
+    let deps = BASE_DEPS.per_test(
+        &context.redis_prefix(),
+        context.http_port(),
+        context.grpc_port(),
+    );
+    Ok(InProcessWorkerExecutor { services, deps })
+}
+
 struct TestWorkerCtx {
     durable_ctx: DurableWorkerCtx<TestWorkerCtx>,
 }
@@ -547,6 +696,14 @@ impl InvocationHooks for TestWorkerCtx {
             .on_invocation_success(full_function_name, function_input, consumed_fuel, output)
             .await
     }
+
+    fn on_invocation_batch_started(&mut self) {
+        self.durable_ctx.on_invocation_batch_started()
+    }
+
+    async fn on_invocation_batch_finished(&mut self) {
+        self.durable_ctx.on_invocation_batch_finished().await
+    }
 }
 
 #[async_trait]
@@ -588,6 +745,16 @@ impl UpdateManagement for TestWorkerCtx {
             .await
     }
 
+    /// Workers whose name starts with `failing-snapshot` simulate a failure to store their
+    /// snapshots
+    async fn on_snapshot_saved(&mut self, snapshot: &[u8]) -> Result<(), String> {
+        if self.worker_id().worker_name.starts_with("failing-snapshot") {
+            Err("simulated failure to store the snapshot".to_string())
+        } else {
+            self.durable_ctx.on_snapshot_saved(snapshot).await
+        }
+    }
+
     async fn on_worker_update_succeeded(
         &self,
         target_version: ComponentVersion,
@@ -621,6 +788,8 @@ impl WorkerCtx for TestWorkerCtx {
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         rpc: Arc<dyn Rpc + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
         _extra_deps: Self::ExtraDeps,
         config: Arc<GolemConfig>,
         worker_config: WorkerConfig,
@@ -641,6 +810,8 @@ impl WorkerCtx for TestWorkerCtx {
             scheduler_service,
             rpc,
             worker_proxy,
+            http_connection_pool,
+            initial_file_system_service,
             config,
             worker_config,
             execution_status,
@@ -692,7 +863,12 @@ impl ResourceLimiterAsync for TestWorkerCtx {
             current,
             desired
         );
-        Ok(true)
+        let delta = (desired as u64).saturating_sub(current as u64);
+        if delta > 0 {
+            self.durable_ctx.increase_memory(delta).await
+        } else {
+            Ok(true)
+        }
     }
 
     async fn table_growing(
@@ -721,6 +897,7 @@ impl Bootstrap<TestWorkerCtx> for ServerBootstrap {
             golem_config.limits.max_active_workers,
             golem_config.active_workers.drop_when_full,
             golem_config.active_workers.ttl,
+            golem_config.memory.worker_memory(),
         ))
     }
 
@@ -729,6 +906,7 @@ impl Bootstrap<TestWorkerCtx> for ServerBootstrap {
         active_workers: Arc<ActiveWorkers<TestWorkerCtx>>,
         engine: Arc<Engine>,
         linker: Arc<Linker<TestWorkerCtx>>,
+        worker_templates: Arc<WorkerTemplates<TestWorkerCtx>>,
         runtime: Handle,
         component_service: Arc<dyn ComponentService + Send + Sync>,
         shard_manager_service: Arc<dyn ShardManagerService + Send + Sync>,
@@ -745,12 +923,16 @@ impl Bootstrap<TestWorkerCtx> for ServerBootstrap {
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
         events: Arc<Events>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
+        guest_profiler: Arc<GuestProfiler>,
     ) -> anyhow::Result<All<TestWorkerCtx>> {
         let rpc = Arc::new(DirectWorkerInvocationRpc::new(
             Arc::new(RemoteInvocationRpc::new(worker_proxy.clone())),
             active_workers.clone(),
             engine.clone(),
             linker.clone(),
+            worker_templates.clone(),
             runtime.clone(),
             component_service.clone(),
             worker_service.clone(),
@@ -766,12 +948,16 @@ impl Bootstrap<TestWorkerCtx> for ServerBootstrap {
             scheduler_service.clone(),
             worker_activator.clone(),
             events.clone(),
+            http_connection_pool.clone(),
+            initial_file_system_service.clone(),
+            guest_profiler.clone(),
             (),
         ));
         Ok(All::new(
             active_workers,
             engine,
             linker,
+            worker_templates,
             runtime,
             component_service,
             shard_manager_service,
@@ -789,6 +975,9 @@ impl Bootstrap<TestWorkerCtx> for ServerBootstrap {
             worker_activator,
             worker_proxy,
             events.clone(),
+            http_connection_pool.clone(),
+            initial_file_system_service.clone(),
+            guest_profiler.clone(),
             (),
         ))
     }
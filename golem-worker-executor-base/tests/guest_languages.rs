@@ -17,6 +17,7 @@ use std::collections::HashMap;
 use std::net::SocketAddr;
 
 use chrono::Datelike;
+use golem_common::model::IdempotencyKey;
 use golem_wasm_rpc::Value;
 use http_02::{Response, StatusCode};
 use std::sync::{Arc, Mutex};
@@ -73,6 +74,69 @@ async fn zig_example_3() {
     assert!(result == vec![Value::U64(21)])
 }
 
+#[tokio::test]
+#[tracing::instrument]
+async fn zig_example_3_batch() {
+    let context = TestContext::new();
+    let executor = start(&context).await.unwrap();
+
+    let component_id = executor.store_component("zig-3").await;
+    let worker_id = executor.start_worker(&component_id, "zig-3-batch").await;
+
+    let results = executor
+        .invoke_and_await_batch(
+            &worker_id,
+            vec![
+                ("golem:it/api.{add}", vec![Value::U64(10)]),
+                ("golem:it/api.{add}", vec![Value::U64(11)]),
+                ("golem:it/api.{get}", vec![]),
+            ],
+        )
+        .await
+        .unwrap();
+
+    // Recovering the worker replays the batched invocations one by one
+    executor.simulated_crash(&worker_id).await;
+    let result = executor
+        .invoke_and_await(&worker_id, "golem:it/api.{get}", vec![])
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(results == vec![vec![], vec![], vec![Value::U64(21)]]);
+    check!(result == vec![Value::U64(21)]);
+}
+
+#[tokio::test]
+#[tracing::instrument]
+async fn zig_example_3_batch_with_repeated_key() {
+    let context = TestContext::new();
+    let executor = start(&context).await.unwrap();
+
+    let component_id = executor.store_component("zig-3").await;
+    let worker_id = executor
+        .start_worker(&component_id, "zig-3-batch-repeated-key")
+        .await;
+
+    let key = IdempotencyKey::fresh();
+    let results = executor
+        .invoke_and_await_batch_with_keys(
+            &worker_id,
+            vec![
+                (key.clone(), "golem:it/api.{add}", vec![Value::U64(10)]),
+                (key, "golem:it/api.{add}", vec![Value::U64(10)]),
+                (IdempotencyKey::fresh(), "golem:it/api.{get}", vec![]),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(results == vec![vec![], vec![], vec![Value::U64(10)]]);
+}
+
 #[tokio::test]
 #[tracing::instrument]
 async fn tinygo_example() {
@@ -583,7 +647,10 @@ async fn c_example_4() {
         .await
         .unwrap();
 
+    let metadata = executor.get_worker_metadata(&worker_id).await.unwrap();
+
     drop(executor);
 
     check!(result == vec![Value::U64(0)]);
+    check!(metadata.last_known_status.total_linear_memory_size >= 512 * 1024 * 1024);
 }
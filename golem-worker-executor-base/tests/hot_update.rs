@@ -14,8 +14,10 @@
 
 use crate::common;
 use assert2::check;
+use golem_common::model::oplog::OplogEntry;
 use golem_test_framework::dsl::TestDsl;
 use golem_wasm_rpc::Value;
+use golem_worker_executor_base::services::golem_config::GolemConfig;
 use log::info;
 use std::time::Duration;
 use tokio::spawn;
@@ -467,3 +469,126 @@ async fn manual_update_on_idle_with_failing_load() {
     check!(metadata.last_known_status.failed_updates.len() == 1);
     check!(metadata.last_known_status.successful_updates.is_empty());
 }
+
+#[tokio::test]
+#[tracing::instrument]
+async fn recover_from_checkpoint() {
+    let context = common::TestContext::new();
+    let enable_checkpoints = |config: &mut GolemConfig| {
+        config.oplog.checkpoint_interval = Some(4);
+    };
+    let executor = common::start_in_process(&context, enable_checkpoints)
+        .await
+        .unwrap();
+
+    let component_id = executor.store_component("update-test-v3").await;
+    let worker_id = executor
+        .start_worker(&component_id, "recover_from_checkpoint")
+        .await
+        .unwrap();
+
+    let _ = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:component/api.{set}",
+            vec![Value::U64(42)],
+        )
+        .await
+        .unwrap();
+    // Writing enough oplog entries to trigger checkpoints
+    for _ in 0..4 {
+        let _ = executor
+            .invoke_and_await(&worker_id, "golem:component/api.{get}", vec![])
+            .await
+            .unwrap();
+    }
+
+    let entries = executor.oplog_entries(&worker_id).await;
+
+    // Simulating a crash by recovering the worker on a new executor
+    drop(executor);
+    let executor = common::start_in_process(&context, enable_checkpoints)
+        .await
+        .unwrap();
+
+    let result = executor
+        .invoke_and_await(&worker_id, "golem:component/api.{get}", vec![])
+        .await
+        .unwrap();
+
+    // Explanation: the worker saved snapshots while it was idle, without being restarted or
+    // recording them as updates. The invocation setting the value is before the snapshots and
+    // is skipped by the recovery, so the value can only be restored by loading a snapshot.
+
+    check!(entries
+        .iter()
+        .any(|entry| matches!(entry, OplogEntry::Snapshot { .. })));
+    check!(!entries.iter().any(|entry| matches!(
+        entry,
+        OplogEntry::SuccessfulUpdate { .. }
+            | OplogEntry::FailedUpdate { .. }
+            | OplogEntry::PendingUpdate { .. }
+            | OplogEntry::Jump { .. }
+    )));
+    check!(result == vec![Value::U64(42)]);
+}
+
+#[tokio::test]
+#[tracing::instrument]
+async fn failed_checkpoint() {
+    let context = common::TestContext::new();
+    let enable_checkpoints = |config: &mut GolemConfig| {
+        config.oplog.checkpoint_interval = Some(4);
+    };
+    let executor = common::start_in_process(&context, enable_checkpoints)
+        .await
+        .unwrap();
+
+    let component_id = executor.store_component("update-test-v3").await;
+    let worker_id = executor
+        .start_worker(&component_id, "failing-snapshot-1")
+        .await
+        .unwrap();
+
+    let _ = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:component/api.{set}",
+            vec![Value::U64(42)],
+        )
+        .await
+        .unwrap();
+    // Writing enough oplog entries to trigger checkpoints
+    for _ in 0..4 {
+        let _ = executor
+            .invoke_and_await(&worker_id, "golem:component/api.{get}", vec![])
+            .await
+            .unwrap();
+    }
+
+    let result1 = executor
+        .invoke_and_await(&worker_id, "golem:component/api.{get}", vec![])
+        .await
+        .unwrap();
+    let entries = executor.oplog_entries(&worker_id).await;
+
+    drop(executor);
+    let executor = common::start_in_process(&context, enable_checkpoints)
+        .await
+        .unwrap();
+
+    let result2 = executor
+        .invoke_and_await(&worker_id, "golem:component/api.{get}", vec![])
+        .await
+        .unwrap();
+
+    // Explanation: storing the snapshots fails, which is not recorded as a failed update. The
+    // worker keeps its state, and is recovered by replaying its whole oplog.
+
+    check!(!entries.iter().any(|entry| matches!(
+        entry,
+        OplogEntry::Snapshot { .. } | OplogEntry::FailedUpdate { .. }
+    )));
+    check!(result1 == vec![Value::U64(42)]);
+    check!(result2 == vec![Value::U64(42)]);
+}
@@ -12,10 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use crate::common::{start, TestContext};
+use crate::common::{start, start_customized, TestContext};
 use assert2::check;
 use golem_test_framework::dsl::TestDsl;
 use golem_wasm_rpc::Value;
+use golem_worker_executor_base::services::golem_config::GolemConfig;
 
 #[tokio::test]
 #[tracing::instrument]
@@ -733,3 +734,231 @@ async fn batch_get_keys_returns_multiple_keys() {
             ])]
     );
 }
+
+#[tokio::test]
+#[tracing::instrument]
+async fn write_behind_writes_are_flushed_and_survive_recovery() {
+    let context = TestContext::new();
+    let enable_write_behind = |config: &mut GolemConfig| {
+        config.key_value_write_behind.enabled = true;
+    };
+    let executor = start_customized(&context, enable_write_behind)
+        .await
+        .unwrap();
+
+    let component_id = executor.store_component("key-value-service").await;
+    let worker_name = "key-value-service-write-behind-1";
+    let worker_id_1 = executor.start_worker(&component_id, worker_name).await;
+    let worker_id_2 = executor
+        .start_worker(&component_id, "key-value-service-write-behind-2")
+        .await;
+    let bucket = format!("{component_id}-{worker_name}-bucket");
+
+    for (key, value) in [("key1", 1), ("key1", 2), ("key2", 3)] {
+        let _ = executor
+            .invoke_and_await(
+                &worker_id_1,
+                "golem:it/api.{set}",
+                vec![
+                    Value::String(bucket.clone()),
+                    Value::String(key.to_string()),
+                    Value::List(vec![Value::U8(value)]),
+                ],
+            )
+            .await
+            .unwrap();
+    }
+    let _ = executor
+        .invoke_and_await(
+            &worker_id_1,
+            "golem:it/api.{delete}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key2".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+
+    // The writes of the first worker are visible to the second one once its invocations finished
+    let result1 = executor
+        .invoke_and_await(
+            &worker_id_2,
+            "golem:it/api.{get}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+    let result2 = executor
+        .invoke_and_await(
+            &worker_id_2,
+            "golem:it/api.{exists}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key2".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+    let executor = start_customized(&context, enable_write_behind)
+        .await
+        .unwrap();
+
+    // Replaying the buffered writes and their flushes does not diverge
+    let result3 = executor
+        .invoke_and_await(
+            &worker_id_1,
+            "golem:it/api.{get}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(
+        result1
+            == vec![Value::Option(Some(Box::new(Value::List(vec![Value::U8(
+                2
+            )]))))]
+    );
+    check!(result2 == vec![Value::Bool(false)]);
+    check!(
+        result3
+            == vec![Value::Option(Some(Box::new(Value::List(vec![Value::U8(
+                2
+            )]))))]
+    );
+}
+
+#[tokio::test]
+#[tracing::instrument]
+async fn write_behind_mode_is_kept_on_recovery() {
+    let context = TestContext::new();
+    let executor = start_customized(&context, |config: &mut GolemConfig| {
+        config.key_value_write_behind.enabled = true;
+    })
+    .await
+    .unwrap();
+
+    let component_id = executor.store_component("key-value-service").await;
+    let worker_name = "key-value-service-write-behind-mode-1";
+    let worker_id = executor.start_worker(&component_id, worker_name).await;
+    let bucket = format!("{component_id}-{worker_name}-bucket");
+
+    let _ = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:it/api.{set}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+                Value::List(vec![Value::U8(1)]),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+    let executor = start(&context).await.unwrap();
+
+    // The worker is replayed, and keeps buffering its writes, with the recorded mode
+    let _ = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:it/api.{set}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+                Value::List(vec![Value::U8(2)]),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+    let executor = start(&context).await.unwrap();
+
+    let result = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:it/api.{get}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(
+        result
+            == vec![Value::Option(Some(Box::new(Value::List(vec![Value::U8(
+                2
+            )]))))]
+    );
+}
+
+#[tokio::test]
+#[tracing::instrument]
+async fn direct_writes_are_kept_on_recovery_with_write_behind_enabled() {
+    let context = TestContext::new();
+    let executor = start(&context).await.unwrap();
+
+    let component_id = executor.store_component("key-value-service").await;
+    let worker_name = "key-value-service-write-behind-mode-2";
+    let worker_id = executor.start_worker(&component_id, worker_name).await;
+    let bucket = format!("{component_id}-{worker_name}-bucket");
+
+    let _ = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:it/api.{set}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+                Value::List(vec![Value::U8(1)]),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+    let executor = start_customized(&context, |config: &mut GolemConfig| {
+        config.key_value_write_behind.enabled = true;
+    })
+    .await
+    .unwrap();
+
+    // The oplog has no write-behind entry, so the worker is replayed with direct writes
+    let result = executor
+        .invoke_and_await(
+            &worker_id,
+            "golem:it/api.{get}",
+            vec![
+                Value::String(bucket.clone()),
+                Value::String("key1".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(
+        result
+            == vec![Value::Option(Some(Box::new(Value::List(vec![Value::U8(
+                1
+            )]))))]
+    );
+}
@@ -1,10 +1,12 @@
 use crate::common::{start, TestContext, TestWorkerExecutor};
 use anyhow::anyhow;
+use assert2::check;
 use golem_test_framework::config::TestDependencies;
 use golem_test_framework::dsl::TestDsl;
 use golem_wasm_ast::analysis::AnalysisContext;
 use golem_wasm_ast::component::Component;
 use golem_wasm_ast::IgnoreAllButMetadata;
+use golem_wasm_rpc::Value;
 use humansize::{ISizeFormatter, BINARY};
 use rand::prelude::SliceRandom;
 use rand::thread_rng;
@@ -151,3 +153,56 @@ async fn measure_component(
         Err(anyhow!("No results"))
     }
 }
+
+/// Wasmtime's default copy-on-write memory initialization does not commit the zero-initialized
+/// part of a component's initial linear memory, so running several workers of a component with
+/// a 512 MiB static array must not make the executor resident in anything close to 512 MiB per
+/// worker.
+#[tokio::test]
+#[ignore]
+async fn large_initial_memory_is_not_resident() {
+    const WORKERS: usize = 4;
+    const INITIAL_MEMORY: i64 = 536870912;
+
+    let mut system = System::new_all();
+    let ctx = TestContext::new();
+    let executor = start(&ctx).await.unwrap();
+
+    let component_id = executor.store_component("large-initial-memory").await;
+
+    let pid = Pid::from_u32(std::process::id());
+    system.refresh_process(pid);
+    let before_memory = system.process(pid).unwrap().memory();
+
+    let mut worker_ids = Vec::new();
+    for idx in 0..WORKERS {
+        let worker_id = executor
+            .start_worker(&component_id, &format!("large-initial-memory-{idx}"))
+            .await;
+        let result = executor
+            .invoke_and_await(&worker_id, "run", vec![])
+            .await
+            .unwrap();
+        check!(result == vec![Value::U64(INITIAL_MEMORY as u64)]);
+        worker_ids.push(worker_id);
+    }
+
+    system.refresh_process(pid);
+    let after_memory = system.process(pid).unwrap().memory();
+    let delta_memory = after_memory as i64 - before_memory as i64;
+
+    info!(
+        "{WORKERS} large-initial-memory workers: resident memory {} -> {} ({})",
+        ISizeFormatter::new(before_memory, BINARY),
+        ISizeFormatter::new(after_memory, BINARY),
+        ISizeFormatter::new(delta_memory, BINARY)
+    );
+
+    for worker_id in &worker_ids {
+        executor.delete_worker(worker_id).await;
+    }
+    drop(executor);
+
+    // Every worker only touches the first and the last page of its 512 MiB array
+    check!(delta_memory < INITIAL_MEMORY);
+}
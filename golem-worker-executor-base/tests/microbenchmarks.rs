@@ -0,0 +1,194 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Microbenchmarks of the runtime overhead of single export calls of native (C and Zig) guests.
+//!
+//! The worker executor's services are created in-process and the workers are invoked directly,
+//! so the measurements include the invocation machinery, the lowering and lifting of the
+//! parameters and results, the host functions and the oplog, but nothing of the gRPC stack.
+//! For every call the elapsed time, the number of heap allocations made by the whole process
+//! and the serialized size of the oplog entries it added are recorded.
+//!
+//! Run with `cargo test -p golem-worker-executor-base --test microbenchmarks -- --ignored`.
+//! The results are written in the format of the other benchmarks to
+//! `GOLEM_BENCHMARK_OUTPUT`, or to `benchmark-data/benchmark_microbenchmarks.json` by default.
+//!
+//! The benchmarks are a test target of their own, so the counting global allocator is not
+//! installed in the integration tests.
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Instant;
+
+use golem_common::model::OwnedWorkerId;
+use golem_test_framework::dsl::benchmark::{
+    BenchmarkRecorder, BenchmarkResult, BenchmarkRunResult, RunConfig,
+};
+use golem_wasm_rpc::Value;
+use tracing::info;
+
+use crate::common::{start_in_process, InProcessWorkerExecutor, TestContext};
+
+#[allow(dead_code)]
+mod common;
+
+const WARMUP_CALLS: usize = 20;
+const MEASURED_CALLS: usize = 200;
+
+static ALLOCATIONS: AtomicU64 = AtomicU64::new(0);
+
+/// Counts the allocations of the test process, delegating to the system allocator
+struct CountingAllocator;
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc_zeroed(layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+#[tokio::test]
+#[ignore]
+async fn microbenchmarks() {
+    let context = TestContext::new();
+    let executor = start_in_process(&context, |_| {}).await.unwrap();
+    let recorder = BenchmarkRecorder::new();
+
+    let c_component_id = executor.store_component("c-1").await;
+    let c_worker_id = executor
+        .start_worker(&c_component_id, "microbenchmark-c-1")
+        .await
+        .unwrap();
+    measure(
+        &executor,
+        &recorder,
+        "c-1 run",
+        &c_worker_id,
+        "run",
+        || vec![],
+    )
+    .await;
+    measure(
+        &executor,
+        &recorder,
+        "c-1 print",
+        &c_worker_id,
+        "print",
+        || vec![Value::String("Hello C!".to_string())],
+    )
+    .await;
+
+    let zig_component_id = executor.store_component("zig-3").await;
+    let zig_worker_id = executor
+        .start_worker(&zig_component_id, "microbenchmark-zig-3")
+        .await
+        .unwrap();
+    measure(
+        &executor,
+        &recorder,
+        "zig-3 add",
+        &zig_worker_id,
+        "golem:it/api.{add}",
+        || vec![Value::U64(1)],
+    )
+    .await;
+    measure(
+        &executor,
+        &recorder,
+        "zig-3 get",
+        &zig_worker_id,
+        "golem:it/api.{get}",
+        Vec::new,
+    )
+    .await;
+
+    let run_config = RunConfig {
+        cluster_size: 1,
+        size: 1,
+        length: MEASURED_CALLS,
+    };
+    let mut run_result = BenchmarkRunResult::new();
+    run_result.add(recorder);
+    let result = BenchmarkResult {
+        runs: vec![run_config.clone()],
+        results: vec![(run_config, run_result)],
+    };
+    info!("{}", result.view());
+
+    let output = std::env::var("GOLEM_BENCHMARK_OUTPUT")
+        .unwrap_or("../benchmark-data/benchmark_microbenchmarks.json".to_string());
+    std::fs::write(&output, serde_json::to_string(&result).unwrap()).unwrap();
+    info!("Microbenchmark results written to {output}");
+}
+
+/// Calls `function_name` repeatedly, recording `{name}` (ns/call), `{name} allocations`
+/// and `{name} oplog bytes` for each of the measured calls
+async fn measure(
+    executor: &InProcessWorkerExecutor,
+    recorder: &BenchmarkRecorder,
+    name: &str,
+    worker_id: &OwnedWorkerId,
+    function_name: &str,
+    params: impl Fn() -> Vec<Value>,
+) {
+    for _ in 0..WARMUP_CALLS {
+        executor
+            .invoke_and_await(worker_id, function_name, params())
+            .await
+            .unwrap();
+    }
+
+    let duration_key = name.to_string();
+    let allocations_key = format!("{name} allocations");
+    let oplog_bytes_key = format!("{name} oplog bytes");
+
+    for _ in 0..MEASURED_CALLS {
+        let params = params();
+        let last_oplog_index = executor.last_oplog_index(worker_id).await;
+
+        let allocations_before = ALLOCATIONS.load(Ordering::Relaxed);
+        let start = Instant::now();
+        executor
+            .invoke_and_await(worker_id, function_name, params)
+            .await
+            .unwrap();
+        let elapsed = start.elapsed();
+        let allocations = ALLOCATIONS.load(Ordering::Relaxed) - allocations_before;
+
+        let oplog_bytes = executor
+            .oplog_bytes_after(worker_id, last_oplog_index)
+            .await;
+
+        recorder.duration(&duration_key, elapsed);
+        recorder.count(&allocations_key, allocations);
+        recorder.count(&oplog_bytes_key, oplog_bytes);
+    }
+}
@@ -18,11 +18,12 @@ use std::sync::atomic::AtomicU8;
 use std::sync::{Arc, Mutex};
 use std::time::{Duration, SystemTime};
 
-use crate::common::{start, TestContext};
+use crate::common::{start, start_customized, TestContext};
 use assert2::{assert, check};
 use golem_common::model::WorkerStatus;
 use golem_test_framework::dsl::{stderr_event, stdout_event, worker_error_message, TestDsl};
 use golem_wasm_rpc::Value;
+use golem_worker_executor_base::services::golem_config::GolemConfig;
 use http_02::{Response, StatusCode};
 use tokio::spawn;
 use tokio::time::Instant;
@@ -572,6 +573,100 @@ async fn http_client_response_persisted_between_invocations() {
     );
 }
 
+#[tokio::test]
+#[tracing::instrument]
+async fn clocks_with_snapshot() {
+    let context = TestContext::new();
+    let enable_clock_snapshot = |config: &mut GolemConfig| {
+        config.clock_snapshot.enabled = true;
+    };
+    let executor = start_customized(&context, enable_clock_snapshot)
+        .await
+        .unwrap();
+
+    let component_id = executor.store_component("clocks").await;
+    let worker_id = executor
+        .start_worker(&component_id, "clocks-snapshot-1")
+        .await;
+
+    let result = executor
+        .invoke_and_await(&worker_id, "run", vec![])
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    // Recovering the worker replays the readings from the snapshots
+    let executor = start_customized(&context, enable_clock_snapshot)
+        .await
+        .unwrap();
+    let result2 = executor
+        .invoke_and_await(&worker_id, "run", vec![])
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(result.len() == 1);
+    check!(result2.len() == 1);
+    let Value::Tuple(tuple) = &result[0] else {
+        panic!("expected tuple")
+    };
+    let Value::F64(elapsed1) = &tuple[0] else {
+        panic!("expected f64")
+    };
+    let Value::F64(elapsed2) = &tuple[1] else {
+        panic!("expected f64")
+    };
+
+    let epoch_seconds = SystemTime::now()
+        .duration_since(SystemTime::UNIX_EPOCH)
+        .unwrap()
+        .as_secs_f64();
+    let diff1 = (epoch_seconds - *elapsed1).abs();
+
+    check!(diff1 < 10.0);
+    // The readings after sleeping include the time spent sleeping
+    check!(*elapsed2 >= 2.0);
+    check!(*elapsed2 < 3.0);
+}
+
+#[tokio::test]
+#[tracing::instrument]
+async fn clock_snapshot_mode_is_kept_on_recovery() {
+    let context = TestContext::new();
+    let executor = start_customized(&context, |config: &mut GolemConfig| {
+        config.clock_snapshot.enabled = true;
+    })
+    .await
+    .unwrap();
+
+    let component_id = executor.store_component("clocks").await;
+    let worker_id = executor
+        .start_worker(&component_id, "clocks-snapshot-2")
+        .await;
+
+    let result = executor
+        .invoke_and_await(&worker_id, "run", vec![])
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    // The worker is replayed with the recorded mode, although the executor does not use
+    // clock snapshots
+    let executor = start(&context).await.unwrap();
+    let result2 = executor
+        .invoke_and_await(&worker_id, "run", vec![])
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(result.len() == 1);
+    check!(result2.len() == 1);
+}
+
 #[tokio::test]
 #[tracing::instrument]
 async fn sleep() {
@@ -727,6 +822,82 @@ async fn file_service_write_direct() {
     );
 }
 
+#[tokio::test]
+#[tracing::instrument]
+async fn initial_file_system_is_copied_on_write() {
+    let context = TestContext::new();
+    let images = tempfile::TempDir::new().unwrap();
+    let images_root = images.path().to_path_buf();
+    let executor = start_customized(&context, |config| {
+        config.initial_file_system.enabled = true;
+        config.initial_file_system.root = images_root;
+    })
+    .await
+    .unwrap();
+
+    let component_id = executor.store_unique_component("file-service").await;
+    let image = images.path().join(component_id.to_string()).join("0");
+    std::fs::create_dir_all(&image).unwrap();
+    std::fs::write(image.join("config.txt"), "initial").unwrap();
+
+    let worker_id1 = executor
+        .start_worker(&component_id, "initial-file-system-1")
+        .await;
+    let worker_id2 = executor
+        .start_worker(&component_id, "initial-file-system-2")
+        .await;
+
+    // Opens the shared file for writing through the WASI filesystem API
+    let write_result = executor
+        .invoke_and_await(
+            &worker_id1,
+            "golem:it/api.{write-file-direct}",
+            vec![
+                Value::String("config.txt".to_string()),
+                Value::String("changed".to_string()),
+            ],
+        )
+        .await
+        .unwrap();
+    let read_result1 = executor
+        .invoke_and_await(
+            &worker_id1,
+            "golem:it/api.{read-file}",
+            vec![Value::String("/config.txt".to_string())],
+        )
+        .await
+        .unwrap();
+    let read_result2 = executor
+        .invoke_and_await(
+            &worker_id2,
+            "golem:it/api.{read-file}",
+            vec![Value::String("/config.txt".to_string())],
+        )
+        .await
+        .unwrap();
+
+    drop(executor);
+
+    check!(write_result == vec![Value::Result(Ok(None))]);
+    check!(
+        read_result1
+            == vec![Value::Result(Ok(Some(Box::new(Value::String(
+                "changed".to_string()
+            )))))]
+    );
+    check!(
+        read_result2
+            == vec![Value::Result(Ok(Some(Box::new(Value::String(
+                "initial".to_string()
+            )))))]
+    );
+    check!(std::fs::read_to_string(image.join("config.txt")).unwrap() == "initial");
+    check!(!std::fs::metadata(image.join("config.txt"))
+        .unwrap()
+        .permissions()
+        .readonly());
+}
+
 #[tokio::test]
 #[tracing::instrument]
 async fn filesystem_write_replay_restores_file_times() {
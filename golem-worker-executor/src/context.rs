@@ -26,6 +26,8 @@ use golem_common::model::{
     AccountId, CallingConvention, ComponentVersion, IdempotencyKey, OwnedWorkerId, WorkerId,
     WorkerMetadata, WorkerStatus, WorkerStatusRecord,
 };
+use golem_worker_executor_base::durable_host::filesystem::initial::InitialFileSystemService;
+use golem_worker_executor_base::durable_host::http::connection_pool::HttpConnectionPool;
 use golem_worker_executor_base::durable_host::{
     DurableWorkerCtx, DurableWorkerCtxView, PublicDurableWorkerState,
 };
@@ -220,6 +222,14 @@ impl InvocationHooks for Context {
             .on_invocation_success(full_function_name, function_input, consumed_fuel, output)
             .await
     }
+
+    fn on_invocation_batch_started(&mut self) {
+        self.durable_ctx.on_invocation_batch_started()
+    }
+
+    async fn on_invocation_batch_finished(&mut self) {
+        self.durable_ctx.on_invocation_batch_finished().await
+    }
 }
 
 #[async_trait]
@@ -242,6 +252,10 @@ impl UpdateManagement for Context {
             .await
     }
 
+    async fn on_snapshot_saved(&mut self, snapshot: &[u8]) -> Result<(), String> {
+        self.durable_ctx.on_snapshot_saved(snapshot).await
+    }
+
     async fn on_worker_update_succeeded(
         &self,
         target_version: ComponentVersion,
@@ -297,6 +311,8 @@ impl WorkerCtx for Context {
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         rpc: Arc<dyn Rpc + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
         _extra_deps: Self::ExtraDeps,
         config: Arc<GolemConfig>,
         worker_config: WorkerConfig,
@@ -317,6 +333,8 @@ impl WorkerCtx for Context {
             scheduler_service,
             rpc,
             worker_proxy,
+            http_connection_pool,
+            initial_file_system_service,
             config,
             worker_config,
             execution_status,
@@ -360,11 +378,16 @@ impl WorkerCtx for Context {
 impl ResourceLimiterAsync for Context {
     async fn memory_growing(
         &mut self,
-        _current: usize,
-        _desired: usize,
+        current: usize,
+        desired: usize,
         _maximum: Option<usize>,
     ) -> anyhow::Result<bool> {
-        Ok(true)
+        let delta = (desired as u64).saturating_sub(current as u64);
+        if delta > 0 {
+            self.durable_ctx.increase_memory(delta).await
+        } else {
+            Ok(true)
+        }
     }
 
     async fn table_growing(
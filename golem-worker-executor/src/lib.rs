@@ -15,11 +15,15 @@
 pub mod context;
 pub mod services;
 
+use std::cmp::min;
 use std::sync::Arc;
 
 use async_trait::async_trait;
+use golem_worker_executor_base::durable_host::filesystem::initial::InitialFileSystemService;
+use golem_worker_executor_base::durable_host::http::connection_pool::HttpConnectionPool;
 use golem_worker_executor_base::durable_host::DurableWorkerCtx;
 use golem_worker_executor_base::preview2::golem;
+use golem_worker_executor_base::profiling::GuestProfiler;
 use golem_worker_executor_base::services::active_workers::ActiveWorkers;
 use golem_worker_executor_base::services::blob_store::BlobStoreService;
 use golem_worker_executor_base::services::component::ComponentService;
@@ -38,6 +42,7 @@ use golem_worker_executor_base::services::worker_enumeration::{
     RunningWorkerEnumerationService, WorkerEnumerationService,
 };
 use golem_worker_executor_base::services::worker_proxy::WorkerProxy;
+use golem_worker_executor_base::services::worker_template::WorkerTemplates;
 use golem_worker_executor_base::services::All;
 use golem_worker_executor_base::wasi_host::create_linker;
 use golem_worker_executor_base::Bootstrap;
@@ -54,8 +59,19 @@ struct ServerBootstrap {}
 
 #[async_trait]
 impl Bootstrap<Context> for ServerBootstrap {
-    fn create_active_workers(&self, _golem_config: &GolemConfig) -> Arc<ActiveWorkers<Context>> {
-        Arc::new(ActiveWorkers::<Context>::unbounded())
+    fn create_active_workers(&self, golem_config: &GolemConfig) -> Arc<ActiveWorkers<Context>> {
+        let worker_memory = golem_config.memory.worker_memory();
+        match golem_config.limits.instance_allocation.max_instances() {
+            // With a fixed number of instance slots the least recently used workers are evicted,
+            // returning their slots to the pool
+            Some(max_instances) => Arc::new(ActiveWorkers::<Context>::bounded(
+                min(golem_config.limits.max_active_workers, max_instances),
+                golem_config.active_workers.drop_when_full,
+                golem_config.active_workers.ttl,
+                worker_memory,
+            )),
+            None => Arc::new(ActiveWorkers::<Context>::unbounded(worker_memory)),
+        }
     }
 
     async fn create_services(
@@ -63,6 +79,7 @@ impl Bootstrap<Context> for ServerBootstrap {
         active_workers: Arc<ActiveWorkers<Context>>,
         engine: Arc<Engine>,
         linker: Arc<Linker<Context>>,
+        worker_templates: Arc<WorkerTemplates<Context>>,
         runtime: Handle,
         component_service: Arc<dyn ComponentService + Send + Sync>,
         shard_manager_service: Arc<dyn ShardManagerService + Send + Sync>,
@@ -79,6 +96,9 @@ impl Bootstrap<Context> for ServerBootstrap {
         scheduler_service: Arc<dyn SchedulerService + Send + Sync>,
         worker_proxy: Arc<dyn WorkerProxy + Send + Sync>,
         events: Arc<Events>,
+        http_connection_pool: Arc<HttpConnectionPool>,
+        initial_file_system_service: Arc<InitialFileSystemService>,
+        guest_profiler: Arc<GuestProfiler>,
     ) -> anyhow::Result<All<Context>> {
         let additional_deps = AdditionalDeps {};
 
@@ -87,6 +107,7 @@ impl Bootstrap<Context> for ServerBootstrap {
             active_workers.clone(),
             engine.clone(),
             linker.clone(),
+            worker_templates.clone(),
             runtime.clone(),
             component_service.clone(),
             worker_service.clone(),
@@ -102,6 +123,9 @@ impl Bootstrap<Context> for ServerBootstrap {
             scheduler_service.clone(),
             worker_activator.clone(),
             events.clone(),
+            http_connection_pool.clone(),
+            initial_file_system_service.clone(),
+            guest_profiler.clone(),
             additional_deps.clone(),
         ));
 
@@ -109,6 +133,7 @@ impl Bootstrap<Context> for ServerBootstrap {
             active_workers,
             engine,
             linker,
+            worker_templates,
             runtime.clone(),
             component_service,
             shard_manager_service,
@@ -126,6 +151,9 @@ impl Bootstrap<Context> for ServerBootstrap {
             worker_activator.clone(),
             worker_proxy.clone(),
             events.clone(),
+            http_connection_pool.clone(),
+            initial_file_system_service.clone(),
+            guest_profiler.clone(),
             additional_deps,
         ))
     }
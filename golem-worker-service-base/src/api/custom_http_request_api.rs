@@ -1,7 +1,7 @@
 use std::future::Future;
 use std::sync::Arc;
 
-use crate::api_definition::http::HttpApiDefinition;
+use crate::api_definition::http::DeployedHttpApiDefinition;
 use crate::evaluator::{DefaultEvaluator, Evaluator, WorkerMetadataFetcher};
 use futures_util::FutureExt;
 use hyper::header::HOST;
@@ -9,12 +9,16 @@ use poem::http::StatusCode;
 use poem::{Body, Endpoint, Request, Response};
 use tracing::{error, info};
 
+use crate::api_definition::ApiSiteString;
+use crate::http::http_request::router::RouterCache;
 use crate::http::{ApiInputPath, InputHttpRequest};
 use crate::service::api_definition_lookup::ApiDefinitionsLookup;
 
-use crate::worker_binding::WorkerBindingResolver;
 use crate::worker_bridge_execution::WorkerRequestExecutor;
 
+// Maximum number of API deployments whose routers are kept
+const ROUTER_CACHE_CAPACITY: usize = 1024;
+
 // Executes custom request with the help of worker_request_executor and definition_service
 // This is a common API projects can make use of, similar to healthcheck service
 #[derive(Clone)]
@@ -22,7 +26,8 @@ pub struct CustomHttpRequestApi {
     pub evaluator: Arc<dyn Evaluator + Sync + Send>,
     pub worker_metadata_fetcher: Arc<dyn WorkerMetadataFetcher + Sync + Send>,
     pub api_definition_lookup_service:
-        Arc<dyn ApiDefinitionsLookup<InputHttpRequest, HttpApiDefinition> + Sync + Send>,
+        Arc<dyn ApiDefinitionsLookup<InputHttpRequest, DeployedHttpApiDefinition> + Sync + Send>,
+    pub router_cache: RouterCache,
 }
 
 impl CustomHttpRequestApi {
@@ -30,7 +35,7 @@ impl CustomHttpRequestApi {
         worker_request_executor_service: Arc<dyn WorkerRequestExecutor + Sync + Send>,
         worker_metadata_fetcher: Arc<dyn WorkerMetadataFetcher + Sync + Send>,
         api_definition_lookup_service: Arc<
-            dyn ApiDefinitionsLookup<InputHttpRequest, HttpApiDefinition> + Sync + Send,
+            dyn ApiDefinitionsLookup<InputHttpRequest, DeployedHttpApiDefinition> + Sync + Send,
         >,
     ) -> Self {
         let evaluator = Arc::new(DefaultEvaluator::from_worker_request_executor(
@@ -41,6 +46,7 @@ impl CustomHttpRequestApi {
             evaluator,
             worker_metadata_fetcher,
             api_definition_lookup_service,
+            router_cache: RouterCache::new(ROUTER_CACHE_CAPACITY),
         }
     }
 
@@ -98,7 +104,21 @@ impl CustomHttpRequestApi {
             }
         };
 
-        match api_request.resolve(possible_api_definitions).await {
+        let router = match self
+            .router_cache
+            .get_or_build(&ApiSiteString(host.clone()), possible_api_definitions)
+            .await
+        {
+            Ok(router) => router,
+            Err(err) => {
+                error!("API request host: {} - error: {}", host, err);
+                return Response::builder()
+                    .status(StatusCode::INTERNAL_SERVER_ERROR)
+                    .body(Body::from_string("Internal error".to_string()));
+            }
+        };
+
+        match api_request.resolve_with_router(&router).await {
             Ok(resolved_worker_request) => {
                 resolved_worker_request
                     .execute_with::<poem::Response>(&self.evaluator, &self.worker_metadata_fetcher)
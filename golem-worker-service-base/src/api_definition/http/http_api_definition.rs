@@ -23,6 +23,14 @@ pub struct HttpApiDefinition {
     pub draft: bool,
 }
 
+// An API definition deployed to a site, with the hash of its contents computed when the
+// definition was stored
+#[derive(Debug, Clone, PartialEq)]
+pub struct DeployedHttpApiDefinition {
+    pub definition: HttpApiDefinition,
+    pub content_hash: u64,
+}
+
 impl HasGolemWorkerBindings for HttpApiDefinition {
     fn get_golem_worker_bindings(&self) -> Vec<GolemWorkerBinding> {
         self.routes
@@ -49,10 +49,15 @@ impl ApiInputPath {
 }
 
 pub mod router {
+    use std::sync::Arc;
+
+    use golem_common::cache::{BackgroundEvictionMode, Cache, FullCacheEvictionMode, SimpleCache};
+
     use crate::{
-        api_definition::http::{PathPattern, QueryInfo, Route, VarInfo},
+        api_definition::http::{DeployedHttpApiDefinition, PathPattern, QueryInfo, Route, VarInfo},
+        api_definition::{ApiDefinitionId, ApiSiteString, ApiVersion},
         http::router::{Router, RouterPattern},
-        worker_binding::GolemWorkerBinding,
+        worker_binding::CompiledGolemWorkerBinding,
     };
 
     #[derive(Debug, Clone)]
@@ -60,7 +65,7 @@ pub mod router {
         // size is the index of all path patterns.
         pub path_params: Vec<(VarInfo, usize)>,
         pub query_params: Vec<QueryInfo>,
-        pub binding: GolemWorkerBinding,
+        pub binding: CompiledGolemWorkerBinding,
     }
 
     pub fn build(routes: Vec<Route>) -> Router<RouteEntry> {
@@ -69,7 +74,7 @@ pub mod router {
         for route in routes {
             let method = route.method.into();
             let path = route.path;
-            let binding = route.binding;
+            let binding = route.binding.into();
 
             let path_params = path
                 .path_patterns
@@ -98,6 +103,65 @@ pub mod router {
 
         router
     }
+
+    // The deployed API definitions with the hashes of their contents
+    type RouterCacheKey = (ApiSiteString, Vec<(ApiDefinitionId, ApiVersion, u64)>);
+
+    // Routers of the API definitions deployed to a site. Deployed API definitions can no longer
+    // be changed, so a router (with the compiled bindings of its routes) is built only
+    // once for every deployment, instead of for every request. An API definition can still be
+    // deleted and created again with the same id and version but other routes, so the
+    // routers are also looked up by the content hashes stored with the definitions. The router
+    // of the replaced definition is left to be evicted.
+    #[derive(Clone)]
+    pub struct RouterCache {
+        cache: Cache<RouterCacheKey, (), Arc<Router<RouteEntry>>, String>,
+    }
+
+    impl RouterCache {
+        pub fn new(capacity: usize) -> Self {
+            RouterCache {
+                cache: Cache::new(
+                    Some(capacity),
+                    FullCacheEvictionMode::LeastRecentlyUsed(1),
+                    BackgroundEvictionMode::None,
+                    "api_deployment_router",
+                ),
+            }
+        }
+
+        pub async fn get_or_build(
+            &self,
+            site: &ApiSiteString,
+            api_definitions: Vec<DeployedHttpApiDefinition>,
+        ) -> Result<Arc<Router<RouteEntry>>, String> {
+            let key = (
+                site.clone(),
+                api_definitions
+                    .iter()
+                    .map(|deployed| {
+                        (
+                            deployed.definition.id.clone(),
+                            deployed.definition.version.clone(),
+                            deployed.content_hash,
+                        )
+                    })
+                    .collect(),
+            );
+
+            self.cache
+                .get_or_insert_simple(&key, || {
+                    Box::pin(async move {
+                        let routes = api_definitions
+                            .into_iter()
+                            .flat_map(|deployed| deployed.definition.routes)
+                            .collect();
+                        Ok(Arc::new(build(routes)))
+                    })
+                })
+                .await
+        }
+    }
 }
 
 #[cfg(test)]
@@ -115,13 +179,15 @@ mod tests {
         ComponentMetadata, Export, ExportFunction, ExportInstance, FunctionResult, WorkerId,
     };
 
-    use crate::api_definition::http::HttpApiDefinition;
+    use crate::api_definition::http::{DeployedHttpApiDefinition, HttpApiDefinition};
+    use crate::api_definition::ApiSiteString;
     use crate::evaluator::getter::Getter;
     use crate::evaluator::path::Path;
     use crate::evaluator::{
         DefaultEvaluator, EvaluationError, Evaluator, ExprEvaluationResult, MetadataFetchError,
         WorkerMetadataFetcher, FQN,
     };
+    use crate::http::http_request::router::RouterCache;
     use crate::http::http_request::{ApiInputPath, InputHttpRequest};
     use crate::merge::Merge;
     use crate::primitive::GetPrimitive;
@@ -1037,6 +1103,46 @@ mod tests {
         }
     }
 
+    #[tokio::test]
+    async fn test_router_cache_rebuilds_replaced_definitions() {
+        let router_cache = RouterCache::new(10);
+        let site = ApiSiteString("foo.com".to_string());
+        let expression = r#"let response = golem:it/api.{get-cart-contents}("a", "b"); response"#;
+
+        let api_specification = DeployedHttpApiDefinition {
+            definition: get_api_spec(
+                "foo/{user-id}",
+                "shopping-cart-${request.path.user-id}",
+                expression,
+            ),
+            content_hash: 1,
+        };
+        let first = router_cache
+            .get_or_build(&site, vec![api_specification.clone()])
+            .await
+            .unwrap();
+        let second = router_cache
+            .get_or_build(&site, vec![api_specification])
+            .await
+            .unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+
+        // Deleted and created again with the same id and version
+        let replaced = DeployedHttpApiDefinition {
+            definition: get_api_spec(
+                "bar/{user-id}",
+                "shopping-cart-${request.path.user-id}",
+                expression,
+            ),
+            content_hash: 2,
+        };
+        let third = router_cache
+            .get_or_build(&site, vec![replaced])
+            .await
+            .unwrap();
+        assert!(!Arc::ptr_eq(&first, &third));
+    }
+
     fn get_api_spec(
         path_pattern: &str,
         worker_name: &str,
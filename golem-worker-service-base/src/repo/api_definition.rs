@@ -1,4 +1,4 @@
-use crate::api_definition::http::HttpApiDefinition;
+use crate::api_definition::http::{DeployedHttpApiDefinition, HttpApiDefinition};
 use crate::repo::RepoError;
 use async_trait::async_trait;
 use sqlx::{Database, Pool, Row};
@@ -14,6 +14,8 @@ pub struct ApiDefinitionRecord {
     pub version: String,
     pub draft: bool,
     pub data: Vec<u8>,
+    // Hash of `data`, missing for the definitions stored before it was recorded
+    pub content_hash: Option<i64>,
 }
 
 impl ApiDefinitionRecord {
@@ -21,15 +23,31 @@ impl ApiDefinitionRecord {
         namespace: Namespace,
         definition: HttpApiDefinition,
     ) -> Result<Self, String> {
-        let data = record_data_serde::serialize(&definition.routes)?;
+        let data: Vec<u8> = record_data_serde::serialize(&definition.routes)?.into();
+        let content_hash = Self::hash(&data);
         Ok(Self {
             namespace: namespace.to_string(),
             id: definition.id.0,
             version: definition.version.0,
             draft: definition.draft,
-            data: data.into(),
+            data,
+            content_hash: Some(content_hash as i64),
         })
     }
+
+    // The hash of the routes, which changes if the definition is deleted and created again with
+    // other routes
+    pub fn content_hash(&self) -> u64 {
+        self.content_hash
+            .map(|hash| hash as u64)
+            .unwrap_or_else(|| Self::hash(&self.data))
+    }
+
+    // XXH3 is stable across builds and platforms, unlike the std hashers, so the stored
+    // hashes stay comparable with the ones computed by other versions of the service
+    fn hash(data: &[u8]) -> u64 {
+        xxhash_rust::xxh3::xxh3_64(data)
+    }
 }
 
 impl TryFrom<ApiDefinitionRecord> for HttpApiDefinition {
@@ -46,6 +64,17 @@ impl TryFrom<ApiDefinitionRecord> for HttpApiDefinition {
     }
 }
 
+impl TryFrom<ApiDefinitionRecord> for DeployedHttpApiDefinition {
+    type Error = String;
+    fn try_from(value: ApiDefinitionRecord) -> Result<Self, Self::Error> {
+        let content_hash = value.content_hash();
+        Ok(Self {
+            definition: value.try_into()?,
+            content_hash,
+        })
+    }
+}
+
 #[async_trait]
 pub trait ApiDefinitionRepo {
     async fn create(&self, definition: &ApiDefinitionRecord) -> Result<(), RepoError>;
@@ -100,9 +129,9 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
         sqlx::query(
             r#"
               INSERT INTO api_definitions
-                (namespace, id, version, draft, data)
+                (namespace, id, version, draft, data, content_hash)
               VALUES
-                ($1, $2, $3, $4, $5)
+                ($1, $2, $3, $4, $5, $6)
                "#,
         )
         .bind(definition.namespace.clone())
@@ -110,6 +139,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
         .bind(definition.version.clone())
         .bind(definition.draft)
         .bind(definition.data.clone())
+        .bind(definition.content_hash)
         .execute(self.db_pool.deref())
         .await?;
 
@@ -120,7 +150,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
         sqlx::query(
             r#"
               UPDATE api_definitions
-              SET draft = $4, data = $5
+              SET draft = $4, data = $5, content_hash = $6
               WHERE namespace = $1 AND id = $2 AND version = $3
                "#,
         )
@@ -129,6 +159,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
         .bind(definition.version.clone())
         .bind(definition.draft)
         .bind(definition.data.clone())
+        .bind(definition.content_hash)
         .execute(self.db_pool.deref())
         .await?;
 
@@ -163,7 +194,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
         id: &str,
         version: &str,
     ) -> Result<Option<ApiDefinitionRecord>, RepoError> {
-        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data FROM api_definitions WHERE namespace = $1 AND id = $2 AND version = $3")
+        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data, content_hash FROM api_definitions WHERE namespace = $1 AND id = $2 AND version = $3")
             .bind(namespace)
             .bind(id)
             .bind(version)
@@ -205,7 +236,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
 
     async fn get_all(&self, namespace: &str) -> Result<Vec<ApiDefinitionRecord>, RepoError> {
         sqlx::query_as::<_, ApiDefinitionRecord>(
-            "SELECT namespace, id, version, draft, data FROM api_definitions WHERE namespace = $1",
+            "SELECT namespace, id, version, draft, data, content_hash FROM api_definitions WHERE namespace = $1",
         )
         .bind(namespace)
         .fetch_all(self.db_pool.deref())
@@ -218,7 +249,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Sqlite> {
         namespace: &str,
         id: &str,
     ) -> Result<Vec<ApiDefinitionRecord>, RepoError> {
-        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data FROM api_definitions WHERE namespace = $1 AND id = $2")
+        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data, content_hash FROM api_definitions WHERE namespace = $1 AND id = $2")
             .bind(namespace)
             .bind(id)
             .fetch_all(self.db_pool.deref())
@@ -233,9 +264,9 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
         sqlx::query(
             r#"
               INSERT INTO api_definitions
-                (namespace, id, version, draft, data)
+                (namespace, id, version, draft, data, content_hash)
               VALUES
-                ($1, $2, $3, $4, $5)
+                ($1, $2, $3, $4, $5, $6)
                "#,
         )
         .bind(definition.namespace.clone())
@@ -243,6 +274,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
         .bind(definition.version.clone())
         .bind(definition.draft)
         .bind(definition.data.clone())
+        .bind(definition.content_hash)
         .execute(self.db_pool.deref())
         .await?;
 
@@ -253,7 +285,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
         sqlx::query(
             r#"
               UPDATE api_definitions
-              SET draft = $4, data = $5
+              SET draft = $4, data = $5, content_hash = $6
               WHERE namespace = $1 AND id = $2 AND version = $3
                "#,
         )
@@ -262,6 +294,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
         .bind(definition.version.clone())
         .bind(definition.draft)
         .bind(definition.data.clone())
+        .bind(definition.content_hash)
         .execute(self.db_pool.deref())
         .await?;
 
@@ -296,7 +329,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
         id: &str,
         version: &str,
     ) -> Result<Option<ApiDefinitionRecord>, RepoError> {
-        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data FROM api_definitions WHERE namespace = $1 AND id = $2 AND version = $3")
+        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data, content_hash FROM api_definitions WHERE namespace = $1 AND id = $2 AND version = $3")
             .bind(namespace)
             .bind(id)
             .bind(version)
@@ -338,7 +371,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
 
     async fn get_all(&self, namespace: &str) -> Result<Vec<ApiDefinitionRecord>, RepoError> {
         sqlx::query_as::<_, ApiDefinitionRecord>(
-            "SELECT namespace, id, version, draft, data FROM api_definitions WHERE namespace = $1",
+            "SELECT namespace, id, version, draft, data, content_hash FROM api_definitions WHERE namespace = $1",
         )
         .bind(namespace)
         .fetch_all(self.db_pool.deref())
@@ -351,7 +384,7 @@ impl ApiDefinitionRepo for DbApiDefinitionRepo<sqlx::Postgres> {
         namespace: &str,
         id: &str,
     ) -> Result<Vec<ApiDefinitionRecord>, RepoError> {
-        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data FROM api_definitions WHERE namespace = $1 AND id = $2")
+        sqlx::query_as::<_, ApiDefinitionRecord>("SELECT namespace, id, version, draft, data, content_hash FROM api_definitions WHERE namespace = $1 AND id = $2")
             .bind(namespace)
             .bind(id)
             .fetch_all(self.db_pool.deref())
@@ -1,7 +1,7 @@
 use std::fmt::Display;
 use std::sync::Arc;
 
-use crate::api_definition::http::HttpApiDefinition;
+use crate::api_definition::http::DeployedHttpApiDefinition;
 use crate::http::InputHttpRequest;
 use crate::service::api_deployment::ApiDeploymentService;
 use async_trait::async_trait;
@@ -36,13 +36,13 @@ impl<Namespace> HttpApiDefinitionLookup<Namespace> {
 }
 
 #[async_trait]
-impl<Namespace> ApiDefinitionsLookup<InputHttpRequest, HttpApiDefinition>
+impl<Namespace> ApiDefinitionsLookup<InputHttpRequest, DeployedHttpApiDefinition>
     for HttpApiDefinitionLookup<Namespace>
 {
     async fn get(
         &self,
         input_http_request: InputHttpRequest,
-    ) -> Result<Vec<HttpApiDefinition>, ApiDefinitionLookupError> {
+    ) -> Result<Vec<DeployedHttpApiDefinition>, ApiDefinitionLookupError> {
         // HOST should exist in Http Request
         let host = input_http_request
             .get_host()
@@ -52,7 +52,7 @@ impl<Namespace> ApiDefinitionsLookup<InputHttpRequest, HttpApiDefinition>
 
         let http_api_defs = self
             .deployment_service
-            .get_definitions_by_site(&host)
+            .get_deployed_definitions_by_site(&host)
             .await
             .map_err(|err| {
                 error!("Error getting API definitions from the repo: {}", err);
@@ -7,7 +7,9 @@ use async_trait::async_trait;
 use std::sync::Arc;
 use tracing::{debug, error, info};
 
-use crate::api_definition::http::{AllPathPatterns, HttpApiDefinition, Route};
+use crate::api_definition::http::{
+    AllPathPatterns, DeployedHttpApiDefinition, HttpApiDefinition, Route,
+};
 
 use crate::http::router::{Router, RouterPattern};
 use crate::repo::api_definition::ApiDefinitionRepo;
@@ -42,6 +44,12 @@ pub trait ApiDeploymentService<Namespace> {
         site: &ApiSiteString,
     ) -> Result<Vec<HttpApiDefinition>, ApiDeploymentError<Namespace>>;
 
+    // The definitions deployed to the site with the hashes of their contents
+    async fn get_deployed_definitions_by_site(
+        &self,
+        site: &ApiSiteString,
+    ) -> Result<Vec<DeployedHttpApiDefinition>, ApiDeploymentError<Namespace>>;
+
     async fn delete(
         &self,
         namespace: &Namespace,
@@ -331,13 +339,24 @@ impl<Namespace: Display + TryFrom<String> + Eq + Clone + Send + Sync>
         &self,
         site: &ApiSiteString,
     ) -> Result<Vec<HttpApiDefinition>, ApiDeploymentError<Namespace>> {
+        let deployed = self.get_deployed_definitions_by_site(site).await?;
+        Ok(deployed
+            .into_iter()
+            .map(|deployed| deployed.definition)
+            .collect())
+    }
+
+    async fn get_deployed_definitions_by_site(
+        &self,
+        site: &ApiSiteString,
+    ) -> Result<Vec<DeployedHttpApiDefinition>, ApiDeploymentError<Namespace>> {
         info!("Get API definitions - site: {}", site);
         let records = self
             .deployment_repo
             .get_definitions_by_site(site.to_string().as_str())
             .await?;
 
-        let mut values: Vec<HttpApiDefinition> = vec![];
+        let mut values: Vec<DeployedHttpApiDefinition> = vec![];
 
         for record in records {
             values.push(record.try_into().map_err(|_| {
@@ -422,6 +441,13 @@ impl<Namespace: Display + TryFrom<String> + Eq + Clone + Send + Sync>
         Ok(vec![])
     }
 
+    async fn get_deployed_definitions_by_site(
+        &self,
+        _site: &ApiSiteString,
+    ) -> Result<Vec<DeployedHttpApiDefinition>, ApiDeploymentError<Namespace>> {
+        Ok(vec![])
+    }
+
     async fn delete(
         &self,
         _namespace: &Namespace,
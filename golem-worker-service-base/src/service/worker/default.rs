@@ -20,7 +20,8 @@ use golem_api_grpc::proto::golem::worker::{InvokeResult as ProtoInvokeResult, Up
 use golem_api_grpc::proto::golem::workerexecutor::worker_executor_client::WorkerExecutorClient;
 use golem_api_grpc::proto::golem::workerexecutor::{
     self, CompletePromiseRequest, ConnectWorkerRequest, CreateWorkerRequest,
-    InterruptWorkerRequest, InvokeAndAwaitWorkerRequest, ResumeWorkerRequest, UpdateWorkerRequest,
+    InterruptWorkerRequest, InvokeAndAwaitWorkerBatchRequest, InvokeAndAwaitWorkerRequest,
+    ResumeWorkerRequest, UpdateWorkerRequest,
 };
 
 use golem_common::model::{
@@ -107,6 +108,17 @@ pub trait WorkerService<AuthCtx> {
         auth_ctx: &AuthCtx,
     ) -> WorkerResult<ProtoInvokeResult>;
 
+    /// Invokes a sequence of functions of the same worker, which executes them as a single
+    /// batch, and awaits all their results
+    async fn invoke_and_await_functions_proto(
+        &self,
+        worker_id: &WorkerId,
+        invocations: Vec<BatchedInvocation>,
+        invocation_context: Option<InvocationContext>,
+        metadata: WorkerRequestMetadata,
+        auth_ctx: &AuthCtx,
+    ) -> WorkerResult<Vec<ProtoInvokeResult>>;
+
     async fn invoke_function(
         &self,
         worker_id: &WorkerId,
@@ -193,6 +205,15 @@ pub struct TypedResult {
     pub function_result_types: Vec<FunctionResult>,
 }
 
+/// One invocation of a batch passed to `invoke_and_await_functions_proto`
+#[derive(Clone, Debug)]
+pub struct BatchedInvocation {
+    pub idempotency_key: Option<ProtoIdempotencyKey>,
+    pub function_name: String,
+    pub params: Vec<ProtoVal>,
+    pub calling_convention: CallingConvention,
+}
+
 #[derive(Clone, Debug)]
 pub struct WorkerRequestMetadata {
     pub account_id: Option<AccountId>,
@@ -219,6 +240,37 @@ impl<AuthCtx> WorkerServiceDefault<AuthCtx> {
         }
     }
 
+    /// Type checks the parameters of an invocation of `function_name` of the component
+    fn validate_proto_params(
+        component_details: &Component,
+        function_name: &str,
+        params: Vec<ProtoVal>,
+        calling_convention: CallingConvention,
+    ) -> WorkerResult<Vec<ProtoVal>> {
+        let function_type = component_details
+            .metadata
+            .function_by_name(function_name)
+            .map_err(|err| {
+                WorkerServiceError::TypeChecker(format!(
+                    "Failed to parse the function name: {}",
+                    err
+                ))
+            })?
+            .ok_or_else(|| {
+                WorkerServiceError::TypeChecker(format!(
+                    "Failed to find the function {}, Available functions: {}",
+                    function_name,
+                    component_details.function_names().join(", ")
+                ))
+            })?;
+        params
+            .validate_function_parameters(
+                Self::get_expected_function_parameters(function_name, &function_type),
+                calling_convention,
+            )
+            .map_err(|err| WorkerServiceError::TypeChecker(err.join(", ")))
+    }
+
     fn get_expected_function_parameters(
         function_name: &str,
         function_type: &ExportFunction,
@@ -499,28 +551,12 @@ where
         let component_details = self
             .try_get_component_for_worker(worker_id, metadata.clone(), auth_ctx)
             .await?;
-        let function_type = component_details
-            .metadata
-            .function_by_name(&function_name)
-            .map_err(|err| {
-                WorkerServiceError::TypeChecker(format!(
-                    "Failed to parse the function name: {}",
-                    err
-                ))
-            })?
-            .ok_or_else(|| {
-                WorkerServiceError::TypeChecker(format!(
-                    "Failed to find the function {}, Available functions: {}",
-                    &function_name,
-                    component_details.function_names().join(", ")
-                ))
-            })?;
-        let params_val = params
-            .validate_function_parameters(
-                Self::get_expected_function_parameters(&function_name, &function_type),
-                *calling_convention,
-            )
-            .map_err(|err| WorkerServiceError::TypeChecker(err.join(", ")))?;
+        let params_val = Self::validate_proto_params(
+            &component_details,
+            &function_name,
+            params,
+            *calling_convention,
+        )?;
 
         let invoke_response = self.retry_on_invalid_shard_id(
             worker_id,
@@ -569,6 +605,80 @@ where
         Ok(invoke_response)
     }
 
+    async fn invoke_and_await_functions_proto(
+        &self,
+        worker_id: &WorkerId,
+        invocations: Vec<BatchedInvocation>,
+        invocation_context: Option<InvocationContext>,
+        metadata: WorkerRequestMetadata,
+        auth_ctx: &AuthCtx,
+    ) -> WorkerResult<Vec<ProtoInvokeResult>> {
+        let component_details = self
+            .try_get_component_for_worker(worker_id, metadata.clone(), auth_ctx)
+            .await?;
+        let mut batched_invocations = Vec::new();
+        for invocation in invocations {
+            let input = Self::validate_proto_params(
+                &component_details,
+                &invocation.function_name,
+                invocation.params,
+                invocation.calling_convention,
+            )?;
+            batched_invocations.push(workerexecutor::BatchedInvocation {
+                name: invocation.function_name,
+                input,
+                idempotency_key: invocation.idempotency_key,
+                calling_convention: invocation.calling_convention.into(),
+            });
+        }
+
+        let invoke_response = self.retry_on_invalid_shard_id(
+            worker_id,
+            &(worker_id.clone(), batched_invocations, metadata, invocation_context),
+            |worker_executor_client, (worker_id, batched_invocations, metadata, invocation_context)| {
+                Box::pin(async move {
+                    let response = worker_executor_client.invoke_and_await_worker_batch(
+                        InvokeAndAwaitWorkerBatchRequest {
+                            worker_id: Some(worker_id.clone().into()),
+                            invocations: batched_invocations.clone(),
+                            account_id: metadata.account_id.clone().map(|id| id.into()),
+                            account_limits: metadata.limits.clone().map(|id| id.into()),
+                            context: invocation_context.clone()
+                        }
+                    ).await.map_err(|err| {
+                        GolemError::RuntimeError(GolemErrorRuntimeError {
+                            details: err.to_string(),
+                        })
+                    })?;
+                    match response.into_inner() {
+                        workerexecutor::InvokeAndAwaitWorkerBatchResponse {
+                            result:
+                            Some(workerexecutor::invoke_and_await_worker_batch_response::Result::Success(
+                                     workerexecutor::InvokeAndAwaitWorkerBatchSuccess {
+                                         results,
+                                     },
+                                 )),
+                        } => Ok(results
+                            .into_iter()
+                            .map(|result| ProtoInvokeResult { result: result.output })
+                            .collect()),
+                        workerexecutor::InvokeAndAwaitWorkerBatchResponse {
+                            result:
+                            Some(workerexecutor::invoke_and_await_worker_batch_response::Result::Failure(err)),
+                        } => Err(err.try_into().unwrap()),
+                        workerexecutor::InvokeAndAwaitWorkerBatchResponse { .. } => {
+                            Err(GolemError::Unknown(GolemErrorUnknown {
+                                details: "Empty response".to_string(),
+                            }))
+                        }
+                    }
+                })
+            },
+        ).await?;
+
+        Ok(invoke_response)
+    }
+
     async fn invoke_function(
         &self,
         worker_id: &WorkerId,
@@ -1532,6 +1642,17 @@ where
         Ok(ProtoInvokeResult::default())
     }
 
+    async fn invoke_and_await_functions_proto(
+        &self,
+        _worker_id: &WorkerId,
+        _invocations: Vec<BatchedInvocation>,
+        _invocation_context: Option<InvocationContext>,
+        _metadata: WorkerRequestMetadata,
+        _auth_ctx: &AuthCtx,
+    ) -> WorkerResult<Vec<ProtoInvokeResult>> {
+        Ok(vec![])
+    }
+
     async fn invoke_function(
         &self,
         _worker_id: &WorkerId,
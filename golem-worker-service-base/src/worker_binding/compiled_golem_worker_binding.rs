@@ -0,0 +1,199 @@
+use golem_common::model::ComponentId;
+use golem_wasm_rpc::TypeAnnotatedValue;
+use rib::{ArmPattern, Expr, MatchArm, Number};
+
+use crate::evaluator::{EvaluationContext, EvaluationError, Evaluator, ExprEvaluationResult};
+use crate::primitive::GetPrimitive;
+use crate::worker_binding::GolemWorkerBinding;
+
+// A worker binding prepared once, when the router of its API deployment is built,
+// so that handling a request evaluates only the parts depending on the request
+#[derive(Debug, Clone)]
+pub struct CompiledGolemWorkerBinding {
+    pub component_id: ComponentId,
+    pub worker_name: CompiledExpr,
+    pub idempotency_key: Option<CompiledExpr>,
+    pub response: CompiledExpr,
+    // Whether any of the expressions may read the request body. Converting the body
+    // to a typed value is the costliest part of preparing the request details, so
+    // the body is left out of them when no expression can observe it.
+    pub uses_request_body: bool,
+}
+
+impl From<GolemWorkerBinding> for CompiledGolemWorkerBinding {
+    fn from(binding: GolemWorkerBinding) -> Self {
+        let uses_request_body = internal::uses_request_body(&binding.worker_name)
+            || binding
+                .idempotency_key
+                .as_ref()
+                .is_some_and(internal::uses_request_body)
+            || internal::uses_request_body(&binding.response.0);
+
+        CompiledGolemWorkerBinding {
+            component_id: binding.component_id,
+            worker_name: CompiledExpr::new(binding.worker_name),
+            idempotency_key: binding.idempotency_key.map(CompiledExpr::new),
+            response: CompiledExpr::new(binding.response.0),
+            uses_request_body,
+        }
+    }
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub enum CompiledExpr {
+    // The value of an expression without variables and function calls,
+    // folded when the binding is compiled
+    Constant(TypeAnnotatedValue),
+    Dynamic(Expr),
+}
+
+impl CompiledExpr {
+    pub fn new(expr: Expr) -> Self {
+        match internal::fold_constant(&expr) {
+            Some(value) => CompiledExpr::Constant(value),
+            None => CompiledExpr::Dynamic(expr),
+        }
+    }
+
+    pub async fn evaluate<E: Evaluator + Sync + ?Sized>(
+        &self,
+        evaluator: &E,
+        evaluation_context: &EvaluationContext,
+    ) -> Result<ExprEvaluationResult, EvaluationError> {
+        match self {
+            CompiledExpr::Constant(value) => Ok(ExprEvaluationResult::Value(value.clone())),
+            CompiledExpr::Dynamic(expr) => evaluator.evaluate(expr, evaluation_context).await,
+        }
+    }
+}
+
+mod internal {
+    use super::*;
+
+    // Folds the expressions the evaluator turns into a value without looking at the context,
+    // producing the same value. Anything else is left to the evaluator.
+    pub(crate) fn fold_constant(expr: &Expr) -> Option<TypeAnnotatedValue> {
+        match expr {
+            Expr::Literal(literal) => Some(TypeAnnotatedValue::Str(literal.clone())),
+            Expr::Number(Number::Unsigned(u64)) => Some(TypeAnnotatedValue::U64(*u64)),
+            Expr::Number(Number::Signed(i64)) => Some(TypeAnnotatedValue::S64(*i64)),
+            Expr::Number(Number::Float(f64)) => Some(TypeAnnotatedValue::F64(*f64)),
+            Expr::Boolean(bool) => Some(TypeAnnotatedValue::Bool(*bool)),
+            Expr::Concat(exprs) => {
+                let mut result = String::new();
+
+                for expr in exprs {
+                    let primitive = fold_constant(expr)?.get_primitive()?;
+                    result.push_str(primitive.to_string().as_str());
+                }
+
+                Some(TypeAnnotatedValue::Str(result))
+            }
+            _ => None,
+        }
+    }
+
+    // Whether the expression may observe `request.body`. Any other use of the
+    // `request` variable than selecting one of its fields counts as reading the body.
+    pub(crate) fn uses_request_body(expr: &Expr) -> bool {
+        match expr {
+            Expr::SelectField(inner, field) => match inner.as_ref() {
+                Expr::Identifier(variable) if variable == "request" => field == "body",
+                inner => uses_request_body(inner),
+            },
+            Expr::Identifier(variable) => variable == "request",
+            Expr::Let(_, expr) | Expr::SelectIndex(expr, _) | Expr::Not(expr) => {
+                uses_request_body(expr)
+            }
+            Expr::Sequence(exprs)
+            | Expr::Tuple(exprs)
+            | Expr::Concat(exprs)
+            | Expr::Multiple(exprs)
+            | Expr::Call(_, exprs) => exprs.iter().any(uses_request_body),
+            Expr::Record(fields) => fields.iter().any(|(_, expr)| uses_request_body(expr)),
+            Expr::GreaterThan(left, right)
+            | Expr::GreaterThanOrEqualTo(left, right)
+            | Expr::LessThanOrEqualTo(left, right)
+            | Expr::EqualTo(left, right)
+            | Expr::LessThan(left, right) => uses_request_body(left) || uses_request_body(right),
+            Expr::Cond(pred, left, right) => {
+                uses_request_body(pred) || uses_request_body(left) || uses_request_body(right)
+            }
+            Expr::PatternMatch(expr, arms) => {
+                uses_request_body(expr)
+                    || arms.iter().any(|MatchArm((pattern, body))| {
+                        pattern_uses_request_body(pattern) || uses_request_body(body)
+                    })
+            }
+            Expr::Option(Some(expr)) | Expr::Result(Ok(expr)) | Expr::Result(Err(expr)) => {
+                uses_request_body(expr)
+            }
+            Expr::Option(None)
+            | Expr::Literal(_)
+            | Expr::Number(_)
+            | Expr::Flags(_)
+            | Expr::Boolean(_) => false,
+        }
+    }
+
+    fn pattern_uses_request_body(pattern: &ArmPattern) -> bool {
+        match pattern {
+            ArmPattern::WildCard => false,
+            ArmPattern::As(_, pattern) => pattern_uses_request_body(pattern),
+            ArmPattern::Constructor(_, patterns) => patterns.iter().any(pattern_uses_request_body),
+            ArmPattern::Literal(expr) => uses_request_body(expr),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use golem_wasm_rpc::TypeAnnotatedValue;
+    use rib::Expr;
+
+    use crate::worker_binding::compiled_golem_worker_binding::internal::uses_request_body;
+    use crate::worker_binding::CompiledExpr;
+
+    #[test]
+    fn constant_expressions_are_folded() {
+        let worker_name = Expr::from_interpolated_str("shopping-cart-1").unwrap();
+        assert_eq!(
+            CompiledExpr::new(worker_name),
+            CompiledExpr::Constant(TypeAnnotatedValue::Str("shopping-cart-1".to_string()))
+        );
+
+        let concatenated = Expr::Concat(vec![
+            Expr::Literal("cart-".to_string()),
+            Expr::unsigned_integer(1),
+            Expr::Literal("-".to_string()),
+            Expr::Boolean(true),
+        ]);
+        assert_eq!(
+            CompiledExpr::new(concatenated),
+            CompiledExpr::Constant(TypeAnnotatedValue::Str("cart-1-true".to_string()))
+        );
+
+        let dynamic = Expr::from_interpolated_str("cart-${request.path.user-id}").unwrap();
+        assert_eq!(
+            CompiledExpr::new(dynamic.clone()),
+            CompiledExpr::Dynamic(dynamic)
+        );
+    }
+
+    #[test]
+    fn request_body_use_is_detected() {
+        let uses = |text: &str| uses_request_body(&rib::from_string(text).unwrap());
+
+        assert!(!uses("${request.path.user-id}"));
+        assert!(!uses("cart-${request.headers.user}"));
+        assert!(uses("${request.body.id}"));
+        assert!(uses("cart-${request.body.user.id}"));
+        assert!(uses("${let x = request; x.body}"));
+        assert!(uses(
+            r#"${match request.body.id { some(id) => id, none => "unknown" }}"#
+        ));
+        assert!(!uses(
+            r#"${if request.path.id > 10 then "large" else "small"}"#
+        ));
+    }
+}
@@ -1,7 +1,9 @@
+pub(crate) use compiled_golem_worker_binding::*;
 pub(crate) use golem_worker_binding::*;
 pub(crate) use request_details::*;
 pub(crate) use worker_binding_resolver::*;
 
+mod compiled_golem_worker_binding;
 mod golem_worker_binding;
 mod request_details;
 mod worker_binding_resolver;
@@ -4,7 +4,7 @@ use crate::evaluator::{
 };
 use crate::evaluator::{Evaluator, WorkerMetadataFetcher};
 use crate::http::http_request::router;
-use crate::http::router::RouterPattern;
+use crate::http::router::{Router, RouterPattern};
 use crate::http::InputHttpRequest;
 use crate::merge::Merge;
 use crate::primitive::GetPrimitive;
@@ -18,7 +18,7 @@ use std::sync::Arc;
 
 use golem_service_base::model::{Id, WorkerId};
 
-use crate::worker_binding::{RequestDetails, ResponseMapping};
+use crate::worker_binding::{CompiledExpr, RequestDetails};
 use crate::worker_bridge_execution::to_response::ToResponse;
 
 // TODO; It will be better if worker binding resolver
@@ -52,7 +52,7 @@ impl Display for WorkerBindingResolutionError {
 pub struct ResolvedWorkerBinding {
     pub worker_detail: WorkerDetail,
     pub request_details: RequestDetails,
-    pub response_mapping: ResponseMapping,
+    pub response_mapping: CompiledExpr,
 }
 
 #[derive(Debug, Clone, PartialEq)]
@@ -140,8 +140,9 @@ impl ResolvedWorkerBinding {
 
                 match runtime {
                     Ok(context) => {
-                        let result = evaluator
-                            .evaluate(&self.response_mapping.clone().0, &context)
+                        let result = self
+                            .response_mapping
+                            .evaluate(evaluator.as_ref(), &context)
                             .await;
 
                         match result {
@@ -165,18 +166,29 @@ impl WorkerBindingResolver<HttpApiDefinition> for InputHttpRequest {
         &self,
         api_definition: Vec<HttpApiDefinition>,
     ) -> Result<ResolvedWorkerBinding, WorkerBindingResolutionError> {
-        let default_evaluator = DefaultEvaluator::noop();
-
         let routes = api_definition
-            .iter()
-            .flat_map(|x| x.routes.clone())
+            .into_iter()
+            .flat_map(|x| x.routes)
             .collect::<Vec<_>>();
 
-        let api_request = self;
         let router = router::build(routes);
+
+        self.resolve_with_router(&router).await
+    }
+}
+
+impl InputHttpRequest {
+    // Resolves the worker binding of the request with a router built beforehand,
+    // see `router::RouterCache`
+    pub async fn resolve_with_router(
+        &self,
+        router: &Router<router::RouteEntry>,
+    ) -> Result<ResolvedWorkerBinding, WorkerBindingResolutionError> {
+        let default_evaluator = DefaultEvaluator::noop();
+
+        let api_request = self;
         let path: Vec<&str> = RouterPattern::split(&api_request.input_path.base_path).collect();
         let request_query_variables = self.input_path.query_components().unwrap_or_default();
-        let request_body = &self.req_body;
         let headers = &self.headers;
 
         let router::RouteEntry {
@@ -187,6 +199,13 @@ impl WorkerBindingResolver<HttpApiDefinition> for InputHttpRequest {
             .check_path(&api_request.req_method, &path)
             .ok_or("Failed to resolve route")?;
 
+        // The body is only converted if it can be observed by the binding
+        let request_body = if binding.uses_request_body {
+            &self.req_body
+        } else {
+            &serde_json::Value::Null
+        };
+
         let zipped_path_params: HashMap<VarInfo, &str> = {
             path_params
                 .iter()
@@ -205,8 +224,9 @@ impl WorkerBindingResolver<HttpApiDefinition> for InputHttpRequest {
 
         let request_evaluation_context = EvaluationContext::from_request_data(&request_details);
 
-        let worker_name: String = default_evaluator
-            .evaluate(&binding.worker_name, &request_evaluation_context)
+        let worker_name: String = binding
+            .worker_name
+            .evaluate(&default_evaluator, &request_evaluation_context)
             .await
             .map_err(|err| err.to_string())?
             .get_value()
@@ -218,8 +238,8 @@ impl WorkerBindingResolver<HttpApiDefinition> for InputHttpRequest {
         let component_id = &binding.component_id;
 
         let idempotency_key = if let Some(expr) = &binding.idempotency_key {
-            let idempotency_key_value = default_evaluator
-                .evaluate(expr, &request_evaluation_context)
+            let idempotency_key_value = expr
+                .evaluate(&default_evaluator, &request_evaluation_context)
                 .await
                 .map_err(|err| err.to_string())?;
 
@@ -0,0 +1 @@
+ALTER TABLE api_definitions ADD COLUMN content_hash integer;
@@ -16,15 +16,16 @@ use golem_api_grpc::proto::golem::common::{Empty, ErrorBody, ErrorsBody};
 use golem_api_grpc::proto::golem::worker::worker_service_server::WorkerService as GrpcWorkerService;
 use golem_api_grpc::proto::golem::worker::{
     complete_promise_response, delete_worker_response, get_worker_metadata_response,
-    get_workers_metadata_response, interrupt_worker_response, invoke_and_await_response,
-    invoke_response, launch_new_worker_response, resume_worker_response, update_worker_response,
-    CompletePromiseRequest, CompletePromiseResponse, ConnectWorkerRequest, DeleteWorkerRequest,
-    DeleteWorkerResponse, GetWorkerMetadataRequest, GetWorkerMetadataResponse,
+    get_workers_metadata_response, interrupt_worker_response, invoke_and_await_batch_response,
+    invoke_and_await_response, invoke_response, launch_new_worker_response, resume_worker_response,
+    update_worker_response, CompletePromiseRequest, CompletePromiseResponse, ConnectWorkerRequest,
+    DeleteWorkerRequest, DeleteWorkerResponse, GetWorkerMetadataRequest, GetWorkerMetadataResponse,
     GetWorkersMetadataRequest, GetWorkersMetadataResponse, GetWorkersMetadataSuccessResponse,
-    InterruptWorkerRequest, InterruptWorkerResponse, InvokeAndAwaitRequest, InvokeAndAwaitResponse,
-    InvokeRequest, InvokeResponse, LaunchNewWorkerRequest, LaunchNewWorkerResponse,
-    LaunchNewWorkerSuccessResponse, ResumeWorkerRequest, ResumeWorkerResponse, UpdateWorkerRequest,
-    UpdateWorkerResponse,
+    InterruptWorkerRequest, InterruptWorkerResponse, InvokeAndAwaitBatchRequest,
+    InvokeAndAwaitBatchResponse, InvokeAndAwaitBatchSuccessResponse, InvokeAndAwaitRequest,
+    InvokeAndAwaitResponse, InvokeRequest, InvokeResponse, LaunchNewWorkerRequest,
+    LaunchNewWorkerResponse, LaunchNewWorkerSuccessResponse, ResumeWorkerRequest,
+    ResumeWorkerResponse, UpdateWorkerRequest, UpdateWorkerResponse,
 };
 use golem_api_grpc::proto::golem::worker::{
     worker_error, worker_execution_error, InvokeResult, WorkerError as GrpcWorkerError,
@@ -32,7 +33,7 @@ use golem_api_grpc::proto::golem::worker::{
 };
 use golem_common::model::{ComponentVersion, ScanCursor, WorkerFilter, WorkerId};
 use golem_worker_service_base::auth::EmptyAuthCtx;
-use golem_worker_service_base::service::worker::ConnectWorkerStream;
+use golem_worker_service_base::service::worker::{BatchedInvocation, ConnectWorkerStream};
 use tap::TapFallible;
 use tonic::{Request, Response, Status};
 
@@ -145,6 +146,22 @@ impl GrpcWorkerService for WorkerGrpcApi {
         }))
     }
 
+    async fn invoke_and_await_batch(
+        &self,
+        request: Request<InvokeAndAwaitBatchRequest>,
+    ) -> Result<Response<InvokeAndAwaitBatchResponse>, Status> {
+        let response = match self.invoke_and_await_batch(request.into_inner()).await {
+            Ok(results) => invoke_and_await_batch_response::Result::Success(
+                InvokeAndAwaitBatchSuccessResponse { results },
+            ),
+            Err(error) => invoke_and_await_batch_response::Result::Error(error),
+        };
+
+        Ok(Response::new(InvokeAndAwaitBatchResponse {
+            result: Some(response),
+        }))
+    }
+
     async fn invoke(
         &self,
         request: Request<InvokeRequest>,
@@ -427,6 +444,45 @@ impl WorkerGrpcApi {
         Ok(result)
     }
 
+    async fn invoke_and_await_batch(
+        &self,
+        request: InvokeAndAwaitBatchRequest,
+    ) -> Result<Vec<InvokeResult>, GrpcWorkerError> {
+        let worker_id = make_crate_worker_id(request.worker_id)?;
+
+        let mut invocations = Vec::new();
+        for invocation in request.invocations {
+            let params = invocation
+                .invoke_parameters
+                .ok_or(bad_request_error("Missing invoke parameters"))?;
+
+            let calling_convention: golem_common::model::CallingConvention = invocation
+                .calling_convention
+                .try_into()
+                .map_err(bad_request_error)?;
+
+            invocations.push(BatchedInvocation {
+                idempotency_key: invocation.idempotency_key,
+                function_name: invocation.function,
+                params: params.params,
+                calling_convention,
+            });
+        }
+
+        let results = self
+            .worker_service
+            .invoke_and_await_functions_proto(
+                &worker_id,
+                invocations,
+                request.context,
+                empty_worker_metadata(),
+                &EmptyAuthCtx::default(),
+            )
+            .await?;
+
+        Ok(results)
+    }
+
     async fn resume_worker(&self, request: ResumeWorkerRequest) -> Result<(), GrpcWorkerError> {
         let worker_id = make_crate_worker_id(request.worker_id)?;
 
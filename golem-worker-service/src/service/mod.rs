@@ -3,7 +3,9 @@ pub mod worker;
 
 use crate::worker_bridge_request_executor::UnauthorisedWorkerRequestExecutor;
 
-use golem_worker_service_base::api_definition::http::HttpApiDefinition;
+use golem_worker_service_base::api_definition::http::{
+    DeployedHttpApiDefinition, HttpApiDefinition,
+};
 
 use golem_worker_service_base::app_config::WorkerServiceBaseConfig;
 use golem_worker_service_base::auth::{DefaultNamespace, EmptyAuthCtx};
@@ -50,7 +52,7 @@ pub struct Services {
     >,
     pub deployment_service: Arc<dyn ApiDeploymentService<DefaultNamespace> + Sync + Send>,
     pub http_definition_lookup_service:
-        Arc<dyn ApiDefinitionsLookup<InputHttpRequest, HttpApiDefinition> + Sync + Send>,
+        Arc<dyn ApiDefinitionsLookup<InputHttpRequest, DeployedHttpApiDefinition> + Sync + Send>,
     pub worker_to_http_service: Arc<dyn WorkerRequestExecutor + Sync + Send>,
     pub worker_metadata_fetcher: Arc<dyn WorkerMetadataFetcher + Sync + Send>,
     pub api_definition_validator_service: Arc<
@@ -0,0 +1,221 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Allocation-pressure benchmark running the `large-dynamic-memory` test component.
+//!
+//! Starts `size` workers concurrently, each allocating 512 pages of 1 MiB. Besides the
+//! invocation latencies, the benchmark records how many times and by how many bytes the
+//! workers grew their total linear memory beyond its recorded high water mark, and the peak
+//! resident memory of the worker executors, scraped from their `/metrics` endpoint.
+
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Arc;
+use std::time::{Duration, SystemTime};
+
+use async_trait::async_trait;
+use tokio::task::JoinHandle;
+
+use golem_test_framework::config::{CliParams, TestDependencies};
+use golem_test_framework::dsl::benchmark::{Benchmark, BenchmarkRecorder, RunConfig};
+use golem_test_framework::dsl::TestDsl;
+
+use crate::benchmarks::{
+    cleanup_iteration, collect_executor_metrics, setup_benchmark, setup_iteration,
+};
+use crate::benchmarks::{BenchmarkContext, IterationContext};
+
+pub struct AllocationBenchmark {
+    config: RunConfig,
+}
+
+#[async_trait]
+impl Benchmark for AllocationBenchmark {
+    type BenchmarkContext = BenchmarkContext;
+    type IterationContext = IterationContext;
+
+    fn name() -> &'static str {
+        "large-dynamic-memory"
+    }
+
+    async fn create_benchmark_context(
+        params: CliParams,
+        cluster_size: usize,
+    ) -> Self::BenchmarkContext {
+        setup_benchmark(params, cluster_size).await
+    }
+
+    async fn cleanup(benchmark_context: Self::BenchmarkContext) {
+        benchmark_context.deps.kill_all()
+    }
+
+    async fn create(_params: CliParams, config: RunConfig) -> Self {
+        Self { config }
+    }
+
+    async fn setup_iteration(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+    ) -> Self::IterationContext {
+        // Workers are started in `run` so their first invocation can be measured
+        setup_iteration(
+            benchmark_context,
+            self.config.clone(),
+            "large-dynamic-memory",
+            false,
+        )
+        .await
+    }
+
+    async fn warmup(
+        &self,
+        _benchmark_context: &Self::BenchmarkContext,
+        _context: &Self::IterationContext,
+    ) {
+    }
+
+    async fn run(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: &Self::IterationContext,
+        recorder: BenchmarkRecorder,
+    ) {
+        let before = ExecutorMemoryStats::collect(benchmark_context).await;
+        let rss_sampler = PeakRssSampler::start(benchmark_context.clone());
+
+        // Start each worker and invoke `run` concurrently
+        let mut fibers = Vec::new();
+        for (n, worker_id) in context.worker_ids.iter().enumerate() {
+            let context_clone = benchmark_context.clone();
+            let worker_id_clone = worker_id.clone();
+            let recorder_clone = recorder.clone();
+            let fiber = tokio::task::spawn(async move {
+                let start = SystemTime::now();
+                let worker_id = context_clone
+                    .deps
+                    .start_worker(&worker_id_clone.component_id, &worker_id_clone.worker_name)
+                    .await;
+                let invocation_start = SystemTime::now();
+                context_clone
+                    .deps
+                    .invoke_and_await(&worker_id, "run", vec![])
+                    .await
+                    .expect("invoke_and_await failed");
+                let elapsed = invocation_start
+                    .elapsed()
+                    .expect("SystemTime elapsed failed");
+                let time_to_first_invocation = start.elapsed().expect("SystemTime elapsed failed");
+                recorder_clone.duration(&"invocation".to_string(), elapsed);
+                recorder_clone.duration(
+                    &"time-to-first-invocation".to_string(),
+                    time_to_first_invocation,
+                );
+                recorder_clone.duration(&format!("worker-{n}"), elapsed);
+
+                let metadata = context_clone.deps.get_worker_metadata(&worker_id).await;
+                if let Some(metadata) = metadata {
+                    recorder_clone.count(
+                        &"linear-memory-bytes".to_string(),
+                        metadata.last_known_status.total_linear_memory_size,
+                    );
+                }
+            });
+            fibers.push(fiber);
+        }
+
+        for fiber in fibers {
+            fiber.await.expect("fiber failed");
+        }
+
+        let peak_rss = rss_sampler.stop().await;
+        let after = ExecutorMemoryStats::collect(benchmark_context).await;
+
+        recorder.count(&"peak-rss-bytes".to_string(), peak_rss);
+        recorder.count(
+            &"memory-high-water-mark-growths".to_string(),
+            after.grow_count.saturating_sub(before.grow_count),
+        );
+        recorder.count(
+            &"memory-high-water-mark-growth-bytes".to_string(),
+            after.grown_bytes.saturating_sub(before.grown_bytes),
+        );
+    }
+
+    async fn cleanup_iteration(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: Self::IterationContext,
+    ) {
+        cleanup_iteration(benchmark_context, context).await
+    }
+}
+
+/// Memory related metrics summed over all the worker executors of the cluster
+#[derive(Debug, Clone)]
+struct ExecutorMemoryStats {
+    resident_memory_bytes: u64,
+    grow_count: u64,
+    grown_bytes: u64,
+}
+
+impl ExecutorMemoryStats {
+    async fn collect(benchmark_context: &BenchmarkContext) -> Self {
+        let metrics = collect_executor_metrics(
+            benchmark_context,
+            &[
+                "process_resident_memory_bytes",
+                "allocated_memory_bytes_count",
+                "allocated_memory_bytes_sum",
+            ],
+        )
+        .await;
+        let get = |name: &str| metrics.get(name).copied().unwrap_or(0.0) as u64;
+        Self {
+            resident_memory_bytes: get("process_resident_memory_bytes"),
+            grow_count: get("allocated_memory_bytes_count"),
+            grown_bytes: get("allocated_memory_bytes_sum"),
+        }
+    }
+}
+
+/// Periodically samples the resident memory of the executors, keeping the maximum
+struct PeakRssSampler {
+    stop: Arc<AtomicBool>,
+    handle: JoinHandle<u64>,
+}
+
+impl PeakRssSampler {
+    const INTERVAL: Duration = Duration::from_millis(100);
+
+    fn start(benchmark_context: BenchmarkContext) -> Self {
+        let stop = Arc::new(AtomicBool::new(false));
+        let stop_clone = stop.clone();
+        let handle = tokio::task::spawn(async move {
+            let mut peak = 0;
+            loop {
+                let stats = ExecutorMemoryStats::collect(&benchmark_context).await;
+                peak = peak.max(stats.resident_memory_bytes);
+                if stop_clone.load(Ordering::Acquire) {
+                    break peak;
+                }
+                tokio::time::sleep(Self::INTERVAL).await;
+            }
+        });
+        Self { stop, handle }
+    }
+
+    async fn stop(self) -> u64 {
+        self.stop.store(true, Ordering::Release);
+        self.handle.await.expect("RSS sampler failed")
+    }
+}
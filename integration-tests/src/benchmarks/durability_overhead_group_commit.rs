@@ -0,0 +1,200 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Variant of the durability overhead benchmark measuring the node level group commit of the
+//! primary oplog. All the workers are invoked concurrently, and besides the invocation latencies
+//! the benchmark records the number of oplog commits per second, and how many of them were
+//! written to the indexed storage together.
+//!
+//! The group commit window of the spawned worker executors is set through the
+//! `GOLEM__OPLOG__GROUP_COMMIT_WINDOW` environment variable, so comparing runs with different
+//! windows shows the throughput versus latency trade-off.
+
+use std::time::SystemTime;
+
+use async_trait::async_trait;
+use golem_wasm_rpc::Value;
+
+use golem_test_framework::config::{CliParams, TestDependencies};
+use golem_test_framework::dsl::benchmark::{Benchmark, BenchmarkRecorder, RunConfig};
+use golem_test_framework::dsl::TestDsl;
+use integration_tests::benchmarks::{
+    cleanup_iteration, collect_executor_metrics, run_benchmark, setup_benchmark, setup_iteration,
+    BenchmarkContext, IterationContext,
+};
+
+struct DurabilityOverheadGroupCommit {
+    config: RunConfig,
+}
+
+const GROUP_COMMIT_METRICS: &[&str] = &[
+    "oplog_group_commit_size_count",
+    "oplog_group_commit_size_sum",
+    "oplog_group_commit_entries_sum",
+];
+
+#[async_trait]
+impl Benchmark for DurabilityOverheadGroupCommit {
+    type BenchmarkContext = BenchmarkContext;
+    type IterationContext = IterationContext;
+
+    fn name() -> &'static str {
+        "durability-overhead-group-commit"
+    }
+
+    async fn create_benchmark_context(
+        params: CliParams,
+        cluster_size: usize,
+    ) -> Self::BenchmarkContext {
+        setup_benchmark(params, cluster_size).await
+    }
+
+    async fn cleanup(benchmark_context: Self::BenchmarkContext) {
+        benchmark_context.deps.kill_all()
+    }
+
+    async fn create(_params: CliParams, config: RunConfig) -> Self {
+        Self { config }
+    }
+
+    async fn setup_iteration(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+    ) -> Self::IterationContext {
+        setup_iteration(
+            benchmark_context,
+            self.config.clone(),
+            "shopping-cart",
+            true,
+        )
+        .await
+    }
+
+    async fn warmup(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: &Self::IterationContext,
+    ) {
+        let mut fibers = Vec::new();
+        for worker_id in context.worker_ids.clone() {
+            let context_clone = benchmark_context.clone();
+            let fiber = tokio::task::spawn(async move {
+                context_clone
+                    .deps
+                    .invoke_and_await(
+                        &worker_id,
+                        "golem:it/api.{initialize-cart}",
+                        vec![Value::String(worker_id.worker_name.clone())],
+                    )
+                    .await
+                    .expect("initialize-cart invoke_and_await failed");
+            });
+            fibers.push(fiber);
+        }
+
+        for fiber in fibers {
+            fiber.await.expect("fiber failed");
+        }
+    }
+
+    async fn run(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: &Self::IterationContext,
+        recorder: BenchmarkRecorder,
+    ) {
+        let before = collect_executor_metrics(benchmark_context, GROUP_COMMIT_METRICS).await;
+        let start = SystemTime::now();
+
+        // Invoke each worker 'length' times in parallel and record the duration
+        let mut fibers = Vec::new();
+        for (n, worker_id) in context.worker_ids.iter().enumerate() {
+            let context_clone = benchmark_context.clone();
+            let worker_id_clone = worker_id.clone();
+            let recorder_clone = recorder.clone();
+            let length = self.config.length;
+            let fiber = tokio::task::spawn(async move {
+                for i in 0..length {
+                    let start = SystemTime::now();
+                    context_clone
+                        .deps
+                        .invoke_and_await(
+                            &worker_id_clone,
+                            "golem:it/api.{add-item}",
+                            vec![Value::Record(vec![
+                                Value::String(i.to_string()),
+                                Value::String(format!("{} Golem T-Shirt M", i)),
+                                Value::F32(100.0 + i as f32),
+                                Value::U32(i as u32),
+                            ])],
+                        )
+                        .await
+                        .expect("add-item invoke_and_await failed");
+                    let elapsed = start.elapsed().expect("SystemTime elapsed failed");
+                    recorder_clone.duration(&"invocation".to_string(), elapsed);
+                    recorder_clone.duration(&format!("worker-{n}"), elapsed);
+                }
+            });
+            fibers.push(fiber);
+        }
+
+        for fiber in fibers {
+            fiber.await.expect("fiber failed");
+        }
+
+        let elapsed = start.elapsed().expect("SystemTime elapsed failed");
+        let after = collect_executor_metrics(benchmark_context, GROUP_COMMIT_METRICS).await;
+        let delta = |name: &str| {
+            (after.get(name).copied().unwrap_or(0.0) - before.get(name).copied().unwrap_or(0.0))
+                .max(0.0)
+        };
+
+        // The group commit histograms are observed once per storage write, with the number of
+        // commits and entries of the write, see `record_oplog_group_commit`
+        let writes = delta("oplog_group_commit_size_count");
+        let commits = delta("oplog_group_commit_size_sum");
+        let entries = delta("oplog_group_commit_entries_sum");
+        recorder.count(
+            &"commits-per-second".to_string(),
+            (commits / elapsed.as_secs_f64()) as u64,
+        );
+        recorder.count(
+            &"storage-writes-per-second".to_string(),
+            (writes / elapsed.as_secs_f64()) as u64,
+        );
+        if writes > 0.0 {
+            recorder.count(
+                &"commits-per-storage-write".to_string(),
+                (commits / writes).round() as u64,
+            );
+            recorder.count(
+                &"entries-per-storage-write".to_string(),
+                (entries / writes).round() as u64,
+            );
+        }
+    }
+
+    async fn cleanup_iteration(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: Self::IterationContext,
+    ) {
+        cleanup_iteration(benchmark_context, context).await
+    }
+}
+
+#[tokio::main]
+async fn main() {
+    run_benchmark::<DurabilityOverheadGroupCommit>().await;
+}
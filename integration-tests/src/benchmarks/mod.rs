@@ -12,18 +12,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use std::collections::HashMap;
 use std::time::SystemTime;
 
 use clap::Parser;
 use golem_wasm_rpc::Value;
 
 use golem_common::model::{ComponentId, WorkerId};
-use golem_test_framework::config::{CliParams, CliTestDependencies};
+use golem_test_framework::config::{CliParams, CliTestDependencies, TestDependencies};
 use golem_test_framework::dsl::benchmark::{
     BenchmarkApi, BenchmarkRecorder, BenchmarkResult, RunConfig,
 };
 use golem_test_framework::dsl::TestDsl;
 
+pub mod allocation;
 pub mod data;
 
 #[derive(Clone)]
@@ -172,6 +174,40 @@ pub async fn run_echo(
     }
 }
 
+/// Scrapes the `/metrics` endpoint of every worker executor of the cluster, returning the
+/// values of the given metrics summed over all of them
+pub async fn collect_executor_metrics(
+    benchmark_context: &BenchmarkContext,
+    names: &[&str],
+) -> HashMap<String, f64> {
+    let client = reqwest::Client::new();
+    let mut result = HashMap::new();
+    for executor in benchmark_context.deps.worker_executor_cluster().to_vec() {
+        let url = format!(
+            "http://{}:{}/metrics",
+            executor.public_host(),
+            executor.public_http_port()
+        );
+        match client.get(&url).send().await {
+            Ok(response) => match response.text().await {
+                Ok(body) => {
+                    for line in body.lines() {
+                        if let Some((name, value)) = line.split_once(' ') {
+                            if names.contains(&name) {
+                                let value = value.trim().parse::<f64>().unwrap_or(0.0);
+                                *result.entry(name.to_string()).or_insert(0.0) += value;
+                            }
+                        }
+                    }
+                }
+                Err(err) => println!("Failed to read metrics from {url}: {err}"),
+            },
+            Err(err) => println!("Failed to get metrics from {url}: {err}"),
+        }
+    }
+    result
+}
+
 pub async fn get_benchmark_results<A: BenchmarkApi>(params: CliParams) -> BenchmarkResult {
     CliTestDependencies::init_logging(&params);
     A::run_benchmark(params).await
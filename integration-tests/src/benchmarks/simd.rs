@@ -0,0 +1,204 @@
+// Copyright 2024 Golem Cloud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Compares the integer dot product kernel of the C and Zig test components built without and
+//! with wasm SIMD (the `-simd` variants of `build-components.sh`). Every variant runs `size`
+//! workers, each invoking the kernel `length` times, and all variants must return the same
+//! result.
+
+use std::time::SystemTime;
+
+use async_trait::async_trait;
+use golem_wasm_rpc::Value;
+
+use golem_common::model::WorkerId;
+use golem_test_framework::config::{CliParams, TestDependencies};
+use golem_test_framework::dsl::benchmark::{Benchmark, BenchmarkRecorder, RunConfig};
+use golem_test_framework::dsl::TestDsl;
+use integration_tests::benchmarks::{run_benchmark, setup_benchmark, setup_with, BenchmarkContext};
+
+const VECTOR_LENGTH: u32 = 16384;
+const KERNEL_ITERATIONS: u32 = 1000;
+
+/// The test components and the name of their kernel export
+const VARIANTS: [(&str, &str); 4] = [
+    ("c-dot", "dot"),
+    ("c-dot-simd", "dot"),
+    ("zig-3", "golem:it/api.{dot}"),
+    ("zig-3-simd", "golem:it/api.{dot}"),
+];
+
+struct Simd {
+    config: RunConfig,
+}
+
+struct SimdIterationContext {
+    /// The workers of each variant, by component name
+    workers: Vec<(&'static str, &'static str, Vec<WorkerId>)>,
+    expected: i64,
+}
+
+#[async_trait]
+impl Benchmark for Simd {
+    type BenchmarkContext = BenchmarkContext;
+    type IterationContext = SimdIterationContext;
+
+    fn name() -> &'static str {
+        "simd"
+    }
+
+    async fn create_benchmark_context(
+        params: CliParams,
+        cluster_size: usize,
+    ) -> Self::BenchmarkContext {
+        setup_benchmark(params, cluster_size).await
+    }
+
+    async fn cleanup(benchmark_context: Self::BenchmarkContext) {
+        benchmark_context.deps.kill_all()
+    }
+
+    async fn create(_params: CliParams, config: RunConfig) -> Self {
+        Self { config }
+    }
+
+    async fn setup_iteration(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+    ) -> Self::IterationContext {
+        let mut workers = Vec::new();
+        for (component_name, function_name) in VARIANTS {
+            let worker_ids = setup_with(
+                self.config.size,
+                component_name,
+                component_name,
+                true,
+                benchmark_context.deps.clone(),
+            )
+            .await;
+            workers.push((component_name, function_name, worker_ids));
+        }
+        SimdIterationContext {
+            workers,
+            expected: expected_dot(VECTOR_LENGTH, KERNEL_ITERATIONS),
+        }
+    }
+
+    async fn warmup(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: &Self::IterationContext,
+    ) {
+        for (_, function_name, worker_ids) in &context.workers {
+            for worker_id in worker_ids {
+                invoke_dot(benchmark_context, worker_id, function_name, 1).await;
+            }
+        }
+    }
+
+    async fn run(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: &Self::IterationContext,
+        recorder: BenchmarkRecorder,
+    ) {
+        // The variants run one after the other, so they do not compete for the executors' CPUs
+        for (component_name, function_name, worker_ids) in &context.workers {
+            let mut fibers = Vec::new();
+            for worker_id in worker_ids {
+                let context_clone = benchmark_context.clone();
+                let worker_id_clone = worker_id.clone();
+                let recorder_clone = recorder.clone();
+                let component_name = component_name.to_string();
+                let function_name = *function_name;
+                let expected = context.expected;
+                let length = self.config.length;
+                let fiber = tokio::task::spawn(async move {
+                    for _ in 0..length {
+                        let start = SystemTime::now();
+                        let result = invoke_dot(
+                            &context_clone,
+                            &worker_id_clone,
+                            function_name,
+                            KERNEL_ITERATIONS,
+                        )
+                        .await;
+                        let elapsed = start.elapsed().expect("SystemTime elapsed failed");
+                        assert_eq!(result, expected, "{component_name} returned a wrong result");
+                        recorder_clone.duration(&component_name, elapsed);
+                    }
+                });
+                fibers.push(fiber);
+            }
+
+            for fiber in fibers {
+                fiber.await.expect("fiber failed");
+            }
+        }
+    }
+
+    async fn cleanup_iteration(
+        &self,
+        benchmark_context: &Self::BenchmarkContext,
+        context: Self::IterationContext,
+    ) {
+        for (_, _, worker_ids) in &context.workers {
+            for worker_id in worker_ids {
+                benchmark_context.deps.delete_worker(worker_id).await
+            }
+        }
+    }
+}
+
+async fn invoke_dot(
+    benchmark_context: &BenchmarkContext,
+    worker_id: &WorkerId,
+    function_name: &str,
+    iterations: u32,
+) -> i64 {
+    let result = benchmark_context
+        .deps
+        .invoke_and_await(
+            worker_id,
+            function_name,
+            vec![Value::U32(VECTOR_LENGTH), Value::U32(iterations)],
+        )
+        .await
+        .expect("invoke_and_await failed");
+    match result.as_slice() {
+        [Value::S64(value)] => *value,
+        _ => panic!("Unexpected result of {function_name}: {result:?}"),
+    }
+}
+
+/// The result of the guests' kernel
+fn expected_dot(length: u32, iterations: u32) -> i64 {
+    let mut a: Vec<i32> = (0..length).map(|i| (i % 7) as i32).collect();
+    let b: Vec<i32> = (0..length).map(|i| (i % 5) as i32).collect();
+    let mut total = 0i64;
+    for iteration in 0..iterations {
+        let sum = a
+            .iter()
+            .zip(&b)
+            .fold(0i32, |sum, (x, y)| sum.wrapping_add(x.wrapping_mul(*y)));
+        total += sum as i64;
+        a[(iteration % length) as usize] += 1;
+    }
+    total
+}
+
+#[tokio::main]
+async fn main() {
+    run_benchmark::<Simd>().await;
+}
@@ -29,6 +29,9 @@ use integration_tests::benchmarks::{run_benchmark, setup_with};
 use reqwest::Client;
 use reqwest::Url;
 
+/// Number of echo invocations sent in one invoke-and-await batch
+const ECHO_BATCH_SIZE: usize = 10;
+
 struct Throughput {
     config: RunConfig,
 }
@@ -251,6 +254,44 @@ impl Benchmark for Throughput {
             fiber.await.expect("fiber failed");
         }
 
+        // The same echo invocations sent in batches, recording the time per invocation
+        let mut fibers = Vec::new();
+        for worker_id in context.worker_ids.iter() {
+            let context_clone = benchmark_context.clone();
+            let worker_id_clone = worker_id.clone();
+            let recorder_clone = recorder.clone();
+            let batches = (self.config.length / ECHO_BATCH_SIZE).max(1);
+            let fiber = tokio::task::spawn(async move {
+                for _ in 0..batches {
+                    let start = SystemTime::now();
+                    context_clone
+                        .deps
+                        .invoke_and_await_batch(
+                            &worker_id_clone,
+                            vec![
+                                (
+                                    "golem:it/api.{echo}",
+                                    vec![Value::String("hello".to_string())]
+                                );
+                                ECHO_BATCH_SIZE
+                            ],
+                        )
+                        .await
+                        .expect("invoke_and_await_batch failed");
+                    let elapsed = start.elapsed().expect("SystemTime elapsed failed");
+                    recorder_clone.duration(
+                        &"worker-echo-batched-invocation".to_string(),
+                        elapsed / ECHO_BATCH_SIZE as u32,
+                    );
+                }
+            });
+            fibers.push(fiber);
+        }
+
+        for fiber in fibers {
+            fiber.await.expect("fiber failed");
+        }
+
         let mut fibers = Vec::new();
         for worker_id in context.worker_ids.iter() {
             let context_clone = benchmark_context.clone();
@@ -10,7 +10,7 @@ js_test_components=("js-1" "js-2" "js-3" "js-4" "js-echo")
 java_test_components=("java-1" "java-2")
 dotnet_test_components=("csharp-1")
 swift_test_components=("swift-1")
-c_test_components=("c-1" "large-initial-memory" "large-dynamic-memory")
+c_test_components=("c-1" "c-dot" "large-initial-memory" "large-dynamic-memory")
 python_test_components=("python-1" "py-echo")
 
 # Optional arguments:
@@ -111,6 +111,10 @@ if [ "$single_lang" = "false" ] || [ "$lang" = "zig" ]; then
     cp zig-out/bin/component.wasm "$target"
     wasm-tools print "$target" >"$target_wat"
 
+    echo "Building the SIMD variant of $subdir..."
+    zig build -Dadapter=../../../golem-wit/adapters/tier1/wasi_snapshot_preview1.wasm -Dsimd=true
+    cp zig-out/bin/component.wasm "../$subdir-simd.wasm"
+
     popd || exit
   done
 fi
@@ -260,7 +264,7 @@ if [ "$single_lang" = "false" ] || [ "$lang" = "c" ]; then
       rm *.wasm
     fi
     wit-bindgen c --autodrop-borrows yes ./wit
-    ~/wasi-sdk-20.0/bin/clang --sysroot ~/wasi-sdk-20.0/share/wasi-sysroot main.c c_api1.c c_api1_component_type.o -o main.wasm
+    ~/wasi-sdk-20.0/bin/clang --sysroot ~/wasi-sdk-20.0/share/wasi-sysroot -O2 main.c c_api1.c c_api1_component_type.o -o main.wasm
 
     echo "Turning the module into a WebAssembly Component..."
     target="../$subdir.wasm"
@@ -268,6 +272,10 @@ if [ "$single_lang" = "false" ] || [ "$lang" = "c" ]; then
     wasm-tools component new main.wasm -o "$target" --adapt ../../../golem-wit/adapters/tier1/wasi_snapshot_preview1.wasm
     wasm-tools print "$target" >"$target_wat"
 
+    echo "Building the SIMD variant of $subdir..."
+    ~/wasi-sdk-20.0/bin/clang --sysroot ~/wasi-sdk-20.0/share/wasi-sysroot -O2 -msimd128 -mrelaxed-simd main.c c_api1.c c_api1_component_type.o -o main-simd.wasm
+    wasm-tools component new main-simd.wasm -o "../$subdir-simd.wasm" --adapt ../../../golem-wit/adapters/tier1/wasi_snapshot_preview1.wasm
+
     popd || exit
   done
 fi
@@ -4,23 +4,34 @@
 #include <time.h>
 
 #include "c_api1.h"
+#include "../cabi-arena/cabi_arena.h"
 
 int32_t main(void) {
     return 0;
 }
 
+static void free_string(c_api1_string_t *s) {
+    if (!cabi_arena_contains(s->ptr)) {
+        c_api1_string_free(s);
+    }
+}
+
 int32_t c_api1_run(void) {
+    cabi_arena_enter();
     printf("Hello World!\n");
+    cabi_arena_reset();
     return 100;
 }
 
 void c_api1_print(c_api1_string_t *s) {
-    char* buf = malloc(s->len + 1);
-    memset(buf, 0, s->len + 1);
-    strncpy(buf, s->ptr, s->len);
+    cabi_arena_enter();
 
     time_t t = time(NULL);
     struct tm tm = *localtime(&t);
 
-    printf("%s %d\n", buf, tm.tm_year + 1900);
+    // The lifted string is not NUL-terminated, so it is printed with an explicit length
+    printf("%.*s %d\n", (int) s->len, (const char*) s->ptr, tm.tm_year + 1900);
+
+    free_string(s);
+    cabi_arena_reset();
 }
@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "c_api1.h"
+
+int32_t main(void) {
+    return 0;
+}
+
+// Integer dot product kernel, auto-vectorized when built with -msimd128
+int64_t c_api1_dot(uint32_t length, uint32_t iterations) {
+    int32_t *a = malloc(length * sizeof(int32_t));
+    int32_t *b = malloc(length * sizeof(int32_t));
+    if (length == 0 || !a || !b) abort();
+
+    for (uint32_t i = 0; i < length; i++) {
+        a[i] = (int32_t) (i % 7);
+        b[i] = (int32_t) (i % 5);
+    }
+
+    int64_t total = 0;
+    for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+        int32_t sum = 0;
+        for (uint32_t i = 0; i < length; i++) {
+            sum += a[i] * b[i];
+        }
+        total += sum;
+        // Keeps the compiler from computing the inner loop only once
+        a[iteration % length] += 1;
+    }
+
+    free(a);
+    free(b);
+    return total;
+}
@@ -0,0 +1,84 @@
+#ifndef CABI_ARENA_H
+#define CABI_ARENA_H
+
+#include <stdlib.h>
+#include <string.h>
+
+// Bump allocator serving the canonical ABI allocations made by the host when lowering the
+// arguments of an export call. It replaces the weak `cabi_realloc` generated by wit-bindgen, so
+// this header must be included by exactly one translation unit of a component.
+//
+// The arena is only armed between export calls: once an export starts running it is disarmed,
+// so allocations made by the guest code or the WASI adapter (which keeps its state in memory
+// allocated through `cabi_realloc`) go to libc. Resetting it at the end of the export releases
+// all the arguments at once. It starts disarmed so the adapter's state is already allocated
+// by the time the first arguments are placed in the arena.
+//
+// Defining NO_CABI_ARENA keeps the libc-only `cabi_realloc` of the generated bindings.
+
+#ifndef NO_CABI_ARENA
+
+#define CABI_ARENA_SIZE 64*1024
+
+static unsigned char cabi_arena[CABI_ARENA_SIZE] __attribute__((__aligned__(16)));
+static size_t cabi_arena_used = 0;
+static int cabi_arena_armed = 0;
+
+int cabi_arena_contains(void *ptr) {
+    return (unsigned char*) ptr >= cabi_arena && (unsigned char*) ptr < cabi_arena + CABI_ARENA_SIZE;
+}
+
+__attribute__((__export_name__("cabi_realloc")))
+void *cabi_realloc(void *ptr, size_t old_size, size_t align, size_t new_size) {
+    if (new_size == 0) return (void*) align;
+
+    size_t copied = old_size < new_size ? old_size : new_size;
+
+    if (cabi_arena_armed) {
+        size_t start = (cabi_arena_used + align - 1) & ~(align - 1);
+        if (start + new_size <= CABI_ARENA_SIZE) {
+            cabi_arena_used = start + new_size;
+            if (ptr != NULL) {
+                memmove(cabi_arena + start, ptr, copied);
+                if (!cabi_arena_contains(ptr)) free(ptr);
+            }
+            return cabi_arena + start;
+        }
+    }
+
+    void *ret;
+    if (cabi_arena_contains(ptr)) {
+        ret = malloc(new_size);
+        if (ret) memcpy(ret, ptr, copied);
+    } else {
+        ret = realloc(ptr, new_size);
+    }
+    if (!ret) abort();
+    return ret;
+}
+
+// Called when an export starts running
+void cabi_arena_enter(void) {
+    cabi_arena_armed = 0;
+}
+
+// Called when an export returns, releasing the arguments placed in the arena
+void cabi_arena_reset(void) {
+    cabi_arena_used = 0;
+    cabi_arena_armed = 1;
+}
+
+#else
+
+int cabi_arena_contains(void *ptr) {
+    (void) ptr;
+    return 0;
+}
+
+void cabi_arena_enter(void) {}
+
+void cabi_arena_reset(void) {}
+
+#endif
+
+#endif
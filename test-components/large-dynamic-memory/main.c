@@ -5,6 +5,7 @@
 #include <unistd.h>
 
 #include "c_api1.h"
+#include "../cabi-arena/cabi_arena.h"
 
 int32_t main(void) {
     return 0;
@@ -14,6 +15,7 @@ int32_t main(void) {
 #define COUNT 512
 
 uint64_t c_api1_run(void) {
+    cabi_arena_enter();
     for (int i = 0; i < COUNT; i++) {
         char* DATA = malloc(PAGE_SIZE);
         printf("page %d first: %d\n", i, DATA[0]);
@@ -22,5 +24,6 @@ uint64_t c_api1_run(void) {
         usleep(5);
     }
 
+    cabi_arena_reset();
     return 0;
 }
@@ -5,6 +5,7 @@
 #include <unistd.h>
 
 #include "c_api1.h"
+#include "../cabi-arena/cabi_arena.h"
 
 int32_t main(void) {
     return 0;
@@ -14,11 +15,13 @@ int32_t main(void) {
 static char DATA[DATA_SIZE] = {};
 
 uint64_t c_api1_run(void) {
+    cabi_arena_enter();
     printf("DATA:  %lu\n", sizeof(DATA));
     printf("first: %d\n", DATA[0]);
     printf("last:  %d\n", DATA[DATA_SIZE-1]);
 
     sleep(2);
 
+    cabi_arena_reset();
     return sizeof(DATA);
 }
@@ -7,11 +7,15 @@ pub fn build(b: *Builder) !void {
         .preferred_optimize_mode = .ReleaseSmall,
     });
 
+    const simd = b.option(bool, "simd", "Enable the WebAssembly SIMD and relaxed SIMD instructions") orelse false;
+    const cpu_features = if (simd) std.Target.wasm.featureSet(&.{ .simd128, .relaxed_simd }) else std.Target.Cpu.Feature.Set.empty;
+
     const bindgen = b.addSystemCommand(&.{ "wit-bindgen", "c", "--autodrop-borrows", "yes", "./wit", "--out-dir", "src/bindings" });
 
     const wasm = b.addExecutable(.{ .name = "main", .root_source_file = .{ .path = "src/main.zig" }, .target = .{
         .cpu_arch = .wasm32,
         .os_tag = .wasi,
+        .cpu_features_add = cpu_features,
     }, .optimize = optimize });
 
     const binding_root = b.pathFromRoot("src/bindings");
@@ -32,6 +36,8 @@ pub fn build(b: *Builder) !void {
         }
     }
 
+    wasm.addCSourceFile(.{ .file = .{ .path = "src/cabi_arena.c" }, .flags = &.{} });
+
     wasm.addIncludePath(.{ .path = binding_root });
     wasm.linkLibC();
 
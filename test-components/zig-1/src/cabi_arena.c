@@ -0,0 +1,2 @@
+// Replaces the libc-only cabi_realloc of the generated bindings with the shared arena
+#include "../../cabi-arena/cabi_arena.h"
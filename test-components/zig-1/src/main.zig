@@ -2,7 +2,13 @@ const std = @import("std");
 
 var gpa = std.heap.GeneralPurposeAllocator(.{}){};
 
+extern fn cabi_arena_enter() void;
+extern fn cabi_arena_reset() void;
+
 export fn zig1_run() void {
+    cabi_arena_enter();
+    defer cabi_arena_reset();
+
     const stdin = std.io.getStdIn().reader();
     const stdout = std.io.getStdOut().writer();
     const stderr = std.io.getStdErr().writer();
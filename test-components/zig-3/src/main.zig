@@ -18,6 +18,33 @@ export fn exports_golem_it_api_get() u64 {
     return state;
 }
 
+// Integer dot product kernel, auto-vectorized when built with -Dsimd=true
+export fn exports_golem_it_api_dot(length: u32, iterations: u32) i64 {
+    const allocator = gpa.allocator();
+    const a = allocator.alloc(i32, length) catch unreachable;
+    defer allocator.free(a);
+    const b = allocator.alloc(i32, length) catch unreachable;
+    defer allocator.free(b);
+
+    for (a, b, 0..) |*x, *y, i| {
+        x.* = @intCast(i % 7);
+        y.* = @intCast(i % 5);
+    }
+
+    var total: i64 = 0;
+    var iteration: u32 = 0;
+    while (iteration < iterations) : (iteration += 1) {
+        var sum: i32 = 0;
+        for (a, b) |x, y| {
+            sum +%= x *% y;
+        }
+        total += sum;
+        // Keeps the compiler from computing the inner loop only once
+        a[iteration % length] += 1;
+    }
+    return total;
+}
+
 pub fn main() anyerror!void {
     const stdout = std.io.getStdOut().writer();
     try stdout.print("Started\n", .{});